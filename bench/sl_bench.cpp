@@ -0,0 +1,1321 @@
+//
+// Microbenchmarks
+//
+// Usage:
+//     sl_bench [--quick] [--csv] [--filter <substring>]
+//
+// Prints one JSON object per benchmark per line (or CSV with --csv) so runs can
+// be diffed or loaded straight into a script:
+//
+//     {"name":"da_append_int","n":1000000,"runs":25,"ns_per_op":1.204,"min_ns_per_op":1.187,"mb_per_s":0}
+//
+// ns_per_op is the median over the runs and min_ns_per_op the fastest.  mb_per_s
+// is only filled in for benchmarks that chew through bytes.  The first line is a
+// "meta" record with the compiler and CPU features so results from different
+// machines don't get compared by accident.
+//
+// --quick cuts the sizes and run times down far enough to use as a smoke test.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#include "dyn_array.h"
+
+#define SL_CPU_IMPL
+#include "sl_cpu.h"
+
+#define SL_HASH_IMPL
+#include "sl_hash.h"
+
+#define SL_BLOB_IMPL
+#include "sl_blob.h"
+
+#define SL_PARSE_IMPL
+#include "sl_parse.h"
+
+#define SL_JOB_IMPL
+#define SL_LOAD_IMPL
+#include "sl_load.h"
+
+#define SL_POOL_IMPL
+#include "sl_pool.h"
+
+#define SL_SORT_IMPL
+#include "sl_sort.h"
+
+#define SL_BITS_IMPL
+#include "sl_bits.h"
+
+#include "sl_heap.h"
+
+#define SL_UTF8_IMPL
+#include "sl_utf8.h"
+
+#define SL_GEOM2D_IMPL
+#include "sl_geom2d.h"
+
+#define SL_PACK_IMPL
+#define SL_VERTEX_IMPL
+#include "sl_vertex.h"
+
+#define SL_TRANSFORM_IMPL
+#include "sl_transform.h"
+
+#define SL_RANDOM_IMPL
+#include "sl_random.h"
+
+#define SL_KDTREE_IMPL
+#include "sl_kdtree.h"
+
+global bool Quick;
+global bool Csv;
+global char* Filter;
+
+// NOTE(scott): results go through here so the compiler can't throw the work away
+global volatile real64 Sink;
+
+internal real64
+NowSeconds()
+{
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (real64)Now.tv_sec + (real64)Now.tv_nsec * 1e-9;
+}
+
+internal u32
+RandomU32()
+{
+    local_persist u32 State = 2463534242u;
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    return State;
+}
+
+internal real32
+RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * (real32)(RandomU32() & 0xffffff) / (real32)0xffffff;
+}
+
+typedef void bench_fn(i32 N, void* Data);
+
+internal int
+CompareReal64(const void* A, const void* B)
+{
+    real64 X = *(const real64*)A, Y = *(const real64*)B;
+    return (X > Y) - (X < Y);
+}
+
+// NOTE(scott): runs Fn over N operations until it has MinSeconds of samples (and
+// at least a few runs) and reports the median, which shrugs off the odd run that
+// got interrupted
+internal void
+Bench(const char* Name, bench_fn* Fn, i32 N, void* Data, size_t BytesPerRun = 0)
+{
+    if (Filter && !strstr(Name, Filter))
+        return;
+
+    const i32 MaxRuns = 1000;
+    real64 MinSeconds = Quick ? 0.01 : 0.5;
+    i32 MinRuns = Quick ? 1 : 5;
+    real64 Times[MaxRuns];
+    i32 Runs = 0;
+
+    // one untimed pass to warm the caches and the allocator
+    Fn(N, Data);
+
+    real64 Total = 0;
+    while (Runs < MaxRuns && (Runs < MinRuns || Total < MinSeconds))
+    {
+        real64 Start = NowSeconds();
+        Fn(N, Data);
+        real64 Elapsed = NowSeconds() - Start;
+        Times[Runs++] = Elapsed;
+        Total += Elapsed;
+    }
+
+    qsort(Times, Runs, sizeof(real64), CompareReal64);
+    real64 Median = Times[Runs / 2];
+    real64 NsPerOp = Median * 1e9 / N;
+    real64 MinNsPerOp = Times[0] * 1e9 / N;
+    real64 MbPerS = BytesPerRun ? (real64)BytesPerRun / Median / (1024.0 * 1024.0) : 0;
+
+    if (Csv)
+        printf("%s,%d,%d,%.3f,%.3f,%.1f\n", Name, N, Runs, NsPerOp, MinNsPerOp, MbPerS);
+    else
+        printf("{\"name\":\"%s\",\"n\":%d,\"runs\":%d,\"ns_per_op\":%.3f,\"min_ns_per_op\":%.3f,\"mb_per_s\":%.1f}\n",
+               Name, N, Runs, NsPerOp, MinNsPerOp, MbPerS);
+    fflush(stdout);
+}
+
+//
+// dyn_array
+//
+
+internal void
+BenchDaAppendInt(i32 N, void* Data)
+{
+    i32* List = NULL;
+    for (i32 i = 0; i < N; i++)
+    {
+        da_append(List, i);
+    }
+    Sink = List[N - 1];
+    da_delete(List);
+}
+
+typedef struct bench_item
+{
+    real32 Position[3];
+    real32 Velocity[3];
+    u32 Flags;
+    i32 Id;
+} bench_item;
+
+internal void
+BenchDaAppendStruct(i32 N, void* Data)
+{
+    bench_item* List = NULL;
+    for (i32 i = 0; i < N; i++)
+    {
+        bench_item Item = { { 1, 2, 3 }, { 4, 5, 6 }, 0, i };
+        da_append(List, Item);
+    }
+    Sink = List[N - 1].Id;
+    da_delete(List);
+}
+
+internal void
+BenchDaInsertFront(i32 N, void* Data)
+{
+    i32* List = NULL;
+    for (i32 i = 0; i < N; i++)
+    {
+        da_insert(List, i, 0);
+    }
+    Sink = List[0];
+    da_delete(List);
+}
+
+internal void
+BenchDaInsertMiddle(i32 N, void* Data)
+{
+    i32* List = NULL;
+    for (i32 i = 0; i < N; i++)
+    {
+        da_insert(List, i, da_len(List) / 2);
+    }
+    Sink = List[0];
+    da_delete(List);
+}
+
+//
+// Allocation
+//
+
+// NOTE(scott): keeps a window of live nodes so frees don't just undo the last
+// alloc, which is the pattern that flatters every allocator
+internal void
+BenchMallocChurn(i32 N, void* Data)
+{
+    void* Live[64] = {};
+    for (i32 i = 0; i < N; i++)
+    {
+        i32 Slot = (i32)((u32)i * 2654435761u >> 26);
+        free(Live[Slot]);
+        Live[Slot] = malloc(32);
+    }
+    for (i32 i = 0; i < 64; i++)
+        free(Live[i]);
+}
+
+internal void
+BenchPoolChurn(i32 N, void* Data)
+{
+    void* Live[64] = {};
+    for (i32 i = 0; i < N; i++)
+    {
+        i32 Slot = (i32)((u32)i * 2654435761u >> 26);
+        sl_pool_free(Live[Slot]);
+        Live[Slot] = sl_pool_alloc(32);
+    }
+    for (i32 i = 0; i < 64; i++)
+        sl_pool_free(Live[i]);
+}
+
+//
+// Sorting
+//
+
+#define Real32Less(A, B) (*(A) < *(B))
+SL_SORT_DEFINE(SortReal32, real32, Real32Less)
+
+typedef struct sort_data
+{
+    real32* Source;
+    real32* Work;
+} sort_data;
+
+internal int
+CompareReal32(const void* A, const void* B)
+{
+    real32 X = *(const real32*)A, Y = *(const real32*)B;
+    return (X > Y) - (X < Y);
+}
+
+internal void
+BenchQsort(i32 N, void* Data)
+{
+    sort_data* D = (sort_data*)Data;
+    memcpy(D->Work, D->Source, sizeof(real32) * N);
+    qsort(D->Work, N, sizeof(real32), CompareReal32);
+    Sink = D->Work[N / 2];
+}
+
+internal void
+BenchIntroSort(i32 N, void* Data)
+{
+    sort_data* D = (sort_data*)Data;
+    memcpy(D->Work, D->Source, sizeof(real32) * N);
+    SortReal32(D->Work, N);
+    Sink = D->Work[N / 2];
+}
+
+internal void
+BenchParallelSort(i32 N, void* Data)
+{
+    sort_data* D = (sort_data*)Data;
+    memcpy(D->Work, D->Source, sizeof(real32) * N);
+    SortReal32_parallel(D->Work, N);
+    Sink = D->Work[N / 2];
+}
+
+internal void
+BenchRadixSort(i32 N, void* Data)
+{
+    sort_data* D = (sort_data*)Data;
+    memcpy(D->Work, D->Source, sizeof(real32) * N);
+    sl_radix_sort_f32(D->Work, N, NULL);
+    Sink = D->Work[N / 2];
+}
+
+//
+// Spatial index
+//
+
+internal void
+BenchKdtreeBuild(i32 N, void* Data)
+{
+    sl_kdtree Tree = sl_kdtree_build((vec3f*)Data);
+    Sink = Tree.Nodes[0].Max.X;
+    sl_kdtree_free(&Tree);
+}
+
+//
+// Flags
+//
+
+typedef struct flag_data
+{
+    bool32* Flags;
+    sl_bits Bits;
+} flag_data;
+
+internal void
+BenchBool32Count(i32 N, void* Data)
+{
+    flag_data* D = (flag_data*)Data;
+    i32 Count = 0;
+    for (i32 i = 0; i < N; i++)
+        Count += D->Flags[i] != 0;
+    Sink = Count;
+}
+
+internal void
+BenchBitsCount(i32 N, void* Data)
+{
+    flag_data* D = (flag_data*)Data;
+    Sink = sl_bits_count(&D->Bits);
+}
+
+//
+// Priority queues
+//
+
+typedef struct bench_event
+{
+    real64 Time;
+    i32 Id;
+} bench_event;
+
+#define BenchEventBefore(A, B) ((A)->Time < (B)->Time)
+SL_HEAP_DEFINE(bench_event_queue, bench_event, BenchEventBefore)
+
+internal void
+BenchHeapPushPop(i32 N, void* Data)
+{
+    real64* Times = (real64*)Data;
+    bench_event_queue Queue = {};
+    for (i32 i = 0; i < N; i++)
+    {
+        bench_event Event = { Times[i], i };
+        bench_event_queue_push(&Queue, Event);
+    }
+    bench_event Event = {};
+    while (bench_event_queue_pop(&Queue, &Event))
+        ;
+    Sink = Event.Time;
+    bench_event_queue_free(&Queue);
+}
+
+//
+// UTF-8
+//
+
+typedef struct utf8_data
+{
+    char* Text;
+    unsigned int* CodePoints;
+} utf8_data;
+
+internal void
+BenchUtf8Validate(i32 N, void* Data)
+{
+    utf8_data* D = (utf8_data*)Data;
+    Sink = sl_utf8_validate(D->Text, (size_t)N, NULL);
+}
+
+internal void
+BenchUtf8ToUtf32(i32 N, void* Data)
+{
+    utf8_data* D = (utf8_data*)Data;
+    Sink = (real64)sl_utf8_to_utf32(D->Text, (size_t)N, D->CodePoints, NULL);
+}
+
+//
+// 2D geometry
+//
+
+typedef struct fence_data
+{
+    vec2f* Fence;
+    vec2f* Points;
+    i32* Inside;
+} fence_data;
+
+internal void
+BenchPointInPolygonLoop(i32 N, void* Data)
+{
+    fence_data* D = (fence_data*)Data;
+    i32 Count = 0;
+    for (i32 i = 0; i < N; i++)
+        Count += ContainsPointPolygon2f(D->Fence, da_len(D->Fence), D->Points[i]);
+    Sink = Count;
+}
+
+internal void
+BenchPointsInPolygon(i32 N, void* Data)
+{
+    fence_data* D = (fence_data*)Data;
+    da_clear(D->Inside);
+    sl_points_in_polygon2f(D->Fence, da_len(D->Fence), D->Points, N, &D->Inside);
+    Sink = da_len(D->Inside);
+}
+
+//
+// Vertex packing
+//
+
+typedef struct vertex_data
+{
+    vec3f* Positions;
+    vec3f* Normals;
+    vec2f* Uvs;
+    sl_vertex_layout Layout;
+    u8* Buffer;
+} vertex_data;
+
+// NOTE(scott): the obvious version, one vertex at a time through the scalar
+// conversions straight into the interleaved buffer
+internal void
+BenchVertexLoop(i32 N, void* Data)
+{
+    vertex_data* D = (vertex_data*)Data;
+    u8* Out = D->Buffer;
+    for (i32 i = 0; i < N; i++)
+    {
+        u32 Normal = EncodeOctNormal(D->Normals[i]);
+        u16 Uv[2] = { Real32ToHalf(D->Uvs[i].X), Real32ToHalf(D->Uvs[i].Y) };
+        memcpy(Out, &D->Positions[i], sizeof(vec3f));
+        memcpy(Out + 12, &Normal, sizeof(Normal));
+        memcpy(Out + 16, Uv, sizeof(Uv));
+        Out += 20;
+    }
+    Sink = D->Buffer[N];
+}
+
+internal void
+BenchVertexPack(i32 N, void* Data)
+{
+    vertex_data* D = (vertex_data*)Data;
+    real32* Sources[3] = { &D->Positions[0].X, &D->Normals[0].X, &D->Uvs[0].X };
+    sl_vertex_pack_da(&D->Layout, Sources, N, &D->Buffer);
+    Sink = D->Buffer[N];
+}
+
+//
+// Transform hierarchies
+//
+
+typedef struct transform_data
+{
+    sl_transforms Scene;
+    sl_transform* Moving;
+} transform_data;
+
+// NOTE(scott): what a tick costs without dirty tracking, every world matrix
+// again in parent first order
+internal void
+BenchTransformEveryNode(i32 N, void* Data)
+{
+    sl_transforms* T = &((transform_data*)Data)->Scene;
+    for (i32 i = 0; i < N; i++)
+        T->World[i] = T->Parent[i] < 0 ? T->Local[i] : MulMat4f(T->World[T->Parent[i]], T->Local[i]);
+    Sink = T->World[N - 1].E[12];
+}
+
+internal void
+BenchTransformUpdateAll(i32 N, void* Data)
+{
+    sl_transforms* T = &((transform_data*)Data)->Scene;
+    sl_transform_update_all(T);
+    Sink = sl_transform_update(T);
+}
+
+internal void
+BenchTransformUpdateMoved(i32 N, void* Data)
+{
+    transform_data* D = (transform_data*)Data;
+    for (i32 i = 0; i < da_len(D->Moving); i++)
+        sl_transform_set_local(&D->Scene, D->Moving[i], sl_transform_local(&D->Scene, D->Moving[i]));
+    Sink = sl_transform_update(&D->Scene);
+}
+
+//
+// Random numbers
+//
+
+typedef struct rng_data
+{
+    sl_random Rng;
+    real32* Floats;
+    vec3f* Directions;
+} rng_data;
+
+// NOTE(scott): what the sampling code did before, rand() scaled to [0, 1)
+internal void
+BenchRandLoop(i32 N, void* Data)
+{
+    rng_data* D = (rng_data*)Data;
+    for (i32 i = 0; i < N; i++)
+        D->Floats[i] = (real32)rand() * (1.f / ((real32)RAND_MAX + 1.f));
+    Sink = D->Floats[N - 1];
+}
+
+internal void
+BenchRandomReal32(i32 N, void* Data)
+{
+    rng_data* D = (rng_data*)Data;
+    for (i32 i = 0; i < N; i++)
+        D->Floats[i] = sl_random_real32(&D->Rng);
+    Sink = D->Floats[N - 1];
+}
+
+internal void
+BenchRandomFillReal32(i32 N, void* Data)
+{
+    rng_data* D = (rng_data*)Data;
+    sl_random_fill_real32(&D->Rng, D->Floats, N, 0.f, 1.f);
+    Sink = D->Floats[N - 1];
+}
+
+internal void
+BenchRandomFillNormal(i32 N, void* Data)
+{
+    rng_data* D = (rng_data*)Data;
+    sl_random_fill_normal(&D->Rng, D->Floats, N, 0.f, 1.f);
+    Sink = D->Floats[N - 1];
+}
+
+internal void
+BenchRandomSphere(i32 N, void* Data)
+{
+    rng_data* D = (rng_data*)Data;
+    da_clear(D->Directions);
+    sl_random_vec3f_sphere_da(&D->Rng, &D->Directions, N);
+    Sink = D->Directions[N - 1].Z;
+}
+
+//
+// Number parsing
+//
+
+internal void
+BenchSlAtof(i32 N, void* Data)
+{
+    char** Strings = (char**)Data;
+    real32 Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        real32 V = 0;
+        sl_atof(Strings[i], &V);
+        Total += V;
+    }
+    Sink = Total;
+}
+
+internal void
+BenchStrtod(i32 N, void* Data)
+{
+    char** Strings = (char**)Data;
+    real64 Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        Total += strtod(Strings[i], NULL);
+    }
+    Sink = Total;
+}
+
+internal void
+BenchStrtof(i32 N, void* Data)
+{
+    char** Strings = (char**)Data;
+    real32 Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        Total += strtof(Strings[i], NULL);
+    }
+    Sink = Total;
+}
+
+typedef struct point_text
+{
+    char* Text;         // "{ x, y, z }" per line
+    size_t Size;
+    char** Lines;       // the same lines, terminated, for ParseVec3f
+} point_text;
+
+internal void
+BenchParseVec3f(i32 N, void* Data)
+{
+    point_text* D = (point_text*)Data;
+    vec3f* Points = NULL;
+    for (i32 i = 0; i < N; i++)
+    {
+        da_append(Points, ParseVec3f(D->Lines[i]));
+    }
+    Sink = Points[N - 1].X;
+    da_delete(Points);
+}
+
+internal void
+BenchParseTuples(i32 N, void* Data)
+{
+    point_text* D = (point_text*)Data;
+    vec3f* Points = NULL;
+    sl_parse_tuples_da(D->Text, D->Size, 3, Points, NULL);
+    Sink = Points[N - 1].X;
+    da_delete(Points);
+}
+
+internal void
+BenchLoadTuples(i32 N, void* Data)
+{
+    point_text* D = (point_text*)Data;
+    vec3f* Points = NULL;
+    sl_load_tuples_da(D->Text, D->Size, 3, Points, NULL);
+    Sink = Points[N - 1].X;
+    da_delete(Points);
+}
+
+//
+// Files
+//
+
+global char BenchIniPath[] = "sl_bench.ini";
+
+internal size_t
+WriteSyntheticIni(i32 Sections, i32 KeysPerSection)
+{
+    FILE* File = fopen(BenchIniPath, "wb");
+    if (!File)
+        return 0;
+
+    fprintf(File, "; synthetic benchmark input\n");
+    for (i32 s = 0; s < Sections; s++)
+    {
+        fprintf(File, "[section_%d]\n", s);
+        for (i32 k = 0; k < KeysPerSection; k++)
+        {
+            switch (k % 4)
+            {
+                case 0: fprintf(File, "key_%d = %d\n", k, (i32)RandomU32()); break;
+                case 1: fprintf(File, "position_%d = { %f, %f }\n", k, RandomReal32(-1000, 1000), RandomReal32(-1000, 1000)); break;
+                case 2: fprintf(File, "name_%d=some value here ; trailing comment\n", k); break;
+                case 3: fprintf(File, "  # indented comment line %d\n", k); break;
+            }
+        }
+        fprintf(File, "\n");
+    }
+
+    size_t Size = (size_t)ftell(File);
+    fclose(File);
+    return Size;
+}
+
+internal void
+CountIni(char* Section, char* Param, char* Value, void* UserData)
+{
+    (*(i32*)UserData)++;
+}
+
+internal void
+BenchParseIniFile(i32 N, void* Data)
+{
+    i32 Count = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        ParseIniFile(BenchIniPath, CountIni, &Count);
+    }
+    Sink = Count;
+}
+
+internal void
+BenchReadEntireFile(i32 N, void* Data)
+{
+    size_t Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        read_file_result File = ReadEntireFile(BenchIniPath, *(bool*)Data);
+        Total += File.size;
+        free(File.contents);
+    }
+    Sink = (real64)Total;
+}
+
+//
+// Hashing
+//
+
+typedef struct hash_data
+{
+    unsigned char* Bytes;
+    size_t Size;
+} hash_data;
+
+internal void
+BenchHash64(i32 N, void* Data)
+{
+    hash_data* D = (hash_data*)Data;
+    u64 Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        Total += sl_hash64(D->Bytes, D->Size, (u64)i);
+    }
+    Sink = (real64)Total;
+}
+
+typedef struct intern_data
+{
+    sl_intern_table Table;
+    char** Names;
+    i32 Count;
+} intern_data;
+
+internal void
+BenchInternFind(i32 N, void* Data)
+{
+    intern_data* D = (intern_data*)Data;
+    i32 Total = 0;
+    for (i32 i = 0; i < N; i++)
+    {
+        Total += sl_intern_find(&D->Table, D->Names[i % D->Count]);
+    }
+    Sink = Total;
+}
+
+//
+// Saving arrays between stages
+//
+
+global char BenchArrayPath[] = "sl_bench.array";
+
+internal void
+BenchVec3fText(i32 N, void* Data)
+{
+    vec3f* Points = (vec3f*)Data;
+    FILE* File = fopen(BenchArrayPath, "wb");
+    for (i32 i = 0; i < N; i++)
+    {
+        char* Line = Vec3fToString(Points[i]);
+        fputs(Line, File);
+        fputc('\n', File);
+        free(Line);
+    }
+    fclose(File);
+
+    read_file_result Text = ReadEntireFile(BenchArrayPath, false);
+    vec3f* Loaded = NULL;
+    char* Line = (char*)Text.contents;
+    while (*Line)
+    {
+        char* End = strchr(Line, '\n');
+        *End = 0;
+        da_append(Loaded, ParseVec3f(Line));
+        Line = End + 1;
+    }
+    Sink = Loaded[N - 1].X;
+    da_delete(Loaded);
+    free(Text.contents);
+}
+
+internal void
+BenchVec3fBlob(i32 N, void* Data)
+{
+    vec3f* Points = (vec3f*)Data;
+    sl_blob_write_da(BenchArrayPath, Points, SL_BLOB_VEC3F);
+
+    vec3f* Loaded = NULL;
+    sl_blob_view View;
+    sl_blob_map_da(BenchArrayPath, Loaded, SL_BLOB_VEC3F, SL_BLOB_VERIFY, &View);
+    real32 Total = 0;
+    for (i32 i = 0; i < da_len(Loaded); i++)
+        Total += Loaded[i].X;
+    Sink = Total;
+    sl_blob_unmap(&View);
+}
+
+//
+// Math
+//
+
+typedef struct mul_data
+{
+    mat4f M;
+    vec4f* In;
+    vec4f* Out;
+} mul_data;
+
+internal void
+BenchMul(i32 N, void* Data)
+{
+    mul_data* D = (mul_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Out[i] = Mul(D->M, D->In[i]);
+    }
+    Sink = D->Out[N - 1].X;
+}
+
+typedef struct rotation_data
+{
+    vec3f* Angles;
+    mat4f* Out;
+} rotation_data;
+
+internal void
+BenchMakeRotationMat4f(i32 N, void* Data)
+{
+    rotation_data* D = (rotation_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Out[i] = MakeRotationMat4f(D->Angles[i]);
+    }
+    Sink = D->Out[N - 1].E[0];
+}
+
+typedef struct quat_data
+{
+    quat* A;
+    quat* B;
+    quat* Out;
+    mat4f* Matrices;
+    vec3f* Points;
+    vec3f* Rotated;
+} quat_data;
+
+internal void
+BenchMulQuat(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Out[i] = MulQuat(D->A[i], D->B[i]);
+    }
+    Sink = D->Out[N - 1].w;
+}
+
+internal void
+BenchMulQuatArray(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    MulQuatArray(D->Out, D->A, D->B, N);
+    Sink = D->Out[N - 1].w;
+}
+
+internal void
+BenchQuatToMat4f(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Matrices[i] = QuatToMat4f(D->A[i]);
+    }
+    Sink = D->Matrices[N - 1].E[0];
+}
+
+internal void
+BenchQuatToMat4fArray(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    QuatToMat4fArray(D->Matrices, D->A, N);
+    Sink = D->Matrices[N - 1].E[0];
+}
+
+internal void
+BenchRotateVec3fByQuat(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    quat Q = D->A[0];
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Rotated[i] = RotateVec3fByQuat(Q, D->Points[i]);
+    }
+    Sink = D->Rotated[N - 1].X;
+}
+
+internal void
+BenchRotateVec3fArrayByQuat(i32 N, void* Data)
+{
+    quat_data* D = (quat_data*)Data;
+    RotateVec3fArrayByQuat(D->Rotated, D->Points, N, D->A[0]);
+    Sink = D->Rotated[N - 1].X;
+}
+
+typedef struct geo_data
+{
+    vec3d* Geodetic;
+    vec3d* Ecef;
+    vec3d* Out;
+} geo_data;
+
+internal void
+BenchGeodeticToEcef(i32 N, void* Data)
+{
+    geo_data* D = (geo_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Out[i] = GeodeticToEcef(D->Geodetic[i]);
+    }
+    Sink = (real32)D->Out[N - 1].X;
+}
+
+internal void
+BenchGeodeticToEcefArray(i32 N, void* Data)
+{
+    geo_data* D = (geo_data*)Data;
+    GeodeticToEcefArray(D->Out, D->Geodetic, N);
+    Sink = (real32)D->Out[N - 1].X;
+}
+
+internal void
+BenchEcefToGeodetic(i32 N, void* Data)
+{
+    geo_data* D = (geo_data*)Data;
+    for (i32 i = 0; i < N; i++)
+    {
+        D->Out[i] = EcefToGeodetic(D->Ecef[i]);
+    }
+    Sink = (real32)D->Out[N - 1].Lat;
+}
+
+internal void
+BenchEcefToGeodeticArray(i32 N, void* Data)
+{
+    geo_data* D = (geo_data*)Data;
+    EcefToGeodeticArray(D->Out, D->Ecef, N);
+    Sink = (real32)D->Out[N - 1].Lat;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+            Quick = true;
+        else if (strcmp(argv[i], "--csv") == 0)
+            Csv = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            Filter = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--quick] [--csv] [--filter <substring>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    char Features[256];
+    sl_cpu_describe(sl_cpu_features(), Features, sizeof(Features));
+#if defined(__clang__)
+    const char* Compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const char* Compiler = "gcc " __VERSION__;
+#else
+    const char* Compiler = "unknown";
+#endif
+#ifdef SL_SSE2
+    const char* Simd = "sse2";
+#else
+    const char* Simd = "none";
+#endif
+
+    if (Csv)
+        printf("name,n,runs,ns_per_op,min_ns_per_op,mb_per_s\n");
+    else
+        printf("{\"name\":\"meta\",\"compiler\":\"%s\",\"simd\":\"%s\",\"cpu\":\"%s\",\"quick\":%s}\n",
+               Compiler, Simd, Features, Quick ? "true" : "false");
+
+    i32 Scale = Quick ? 100 : 1;
+
+    Bench("da_append_int", BenchDaAppendInt, 1000000 / Scale, NULL);
+    Bench("da_append_struct32", BenchDaAppendStruct, 1000000 / Scale, NULL);
+    Bench("da_insert_front", BenchDaInsertFront, 20000 / Scale, NULL);
+    Bench("da_insert_middle", BenchDaInsertMiddle, 20000 / Scale, NULL);
+
+    Bench("malloc_free_32", BenchMallocChurn, 1000000 / Scale, NULL);
+    Bench("sl_pool_alloc_free_32", BenchPoolChurn, 1000000 / Scale, NULL);
+
+    i32 SortCount = 1000000 / Scale;
+    sort_data Sort;
+    Sort.Source = (real32*)malloc(sizeof(real32) * SortCount);
+    Sort.Work = (real32*)malloc(sizeof(real32) * SortCount);
+    for (i32 i = 0; i < SortCount; i++)
+        Sort.Source[i] = RandomReal32(-1000, 1000);
+    Bench("qsort_f32", BenchQsort, SortCount, &Sort);
+    Bench("sl_sort_f32", BenchIntroSort, SortCount, &Sort);
+    sl_job_init(0);
+    Bench("sl_sort_parallel_f32", BenchParallelSort, SortCount, &Sort);
+    sl_job_shutdown();
+    Bench("sl_radix_sort_f32", BenchRadixSort, SortCount, &Sort);
+    free(Sort.Source);
+    free(Sort.Work);
+
+    i32 KdCount = 1000000 / Scale;
+    vec3f* KdPoints = NULL;
+    for (i32 i = 0; i < KdCount; i++)
+    {
+        da_append(KdPoints, Vec3f(RandomReal32(-1000, 1000), RandomReal32(-1000, 1000), RandomReal32(-100, 100)));
+    }
+    Bench("sl_kdtree_build", BenchKdtreeBuild, KdCount, KdPoints);
+    sl_job_init(0);
+    Bench("sl_kdtree_build_parallel", BenchKdtreeBuild, KdCount, KdPoints);
+    sl_job_shutdown();
+    da_delete(KdPoints);
+
+    i32 FlagCount = 10000000 / Scale;
+    flag_data Flags;
+    Flags.Flags = (bool32*)malloc(sizeof(bool32) * FlagCount);
+    Flags.Bits = {};
+    sl_bits_resize(&Flags.Bits, FlagCount);
+    for (i32 i = 0; i < FlagCount; i++)
+    {
+        Flags.Flags[i] = (RandomU32() & 7) == 0;
+        sl_bits_assign(&Flags.Bits, i, Flags.Flags[i]);
+    }
+    Bench("bool32_count", BenchBool32Count, FlagCount, &Flags, sizeof(bool32) * FlagCount);
+    Bench("sl_bits_count", BenchBitsCount, FlagCount, &Flags, FlagCount / 8);
+    free(Flags.Flags);
+    sl_bits_free(&Flags.Bits);
+
+    i32 EventCount = 100000 / Scale;
+    real64* EventTimes = (real64*)malloc(sizeof(real64) * EventCount);
+    for (i32 i = 0; i < EventCount; i++)
+        EventTimes[i] = RandomReal32(0, 1000);
+    Bench("sl_heap_push_pop", BenchHeapPushPop, EventCount, EventTimes);
+    free(EventTimes);
+
+    // NOTE(scott): mostly ASCII with a sprinkling of two, three and four byte
+    // characters, like a config or data file with some names in it
+    i32 TextBytes = 4000000 / Scale;
+    utf8_data Utf8;
+    Utf8.Text = (char*)malloc(TextBytes + 4);
+    Utf8.CodePoints = (unsigned int*)malloc(sizeof(unsigned int) * (TextBytes + 4));
+    i32 TextLength = 0;
+    while (TextLength < TextBytes)
+    {
+        u32 Roll = RandomU32() % 100;
+        const char* Piece = Roll < 3 ? "\xc3\xa9" : Roll < 5 ? "\xe6\x97\xa5" : Roll < 6 ? "\xf0\x9f\x98\x80" : "e";
+        i32 Length = (i32)strlen(Piece);
+        memcpy(Utf8.Text + TextLength, Piece, Length);
+        TextLength += Length;
+    }
+    sl_cpu_override(0);
+    Bench("sl_utf8_validate_scalar", BenchUtf8Validate, TextLength, &Utf8, TextLength);
+    sl_cpu_override(~0u);
+    Bench("sl_utf8_validate", BenchUtf8Validate, TextLength, &Utf8, TextLength);
+    Bench("sl_utf8_to_utf32", BenchUtf8ToUtf32, TextLength, &Utf8, TextLength);
+    free(Utf8.Text);
+    free(Utf8.CodePoints);
+
+    // NOTE(scott): a 64 sided fence in the middle of points spread over 4x its
+    // bounds, so most of them get thrown out by the bounds check
+    i32 FencePoints = 1000000 / Scale;
+    fence_data Fence = {};
+    for (i32 i = 0; i < 64; i++)
+    {
+        real32 Angle = (real32)(2 * SL_PI * i / 64);
+        real32 Radius = (i & 1) ? 80.f : 100.f;
+        vec2f V = Vec2f(Radius * cosf(Angle), Radius * sinf(Angle));
+        da_append(Fence.Fence, V);
+    }
+    Fence.Points = (vec2f*)malloc(sizeof(vec2f) * FencePoints);
+    for (i32 i = 0; i < FencePoints; i++)
+        Fence.Points[i] = Vec2f(RandomReal32(-200, 200), RandomReal32(-200, 200));
+    Bench("point_in_polygon_loop", BenchPointInPolygonLoop, FencePoints, &Fence);
+    Bench("sl_points_in_polygon2f", BenchPointsInPolygon, FencePoints, &Fence);
+    da_delete(Fence.Fence);
+    da_delete(Fence.Inside);
+    free(Fence.Points);
+
+    // NOTE(scott): float3 position, octahedral normal and half2 uv, 20 bytes a vertex
+    i32 VertexCount = 1000000 / Scale;
+    vertex_data Vertices = {};
+    sl_vertex_layout_add(&Vertices.Layout, 3, SL_VERTEX_FLOAT);
+    sl_vertex_layout_add(&Vertices.Layout, 3, SL_VERTEX_OCT_NORMAL);
+    sl_vertex_layout_add(&Vertices.Layout, 2, SL_VERTEX_HALF);
+    for (i32 i = 0; i < VertexCount; i++)
+    {
+        vec3f P = Vec3f(RandomReal32(-100, 100), RandomReal32(-100, 100), RandomReal32(-100, 100));
+        vec3f N = Vec3f(RandomReal32(-1, 1), RandomReal32(-1, 1), RandomReal32(-1, 1) + 2.f);
+        real32 Length = sqrtf(N.X * N.X + N.Y * N.Y + N.Z * N.Z);
+        N = Vec3f(N.X / Length, N.Y / Length, N.Z / Length);
+        vec2f Uv = Vec2f(RandomReal32(0, 1), RandomReal32(0, 1));
+        da_append(Vertices.Positions, P);
+        da_append(Vertices.Normals, N);
+        da_append(Vertices.Uvs, Uv);
+    }
+    Vertices.Buffer = _da_init(Vertices.Buffer, VertexCount * Vertices.Layout.Stride);
+    i32 VertexBytes = VertexCount * Vertices.Layout.Stride;
+    Bench("vertex_interleave_loop", BenchVertexLoop, VertexCount, &Vertices, VertexBytes);
+    Bench("sl_vertex_pack", BenchVertexPack, VertexCount, &Vertices, VertexBytes);
+    da_delete(Vertices.Positions);
+    da_delete(Vertices.Normals);
+    da_delete(Vertices.Uvs);
+    da_delete(Vertices.Buffer);
+
+    // NOTE(scott): a wide shallow scene, 1% of the leaves and a few mid level
+    // nodes move each tick
+    i32 TransformCount = 100000 / Scale;
+    transform_data Transforms = {};
+    sl_transform* AllTransforms = NULL;
+    for (i32 i = 0; i < TransformCount; i++)
+    {
+        sl_transform Parent = i < 16 ? SL_TRANSFORM_NONE : AllTransforms[RandomU32() % (i < 1000 ? i : 1000)];
+        mat4f Local = TranslateMat4fByVec3f(MakeRotationMat4f(Vec3f(RandomReal32(-3, 3), 0, 0)),
+                                            Vec3f(RandomReal32(-1, 1), RandomReal32(-1, 1), RandomReal32(-1, 1)));
+        sl_transform Node = sl_transform_add(&Transforms.Scene, Parent, Local);
+        da_append(AllTransforms, Node);
+        if (i >= 1000 && RandomU32() % 100 == 0)
+        {
+            da_append(Transforms.Moving, Node);
+        }
+    }
+    for (i32 i = 0; i < 4; i++)
+    {
+        da_append(Transforms.Moving, AllTransforms[500 + i]);
+    }
+    sl_transform_update(&Transforms.Scene);
+    Bench("transform_every_node", BenchTransformEveryNode, TransformCount, &Transforms);
+    Bench("sl_transform_update_all", BenchTransformUpdateAll, TransformCount, &Transforms);
+    Bench("sl_transform_update_moved", BenchTransformUpdateMoved, TransformCount, &Transforms);
+    sl_transforms_free(&Transforms.Scene);
+    da_delete(Transforms.Moving);
+    da_delete(AllTransforms);
+
+    i32 RandomCount = 1000000 / Scale;
+    rng_data Rngs = {};
+    sl_random_seed(&Rngs.Rng, 1);
+    Rngs.Floats = (real32*)malloc(sizeof(real32) * RandomCount);
+    Bench("rand_real32_loop", BenchRandLoop, RandomCount, &Rngs);
+    Bench("sl_random_real32", BenchRandomReal32, RandomCount, &Rngs);
+    Bench("sl_random_fill_real32", BenchRandomFillReal32, RandomCount, &Rngs, sizeof(real32) * RandomCount);
+    Bench("sl_random_fill_normal", BenchRandomFillNormal, RandomCount, &Rngs, sizeof(real32) * RandomCount);
+    Bench("sl_random_vec3f_sphere_da", BenchRandomSphere, RandomCount, &Rngs, sizeof(vec3f) * RandomCount);
+    free(Rngs.Floats);
+    da_delete(Rngs.Directions);
+
+    i32 NumberCount = 100000 / Scale;
+    char** Numbers = (char**)malloc(sizeof(char*) * NumberCount);
+    for (i32 i = 0; i < NumberCount; i++)
+    {
+        char Buffer[64];
+        snprintf(Buffer, sizeof(Buffer), "%.6f", RandomReal32(-100000, 100000));
+        Numbers[i] = (char*)malloc(strlen(Buffer) + 1);
+        strcpy(Numbers[i], Buffer);
+    }
+    Bench("sl_atof", BenchSlAtof, NumberCount, Numbers);
+    Bench("strtod", BenchStrtod, NumberCount, Numbers);
+    Bench("strtof", BenchStrtof, NumberCount, Numbers);
+    for (i32 i = 0; i < NumberCount; i++)
+        free(Numbers[i]);
+    free(Numbers);
+
+    point_text PointText = {};
+    PointText.Lines = (char**)malloc(sizeof(char*) * NumberCount);
+    for (i32 i = 0; i < NumberCount; i++)
+    {
+        PointText.Lines[i] = sl_format(malloc, "{ %f, %f, %f }", RandomReal32(-1000, 1000), RandomReal32(-1000, 1000), RandomReal32(-1000, 1000));
+        PointText.Size += strlen(PointText.Lines[i]) + 1;
+    }
+    PointText.Text = (char*)malloc(PointText.Size);
+    for (size_t i = 0, At = 0; i < (size_t)NumberCount; i++)
+    {
+        size_t Length = strlen(PointText.Lines[i]);
+        memcpy(PointText.Text + At, PointText.Lines[i], Length);
+        PointText.Text[At + Length] = '\n';
+        At += Length + 1;
+    }
+    Bench("ParseVec3f", BenchParseVec3f, NumberCount, &PointText, PointText.Size);
+    Bench("sl_parse_tuples_vec3f", BenchParseTuples, NumberCount, &PointText, PointText.Size);
+    sl_job_init(0);
+    Bench("sl_load_tuples_vec3f", BenchLoadTuples, NumberCount, &PointText, PointText.Size);
+    sl_job_shutdown();
+    for (i32 i = 0; i < NumberCount; i++)
+        free(PointText.Lines[i]);
+    free(PointText.Lines);
+    free(PointText.Text);
+
+    size_t IniSize = Quick ? WriteSyntheticIni(100, 16) : WriteSyntheticIni(20000, 16);
+    if (!IniSize)
+    {
+        fprintf(stderr, "Couldn't write %s\n", BenchIniPath);
+        return 1;
+    }
+    bool AsText = false, AsBinary = true;
+    Bench("ParseIniFile", BenchParseIniFile, 1, NULL, IniSize);
+    Bench("ReadEntireFile_text", BenchReadEntireFile, 1, &AsText, IniSize);
+    Bench("ReadEntireFile_binary", BenchReadEntireFile, 1, &AsBinary, IniSize);
+    remove(BenchIniPath);
+
+    hash_data Hash;
+    Hash.Size = 64 * 1024;
+    Hash.Bytes = (unsigned char*)malloc(Hash.Size);
+    for (size_t i = 0; i < Hash.Size; i++)
+        Hash.Bytes[i] = (unsigned char)RandomU32();
+    Bench("sl_hash64_64k", BenchHash64, 1000 / Scale, &Hash, Hash.Size * (1000 / Scale));
+    Hash.Size = 16;
+    Bench("sl_hash64_16b", BenchHash64, 1000000 / Scale, &Hash, Hash.Size * (1000000 / Scale));
+    free(Hash.Bytes);
+
+    intern_data Intern = {};
+    Intern.Count = 10000 / Scale;
+    Intern.Names = (char**)malloc(sizeof(char*) * Intern.Count);
+    for (i32 i = 0; i < Intern.Count; i++)
+    {
+        char Buffer[64];
+        snprintf(Buffer, sizeof(Buffer), "section_%u.key_%d", RandomU32() % 1000, i);
+        Intern.Names[i] = (char*)sl_intern_str(&Intern.Table, Buffer);
+    }
+    Bench("sl_intern_find", BenchInternFind, 1000000 / Scale, &Intern);
+    sl_intern_free(&Intern.Table);
+    free(Intern.Names);
+
+    i32 PointCount = 100000 / Scale;
+    vec3f* Points = NULL;
+    for (i32 i = 0; i < PointCount; i++)
+    {
+        da_append(Points, Vec3f(RandomReal32(-1000, 1000), RandomReal32(-1000, 1000), RandomReal32(-1000, 1000)));
+    }
+    Bench("vec3f_save_load_text", BenchVec3fText, PointCount, Points);
+    Bench("vec3f_save_load_blob", BenchVec3fBlob, PointCount, Points, sizeof(vec3f) * PointCount);
+    remove(BenchArrayPath);
+    da_delete(Points);
+
+    i32 MathCount = 100000 / Scale;
+    mul_data Mul = {};
+    Mul.M = MakeRotationMat4f(Vec3f(0.1f, 0.2f, 0.3f));
+    Mul.M = TranslateMat4fByVec3f(Mul.M, Vec3f(1, 2, 3));
+    Mul.In = (vec4f*)malloc(sizeof(vec4f) * MathCount);
+    Mul.Out = (vec4f*)malloc(sizeof(vec4f) * MathCount);
+    for (i32 i = 0; i < MathCount; i++)
+    {
+        vec4f V = { RandomReal32(-10, 10), RandomReal32(-10, 10), RandomReal32(-10, 10), 1.f };
+        Mul.In[i] = V;
+    }
+    Bench("Mul_mat4f_vec4f", BenchMul, MathCount, &Mul, sizeof(vec4f) * 2 * MathCount);
+    free(Mul.In);
+    free(Mul.Out);
+
+    rotation_data Rotation;
+    Rotation.Angles = (vec3f*)malloc(sizeof(vec3f) * MathCount);
+    Rotation.Out = (mat4f*)malloc(sizeof(mat4f) * MathCount);
+    for (i32 i = 0; i < MathCount; i++)
+        Rotation.Angles[i] = Vec3f(RandomReal32(-3, 3), RandomReal32(-3, 3), RandomReal32(-3, 3));
+    Bench("MakeRotationMat4f", BenchMakeRotationMat4f, MathCount, &Rotation);
+    free(Rotation.Angles);
+    free(Rotation.Out);
+
+    quat_data Quats;
+    Quats.A = (quat*)malloc(sizeof(quat) * MathCount);
+    Quats.B = (quat*)malloc(sizeof(quat) * MathCount);
+    Quats.Out = (quat*)malloc(sizeof(quat) * MathCount);
+    Quats.Matrices = (mat4f*)malloc(sizeof(mat4f) * MathCount);
+    Quats.Points = (vec3f*)malloc(sizeof(vec3f) * MathCount);
+    Quats.Rotated = (vec3f*)malloc(sizeof(vec3f) * MathCount);
+    for (i32 i = 0; i < MathCount; i++)
+    {
+        Quats.A[i] = QuatFromAxisAngle(Vec3f(0, 0, 1), RandomReal32(-3, 3));
+        Quats.B[i] = QuatFromAxisAngle(Vec3f(1, 0, 0), RandomReal32(-3, 3));
+        Quats.Points[i] = Vec3f(RandomReal32(-100, 100), RandomReal32(-100, 100), RandomReal32(-100, 100));
+    }
+    Bench("MulQuat", BenchMulQuat, MathCount, &Quats);
+    Bench("MulQuatArray", BenchMulQuatArray, MathCount, &Quats);
+    Bench("QuatToMat4f", BenchQuatToMat4f, MathCount, &Quats);
+    Bench("QuatToMat4fArray", BenchQuatToMat4fArray, MathCount, &Quats);
+    Bench("RotateVec3fByQuat", BenchRotateVec3fByQuat, MathCount, &Quats);
+    Bench("RotateVec3fArrayByQuat", BenchRotateVec3fArrayByQuat, MathCount, &Quats);
+    free(Quats.A);
+    free(Quats.B);
+    free(Quats.Out);
+    free(Quats.Matrices);
+    free(Quats.Points);
+    free(Quats.Rotated);
+
+    geo_data Geo;
+    Geo.Geodetic = (vec3d*)malloc(sizeof(vec3d) * MathCount);
+    Geo.Ecef = (vec3d*)malloc(sizeof(vec3d) * MathCount);
+    Geo.Out = (vec3d*)malloc(sizeof(vec3d) * MathCount);
+    for (i32 i = 0; i < MathCount; i++)
+    {
+        Geo.Geodetic[i] = Vec3d(RandomReal32(-1.5f, 1.5f), RandomReal32(-3, 3), RandomReal32(0, 12000));
+        Geo.Ecef[i] = GeodeticToEcef(Geo.Geodetic[i]);
+    }
+    Bench("GeodeticToEcef", BenchGeodeticToEcef, MathCount, &Geo);
+    Bench("GeodeticToEcefArray", BenchGeodeticToEcefArray, MathCount, &Geo);
+    Bench("EcefToGeodetic", BenchEcefToGeodetic, MathCount, &Geo);
+    Bench("EcefToGeodeticArray", BenchEcefToGeodeticArray, MathCount, &Geo);
+    free(Geo.Geodetic);
+    free(Geo.Ecef);
+    free(Geo.Out);
+
+    return 0;
+}
@@ -21,6 +21,17 @@
 //     int cap
 //     T[cap]  <- return of da_init points here
 
+// NOTE(Scott): build with SL_PROFILE to time the resizes, see sl_profile.h
+#if defined(SL_PROFILE)
+#include "sl_profile.h"
+#endif
+#ifndef SL_PROFILE_ZONE
+#define SL_PROFILE_ZONE(Name)
+#endif
+
+#include <string.h>
+#include <assert.h>
+
 #if !defined(da_alloc) || !defined(da_realloc) || !defined(da_free)
     #include <stdlib.h>
     #define da_alloc(size) malloc(size)
@@ -36,8 +47,15 @@
 void* _da_resize(void* ptr, size_t elem_size, size_t new_len);
 
 
+// NOTE(Scott): C++ won't assign a void* back to the list without a cast
+#if defined(__cplusplus)
+template <typename T> inline T* _da_typed(T*, void* ptr) { return (T*)ptr; }
+#define _da_init(__da_list, __size) \
+    _da_typed(__da_list, _da_resize(__da_list, sizeof(*__da_list), __size))
+#else
 #define _da_init(__da_list, __size) \
     _da_resize(__da_list, sizeof(*__da_list), __size)
+#endif
 
 
 #define da_len(__da_list) \
@@ -59,7 +77,7 @@ void* _da_resize(void* ptr, size_t elem_size, size_t new_len);
 #define da_insert(__da_list, __item, __index) \
     if((__da_list)==NULL) (__da_list) = _da_init(__da_list, 16);     \
     else if (da_cap((__da_list)) == da_len((__da_list))) (__da_list) = _da_init((__da_list), da_cap((__da_list)) * 2);    \
-    memcpy((__da_list) + (__index) + 1, (__da_list) + (__index), sizeof(*(__da_list)) * (da_len((__da_list)) - (__index)));  \
+    memmove((__da_list) + (__index) + 1, (__da_list) + (__index), sizeof(*(__da_list)) * (da_len((__da_list)) - (__index)));  \
     (__da_list)[__index] = (__item); \
     _da_hdr((__da_list))++ // incrememnt len
 
@@ -70,14 +88,14 @@ void* _da_resize(void* ptr, size_t elem_size, size_t new_len);
 
 // NOTE(Scott): this is an ordered, slower remove
 #define da_remove(__da_list, __index) \
-    assert(da_len((__da_list)) > __index + 1); \
-    memcpy((__da_list) + (__index), (__da_list) + (__index) + 1, sizeof(*(__da_list)) * (da_len((__da_list)) - (__index)));  \
-    (_da_hdr((__da_list))--);
+    assert((__index) >= 0 && (__index) < da_len((__da_list))); \
+    memmove((__da_list) + (__index), (__da_list) + (__index) + 1, sizeof(*(__da_list)) * (da_len((__da_list)) - (__index) - 1));  \
+    (_da_hdr((__da_list))--)
 
 
 // NOTE(Scott): this is an unordered, faster move
 #define da_remove_unordered(__da_list, __index) \
-    assert(da_len((__da_list)) > __index + 1);     \
+    assert((__index) >= 0 && (__index) < da_len((__da_list)));     \
     (__da_list)[(__index)] = (__da_list)[da_len((__da_list)) - 1], _da_hdr((__da_list))--
 
 
@@ -94,7 +112,8 @@ void* _da_resize(void* ptr, size_t elem_size, size_t new_len);
 //
 #ifdef DYN_ARRAY_IMPL
 
-inline void* _da_resize(void* ptr, size_t elem_size, size_t new_len) {    
+void* _da_resize(void* ptr, size_t elem_size, size_t new_len) {    
+    SL_PROFILE_ZONE("_da_resize");
     if (ptr) {
         int* block = (int*)da_realloc(&_da_hdr(ptr), sizeof(int) * 2 + elem_size * new_len);
         *(block+1) = new_len;
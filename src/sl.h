@@ -26,6 +26,31 @@ Define SL_DEBUG _once_ before #including this file to enable debug code
 #ifndef _SL_H_
 #define _SL_H_
 
+// NOTE(scott): define SL_NO_SIMD to force the scalar paths
+#if !defined(SL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#ifndef SL_SSE2
+#define SL_SSE2 1
+#endif
+#endif
+
+#ifdef SL_SSE2
+#include <emmintrin.h>
+#endif
+
+// NOTE(scott): build with SL_PROFILE to turn on the zones in the hot paths, see sl_profile.h
+#if defined(SL_PROFILE)
+#include "sl_profile.h"
+#endif
+#ifndef SL_PROFILE_ZONE
+#define SL_PROFILE_ZONE(Name)
+#endif
+
+// NOTE(scott): build with SL_UTF8_CHECK to have text files checked for valid
+// UTF-8 as they're read, see sl_utf8.h (which then needs SL_UTF8_IMPL somewhere)
+#if defined(SL_UTF8_CHECK)
+#include "sl_utf8.h"
+#endif
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -67,6 +92,31 @@ extern "C" {
     
 #define cast(TYPE) (TYPE)
     
+#ifndef SL_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define SL_THREAD_LOCAL __declspec(thread)
+#else
+#define SL_THREAD_LOCAL __thread
+#endif
+#endif
+
+// NOTE(scott): with FMA available (-march=native and friends) GCC and Clang fuse
+// a * b + c into one rounding, and not the same way in a scalar loop and its SSE2
+// version.  Code that promises the same bits as some other path goes between
+// these so contraction is off for it whatever the build flags are.  GCC won't
+// inline it into code built with contraction on, so keep the regions to what
+// needs them.
+#if defined(__clang__)
+#define SL_NO_CONTRACT_BEGIN _Pragma("float_control(push)") _Pragma("clang fp contract(off)")
+#define SL_NO_CONTRACT_END _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+#define SL_NO_CONTRACT_BEGIN _Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+#define SL_NO_CONTRACT_END _Pragma("GCC pop_options")
+#else
+#define SL_NO_CONTRACT_BEGIN
+#define SL_NO_CONTRACT_END
+#endif
+    
     
 #define internal        static
 #define global          static
@@ -157,6 +207,60 @@ extern "C" {
         Abs(real32 Value);
     
     
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // Scratch Memory
+    //
+    // Every thread gets its own arena for results that only live a little while.
+    // Push a scope, allocate as much as you like, pop the scope and it's all gone:
+    //
+    //     sl_scratch_mark Mark = sl_scratch_push();
+    //     char* Name = CatStringsScratch(Dir, File);
+    //     ...
+    //     sl_scratch_pop(Mark);
+    //
+    // Scopes nest and popping an outer mark throws away the inner ones too.  The
+    // blocks stay with the thread after a pop so once it's warmed up it never goes
+    // back to malloc.  sl_scratch_release() hands them back, e.g. at thread exit.
+    //
+    // The *Scratch versions of the string functions below return scratch memory
+    // instead of a malloc'd buffer, don't free() them.
+    //
+    
+#ifndef SL_SCRATCH_BLOCK_SIZE
+#define SL_SCRATCH_BLOCK_SIZE (64 * 1024)
+#endif
+    
+    typedef struct sl_scratch_block
+    {
+        struct sl_scratch_block* Next;
+        size_t Size;
+        size_t Used;
+    } sl_scratch_block;
+    
+    typedef struct sl_scratch_mark
+    {
+        sl_scratch_block* Block;
+        size_t Used;
+    } sl_scratch_mark;
+    
+    sl_scratch_mark
+        sl_scratch_push();
+    
+    void
+        sl_scratch_pop(sl_scratch_mark Mark);
+    
+    // 16 byte aligned
+    void*
+        sl_scratch_alloc(size_t Size);
+    
+    void
+        sl_scratch_release();
+    
+    char*
+        sl_scratch_printf(const char* Format, ...);
+    
+    
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //
     // File IO
@@ -167,6 +271,11 @@ extern "C" {
         bool success;
         char* contents;
         size_t size;
+        
+        // NOTE(scott): only with SL_UTF8_CHECK, a text read that isn't valid
+        // UTF-8 fails with bad_utf8 set and the offset of the first bad byte
+        bool bad_utf8;
+        size_t utf8_error_offset;
     } read_file_result;
     
     static read_file_result ReadEntireFile(char* Path, bool AsBinary = false);
@@ -174,6 +283,9 @@ extern "C" {
     char*
         CatStrings(char* A, char* B);
     
+    char*
+        CatStringsScratch(char* A, char* B);
+    
     void
         StringCopy(char* Dest, char* Src, i32 Count);
     
@@ -200,6 +312,8 @@ extern "C" {
     
     typedef void(*sl_ini_handler)(char* Section, char* Param, char* Value, void* UserData);
     
+    // 0 on success, -1 when the file can't be read, -2 when it isn't valid UTF-8
+    // (only checked with SL_UTF8_CHECK)
     i32 ParseIniFile(char* FilePath, sl_ini_handler Handler, void* UserData);
     
     
@@ -208,7 +322,7 @@ extern "C" {
     // Spacial Types & Math
     //
     
-    typedef struct vec2f
+    typedef union vec2f
     {
         struct
         {
@@ -232,6 +346,9 @@ extern "C" {
     char*
         Vec2fToString(vec2f V);
     
+    char*
+        Vec2fToStringScratch(vec2f V);
+    
     void
         PrintVec2f(vec2f V);
     
@@ -254,7 +371,7 @@ bool operator==(const vec2f& A, const vec2f& B);
 extern "C" {
 #endif
     
-    typedef struct vec3f
+    typedef union vec3f
     {
         struct
         {
@@ -275,6 +392,8 @@ extern "C" {
         real32 E[3];
     } vec3f;
     
+    vec3f Vec3f(real32 X, real32 Y, real32 Z);
+    
     vec3f
         InvalidVec3f();
     
@@ -284,10 +403,33 @@ extern "C" {
     char*
         Vec3fToString(vec3f V);
     
+    char*
+        Vec3fToStringScratch(vec3f V);
+    
     void
         PrintVec3f(vec3f V);
     
     
+    // NOTE(scott): real32 only has ~7 significant digits which is about half a
+    // meter at the surface of the earth, so anything geodetic uses vec3d
+    typedef union vec3d
+    {
+        struct
+        {
+            real64 X, Y, Z;
+        };
+        struct
+        {
+            real64 Lat, Lon, Alt;
+        };
+        real64 E[3];
+    } vec3d;
+    
+    vec3d Vec3d(real64 X, real64 Y, real64 Z);
+    vec3d Vec3fToVec3d(vec3f V);
+    vec3f Vec3dToVec3f(vec3d V);
+    
+    
     typedef union vec4f
     {
         struct
@@ -326,7 +468,7 @@ extern "C" {
         };
         vec4f col[4];
         real32 E[16];
-    } mat4;
+    } mat4f;
     
     mat4f
         Mat4Identity();
@@ -343,34 +485,51 @@ extern "C" {
     mat4f
         MakeRotationMat4f(vec3f V);
     
-#if 0
-    // TODO: implement this
+    // A * B, column vectors, so B applies first
     mat4f
-        RotateMat4fByVec3f(mat4f M, vec3f V)
-    {
-        mat4f Result;
-        
-        mat4f Rotation = MakeRotationMat4f(V);
-        Result = MulMat4f(Rotation, M);
-        
-        return Result;
-    }
-#endif
+        MulMat4f(mat4f A, mat4f B);
+    
+    mat4f
+        RotateMat4fByVec3f(mat4f M, vec3f V);
 
 char*
 Vec4fToString(vec4f V);
 
+char*
+Vec4fToStringScratch(vec4f V);
+
 void
 PrintVec4f(vec4f V);
 
 //--------------------------------------------------------------
 
+//
+// Geodesy (WGS-84)
+//
+// Lat and Lon are in radians, Alt is meters above the ellipsoid, ECEF is meters.
+//
+
+#define SL_WGS84_A      6378137.0               // semi-major axis (m)
+#define SL_WGS84_F      (1.0 / 298.257223563)   // flattening
+#define SL_WGS84_B      (SL_WGS84_A * (1.0 - SL_WGS84_F))
+#define SL_WGS84_E2     (SL_WGS84_F * (2.0 - SL_WGS84_F))
+
+vec3d GeodeticToEcef(vec3d LatLonAlt);
+vec3d EcefToGeodetic(vec3d Ecef);
+
+// NOTE(scott): batch versions, Out may alias In.  With SL_SSE2 they run 2 at a
+// time with their own sin/cos/atan2/cbrt instead of libm.
+void GeodeticToEcefArray(vec3d* Out, vec3d* In, i32 Count);
+void EcefToGeodeticArray(vec3d* Out, vec3d* In, i32 Count);
+
+//--------------------------------------------------------------
+
 typedef union quat
 {
     struct
     {
         real32 x, y, z, w;
-    }
+    };
     struct
     {
         vec3f v;
@@ -379,21 +538,44 @@ typedef union quat
     real32 E[4];
 } quat;
 
+quat Quat(real32 x, real32 y, real32 z, real32 w);
+quat IdentityQuat();
+quat QuatFromAxisAngle(vec3f Axis, real32 Angle);
 quat AddQuat(quat A, quat B);
+real32 DotQuat(quat A, quat B);
 real32 NormQuat(quat A);
 quat NozQuat(quat A);
 quat MulQuat(quat A, quat B);
 quat InvQuat(quat A);
 quat ConjQuat(quat A);
 bool EqualsQuat(quat A, quat B);
+quat NlerpQuat(quat A, quat B, real32 t);
+quat SlerpQuat(quat A, quat B, real32 t);
+vec3f RotateVec3fByQuat(quat Q, vec3f V);
+mat4f QuatToMat4f(quat Q);
+
+// NOTE(scott): batch versions of the above.  Out may alias the inputs.  These
+// work 4 quats at a time in SIMD registers when SL_SSE2 is defined.
+void MulQuatArray(quat* Out, quat* A, quat* B, i32 Count);
+void NozQuatArray(quat* Out, quat* A, i32 Count);
+void NlerpQuatArray(quat* Out, quat* A, quat* B, real32* t, i32 Count);
+void SlerpQuatArray(quat* Out, quat* A, quat* B, real32* t, i32 Count);
+void QuatToMat4fArray(mat4f* Out, quat* Q, i32 Count);
+void RotateVec3fArrayByQuat(vec3f* Out, vec3f* V, i32 Count, quat Q);
 
 #if defined(__cplusplus)
 }
-#endif
 quat operator+(const quat& A, const quat& B);
 quat operator*(const quat& A, const quat& B);
-bool operator==(const vec2f& A, const vec2f& B);
-#if defined(__cplusplus)
+bool operator==(const quat& A, const quat& B);
+
+// pops on the way out of the enclosing block
+struct sl_scratch_scope
+{
+    sl_scratch_mark Mark;
+    sl_scratch_scope() : Mark(sl_scratch_push()) {}
+    ~sl_scratch_scope() { sl_scratch_pop(Mark); }
+};
 extern "C" {
 #endif
 
@@ -412,6 +594,11 @@ extern "C" {
 #if defined(_SL_H_IMPLEMENTATION) && !defined(_SL_H_IMPLEMENTATION_DONE)
 #define _SL_H_IMPLEMENTATION_DONE
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -446,8 +633,131 @@ extern "C" {
     }
     
     
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // Scratch Memory
+    //
+    
+    // NOTE(scott): blocks form a list that only grows.  Current is the block
+    // being carved up; anything after it is free and gets reused before we
+    // allocate again.
+    global SL_THREAD_LOCAL sl_scratch_block* sl_scratch_first;
+    global SL_THREAD_LOCAL sl_scratch_block* sl_scratch_current;
+    
+    sl_scratch_mark
+        sl_scratch_push()
+    {
+        sl_scratch_mark Result;
+        Result.Block = sl_scratch_current;
+        Result.Used = sl_scratch_current ? sl_scratch_current->Used : 0;
+        return Result;
+    }
+    
+    void
+        sl_scratch_pop(sl_scratch_mark Mark)
+    {
+        if (Mark.Block)
+        {
+            sl_scratch_current = Mark.Block;
+            sl_scratch_current->Used = Mark.Used;
+        }
+        else if (sl_scratch_first)
+        {
+            sl_scratch_current = sl_scratch_first;
+            sl_scratch_current->Used = 0;
+        }
+    }
+    
+    void*
+        sl_scratch_alloc(size_t Size)
+    {
+        Size = (Size + 15) & ~cast(size_t)15;
+        
+        sl_scratch_block* Block = sl_scratch_current;
+        if (!Block || Block->Used + Size > Block->Size)
+        {
+            sl_scratch_block* Next = Block ? Block->Next : sl_scratch_first;
+            if (Next && Next->Size >= Size)
+            {
+                Next->Used = 0;
+                Block = Next;
+            }
+            else
+            {
+                size_t BlockSize = Size > SL_SCRATCH_BLOCK_SIZE ? Size : SL_SCRATCH_BLOCK_SIZE;
+                sl_scratch_block* New = cast(sl_scratch_block*)malloc(sizeof(sl_scratch_block) + 16 + BlockSize);
+                New->Size = BlockSize;
+                New->Used = 0;
+                New->Next = Next;
+                if (Block)
+                    Block->Next = New;
+                else
+                    sl_scratch_first = New;
+                Block = New;
+            }
+            sl_scratch_current = Block;
+        }
+        
+        // NOTE(scott): the data starts on the first 16 byte boundary after the header
+        u8* Base = cast(u8*)(Block + 1);
+        Base += (16 - (cast(size_t)Base & 15)) & 15;
+        
+        void* Result = Base + Block->Used;
+        Block->Used += Size;
+        return Result;
+    }
+    
+    void
+        sl_scratch_release()
+    {
+        sl_scratch_block* Block = sl_scratch_first;
+        while (Block)
+        {
+            sl_scratch_block* Next = Block->Next;
+            free(Block);
+            Block = Next;
+        }
+        sl_scratch_first = 0;
+        sl_scratch_current = 0;
+    }
+    
+    internal char*
+        sl_vformat(void* (*Alloc)(size_t), const char* Format, va_list Args)
+    {
+        va_list Copy;
+        va_copy(Copy, Args);
+        int Length = vsnprintf(0, 0, Format, Copy) + 1;
+        va_end(Copy);
+        
+        char* Result = cast(char*)Alloc(Length);
+        vsnprintf(Result, Length, Format, Args);
+        return Result;
+    }
+    
+    internal char*
+        sl_format(void* (*Alloc)(size_t), const char* Format, ...)
+    {
+        va_list Args;
+        va_start(Args, Format);
+        char* Result = sl_vformat(Alloc, Format, Args);
+        va_end(Args);
+        return Result;
+    }
+    
+    char*
+        sl_scratch_printf(const char* Format, ...)
+    {
+        va_list Args;
+        va_start(Args, Format);
+        char* Result = sl_vformat(sl_scratch_alloc, Format, Args);
+        va_end(Args);
+        return Result;
+    }
+    
+    
     read_file_result ReadEntireFile(char* Path, bool AsBinary)
     {
+        SL_PROFILE_ZONE("ReadEntireFile");
         read_file_result Result = {0};
         
         FILE *f = NULL;
@@ -469,19 +779,45 @@ extern "C" {
             Result.contents[Result.size] = 0;
             Result.contents[Result.size + 1] = EOF;
             Result.success = true;
+            
+#if defined(SL_UTF8_CHECK)
+            // NOTE(scott): checked here while the file is still hot in cache
+            // instead of callers making a second pass over it
+            if (!AsBinary && !sl_utf8_validate(Result.contents, Result.size, &Result.utf8_error_offset))
+            {
+                free(Result.contents);
+                Result.contents = 0;
+                Result.size = 0;
+                Result.success = false;
+                Result.bad_utf8 = true;
+            }
+#endif
         }
         
         return Result;
     }
     
+    internal char*
+        sl_cat_strings(void* (*Alloc)(size_t), char* A, char* B)
+    {
+        size_t LenA = strlen(A);
+        size_t LenB = strlen(B);
+        char* Result = cast(char*)Alloc(LenA + LenB + 1);
+        memcpy(Result, A, LenA);
+        memcpy(Result + LenA, B, LenB + 1);
+        return Result;
+    }
+    
     char* 
         CatStrings(char* A, char* B)
     {
-        int LenA = strlen(A);
-        int LenB = strlen(B);
-        char* Result = cast(char*)malloc(LenA + LenB + 1);
-        snprintf(Result, LenA + LenB + 1, "%s%s", A, B);
-        return Result;
+        return sl_cat_strings(malloc, A, B);
+    }
+    
+    char*
+        CatStringsScratch(char* A, char* B)
+    {
+        return sl_cat_strings(sl_scratch_alloc, A, B);
     }
     
     void
@@ -599,7 +935,7 @@ extern "C" {
     typedef void (*sl_ini_handler)(char* Section, char* Param, char* Value, void* UserData);
     
     internal char*
-        sl_get_line(char* s)
+        sl_get_line_alloc(char* s, void* (*Alloc)(size_t))
     {
         static char* Start;
         char* End;
@@ -617,7 +953,9 @@ extern "C" {
             return 0;
         }
         
-        while(*s != EOF && *s != '\n')
+        // NOTE(scott): ReadEntireFile ends the contents with 0 then EOF, stop at
+        // either so the terminator never ends up inside the last line
+        while(*s && *s != EOF && *s != '\n')
         {
             s++;
         }
@@ -625,13 +963,12 @@ extern "C" {
         End = s;
         
         i32 len = End - Start;
-        char* Result = cast(char*)malloc(len + 1);
+        char* Result = cast(char*)Alloc(len + 1);
         StringCopy(Result, Start, len);
         
-        if (*s == EOF)
+        if (*s == 0 || *s == EOF)
         {
             Start = 0;
-            Result[len-1] = EOF;
         }
         else
         {
@@ -641,6 +978,18 @@ extern "C" {
         return Result;
     }
     
+    internal char*
+        sl_get_line(char* s)
+    {
+        return sl_get_line_alloc(s, malloc);
+    }
+    
+    internal char*
+        sl_get_line_scratch(char* s)
+    {
+        return sl_get_line_alloc(s, sl_scratch_alloc);
+    }
+    
     internal char*
         sl_find_next_char(char* s, char c)
     {
@@ -661,13 +1010,14 @@ extern "C" {
     
     i32 ParseIniFile(char* FilePath, sl_ini_handler Handler, void* UserData)
     {
+        SL_PROFILE_ZONE("ParseIniFile");
         i32 LineNumber;
         
         read_file_result ReadFile = ReadEntireFile(FilePath);
         
         if (!ReadFile.success)
         {
-            return -1;
+            return ReadFile.bad_utf8 ? -2 : -1;
         }
         
         char Section[256];
@@ -676,7 +1026,10 @@ extern "C" {
         
         Section[0] = 0;
         
-        char* line = sl_get_line(ReadFile.contents);
+        // NOTE(scott): lines come out of scratch memory and get popped before the
+        // next one is read, so the whole file goes through one reused block
+        sl_scratch_mark Mark = sl_scratch_push();
+        char* line = sl_get_line_scratch(ReadFile.contents);
         LineNumber = 0;
         do {
             char* str = line;
@@ -707,7 +1060,6 @@ extern "C" {
                 // skip comment lines
                 if (*str == ';' || *str == '#')
                 {
-                    free(line);
                     LineNumber++;
                     continue;
                 }
@@ -718,7 +1070,6 @@ extern "C" {
                 if (Start == End)
                 {
                     // Empty line
-                    free(line);
                     LineNumber++;
                     continue;
                 }
@@ -742,9 +1093,11 @@ extern "C" {
                 Handler(Section, Key, Value, UserData);
             }
             
-            free(line);
             LineNumber++;
-        } while ((line = sl_get_line(0)));
+        } while (sl_scratch_pop(Mark), (line = sl_get_line_scratch(0)));
+        
+        sl_scratch_pop(Mark);
+        free(ReadFile.contents);
         
         return 0;
     }
@@ -817,20 +1170,21 @@ extern "C" {
     char*
         Vec2fToString(vec2f V)
     {
-        int Length = snprintf(0, 0, "%f, %f", V.X, V.Y);
-        char* Result = cast(char*)malloc(Length);
-        
-        snprintf(Result, Length, "%f, %f", V.X, V.Y);
-        
-        return Result;
+        return sl_format(malloc, "%f, %f", V.X, V.Y);
+    }
+    
+    char*
+        Vec2fToStringScratch(vec2f V)
+    {
+        return sl_format(sl_scratch_alloc, "%f, %f", V.X, V.Y);
     }
     
     void
         PrintVec2f(vec2f V)
     {
-        char* FormattedString = Vec2fToString(V);
-        printf("{ %s }", FormattedString);
-        free(FormattedString);
+        sl_scratch_mark Mark = sl_scratch_push();
+        printf("{ %s }", Vec2fToStringScratch(V));
+        sl_scratch_pop(Mark);
     }
     
     vec2f AddVec2f(vec2f A, vec2f B)
@@ -901,6 +1255,16 @@ extern "C" {
     // Vec3f
     //
     
+    vec3f
+        Vec3f(real32 X, real32 Y, real32 Z)
+    {
+        vec3f Result;
+        Result.X = X;
+        Result.Y = Y;
+        Result.Z = Z;
+        return Result;
+    }
+    
     vec3f
         InvalidVec3f()
     {
@@ -957,20 +1321,47 @@ extern "C" {
     char*
         Vec3fToString(vec3f V)
     {
-        int Length = snprintf(0, 0, "%f, %f, %f", V.X, V.Y, V.Z);
-        char* Result = cast(char*)malloc(Length);
-        
-        snprintf(Result, Length, "%f, %f, %f", V.X, V.Y, V.Z);
-        
-        return Result;
+        return sl_format(malloc, "%f, %f, %f", V.X, V.Y, V.Z);
+    }
+    
+    char*
+        Vec3fToStringScratch(vec3f V)
+    {
+        return sl_format(sl_scratch_alloc, "%f, %f, %f", V.X, V.Y, V.Z);
     }
     
     void
         PrintVec3f(vec3f V)
     {
-        char* FormattedString = Vec3fToString(V);
-        printf("{ %s }", FormattedString);
-        free(FormattedString);
+        sl_scratch_mark Mark = sl_scratch_push();
+        printf("{ %s }", Vec3fToStringScratch(V));
+        sl_scratch_pop(Mark);
+    }
+    
+    //
+    // Vec3d
+    //
+    
+    vec3d
+        Vec3d(real64 X, real64 Y, real64 Z)
+    {
+        vec3d Result;
+        Result.X = X;
+        Result.Y = Y;
+        Result.Z = Z;
+        return Result;
+    }
+    
+    vec3d
+        Vec3fToVec3d(vec3f V)
+    {
+        return Vec3d(V.X, V.Y, V.Z);
+    }
+    
+    vec3f
+        Vec3dToVec3f(vec3d V)
+    {
+        return Vec3f(cast(real32)V.X, cast(real32)V.Y, cast(real32)V.Z);
     }
     
     
@@ -978,7 +1369,7 @@ extern "C" {
     mat4f 
         Mat4Identity()
     {
-        mat4 Result;
+        mat4f Result;
         
         Result.col[0] = {1.f, 0.f, 0.f, 0.f };
         Result.col[1] = {0.f, 1.f, 0.f, 0.f };
@@ -988,6 +1379,8 @@ extern "C" {
         return Result;
     }
     
+    // NOTE(scott): Mul and MulMat4f are what sl_transform.h matches bit for bit
+SL_NO_CONTRACT_BEGIN
     vec4f
         Mul(mat4f M, vec4f V)
     {
@@ -1011,6 +1404,7 @@ extern "C" {
         
         return Result;
     }
+SL_NO_CONTRACT_END
     
     mat4f
         TranslateMat4fByVec4f(mat4f M, vec4f V)
@@ -1068,8 +1462,21 @@ extern "C" {
         return Result;
     }
     
-#if 0
-    // TODO: implement this
+SL_NO_CONTRACT_BEGIN
+    mat4f
+        MulMat4f(mat4f A, mat4f B)
+    {
+        mat4f Result;
+        
+        Result.col[0] = Mul(A, B.col[0]);
+        Result.col[1] = Mul(A, B.col[1]);
+        Result.col[2] = Mul(A, B.col[2]);
+        Result.col[3] = Mul(A, B.col[3]);
+        
+        return Result;
+    }
+SL_NO_CONTRACT_END
+    
     mat4f
         RotateMat4fByVec3f(mat4f M, vec3f V)
     {
@@ -1080,25 +1487,376 @@ extern "C" {
         
         return Result;
     }
-#endif
     
-    snprintf(Result, Length, "%f, %f, %f, %f", V.X, V.Y, V.Z, V.W);
+char*
+Vec4fToString(vec4f V)
+{
+    return sl_format(malloc, "%f, %f, %f, %f", V.X, V.Y, V.Z, V.W);
+}
 
-    return Result;
+char*
+Vec4fToStringScratch(vec4f V)
+{
+    return sl_format(sl_scratch_alloc, "%f, %f, %f, %f", V.X, V.Y, V.Z, V.W);
 }
 
 void
 PrintVec4f(vec4f V)
 {
-    char* FormattedString = Vec4fToString(V);
-    printf("{ %s }", FormattedString);
-    free(FormattedString);
+    sl_scratch_mark Mark = sl_scratch_push();
+    printf("{ %s }", Vec4fToStringScratch(V));
+    sl_scratch_pop(Mark);
+}
+
+//
+// Geodesy
+//
+
+vec3d GeodeticToEcef(vec3d LatLonAlt)
+{
+    const real64 A = SL_WGS84_A;
+    const real64 E2 = SL_WGS84_E2;
+    const real64 OneMinusE2 = 1.0 - E2;
+
+    real64 Lat = LatLonAlt.Lat, Lon = LatLonAlt.Lon, Alt = LatLonAlt.Alt;
+    real64 SinLat = sin(Lat), CosLat = cos(Lat);
+    real64 SinLon = sin(Lon), CosLon = cos(Lon);
+
+    // prime vertical radius of curvature
+    real64 N = A / sqrt(1.0 - E2 * SinLat * SinLat);
+
+    vec3d Result;
+    Result.X = (N + Alt) * CosLat * CosLon;
+    Result.Y = (N + Alt) * CosLat * SinLon;
+    Result.Z = (N * OneMinusE2 + Alt) * SinLat;
+    return Result;
+}
+
+vec3d EcefToGeodetic(vec3d Ecef)
+{
+    // NOTE(scott): Heikkinen's closed form (J. Zhu, "Conversion of Earth-centered
+    // Earth-fixed coordinates to geodetic coordinates", 1994).  No iteration, so
+    // every element does the same work.  Good to well under a millimeter
+    // everywhere except within a few km of the center of the earth.
+    const real64 A = SL_WGS84_A;
+    const real64 B = SL_WGS84_B;
+    const real64 A2 = A * A;
+    const real64 B2 = B * B;
+    const real64 E2 = SL_WGS84_E2;
+    const real64 E4 = E2 * E2;
+    const real64 EP2 = (A2 - B2) / B2;
+    const real64 OneMinusE2 = 1.0 - E2;
+
+    real64 X = Ecef.X, Y = Ecef.Y, Z = Ecef.Z;
+    real64 Z2 = Z * Z;
+    real64 P2 = X * X + Y * Y;
+    real64 P = sqrt(P2);
+
+    real64 F = 54.0 * B2 * Z2;
+    real64 G = P2 + OneMinusE2 * Z2 - E2 * (A2 - B2);
+    real64 C = E4 * F * P2 / (G * G * G);
+    real64 S = cbrt(1.0 + C + sqrt(C * C + 2.0 * C));
+    real64 K = S + 1.0 + 1.0 / S;
+    real64 PP = F / (3.0 * K * K * G * G);
+    real64 Q = sqrt(1.0 + 2.0 * E4 * PP);
+    real64 R0 = -(PP * E2 * P) / (1.0 + Q) +
+        sqrt(fmax(0.0, 0.5 * A2 * (1.0 + 1.0 / Q) - PP * OneMinusE2 * Z2 / (Q * (1.0 + Q)) - 0.5 * PP * P2));
+    real64 T = P - E2 * R0;
+    real64 U = sqrt(T * T + Z2);
+    real64 V = sqrt(T * T + OneMinusE2 * Z2);
+    real64 Z0 = B2 * Z / (A * V);
+
+    vec3d Result;
+    Result.Lat = atan2(Z + EP2 * Z0, P);
+    Result.Lon = atan2(Y, X);
+    Result.Alt = U * (1.0 - B2 / (A * V));
+    return Result;
+}
+
+//
+// Geodesy batch kernels
+//
+// The SIMD paths run the same formulas as the scalar versions 2 doubles at a
+// time, with Cephes style sin/cos/atan2 and a Halley cbrt standing in for libm.
+// They agree with the scalar versions to a few ulps.  Inputs outside the range
+// those approximations are written for go through the scalar versions, as does
+// whatever doesn't fill a pair.
+//
+
+#ifdef SL_SSE2
+
+// 2 vec3d are 3 registers, (x0 y0) (z0 x1) (y1 z1)
+#define SL_LOAD_VEC3D2(Src, X, Y, Z) \
+    { \
+        real64* E_ = (real64*)(Src); \
+        __m128d A_ = _mm_loadu_pd(E_); \
+        __m128d B_ = _mm_loadu_pd(E_ + 2); \
+        __m128d C_ = _mm_loadu_pd(E_ + 4); \
+        X = _mm_shuffle_pd(A_, B_, 2); \
+        Y = _mm_shuffle_pd(A_, C_, 1); \
+        Z = _mm_shuffle_pd(B_, C_, 2); \
+    }
+
+#define SL_STORE_VEC3D2(Dest, X, Y, Z) \
+    { \
+        real64* E_ = (real64*)(Dest); \
+        _mm_storeu_pd(E_, _mm_shuffle_pd(X, Y, 0)); \
+        _mm_storeu_pd(E_ + 2, _mm_shuffle_pd(Z, X, 2)); \
+        _mm_storeu_pd(E_ + 4, _mm_shuffle_pd(Y, Z, 3)); \
+    }
+
+internal inline __m128d
+sl_select_pd(__m128d Mask, __m128d A, __m128d B)
+{
+    return _mm_or_pd(_mm_and_pd(Mask, A), _mm_andnot_pd(Mask, B));
+}
+
+// NOTE(scott): Cephes sin/cos.  The 3 part reduction by Pi/4 is exact while
+// |X| * 4/Pi fits in about 2^26, callers keep anything bigger on libm.
+internal inline void
+sl_sincos_pd(__m128d X, __m128d* Sin, __m128d* Cos)
+{
+    __m128d SignBit = _mm_set1_pd(-0.0);
+    __m128d SignX = _mm_and_pd(SignBit, X);
+    X = _mm_andnot_pd(SignBit, X);
+
+    // octant, rounded up to even so the reduced angle is within +-Pi/4
+    __m128i J = _mm_cvttpd_epi32(_mm_mul_pd(X, _mm_set1_pd(1.27323954473516268615)));
+    J = _mm_and_si128(_mm_add_epi32(J, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128d Y = _mm_cvtepi32_pd(J);
+    J = _mm_shuffle_epi32(J, _MM_SHUFFLE(1, 1, 0, 0));
+
+    __m128d Z = _mm_sub_pd(X, _mm_mul_pd(Y, _mm_set1_pd(7.85398125648498535156E-1)));
+    Z = _mm_sub_pd(Z, _mm_mul_pd(Y, _mm_set1_pd(3.77489470793079817668E-8)));
+    Z = _mm_sub_pd(Z, _mm_mul_pd(Y, _mm_set1_pd(2.69515142907905952645E-15)));
+    __m128d ZZ = _mm_mul_pd(Z, Z);
+
+    __m128d S = _mm_set1_pd(1.58962301576546568060E-10);
+    S = _mm_add_pd(_mm_mul_pd(S, ZZ), _mm_set1_pd(-2.50507477628578072866E-8));
+    S = _mm_add_pd(_mm_mul_pd(S, ZZ), _mm_set1_pd(2.75573136213857245213E-6));
+    S = _mm_add_pd(_mm_mul_pd(S, ZZ), _mm_set1_pd(-1.98412698295895385996E-4));
+    S = _mm_add_pd(_mm_mul_pd(S, ZZ), _mm_set1_pd(8.33333333332211858878E-3));
+    S = _mm_add_pd(_mm_mul_pd(S, ZZ), _mm_set1_pd(-1.66666666666666307295E-1));
+    S = _mm_add_pd(Z, _mm_mul_pd(_mm_mul_pd(Z, ZZ), S));
+
+    __m128d C = _mm_set1_pd(-1.13585365213876817300E-11);
+    C = _mm_add_pd(_mm_mul_pd(C, ZZ), _mm_set1_pd(2.08757008419747316778E-9));
+    C = _mm_add_pd(_mm_mul_pd(C, ZZ), _mm_set1_pd(-2.75573141792967388112E-7));
+    C = _mm_add_pd(_mm_mul_pd(C, ZZ), _mm_set1_pd(2.48015872888517045348E-5));
+    C = _mm_add_pd(_mm_mul_pd(C, ZZ), _mm_set1_pd(-1.38888888888730564116E-3));
+    C = _mm_add_pd(_mm_mul_pd(C, ZZ), _mm_set1_pd(4.16666666666665929218E-2));
+    C = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), ZZ)), _mm_mul_pd(_mm_mul_pd(ZZ, ZZ), C));
+
+    // octants 2 and 6 swap the polynomials, 4 and up flip sin, 2 through 5 flip cos
+    __m128d Swap = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(J, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    __m128i Four = _mm_set1_epi64x(4);
+    __m128d SinSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(J, Four), 61));
+    __m128d CosSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(_mm_add_epi32(J, _mm_set1_epi32(2)), Four), 61));
+
+    *Sin = _mm_xor_pd(sl_select_pd(Swap, C, S), _mm_xor_pd(SinSign, SignX));
+    *Cos = _mm_xor_pd(sl_select_pd(Swap, S, C), CosSign);
+}
+
+// NOTE(scott): Cephes atan on min/max of |Y| and |X|, then unfolded into the
+// right quadrant.  Both can't be infinite.
+internal inline __m128d
+sl_atan2_pd(__m128d Y, __m128d X)
+{
+    const real64 MoreBits = 6.123233995736765886130E-17;
+    __m128d SignBit = _mm_set1_pd(-0.0);
+    __m128d One = _mm_set1_pd(1.0);
+    __m128d AX = _mm_andnot_pd(SignBit, X);
+    __m128d AY = _mm_andnot_pd(SignBit, Y);
+    __m128d Swap = _mm_cmpgt_pd(AY, AX);
+    __m128d Max = _mm_max_pd(AX, AY);
+    __m128d T = _mm_div_pd(_mm_min_pd(AX, AY), Max);
+    T = _mm_andnot_pd(_mm_cmpeq_pd(Max, _mm_setzero_pd()), T);
+
+    // T is in [0, 1], above 0.66 reduce around Pi/4
+    __m128d Big = _mm_cmpgt_pd(T, _mm_set1_pd(0.66));
+    T = sl_select_pd(Big, _mm_div_pd(_mm_sub_pd(T, One), _mm_add_pd(T, One)), T);
+    __m128d Z = _mm_mul_pd(T, T);
+
+    __m128d P = _mm_set1_pd(-8.750608600031904122785E-1);
+    P = _mm_add_pd(_mm_mul_pd(P, Z), _mm_set1_pd(-1.615753718733365076637E1));
+    P = _mm_add_pd(_mm_mul_pd(P, Z), _mm_set1_pd(-7.500855792314704667340E1));
+    P = _mm_add_pd(_mm_mul_pd(P, Z), _mm_set1_pd(-1.228866684490136173410E2));
+    P = _mm_add_pd(_mm_mul_pd(P, Z), _mm_set1_pd(-6.485021904942025371773E1));
+    __m128d Q = _mm_add_pd(Z, _mm_set1_pd(2.485846490142306297962E1));
+    Q = _mm_add_pd(_mm_mul_pd(Q, Z), _mm_set1_pd(1.650270098316988542046E2));
+    Q = _mm_add_pd(_mm_mul_pd(Q, Z), _mm_set1_pd(4.328810604912902668951E2));
+    Q = _mm_add_pd(_mm_mul_pd(Q, Z), _mm_set1_pd(4.853903996359136964868E2));
+    Q = _mm_add_pd(_mm_mul_pd(Q, Z), _mm_set1_pd(1.945506571482613964425E2));
+
+    __m128d R = _mm_add_pd(T, _mm_mul_pd(T, _mm_div_pd(_mm_mul_pd(Z, P), Q)));
+    R = _mm_add_pd(R, _mm_and_pd(Big, _mm_set1_pd(0.5 * MoreBits)));
+    R = _mm_add_pd(_mm_and_pd(Big, _mm_set1_pd(SL_PI_4)), R);
+
+    // MoreBits is what the doubles for Pi/2 and Pi leave off
+    R = sl_select_pd(Swap, _mm_add_pd(_mm_sub_pd(_mm_set1_pd(SL_PI_2), R), _mm_set1_pd(MoreBits)), R);
+    R = sl_select_pd(_mm_cmplt_pd(X, _mm_setzero_pd()),
+                     _mm_add_pd(_mm_sub_pd(_mm_set1_pd(SL_PI), R), _mm_set1_pd(2.0 * MoreBits)), R);
+    return _mm_or_pd(R, _mm_and_pd(SignBit, Y));
+}
+
+// NOTE(scott): positive normal X only.  Kahan's guess from a third of the
+// exponent is good to ~5 bits, each Halley step triples that.
+internal inline __m128d
+sl_cbrt_pd(__m128d X)
+{
+    __m128i High = _mm_shuffle_epi32(_mm_castpd_si128(X), _MM_SHUFFLE(3, 1, 3, 1));
+    __m128d Third = _mm_mul_pd(_mm_cvtepi32_pd(High), _mm_set1_pd(1.0 / 3.0));
+    High = _mm_add_epi32(_mm_cvttpd_epi32(Third), _mm_set1_epi32(715094163));
+    __m128d T = _mm_castsi128_pd(_mm_unpacklo_epi32(_mm_setzero_si128(), High));
+    for (i32 Step = 0; Step < 3; Step++)
+    {
+        __m128d T3 = _mm_mul_pd(_mm_mul_pd(T, T), T);
+        T = _mm_mul_pd(T, _mm_div_pd(_mm_add_pd(T3, _mm_add_pd(X, X)), _mm_add_pd(_mm_add_pd(T3, T3), X)));
+    }
+    return T;
+}
+
+#endif // SL_SSE2
+
+void GeodeticToEcefArray(vec3d* Out, vec3d* In, i32 Count)
+{
+    SL_PROFILE_ZONE("GeodeticToEcefArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    const real64 E2 = SL_WGS84_E2;
+    __m128d SignBit = _mm_set1_pd(-0.0);
+    __m128d Limit = _mm_set1_pd(1e6);
+    __m128d One = _mm_set1_pd(1.0);
+    for (; i + 2 <= Count; i += 2)
+    {
+        __m128d Lat, Lon, Alt;
+        SL_LOAD_VEC3D2(In + i, Lat, Lon, Alt);
+        __m128d Outside = _mm_or_pd(_mm_cmpnle_pd(_mm_andnot_pd(SignBit, Lat), Limit),
+                                    _mm_cmpnle_pd(_mm_andnot_pd(SignBit, Lon), Limit));
+        if (_mm_movemask_pd(Outside))
+        {
+            Out[i] = GeodeticToEcef(In[i]);
+            Out[i + 1] = GeodeticToEcef(In[i + 1]);
+            continue;
+        }
+
+        __m128d SinLat, CosLat, SinLon, CosLon;
+        sl_sincos_pd(Lat, &SinLat, &CosLat);
+        sl_sincos_pd(Lon, &SinLon, &CosLon);
+
+        __m128d N = _mm_div_pd(_mm_set1_pd(SL_WGS84_A),
+                               _mm_sqrt_pd(_mm_sub_pd(One, _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(E2), SinLat), SinLat))));
+        __m128d NCosLat = _mm_mul_pd(_mm_add_pd(N, Alt), CosLat);
+        __m128d X = _mm_mul_pd(NCosLat, CosLon);
+        __m128d Y = _mm_mul_pd(NCosLat, SinLon);
+        __m128d Z = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(N, _mm_set1_pd(1.0 - E2)), Alt), SinLat);
+        SL_STORE_VEC3D2(Out + i, X, Y, Z);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = GeodeticToEcef(In[i]);
+    }
+}
+
+void EcefToGeodeticArray(vec3d* Out, vec3d* In, i32 Count)
+{
+    SL_PROFILE_ZONE("EcefToGeodeticArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    const real64 A = SL_WGS84_A;
+    const real64 B = SL_WGS84_B;
+    const real64 A2 = A * A;
+    const real64 B2 = B * B;
+    const real64 E2 = SL_WGS84_E2;
+    const real64 E4 = E2 * E2;
+    const real64 OneMinusE2 = 1.0 - E2;
+    __m128d One = _mm_set1_pd(1.0);
+    __m128d Half = _mm_set1_pd(0.5);
+    // NOTE(scott): within 100 km of the center the cube root can go negative,
+    // that and anything non-finite stays scalar
+    __m128d Near = _mm_set1_pd(1e10);
+    __m128d Far = _mm_set1_pd(1e30);
+    for (; i + 2 <= Count; i += 2)
+    {
+        __m128d X, Y, Z;
+        SL_LOAD_VEC3D2(In + i, X, Y, Z);
+        __m128d Z2 = _mm_mul_pd(Z, Z);
+        __m128d P2 = _mm_add_pd(_mm_mul_pd(X, X), _mm_mul_pd(Y, Y));
+        __m128d R2 = _mm_add_pd(P2, Z2);
+        if (_mm_movemask_pd(_mm_or_pd(_mm_cmplt_pd(R2, Near), _mm_cmpnle_pd(R2, Far))))
+        {
+            Out[i] = EcefToGeodetic(In[i]);
+            Out[i + 1] = EcefToGeodetic(In[i + 1]);
+            continue;
+        }
+        __m128d P = _mm_sqrt_pd(P2);
+
+        __m128d F = _mm_mul_pd(_mm_set1_pd(54.0 * B2), Z2);
+        __m128d G = _mm_sub_pd(_mm_add_pd(P2, _mm_mul_pd(_mm_set1_pd(OneMinusE2), Z2)), _mm_set1_pd(E2 * (A2 - B2)));
+        __m128d G2 = _mm_mul_pd(G, G);
+        __m128d C = _mm_div_pd(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(E4), F), P2), _mm_mul_pd(G2, G));
+        __m128d S = sl_cbrt_pd(_mm_add_pd(_mm_add_pd(One, C), _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(C, C), _mm_add_pd(C, C)))));
+        __m128d K = _mm_add_pd(_mm_add_pd(S, One), _mm_div_pd(One, S));
+        __m128d PP = _mm_div_pd(F, _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(3.0), K), K), G2));
+        __m128d Q = _mm_sqrt_pd(_mm_add_pd(One, _mm_mul_pd(_mm_set1_pd(2.0 * E4), PP)));
+        __m128d OnePlusQ = _mm_add_pd(One, Q);
+        __m128d Root = _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(_mm_set1_pd(0.5 * A2), _mm_add_pd(One, _mm_div_pd(One, Q))),
+                                             _mm_div_pd(_mm_mul_pd(_mm_mul_pd(PP, _mm_set1_pd(OneMinusE2)), Z2), _mm_mul_pd(Q, OnePlusQ))),
+                                  _mm_mul_pd(_mm_mul_pd(Half, PP), P2));
+        __m128d R0 = _mm_sub_pd(_mm_sqrt_pd(_mm_max_pd(Root, _mm_setzero_pd())),
+                                _mm_div_pd(_mm_mul_pd(_mm_mul_pd(PP, _mm_set1_pd(E2)), P), OnePlusQ));
+        __m128d T = _mm_sub_pd(P, _mm_mul_pd(_mm_set1_pd(E2), R0));
+        __m128d T2 = _mm_mul_pd(T, T);
+        __m128d U = _mm_sqrt_pd(_mm_add_pd(T2, Z2));
+        __m128d AV = _mm_mul_pd(_mm_set1_pd(A), _mm_sqrt_pd(_mm_add_pd(T2, _mm_mul_pd(_mm_set1_pd(OneMinusE2), Z2))));
+        __m128d Z0 = _mm_div_pd(_mm_mul_pd(_mm_set1_pd(B2), Z), AV);
+
+        __m128d Lat = sl_atan2_pd(_mm_add_pd(Z, _mm_mul_pd(_mm_set1_pd((A2 - B2) / B2), Z0)), P);
+        __m128d Lon = sl_atan2_pd(Y, X);
+        __m128d Alt = _mm_mul_pd(U, _mm_sub_pd(One, _mm_div_pd(_mm_set1_pd(B2), AV)));
+        SL_STORE_VEC3D2(Out + i, Lat, Lon, Alt);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = EcefToGeodetic(In[i]);
+    }
+}
+
+//
+// Quat
+//
+
+quat Quat(real32 x, real32 y, real32 z, real32 w)
+{
+    quat Result;
+    Result.x = x;
+    Result.y = y;
+    Result.z = z;
+    Result.w = w;
+    return Result;
+}
+
+quat IdentityQuat()
+{
+    return Quat(0.f, 0.f, 0.f, 1.f);
+}
+
+quat QuatFromAxisAngle(vec3f Axis, real32 Angle)
+{
+    real32 Len = sqrtf(Axis.X*Axis.X + Axis.Y*Axis.Y + Axis.Z*Axis.Z);
+    if (Len == 0.f)
+        return IdentityQuat();
+
+    real32 S = sinf(0.5f * Angle) / Len;
+    return Quat(Axis.X * S, Axis.Y * S, Axis.Z * S, cosf(0.5f * Angle));
 }
 
 quat AddQuat(quat A, quat B)
 {
     quat Result;
-    Result.x = A.x + A.x;
+    Result.x = A.x + B.x;
     Result.y = A.y + B.y;
     Result.z = A.z + B.z;
     Result.w = A.w + B.w;
@@ -1106,32 +1864,456 @@ quat AddQuat(quat A, quat B)
     return Result;
 }
 
+real32 DotQuat(quat A, quat B)
+{
+    return A.x*B.x + A.y*B.y + A.z*B.z + A.w*B.w;
+}
+
 real32 NormQuat(quat A)
 {
     real32 Result;
-    Result = A.x*A.x + A.y*A.y + A.z*A.z + A.w+A.w;
+    Result = sqrtf(DotQuat(A, A));
     return Result;
 }
 
 quat NozQuat(quat A)
 {
-    real32 Result;
+    quat Result = {0};
+
+    real32 Norm = NormQuat(A);
+    if (Norm > 0.f)
+    {
+        real32 InvNorm = 1.f / Norm;
+        Result.x = A.x * InvNorm;
+        Result.y = A.y * InvNorm;
+        Result.z = A.z * InvNorm;
+        Result.w = A.w * InvNorm;
+    }
 
     return Result;
 }
 
-quat MulQuat(quat A, quat B);
-quat InvQuat(quat A);
-quat ConjQuat(quat A);
-bool EqualsQuat(quat A, quat B);
+quat MulQuat(quat A, quat B)
+{
+    quat Result;
+    Result.x = A.w*B.x + A.x*B.w + A.y*B.z - A.z*B.y;
+    Result.y = A.w*B.y - A.x*B.z + A.y*B.w + A.z*B.x;
+    Result.z = A.w*B.z + A.x*B.y - A.y*B.x + A.z*B.w;
+    Result.w = A.w*B.w - A.x*B.x - A.y*B.y - A.z*B.z;
+    return Result;
+}
 
-#if defined(__cplusplus)
+quat ConjQuat(quat A)
+{
+    return Quat(-A.x, -A.y, -A.z, A.w);
+}
+
+quat InvQuat(quat A)
+{
+    quat Result = {0};
+
+    real32 NormSq = DotQuat(A, A);
+    if (NormSq > 0.f)
+    {
+        real32 InvNormSq = 1.f / NormSq;
+        Result.x = -A.x * InvNormSq;
+        Result.y = -A.y * InvNormSq;
+        Result.z = -A.z * InvNormSq;
+        Result.w = A.w * InvNormSq;
+    }
+
+    return Result;
+}
+
+bool EqualsQuat(quat A, quat B)
+{
+    return (A.x == B.x) && (A.y == B.y) && (A.z == B.z) && (A.w == B.w);
+}
+
+quat NlerpQuat(quat A, quat B, real32 t)
+{
+    // NOTE(scott): take the short way around
+    real32 Sign = (DotQuat(A, B) < 0.f) ? -1.f : 1.f;
+    real32 WA = 1.f - t;
+    real32 WB = t * Sign;
+
+    quat Result;
+    Result.x = WA*A.x + WB*B.x;
+    Result.y = WA*A.y + WB*B.y;
+    Result.z = WA*A.z + WB*B.z;
+    Result.w = WA*A.w + WB*B.w;
+    return NozQuat(Result);
+}
+
+internal void
+sl_slerp_weights(real32 CosTheta, real32 t, real32* WA, real32* WB)
+{
+    // NOTE(scott): CosTheta must already be positive.  Fall back to a plain
+    // lerp when the angle is too small for the sine ratio to be stable.
+    if (CosTheta > 0.9995f)
+    {
+        *WA = 1.f - t;
+        *WB = t;
+        return;
+    }
+
+    real32 Theta = acosf(CosTheta);
+    real32 InvSin = 1.f / sinf(Theta);
+    *WA = sinf((1.f - t) * Theta) * InvSin;
+    *WB = sinf(t * Theta) * InvSin;
+}
+
+quat SlerpQuat(quat A, quat B, real32 t)
+{
+    real32 CosTheta = DotQuat(A, B);
+    real32 Sign = 1.f;
+    if (CosTheta < 0.f)
+    {
+        CosTheta = -CosTheta;
+        Sign = -1.f;
+    }
+
+    real32 WA, WB;
+    sl_slerp_weights(CosTheta, t, &WA, &WB);
+    WB *= Sign;
+
+    quat Result;
+    Result.x = WA*A.x + WB*B.x;
+    Result.y = WA*A.y + WB*B.y;
+    Result.z = WA*A.z + WB*B.z;
+    Result.w = WA*A.w + WB*B.w;
+    return NozQuat(Result);
+}
+
+vec3f RotateVec3fByQuat(quat Q, vec3f V)
+{
+    // v' = v + w*t + u x t, where t = 2 * (u x v)
+    real32 tx = 2.f * (Q.y*V.Z - Q.z*V.Y);
+    real32 ty = 2.f * (Q.z*V.X - Q.x*V.Z);
+    real32 tz = 2.f * (Q.x*V.Y - Q.y*V.X);
+
+    vec3f Result;
+    Result.X = V.X + Q.w*tx + (Q.y*tz - Q.z*ty);
+    Result.Y = V.Y + Q.w*ty + (Q.z*tx - Q.x*tz);
+    Result.Z = V.Z + Q.w*tz + (Q.x*ty - Q.y*tx);
+    return Result;
+}
+
+mat4f QuatToMat4f(quat Q)
+{
+    mat4f Result;
+
+    real32 xx = Q.x*Q.x, yy = Q.y*Q.y, zz = Q.z*Q.z;
+    real32 xy = Q.x*Q.y, xz = Q.x*Q.z, yz = Q.y*Q.z;
+    real32 wx = Q.w*Q.x, wy = Q.w*Q.y, wz = Q.w*Q.z;
+
+    // NOTE(scott): column major, same as Mul()
+    Result.E[0]  = 1.f - 2.f*(yy + zz);
+    Result.E[1]  = 2.f*(xy + wz);
+    Result.E[2]  = 2.f*(xz - wy);
+    Result.E[3]  = 0.f;
+    Result.E[4]  = 2.f*(xy - wz);
+    Result.E[5]  = 1.f - 2.f*(xx + zz);
+    Result.E[6]  = 2.f*(yz + wx);
+    Result.E[7]  = 0.f;
+    Result.E[8]  = 2.f*(xz + wy);
+    Result.E[9]  = 2.f*(yz - wx);
+    Result.E[10] = 1.f - 2.f*(xx + yy);
+    Result.E[11] = 0.f;
+    Result.E[12] = Result.E[13] = Result.E[14] = 0.f;
+    Result.E[15] = 1.f;
+
+    return Result;
 }
+
+//
+// Quat batch kernels
+//
+// The SIMD paths load 4 quats, transpose them so each register holds one
+// component of all 4 (x x x x, y y y y, ...), run the scalar formula 4-wide and
+// transpose back.  Whatever doesn't fill a group of 4 goes through the scalar
+// versions above.
+//
+
+#ifdef SL_SSE2
+
+#define SL_LOAD_QUAT4(Src, X, Y, Z, W) \
+    X = _mm_loadu_ps((Src)[0].E); \
+    Y = _mm_loadu_ps((Src)[1].E); \
+    Z = _mm_loadu_ps((Src)[2].E); \
+    W = _mm_loadu_ps((Src)[3].E); \
+    _MM_TRANSPOSE4_PS(X, Y, Z, W)
+
+#define SL_STORE_QUAT4(Dest, X, Y, Z, W) \
+    _MM_TRANSPOSE4_PS(X, Y, Z, W); \
+    _mm_storeu_ps((Dest)[0].E, X); \
+    _mm_storeu_ps((Dest)[1].E, Y); \
+    _mm_storeu_ps((Dest)[2].E, Z); \
+    _mm_storeu_ps((Dest)[3].E, W)
+
+// 4 vec3f are 3 registers, (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+#define SL_LOAD_VEC3F4(Src, X, Y, Z) \
+    { \
+        real32* E_ = (real32*)(Src); \
+        __m128 A_ = _mm_loadu_ps(E_); \
+        __m128 B_ = _mm_loadu_ps(E_ + 4); \
+        __m128 C_ = _mm_loadu_ps(E_ + 8); \
+        __m128 XY_ = _mm_shuffle_ps(B_, C_, _MM_SHUFFLE(2, 1, 3, 2)); \
+        __m128 YZ_ = _mm_shuffle_ps(A_, B_, _MM_SHUFFLE(1, 0, 2, 1)); \
+        X = _mm_shuffle_ps(A_, XY_, _MM_SHUFFLE(2, 0, 3, 0)); \
+        Y = _mm_shuffle_ps(YZ_, XY_, _MM_SHUFFLE(3, 1, 2, 0)); \
+        Z = _mm_shuffle_ps(YZ_, C_, _MM_SHUFFLE(3, 0, 3, 1)); \
+    }
+
+#define SL_STORE_VEC3F4(Dest, X, Y, Z) \
+    { \
+        real32* E_ = (real32*)(Dest); \
+        __m128 XY_ = _mm_shuffle_ps(X, Y, _MM_SHUFFLE(2, 0, 2, 0)); \
+        __m128 YZ_ = _mm_shuffle_ps(Y, Z, _MM_SHUFFLE(3, 1, 3, 1)); \
+        __m128 ZX_ = _mm_shuffle_ps(Z, X, _MM_SHUFFLE(3, 1, 2, 0)); \
+        _mm_storeu_ps(E_, _mm_shuffle_ps(XY_, ZX_, _MM_SHUFFLE(2, 0, 2, 0))); \
+        _mm_storeu_ps(E_ + 4, _mm_shuffle_ps(YZ_, XY_, _MM_SHUFFLE(3, 1, 2, 0))); \
+        _mm_storeu_ps(E_ + 8, _mm_shuffle_ps(ZX_, YZ_, _MM_SHUFFLE(3, 1, 3, 1))); \
+    }
+
+internal inline void
+sl_noz_quat4(__m128* X, __m128* Y, __m128* Z, __m128* W)
+{
+    __m128 NormSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(*X, *X), _mm_mul_ps(*Y, *Y)),
+                               _mm_add_ps(_mm_mul_ps(*Z, *Z), _mm_mul_ps(*W, *W)));
+    // NOTE(scott): zero length quats come out as zero, same as NozQuat
+    __m128 Valid = _mm_cmpgt_ps(NormSq, _mm_setzero_ps());
+    __m128 InvNorm = _mm_and_ps(Valid, _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(NormSq)));
+    *X = _mm_mul_ps(*X, InvNorm);
+    *Y = _mm_mul_ps(*Y, InvNorm);
+    *Z = _mm_mul_ps(*Z, InvNorm);
+    *W = _mm_mul_ps(*W, InvNorm);
+}
+
+internal inline void
+sl_blend_quat4(__m128 WA, __m128 WB,
+               __m128 AX, __m128 AY, __m128 AZ, __m128 AW,
+               __m128* BX, __m128* BY, __m128* BZ, __m128* BW)
+{
+    *BX = _mm_add_ps(_mm_mul_ps(WA, AX), _mm_mul_ps(WB, *BX));
+    *BY = _mm_add_ps(_mm_mul_ps(WA, AY), _mm_mul_ps(WB, *BY));
+    *BZ = _mm_add_ps(_mm_mul_ps(WA, AZ), _mm_mul_ps(WB, *BZ));
+    *BW = _mm_add_ps(_mm_mul_ps(WA, AW), _mm_mul_ps(WB, *BW));
+}
+
+#endif // SL_SSE2
+
+void MulQuatArray(quat* Out, quat* A, quat* B, i32 Count)
+{
+    SL_PROFILE_ZONE("MulQuatArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 AX, AY, AZ, AW, BX, BY, BZ, BW;
+        SL_LOAD_QUAT4(A + i, AX, AY, AZ, AW);
+        SL_LOAD_QUAT4(B + i, BX, BY, BZ, BW);
+
+        __m128 X = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(AW, BX), _mm_mul_ps(AX, BW)), _mm_mul_ps(AY, BZ)), _mm_mul_ps(AZ, BY));
+        __m128 Y = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(AW, BY), _mm_mul_ps(AX, BZ)), _mm_mul_ps(AY, BW)), _mm_mul_ps(AZ, BX));
+        __m128 Z = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(AW, BZ), _mm_mul_ps(AX, BY)), _mm_mul_ps(AY, BX)), _mm_mul_ps(AZ, BW));
+        __m128 W = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(AW, BW), _mm_mul_ps(AX, BX)), _mm_mul_ps(AY, BY)), _mm_mul_ps(AZ, BZ));
+
+        SL_STORE_QUAT4(Out + i, X, Y, Z, W);
+    }
 #endif
-quat operator+(const quat& A, const quat& B);
-quat operator*(const quat& A, const quat& B);
-bool operator==(const vec2f& A, const vec2f& B);
+    for (; i < Count; i++)
+    {
+        Out[i] = MulQuat(A[i], B[i]);
+    }
+}
+
+void NozQuatArray(quat* Out, quat* A, i32 Count)
+{
+    SL_PROFILE_ZONE("NozQuatArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X, Y, Z, W;
+        SL_LOAD_QUAT4(A + i, X, Y, Z, W);
+        sl_noz_quat4(&X, &Y, &Z, &W);
+        SL_STORE_QUAT4(Out + i, X, Y, Z, W);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = NozQuat(A[i]);
+    }
+}
+
+void NlerpQuatArray(quat* Out, quat* A, quat* B, real32* t, i32 Count)
+{
+    SL_PROFILE_ZONE("NlerpQuatArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 SignBit = _mm_set1_ps(-0.f);
+    __m128 One = _mm_set1_ps(1.f);
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 AX, AY, AZ, AW, BX, BY, BZ, BW;
+        SL_LOAD_QUAT4(A + i, AX, AY, AZ, AW);
+        SL_LOAD_QUAT4(B + i, BX, BY, BZ, BW);
+
+        __m128 Dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(AX, BX), _mm_mul_ps(AY, BY)),
+                                _mm_add_ps(_mm_mul_ps(AZ, BZ), _mm_mul_ps(AW, BW)));
+        __m128 T = _mm_loadu_ps(t + i);
+        __m128 WA = _mm_sub_ps(One, T);
+        // NOTE(scott): flip B where the dot is negative to take the short way around
+        __m128 WB = _mm_xor_ps(T, _mm_and_ps(SignBit, _mm_cmplt_ps(Dot, _mm_setzero_ps())));
+
+        sl_blend_quat4(WA, WB, AX, AY, AZ, AW, &BX, &BY, &BZ, &BW);
+        sl_noz_quat4(&BX, &BY, &BZ, &BW);
+        SL_STORE_QUAT4(Out + i, BX, BY, BZ, BW);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = NlerpQuat(A[i], B[i], t[i]);
+    }
+}
+
+void SlerpQuatArray(quat* Out, quat* A, quat* B, real32* t, i32 Count)
+{
+    SL_PROFILE_ZONE("SlerpQuatArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 SignBit = _mm_set1_ps(-0.f);
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 AX, AY, AZ, AW, BX, BY, BZ, BW;
+        SL_LOAD_QUAT4(A + i, AX, AY, AZ, AW);
+        SL_LOAD_QUAT4(B + i, BX, BY, BZ, BW);
+
+        __m128 Dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(AX, BX), _mm_mul_ps(AY, BY)),
+                                _mm_add_ps(_mm_mul_ps(AZ, BZ), _mm_mul_ps(AW, BW)));
+        __m128 Flip = _mm_and_ps(SignBit, _mm_cmplt_ps(Dot, _mm_setzero_ps()));
+
+        // NOTE(scott): the trig only runs once per lane, everything else stays 4-wide
+        real32 CosTheta[4], WA[4], WB[4];
+        _mm_storeu_ps(CosTheta, _mm_andnot_ps(SignBit, Dot));
+        for (i32 Lane = 0; Lane < 4; Lane++)
+        {
+            sl_slerp_weights(CosTheta[Lane], t[i + Lane], WA + Lane, WB + Lane);
+        }
+
+        __m128 WeightB = _mm_xor_ps(_mm_loadu_ps(WB), Flip);
+        sl_blend_quat4(_mm_loadu_ps(WA), WeightB, AX, AY, AZ, AW, &BX, &BY, &BZ, &BW);
+        sl_noz_quat4(&BX, &BY, &BZ, &BW);
+        SL_STORE_QUAT4(Out + i, BX, BY, BZ, BW);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = SlerpQuat(A[i], B[i], t[i]);
+    }
+}
+
+void QuatToMat4fArray(mat4f* Out, quat* Q, i32 Count)
+{
+    SL_PROFILE_ZONE("QuatToMat4fArray");
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 One = _mm_set1_ps(1.f);
+    __m128 Two = _mm_set1_ps(2.f);
+    __m128 Zero = _mm_setzero_ps();
+    __m128 Last = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X, Y, Z, W;
+        SL_LOAD_QUAT4(Q + i, X, Y, Z, W);
+
+        __m128 xx = _mm_mul_ps(X, X), yy = _mm_mul_ps(Y, Y), zz = _mm_mul_ps(Z, Z);
+        __m128 xy = _mm_mul_ps(X, Y), xz = _mm_mul_ps(X, Z), yz = _mm_mul_ps(Y, Z);
+        __m128 wx = _mm_mul_ps(W, X), wy = _mm_mul_ps(W, Y), wz = _mm_mul_ps(W, Z);
+
+        // NOTE(scott): each register is one matrix entry of all 4 quats, so a
+        // column's 3 entries plus a zero transpose into that column of all 4
+        __m128 C0 = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(yy, zz)));
+        __m128 C1 = _mm_mul_ps(Two, _mm_add_ps(xy, wz));
+        __m128 C2 = _mm_mul_ps(Two, _mm_sub_ps(xz, wy));
+        __m128 C3 = Zero;
+        _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+        _mm_storeu_ps(Out[i + 0].E + 0, C0);
+        _mm_storeu_ps(Out[i + 1].E + 0, C1);
+        _mm_storeu_ps(Out[i + 2].E + 0, C2);
+        _mm_storeu_ps(Out[i + 3].E + 0, C3);
+
+        C0 = _mm_mul_ps(Two, _mm_sub_ps(xy, wz));
+        C1 = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(xx, zz)));
+        C2 = _mm_mul_ps(Two, _mm_add_ps(yz, wx));
+        C3 = Zero;
+        _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+        _mm_storeu_ps(Out[i + 0].E + 4, C0);
+        _mm_storeu_ps(Out[i + 1].E + 4, C1);
+        _mm_storeu_ps(Out[i + 2].E + 4, C2);
+        _mm_storeu_ps(Out[i + 3].E + 4, C3);
+
+        C0 = _mm_mul_ps(Two, _mm_add_ps(xz, wy));
+        C1 = _mm_mul_ps(Two, _mm_sub_ps(yz, wx));
+        C2 = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(xx, yy)));
+        C3 = Zero;
+        _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+        _mm_storeu_ps(Out[i + 0].E + 8, C0);
+        _mm_storeu_ps(Out[i + 1].E + 8, C1);
+        _mm_storeu_ps(Out[i + 2].E + 8, C2);
+        _mm_storeu_ps(Out[i + 3].E + 8, C3);
+
+        _mm_storeu_ps(Out[i + 0].E + 12, Last);
+        _mm_storeu_ps(Out[i + 1].E + 12, Last);
+        _mm_storeu_ps(Out[i + 2].E + 12, Last);
+        _mm_storeu_ps(Out[i + 3].E + 12, Last);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = QuatToMat4f(Q[i]);
+    }
+}
+
+void RotateVec3fArrayByQuat(vec3f* Out, vec3f* V, i32 Count, quat Q)
+{
+    SL_PROFILE_ZONE("RotateVec3fArrayByQuat");
+    // NOTE(scott): build the 3x3 once, then it's 9 multiply-adds per vector
+    mat4f M = QuatToMat4f(Q);
+    real32 m0 = M.E[0], m1 = M.E[1], m2  = M.E[2];
+    real32 m4 = M.E[4], m5 = M.E[5], m6  = M.E[6];
+    real32 m8 = M.E[8], m9 = M.E[9], m10 = M.E[10];
+
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 M0 = _mm_set1_ps(m0), M1 = _mm_set1_ps(m1), M2  = _mm_set1_ps(m2);
+    __m128 M4 = _mm_set1_ps(m4), M5 = _mm_set1_ps(m5), M6  = _mm_set1_ps(m6);
+    __m128 M8 = _mm_set1_ps(m8), M9 = _mm_set1_ps(m9), M10 = _mm_set1_ps(m10);
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X, Y, Z;
+        SL_LOAD_VEC3F4(V + i, X, Y, Z);
+        __m128 RX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(M0, X), _mm_mul_ps(M4, Y)), _mm_mul_ps(M8, Z));
+        __m128 RY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(M1, X), _mm_mul_ps(M5, Y)), _mm_mul_ps(M9, Z));
+        __m128 RZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(M2, X), _mm_mul_ps(M6, Y)), _mm_mul_ps(M10, Z));
+        SL_STORE_VEC3F4(Out + i, RX, RY, RZ);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        real32 X = V[i].X, Y = V[i].Y, Z = V[i].Z;
+        Out[i].X = m0*X + m4*Y + m8*Z;
+        Out[i].Y = m1*X + m5*Y + m9*Z;
+        Out[i].Z = m2*X + m6*Y + m10*Z;
+    }
+}
+
 #if defined(__cplusplus)
+}
+quat operator+(const quat& A, const quat& B) { return AddQuat(A, B); }
+quat operator*(const quat& A, const quat& B) { return MulQuat(A, B); }
+bool operator==(const quat& A, const quat& B) { return EqualsQuat(A, B); }
 extern "C" {
 #endif
 
@@ -0,0 +1,375 @@
+#ifndef SL_BITS_H
+#define SL_BITS_H
+
+//
+// Bit arrays
+//
+// One bit per flag instead of a bool32, for per-element flags (visible, dirty,
+// selected) on big arrays.  The words live in a dyn_array of 64-bit words so
+// they grow the same way (and through the same da_alloc hooks) as everything
+// else.
+//
+//     sl_bits Visible = {0};
+//     sl_bits_resize(&Visible, da_len(Objects));
+//     sl_bits_set(&Visible, 10);
+//
+//     for (int i = sl_bits_next_set(&Visible, 0); i >= 0; i = sl_bits_next_set(&Visible, i + 1))
+//         Draw(Objects + i);
+//
+// sl_bits_and/or/xor/andnot() combine whole arrays with SSE2 or AVX2 (picked at
+// run time, see sl_cpu.h), sl_bits_count() uses popcnt when the CPU has it, and
+// sl_bits_compact() squeezes an array down to the elements whose bit is set:
+//
+//     sl_bits_compact_da(Objects, &Visible);     // Objects keeps the visible ones
+//
+// Bits past Count in the last word are always zero, every function keeps it
+// that way.
+//
+// C compatible.  Define SL_BITS_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h and sl_cpu.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+#include "sl_cpu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_bits
+{
+    unsigned long long* Words;  // dyn_array
+    int Count;
+} sl_bits;
+
+#define sl_bits_get(Bits, Index)    (((Bits)->Words[(Index) >> 6] >> ((Index) & 63)) & 1)
+#define sl_bits_set(Bits, Index)    ((Bits)->Words[(Index) >> 6] |= 1ull << ((Index) & 63))
+#define sl_bits_clear(Bits, Index)  ((Bits)->Words[(Index) >> 6] &= ~(1ull << ((Index) & 63)))
+#define sl_bits_toggle(Bits, Index) ((Bits)->Words[(Index) >> 6] ^= 1ull << ((Index) & 63))
+#define sl_bits_assign(Bits, Index, Value) \
+    ((Value) ? sl_bits_set(Bits, Index) : sl_bits_clear(Bits, Index))
+
+// new bits start clear
+void sl_bits_resize(sl_bits* Bits, int Count);
+void sl_bits_push(sl_bits* Bits, int Value);
+void sl_bits_free(sl_bits* Bits);
+
+void sl_bits_set_all(sl_bits* Bits);
+void sl_bits_clear_all(sl_bits* Bits);
+
+// Result = A op B, A and B the same size, Result may be either of them
+void sl_bits_and(sl_bits* Result, const sl_bits* A, const sl_bits* B);
+void sl_bits_or(sl_bits* Result, const sl_bits* A, const sl_bits* B);
+void sl_bits_xor(sl_bits* Result, const sl_bits* A, const sl_bits* B);
+void sl_bits_andnot(sl_bits* Result, const sl_bits* A, const sl_bits* B);   // A & ~B
+
+int sl_bits_count(const sl_bits* Bits);
+
+// first set (clear) bit at or after From, -1 when there isn't one
+int sl_bits_next_set(const sl_bits* Bits, int From);
+int sl_bits_next_clear(const sl_bits* Bits, int From);
+
+// keeps the elements of Array whose bit is set, in order, returns how many
+int sl_bits_compact(void* Array, int Stride, const sl_bits* Mask);
+
+#define sl_bits_compact_da(List, Mask) \
+    do { if (List) _da_hdr(List) = sl_bits_compact((List), (int)sizeof(*(List)), (Mask)); } while (0)
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_BITS_IMPL
+
+#include <string.h>
+#include <assert.h>
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define sl_bits_word_count(Count) (((Count) + 63) >> 6)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static int sl_bits_ctz(unsigned long long x) { unsigned long i; _BitScanForward64(&i, x); return (int)i; }
+#else
+#define sl_bits_ctz(x) __builtin_ctzll(x)
+#endif
+
+// NOTE(scott): zeroes the bits past Count so the counting and searching never
+// have to mask
+static void
+sl_bits_trim(sl_bits* Bits)
+{
+    if (Bits->Count & 63)
+        Bits->Words[Bits->Count >> 6] &= (1ull << (Bits->Count & 63)) - 1;
+}
+
+void sl_bits_resize(sl_bits* Bits, int Count)
+{
+    int Old = da_len(Bits->Words);
+    int Words = sl_bits_word_count(Count);
+    if (Words > da_cap(Bits->Words))
+        Bits->Words = (unsigned long long*)_da_resize(Bits->Words, sizeof(unsigned long long), (size_t)Words);
+    if (Words > Old)
+        memset(Bits->Words + Old, 0, sizeof(unsigned long long) * (size_t)(Words - Old));
+    if (Bits->Words)
+        _da_hdr(Bits->Words) = Words;
+
+    Bits->Count = Count;
+    if (Words)
+        sl_bits_trim(Bits);
+}
+
+void sl_bits_push(sl_bits* Bits, int Value)
+{
+    int Index = Bits->Count;
+    if ((Index & 63) == 0)
+    {
+        unsigned long long Zero = 0;
+        da_append(Bits->Words, Zero);
+    }
+    Bits->Count++;
+    if (Value)
+        sl_bits_set(Bits, Index);
+}
+
+void sl_bits_free(sl_bits* Bits)
+{
+    da_delete(Bits->Words);
+    Bits->Words = NULL;
+    Bits->Count = 0;
+}
+
+void sl_bits_set_all(sl_bits* Bits)
+{
+    memset(Bits->Words, 0xff, sizeof(unsigned long long) * (size_t)da_len(Bits->Words));
+    if (Bits->Count)
+        sl_bits_trim(Bits);
+}
+
+void sl_bits_clear_all(sl_bits* Bits)
+{
+    memset(Bits->Words, 0, sizeof(unsigned long long) * (size_t)da_len(Bits->Words));
+}
+
+//
+// Set operations
+//
+
+enum { SL_BITS_AND, SL_BITS_OR, SL_BITS_XOR, SL_BITS_ANDNOT };
+
+static void
+sl_bits_op_scalar(unsigned long long* R, const unsigned long long* A, const unsigned long long* B, int Words, int Op)
+{
+    switch (Op)
+    {
+        case SL_BITS_AND:    for (int i = 0; i < Words; i++) R[i] = A[i] & B[i]; break;
+        case SL_BITS_OR:     for (int i = 0; i < Words; i++) R[i] = A[i] | B[i]; break;
+        case SL_BITS_XOR:    for (int i = 0; i < Words; i++) R[i] = A[i] ^ B[i]; break;
+        case SL_BITS_ANDNOT: for (int i = 0; i < Words; i++) R[i] = A[i] & ~B[i]; break;
+    }
+}
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+
+SL_TARGET("sse2") static void
+sl_bits_op_sse2(unsigned long long* R, const unsigned long long* A, const unsigned long long* B, int Words, int Op)
+{
+    int i = 0;
+    for (; i + 2 <= Words; i += 2)
+    {
+        __m128i X = _mm_loadu_si128((const __m128i*)(A + i));
+        __m128i Y = _mm_loadu_si128((const __m128i*)(B + i));
+        __m128i Z;
+        switch (Op)
+        {
+            case SL_BITS_AND: Z = _mm_and_si128(X, Y); break;
+            case SL_BITS_OR:  Z = _mm_or_si128(X, Y); break;
+            case SL_BITS_XOR: Z = _mm_xor_si128(X, Y); break;
+            default:          Z = _mm_andnot_si128(Y, X); break;
+        }
+        _mm_storeu_si128((__m128i*)(R + i), Z);
+    }
+    sl_bits_op_scalar(R + i, A + i, B + i, Words - i, Op);
+}
+
+SL_TARGET("avx2") static void
+sl_bits_op_avx2(unsigned long long* R, const unsigned long long* A, const unsigned long long* B, int Words, int Op)
+{
+    int i = 0;
+    for (; i + 4 <= Words; i += 4)
+    {
+        __m256i X = _mm256_loadu_si256((const __m256i*)(A + i));
+        __m256i Y = _mm256_loadu_si256((const __m256i*)(B + i));
+        __m256i Z;
+        switch (Op)
+        {
+            case SL_BITS_AND: Z = _mm256_and_si256(X, Y); break;
+            case SL_BITS_OR:  Z = _mm256_or_si256(X, Y); break;
+            case SL_BITS_XOR: Z = _mm256_xor_si256(X, Y); break;
+            default:          Z = _mm256_andnot_si256(Y, X); break;
+        }
+        _mm256_storeu_si256((__m256i*)(R + i), Z);
+    }
+    sl_bits_op_scalar(R + i, A + i, B + i, Words - i, Op);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+SL_TARGET("popcnt") static int
+sl_bits_count_popcnt(const unsigned long long* Words, int Count)
+{
+    // NOTE(scott): four accumulators, popcnt has a false dependency on its
+    // output register on a lot of Intel parts
+    long long C0 = 0, C1 = 0, C2 = 0, C3 = 0;
+    int i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        C0 += _mm_popcnt_u64(Words[i]);
+        C1 += _mm_popcnt_u64(Words[i + 1]);
+        C2 += _mm_popcnt_u64(Words[i + 2]);
+        C3 += _mm_popcnt_u64(Words[i + 3]);
+    }
+    for (; i < Count; i++)
+        C0 += _mm_popcnt_u64(Words[i]);
+    return (int)(C0 + C1 + C2 + C3);
+}
+#endif
+
+#endif
+
+static void
+sl_bits_op(sl_bits* Result, const sl_bits* A, const sl_bits* B, int Op)
+{
+    assert(A->Count == B->Count);
+    if (Result != A && Result != B)
+        sl_bits_resize(Result, A->Count);
+
+    int Words = sl_bits_word_count(A->Count);
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    unsigned int Features = sl_cpu_features();
+    if (Features & SL_CPU_AVX2)
+        sl_bits_op_avx2(Result->Words, A->Words, B->Words, Words, Op);
+    else if (Features & SL_CPU_SSE2)
+        sl_bits_op_sse2(Result->Words, A->Words, B->Words, Words, Op);
+    else
+#endif
+        sl_bits_op_scalar(Result->Words, A->Words, B->Words, Words, Op);
+}
+
+void sl_bits_and(sl_bits* Result, const sl_bits* A, const sl_bits* B) { sl_bits_op(Result, A, B, SL_BITS_AND); }
+void sl_bits_or(sl_bits* Result, const sl_bits* A, const sl_bits* B) { sl_bits_op(Result, A, B, SL_BITS_OR); }
+void sl_bits_xor(sl_bits* Result, const sl_bits* A, const sl_bits* B) { sl_bits_op(Result, A, B, SL_BITS_XOR); }
+void sl_bits_andnot(sl_bits* Result, const sl_bits* A, const sl_bits* B) { sl_bits_op(Result, A, B, SL_BITS_ANDNOT); }
+
+//
+// Queries
+//
+
+static int
+sl_bits_popcount_scalar(unsigned long long x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+}
+
+int sl_bits_count(const sl_bits* Bits)
+{
+    int Words = sl_bits_word_count(Bits->Count);
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    if (sl_cpu_features() & SL_CPU_POPCNT)
+        return sl_bits_count_popcnt(Bits->Words, Words);
+#endif
+    int Result = 0;
+    for (int i = 0; i < Words; i++)
+        Result += sl_bits_popcount_scalar(Bits->Words[i]);
+    return Result;
+}
+
+int sl_bits_next_set(const sl_bits* Bits, int From)
+{
+    if (From >= Bits->Count)
+        return -1;
+
+    int Words = sl_bits_word_count(Bits->Count);
+    int i = From >> 6;
+    unsigned long long Word = Bits->Words[i] & (~0ull << (From & 63));
+    while (!Word)
+    {
+        if (++i == Words)
+            return -1;
+        Word = Bits->Words[i];
+    }
+    return (i << 6) + sl_bits_ctz(Word);
+}
+
+int sl_bits_next_clear(const sl_bits* Bits, int From)
+{
+    if (From >= Bits->Count)
+        return -1;
+
+    int Words = sl_bits_word_count(Bits->Count);
+    int i = From >> 6;
+    unsigned long long Word = ~Bits->Words[i] & (~0ull << (From & 63));
+    while (!Word)
+    {
+        if (++i == Words)
+            return -1;
+        Word = ~Bits->Words[i];
+    }
+    int Result = (i << 6) + sl_bits_ctz(Word);
+    return Result < Bits->Count ? Result : -1;
+}
+
+int sl_bits_compact(void* Array, int Stride, const sl_bits* Mask)
+{
+    char* Base = (char*)Array;
+    size_t Size = (size_t)Stride;
+    int Words = sl_bits_word_count(Mask->Count);
+    int Kept = 0;
+
+    for (int w = 0; w < Words; w++)
+    {
+        unsigned long long Word = Mask->Words[w];
+        int First = w << 6;
+
+        // NOTE(scott): whole words of ones move as one block, and nothing moves
+        // at all until the first hole
+        if (Word == ~0ull)
+        {
+            if (Kept != First)
+                memmove(Base + (size_t)Kept * Size, Base + (size_t)First * Size, Size * 64);
+            Kept += 64;
+            continue;
+        }
+
+        while (Word)
+        {
+            int i = First + sl_bits_ctz(Word);
+            if (Kept != i)
+                memcpy(Base + (size_t)Kept * Size, Base + (size_t)i * Size, Size);
+            Kept++;
+            Word &= Word - 1;
+        }
+    }
+    return Kept;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_BITS_IMPL
+
+#endif // SL_BITS_H
@@ -0,0 +1,385 @@
+#ifndef SL_BLOB_H
+#define SL_BLOB_H
+
+//
+// Binary dyn_array files
+//
+// Saves a dyn_array as a small header followed by the raw elements, so passing
+// a big array of vec3f/mat4f between tools doesn't go through Vec3fToString()
+// and back through ParseVec3f().
+//
+//     if (sl_blob_write_da("points.bin", Points, SL_BLOB_VEC3F) != SL_BLOB_OK)
+//         ...
+//
+// The header records a type tag, the element count, size and alignment, the
+// byte order and an XXH64 checksum of the payload.  Reading checks the tag, size
+// and alignment against what the caller expects.  The payload is written with
+// one fwrite so big arrays go straight from the array to the file.
+//
+// Reading maps the file and hands back a dyn_array that points into the
+// mapping, no copying or parsing:
+//
+//     sl_blob_view View;
+//     if (sl_blob_map_da("points.bin", Points, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_OK)
+//     {
+//         for (int i = 0; i < da_len(Points); i++)
+//             ...
+//         sl_blob_unmap(&View);
+//     }
+//
+// The mapping is copy on write so elements can be changed in place, but the
+// array can't grow or be passed to da_delete(); use sl_blob_read_da() for an
+// ordinary heap copy.  Pass SL_BLOB_VERIFY to check the checksum, which costs
+// a pass over the data.
+//
+// Files are written in native byte order and rejected on a machine with the
+// other order rather than swapped.
+//
+// C compatible.  Define SL_BLOB_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h and sl_hash.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+#include "sl_hash.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+#define SL_BLOB_ALIGNOF(x) __alignof(x)
+#else
+#define SL_BLOB_ALIGNOF(x) __alignof__(x)
+#endif
+
+// type tags, checked on read so a vec3f file isn't loaded as vec4f
+enum
+{
+    SL_BLOB_RAW = 0,
+    SL_BLOB_U8,
+    SL_BLOB_I32,
+    SL_BLOB_U32,
+    SL_BLOB_F32,
+    SL_BLOB_F64,
+    SL_BLOB_VEC2F,
+    SL_BLOB_VEC3F,
+    SL_BLOB_VEC4F,
+    SL_BLOB_QUAT,
+    SL_BLOB_MAT4F,
+    SL_BLOB_USER = 1024,    // your own types from here up
+};
+
+typedef enum sl_blob_result
+{
+    SL_BLOB_OK = 0,
+    SL_BLOB_ERROR_IO,
+    SL_BLOB_ERROR_FORMAT,
+    SL_BLOB_ERROR_ENDIAN,
+    SL_BLOB_ERROR_TYPE,
+    SL_BLOB_ERROR_TRUNCATED,
+    SL_BLOB_ERROR_CHECKSUM,
+} sl_blob_result;
+
+enum
+{
+    SL_BLOB_VERIFY = 1 << 0,
+};
+
+#define SL_BLOB_MAGIC 0x41444C53u   // "SLDA"
+#define SL_BLOB_VERSION 1
+#define SL_BLOB_HEADER_SIZE 64
+
+// NOTE(scott): 64 bytes so the payload starts cache line (and mat4f) aligned in
+// a page aligned mapping.  Length and Capacity sit right before the payload in
+// the same spot dyn_array keeps its header, which is what makes the view work.
+typedef struct sl_blob_header
+{
+    unsigned int Magic;
+    unsigned short Version;
+    unsigned char LittleEndian;
+    unsigned char Unused0;
+    unsigned int Type;
+    unsigned int ElementSize;
+    unsigned int Alignment;
+    unsigned int Unused1;
+    unsigned long long Count;
+    unsigned long long Checksum;
+    unsigned char Reserved[16];
+    int Length;
+    int Capacity;
+} sl_blob_header;
+
+typedef struct sl_blob_view
+{
+    void* Array;        // dyn_array view of the payload
+    void* Base;
+    size_t Size;
+} sl_blob_view;
+
+sl_blob_result sl_blob_write(const char* Path, const void* Array, int Count, int ElementSize, int Alignment, unsigned int Type);
+sl_blob_result sl_blob_map(const char* Path, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, sl_blob_view* View);
+void sl_blob_unmap(sl_blob_view* View);
+
+// reads into a new heap dyn_array, free it with da_delete()
+sl_blob_result sl_blob_read(const char* Path, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, void** Array);
+
+const char* sl_blob_error_string(sl_blob_result Result);
+
+#define sl_blob_write_da(Path, List, Type) \
+    sl_blob_write((Path), (List), da_len(List), (int)sizeof(*(List)), (int)SL_BLOB_ALIGNOF(*(List)), (Type))
+
+#define sl_blob_map_da(Path, List, Type, Flags, View) \
+    sl_blob_map_typed_((Path), (void**)&(List), (Type), (int)sizeof(*(List)), (int)SL_BLOB_ALIGNOF(*(List)), (Flags), (View))
+
+#define sl_blob_read_da(Path, List, Type, Flags) \
+    sl_blob_read((Path), (Type), (int)sizeof(*(List)), (int)SL_BLOB_ALIGNOF(*(List)), (Flags), (void**)&(List))
+
+sl_blob_result sl_blob_map_typed_(const char* Path, void** List, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, sl_blob_view* View);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_BLOB_IMPL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+static int
+sl_blob_little_endian(void)
+{
+    unsigned int One = 1;
+    return *(unsigned char*)&One == 1;
+}
+
+sl_blob_result sl_blob_write(const char* Path, const void* Array, int Count, int ElementSize, int Alignment, unsigned int Type)
+{
+    size_t PayloadSize = (size_t)Count * (size_t)ElementSize;
+
+    sl_blob_header Header;
+    memset(&Header, 0, sizeof(Header));
+    Header.Magic = SL_BLOB_MAGIC;
+    Header.Version = SL_BLOB_VERSION;
+    Header.LittleEndian = (unsigned char)sl_blob_little_endian();
+    Header.Type = Type;
+    Header.ElementSize = (unsigned int)ElementSize;
+    Header.Alignment = (unsigned int)Alignment;
+    Header.Count = (unsigned long long)Count;
+    Header.Checksum = sl_hash64(Array, PayloadSize, 0);
+    Header.Length = Count;
+    Header.Capacity = Count;
+
+    FILE* File = fopen(Path, "wb");
+    if (!File)
+        return SL_BLOB_ERROR_IO;
+
+    int Ok = fwrite(&Header, sizeof(Header), 1, File) == 1;
+    if (Ok && PayloadSize)
+        Ok = fwrite(Array, PayloadSize, 1, File) == 1;
+    if (fclose(File) != 0)
+        Ok = 0;
+
+    return Ok ? SL_BLOB_OK : SL_BLOB_ERROR_IO;
+}
+
+static sl_blob_result
+sl_blob_check(const sl_blob_header* Header, size_t FileSize, unsigned int Type, int ElementSize, int Alignment)
+{
+    if (FileSize < sizeof(sl_blob_header) || Header->Magic != SL_BLOB_MAGIC || Header->Version != SL_BLOB_VERSION)
+        return SL_BLOB_ERROR_FORMAT;
+    if (Header->LittleEndian != sl_blob_little_endian())
+        return SL_BLOB_ERROR_ENDIAN;
+    if (Header->Type != Type || Header->ElementSize != (unsigned int)ElementSize ||
+        Header->Alignment != (unsigned int)Alignment)
+        return SL_BLOB_ERROR_TYPE;
+    if (Header->Count > 0x7fffffff || (unsigned long long)Header->Length != Header->Count)
+        return SL_BLOB_ERROR_FORMAT;
+    if (Header->Count * Header->ElementSize > FileSize - sizeof(sl_blob_header))
+        return SL_BLOB_ERROR_TRUNCATED;
+    return SL_BLOB_OK;
+}
+
+sl_blob_result sl_blob_map(const char* Path, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, sl_blob_view* View)
+{
+    memset(View, 0, sizeof(*View));
+
+#if defined(_WIN32)
+    HANDLE File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (File == INVALID_HANDLE_VALUE)
+        return SL_BLOB_ERROR_IO;
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart < (LONGLONG)sizeof(sl_blob_header))
+    {
+        CloseHandle(File);
+        return SL_BLOB_ERROR_FORMAT;
+    }
+
+    HANDLE Mapping = CreateFileMappingA(File, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(File);
+    if (!Mapping)
+        return SL_BLOB_ERROR_IO;
+
+    void* Base = MapViewOfFile(Mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(Mapping);
+    if (!Base)
+        return SL_BLOB_ERROR_IO;
+    size_t Size = (size_t)FileSize.QuadPart;
+#else
+    int File = open(Path, O_RDONLY);
+    if (File < 0)
+        return SL_BLOB_ERROR_IO;
+
+    struct stat Stat;
+    if (fstat(File, &Stat) != 0 || Stat.st_size < (off_t)sizeof(sl_blob_header))
+    {
+        close(File);
+        return SL_BLOB_ERROR_FORMAT;
+    }
+
+    size_t Size = (size_t)Stat.st_size;
+    void* Base = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, File, 0);
+    close(File);
+    if (Base == MAP_FAILED)
+        return SL_BLOB_ERROR_IO;
+#endif
+
+    View->Base = Base;
+    View->Size = Size;
+
+    sl_blob_header* Header = (sl_blob_header*)Base;
+    sl_blob_result Result = sl_blob_check(Header, Size, Type, ElementSize, Alignment);
+    if (Result == SL_BLOB_OK && (Flags & SL_BLOB_VERIFY))
+    {
+        if (sl_hash64(Header + 1, Header->Count * Header->ElementSize, 0) != Header->Checksum)
+            Result = SL_BLOB_ERROR_CHECKSUM;
+    }
+
+    if (Result != SL_BLOB_OK)
+    {
+        sl_blob_unmap(View);
+        return Result;
+    }
+
+    // NOTE(scott): an empty array is NULL everywhere else, keep it that way
+    View->Array = Header->Count ? (void*)(Header + 1) : NULL;
+    return SL_BLOB_OK;
+}
+
+sl_blob_result sl_blob_map_typed_(const char* Path, void** List, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, sl_blob_view* View)
+{
+    sl_blob_result Result = sl_blob_map(Path, Type, ElementSize, Alignment, Flags, View);
+    *List = View->Array;
+    return Result;
+}
+
+void sl_blob_unmap(sl_blob_view* View)
+{
+    if (View->Base)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(View->Base);
+#else
+        munmap(View->Base, View->Size);
+#endif
+    }
+    memset(View, 0, sizeof(*View));
+}
+
+sl_blob_result sl_blob_read(const char* Path, unsigned int Type, int ElementSize, int Alignment, unsigned int Flags, void** Array)
+{
+    *Array = NULL;
+
+    FILE* File = fopen(Path, "rb");
+    if (!File)
+        return SL_BLOB_ERROR_IO;
+
+    // NOTE(scott): not ftell, a long is 32 bits on Windows
+#if defined(_WIN32)
+    _fseeki64(File, 0, SEEK_END);
+    long long FileSize = _ftelli64(File);
+    _fseeki64(File, 0, SEEK_SET);
+#else
+    struct stat Stat;
+    long long FileSize = stat(Path, &Stat) == 0 ? (long long)Stat.st_size : -1;
+#endif
+
+    sl_blob_header Header;
+    if (FileSize < (long long)sizeof(Header) || fread(&Header, sizeof(Header), 1, File) != 1)
+    {
+        fclose(File);
+        return SL_BLOB_ERROR_FORMAT;
+    }
+
+    sl_blob_result Result = sl_blob_check(&Header, (size_t)FileSize, Type, ElementSize, Alignment);
+    if (Result != SL_BLOB_OK || !Header.Count)
+    {
+        fclose(File);
+        return Result;
+    }
+
+    // straight into the dyn_array's storage with one read
+    size_t PayloadSize = Header.Count * Header.ElementSize;
+    void* List = _da_resize(NULL, (size_t)ElementSize, (size_t)Header.Count);
+    int Ok = fread(List, PayloadSize, 1, File) == 1;
+    fclose(File);
+
+    if (!Ok)
+        Result = SL_BLOB_ERROR_IO;
+    else if ((Flags & SL_BLOB_VERIFY) && sl_hash64(List, PayloadSize, 0) != Header.Checksum)
+        Result = SL_BLOB_ERROR_CHECKSUM;
+
+    if (Result != SL_BLOB_OK)
+    {
+        da_delete(List);
+        return Result;
+    }
+
+    _da_hdr(List) = (int)Header.Count;
+    *Array = List;
+    return SL_BLOB_OK;
+}
+
+const char* sl_blob_error_string(sl_blob_result Result)
+{
+    switch (Result)
+    {
+        case SL_BLOB_OK: return "ok";
+        case SL_BLOB_ERROR_IO: return "couldn't read or write the file";
+        case SL_BLOB_ERROR_FORMAT: return "not a blob file";
+        case SL_BLOB_ERROR_ENDIAN: return "written with the other byte order";
+        case SL_BLOB_ERROR_TYPE: return "element type or size doesn't match";
+        case SL_BLOB_ERROR_TRUNCATED: return "file is shorter than its header says";
+        case SL_BLOB_ERROR_CHECKSUM: return "checksum mismatch";
+    }
+    return "unknown error";
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_BLOB_IMPL
+
+#endif // SL_BLOB_H
@@ -0,0 +1,531 @@
+#ifndef SL_BOUNDS_H
+#define SL_BOUNDS_H
+
+//
+// Bounding volumes and culling
+//
+// AABBs (2D and 3D), bounding spheres and view frustums, plus batch kernels that
+// test whole arrays of volumes and append the indices of the ones that pass to a
+// dyn_array.  The batch kernels come in AoS flavors (arrays of aabb3f /
+// sphere3f) and SoA flavors (one array per component) and run 4 at a time when
+// SL_SSE2 is defined.
+//
+// Culling is conservative: a volume is kept unless it's completely outside one
+// of the frustum planes, so a few volumes near the corners of the frustum can
+// come back as visible when they aren't.
+//
+// Usage:
+//     sl_frustum Frustum = sl_frustum_from_mat4f(ViewProjection);
+//
+//     i32* Visible = NULL;   // dyn_array
+//     sl_cull_spheres(&Frustum, Spheres, da_len(Spheres), &Visible);
+//     for (i32 i = 0; i < da_len(Visible); i++)
+//         Draw(Objects[Visible[i]]);
+//     da_clear(Visible);
+//
+// Define SL_BOUNDS_IMPL in one file before including this to get the
+// implementation.  Needs sl.h and dyn_array.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct aabb2f
+{
+    vec2f Min;
+    vec2f Max;
+} aabb2f;
+
+typedef struct aabb3f
+{
+    vec3f Min;
+    vec3f Max;
+} aabb3f;
+
+typedef struct sphere3f
+{
+    vec3f Center;
+    real32 Radius;
+} sphere3f;
+
+// NOTE(scott): planes are stored as (Normal, D) with the normal pointing into the
+// frustum, so a point P is inside when Normal.P + D >= 0
+typedef struct sl_frustum
+{
+    vec4f Planes[6];    // left, right, bottom, top, near, far
+} sl_frustum;
+
+aabb3f Aabb3f(vec3f Min, vec3f Max);
+aabb2f Aabb2f(vec2f Min, vec2f Max);
+
+// smallest box around the points, an inverted (empty) box when Count is 0
+aabb3f Aabb3fFromPoints(vec3f* Points, i32 Count);
+aabb3f UnionAabb3f(aabb3f A, aabb3f B);
+bool OverlapsAabb3f(aabb3f A, aabb3f B);
+bool OverlapsAabb2f(aabb2f A, aabb2f B);
+bool ContainsPointAabb3f(aabb3f A, vec3f P);
+sphere3f SphereFromAabb3f(aabb3f A);
+
+// Gribb/Hartmann extraction from a column major (OpenGL style, -1..1 clip z)
+// projection or view-projection matrix.  The planes come back normalized.
+sl_frustum sl_frustum_from_mat4f(mat4f M);
+
+bool sl_frustum_test_point(sl_frustum* Frustum, vec3f P);
+bool sl_frustum_test_sphere(sl_frustum* Frustum, sphere3f S);
+bool sl_frustum_test_aabb(sl_frustum* Frustum, aabb3f A);
+
+//
+// Batch kernels
+//
+// Each of these appends the index of every volume that passes to the dyn_array
+// *Out, in increasing order.  *Out is not cleared first.
+//
+
+void sl_cull_spheres(sl_frustum* Frustum, sphere3f* Spheres, i32 Count, i32** Out);
+void sl_cull_spheres_soa(sl_frustum* Frustum, real32* X, real32* Y, real32* Z, real32* Radius,
+                         i32 Count, i32** Out);
+
+void sl_cull_aabbs(sl_frustum* Frustum, aabb3f* Boxes, i32 Count, i32** Out);
+void sl_cull_aabbs_soa(sl_frustum* Frustum,
+                       real32* MinX, real32* MinY, real32* MinZ,
+                       real32* MaxX, real32* MaxY, real32* MaxZ,
+                       i32 Count, i32** Out);
+
+// range filters, keeps everything overlapping Range
+void sl_cull_aabbs_by_aabb(aabb3f Range, aabb3f* Boxes, i32 Count, i32** Out);
+void sl_cull_aabb2fs(aabb2f Range, aabb2f* Boxes, i32 Count, i32** Out);
+void sl_cull_points2f(aabb2f Range, vec2f* Points, i32 Count, i32** Out);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_BOUNDS_IMPL
+
+#include <math.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+aabb3f Aabb3f(vec3f Min, vec3f Max)
+{
+    aabb3f Result;
+    Result.Min = Min;
+    Result.Max = Max;
+    return Result;
+}
+
+aabb2f Aabb2f(vec2f Min, vec2f Max)
+{
+    aabb2f Result;
+    Result.Min = Min;
+    Result.Max = Max;
+    return Result;
+}
+
+aabb3f Aabb3fFromPoints(vec3f* Points, i32 Count)
+{
+    aabb3f Result;
+    Result.Min = Vec3f(3.402823466e+38f, 3.402823466e+38f, 3.402823466e+38f);
+    Result.Max = Vec3f(-3.402823466e+38f, -3.402823466e+38f, -3.402823466e+38f);
+    for (i32 i = 0; i < Count; i++)
+    {
+        for (i32 Axis = 0; Axis < 3; Axis++)
+        {
+            real32 V = Points[i].E[Axis];
+            if (V < Result.Min.E[Axis]) Result.Min.E[Axis] = V;
+            if (V > Result.Max.E[Axis]) Result.Max.E[Axis] = V;
+        }
+    }
+    return Result;
+}
+
+aabb3f UnionAabb3f(aabb3f A, aabb3f B)
+{
+    aabb3f Result;
+    for (i32 Axis = 0; Axis < 3; Axis++)
+    {
+        Result.Min.E[Axis] = A.Min.E[Axis] < B.Min.E[Axis] ? A.Min.E[Axis] : B.Min.E[Axis];
+        Result.Max.E[Axis] = A.Max.E[Axis] > B.Max.E[Axis] ? A.Max.E[Axis] : B.Max.E[Axis];
+    }
+    return Result;
+}
+
+bool OverlapsAabb3f(aabb3f A, aabb3f B)
+{
+    return A.Min.X <= B.Max.X && A.Max.X >= B.Min.X &&
+        A.Min.Y <= B.Max.Y && A.Max.Y >= B.Min.Y &&
+        A.Min.Z <= B.Max.Z && A.Max.Z >= B.Min.Z;
+}
+
+bool OverlapsAabb2f(aabb2f A, aabb2f B)
+{
+    return A.Min.X <= B.Max.X && A.Max.X >= B.Min.X &&
+        A.Min.Y <= B.Max.Y && A.Max.Y >= B.Min.Y;
+}
+
+bool ContainsPointAabb3f(aabb3f A, vec3f P)
+{
+    return P.X >= A.Min.X && P.X <= A.Max.X &&
+        P.Y >= A.Min.Y && P.Y <= A.Max.Y &&
+        P.Z >= A.Min.Z && P.Z <= A.Max.Z;
+}
+
+sphere3f SphereFromAabb3f(aabb3f A)
+{
+    sphere3f Result;
+    real32 HX = 0.5f * (A.Max.X - A.Min.X);
+    real32 HY = 0.5f * (A.Max.Y - A.Min.Y);
+    real32 HZ = 0.5f * (A.Max.Z - A.Min.Z);
+    Result.Center = Vec3f(A.Min.X + HX, A.Min.Y + HY, A.Min.Z + HZ);
+    Result.Radius = sqrtf(HX*HX + HY*HY + HZ*HZ);
+    return Result;
+}
+
+sl_frustum sl_frustum_from_mat4f(mat4f M)
+{
+    sl_frustum Result;
+
+    // NOTE(scott): column major, so row i is E[i], E[4+i], E[8+i], E[12+i]
+    vec4f Row[4];
+    for (i32 i = 0; i < 4; i++)
+    {
+        Row[i].X = M.E[i];
+        Row[i].Y = M.E[4 + i];
+        Row[i].Z = M.E[8 + i];
+        Row[i].W = M.E[12 + i];
+    }
+
+    for (i32 i = 0; i < 3; i++)
+    {
+        for (i32 c = 0; c < 4; c++)
+        {
+            Result.Planes[i*2 + 0].E[c] = Row[3].E[c] + Row[i].E[c];
+            Result.Planes[i*2 + 1].E[c] = Row[3].E[c] - Row[i].E[c];
+        }
+    }
+
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* P = Result.Planes + i;
+        real32 Len = sqrtf(P->X*P->X + P->Y*P->Y + P->Z*P->Z);
+        if (Len > 0.f)
+        {
+            real32 InvLen = 1.f / Len;
+            P->X *= InvLen;
+            P->Y *= InvLen;
+            P->Z *= InvLen;
+            P->W *= InvLen;
+        }
+    }
+
+    return Result;
+}
+
+bool sl_frustum_test_point(sl_frustum* Frustum, vec3f P)
+{
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* Plane = Frustum->Planes + i;
+        if (Plane->X*P.X + Plane->Y*P.Y + Plane->Z*P.Z + Plane->W < 0.f)
+            return false;
+    }
+    return true;
+}
+
+bool sl_frustum_test_sphere(sl_frustum* Frustum, sphere3f S)
+{
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* Plane = Frustum->Planes + i;
+        real32 Dist = Plane->X*S.Center.X + Plane->Y*S.Center.Y + Plane->Z*S.Center.Z + Plane->W;
+        if (Dist < -S.Radius)
+            return false;
+    }
+    return true;
+}
+
+bool sl_frustum_test_aabb(sl_frustum* Frustum, aabb3f A)
+{
+    real32 CX = 0.5f * (A.Max.X + A.Min.X), EX = 0.5f * (A.Max.X - A.Min.X);
+    real32 CY = 0.5f * (A.Max.Y + A.Min.Y), EY = 0.5f * (A.Max.Y - A.Min.Y);
+    real32 CZ = 0.5f * (A.Max.Z + A.Min.Z), EZ = 0.5f * (A.Max.Z - A.Min.Z);
+
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* Plane = Frustum->Planes + i;
+        real32 Dist = Plane->X*CX + Plane->Y*CY + Plane->Z*CZ + Plane->W;
+        real32 Radius = EX*fabsf(Plane->X) + EY*fabsf(Plane->Y) + EZ*fabsf(Plane->Z);
+        if (Dist < -Radius)
+            return false;
+    }
+    return true;
+}
+
+//
+// Batch kernels
+//
+
+// NOTE(scott): grows *Out so Count more indices fit and returns where they go.
+// The kernels write straight into that space and bump the length once at the end.
+internal i32*
+sl_cull_reserve(i32** Out, i32 Count)
+{
+    i32 Len = da_len(*Out);
+    if (da_cap(*Out) < Len + Count)
+    {
+        i32 NewCap = da_cap(*Out) * 2;
+        if (NewCap < Len + Count)
+            NewCap = Len + Count;
+        if (NewCap < 16)
+            NewCap = 16;
+        *Out = _da_init(*Out, NewCap);
+    }
+    return *Out + Len;
+}
+
+internal void
+sl_cull_commit(i32** Out, i32* End)
+{
+    if (*Out)
+        _da_hdr(*Out) = (i32)(End - *Out);
+}
+
+#ifdef SL_SSE2
+
+// NOTE(scott): writes the indices Base..Base+3 whose bit is set in Mask
+#define SL_CULL_EMIT(Dest, Mask, Base) \
+    if (Mask) { \
+        if ((Mask) & 1) *(Dest)++ = (Base) + 0; \
+        if ((Mask) & 2) *(Dest)++ = (Base) + 1; \
+        if ((Mask) & 4) *(Dest)++ = (Base) + 2; \
+        if ((Mask) & 8) *(Dest)++ = (Base) + 3; \
+    }
+
+internal inline __m128
+sl_abs_ps(__m128 V)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.f), V);
+}
+
+// lanes that are inside (or straddling) every plane
+internal inline int
+sl_cull_spheres4(sl_frustum* Frustum, __m128 X, __m128 Y, __m128 Z, __m128 R)
+{
+    __m128 NegR = _mm_sub_ps(_mm_setzero_ps(), R);
+    __m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* Plane = Frustum->Planes + i;
+        __m128 Dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(Plane->X), X),
+                                            _mm_mul_ps(_mm_set1_ps(Plane->Y), Y)),
+                                 _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Plane->Z), Z),
+                                            _mm_set1_ps(Plane->W)));
+        Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Dist, NegR));
+    }
+    return _mm_movemask_ps(Inside);
+}
+
+internal inline int
+sl_cull_aabbs4(sl_frustum* Frustum,
+               __m128 MinX, __m128 MinY, __m128 MinZ,
+               __m128 MaxX, __m128 MaxY, __m128 MaxZ)
+{
+    __m128 Half = _mm_set1_ps(0.5f);
+    __m128 CX = _mm_mul_ps(Half, _mm_add_ps(MaxX, MinX)), EX = _mm_mul_ps(Half, _mm_sub_ps(MaxX, MinX));
+    __m128 CY = _mm_mul_ps(Half, _mm_add_ps(MaxY, MinY)), EY = _mm_mul_ps(Half, _mm_sub_ps(MaxY, MinY));
+    __m128 CZ = _mm_mul_ps(Half, _mm_add_ps(MaxZ, MinZ)), EZ = _mm_mul_ps(Half, _mm_sub_ps(MaxZ, MinZ));
+
+    __m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (i32 i = 0; i < 6; i++)
+    {
+        vec4f* Plane = Frustum->Planes + i;
+        __m128 PX = _mm_set1_ps(Plane->X), PY = _mm_set1_ps(Plane->Y), PZ = _mm_set1_ps(Plane->Z);
+        __m128 Dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(PX, CX), _mm_mul_ps(PY, CY)),
+                                 _mm_add_ps(_mm_mul_ps(PZ, CZ), _mm_set1_ps(Plane->W)));
+        __m128 Radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sl_abs_ps(PX), EX), _mm_mul_ps(sl_abs_ps(PY), EY)),
+                                   _mm_mul_ps(sl_abs_ps(PZ), EZ));
+        Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Dist, _mm_sub_ps(_mm_setzero_ps(), Radius)));
+    }
+    return _mm_movemask_ps(Inside);
+}
+
+#endif // SL_SSE2
+
+void sl_cull_spheres(sl_frustum* Frustum, sphere3f* Spheres, i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X = _mm_loadu_ps(&Spheres[i + 0].Center.X);
+        __m128 Y = _mm_loadu_ps(&Spheres[i + 1].Center.X);
+        __m128 Z = _mm_loadu_ps(&Spheres[i + 2].Center.X);
+        __m128 R = _mm_loadu_ps(&Spheres[i + 3].Center.X);
+        _MM_TRANSPOSE4_PS(X, Y, Z, R);
+
+        int Mask = sl_cull_spheres4(Frustum, X, Y, Z, R);
+        SL_CULL_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (sl_frustum_test_sphere(Frustum, Spheres[i]))
+            *Dest++ = i;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_spheres_soa(sl_frustum* Frustum, real32* X, real32* Y, real32* Z, real32* Radius,
+                         i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        int Mask = sl_cull_spheres4(Frustum, _mm_loadu_ps(X + i), _mm_loadu_ps(Y + i),
+                                    _mm_loadu_ps(Z + i), _mm_loadu_ps(Radius + i));
+        SL_CULL_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        sphere3f S;
+        S.Center = Vec3f(X[i], Y[i], Z[i]);
+        S.Radius = Radius[i];
+        if (sl_frustum_test_sphere(Frustum, S))
+            *Dest++ = i;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_aabbs(sl_frustum* Frustum, aabb3f* Boxes, i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        aabb3f* B = Boxes + i;
+        __m128 MinX = _mm_setr_ps(B[0].Min.X, B[1].Min.X, B[2].Min.X, B[3].Min.X);
+        __m128 MinY = _mm_setr_ps(B[0].Min.Y, B[1].Min.Y, B[2].Min.Y, B[3].Min.Y);
+        __m128 MinZ = _mm_setr_ps(B[0].Min.Z, B[1].Min.Z, B[2].Min.Z, B[3].Min.Z);
+        __m128 MaxX = _mm_setr_ps(B[0].Max.X, B[1].Max.X, B[2].Max.X, B[3].Max.X);
+        __m128 MaxY = _mm_setr_ps(B[0].Max.Y, B[1].Max.Y, B[2].Max.Y, B[3].Max.Y);
+        __m128 MaxZ = _mm_setr_ps(B[0].Max.Z, B[1].Max.Z, B[2].Max.Z, B[3].Max.Z);
+
+        int Mask = sl_cull_aabbs4(Frustum, MinX, MinY, MinZ, MaxX, MaxY, MaxZ);
+        SL_CULL_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (sl_frustum_test_aabb(Frustum, Boxes[i]))
+            *Dest++ = i;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_aabbs_soa(sl_frustum* Frustum,
+                       real32* MinX, real32* MinY, real32* MinZ,
+                       real32* MaxX, real32* MaxY, real32* MaxZ,
+                       i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        int Mask = sl_cull_aabbs4(Frustum,
+                                  _mm_loadu_ps(MinX + i), _mm_loadu_ps(MinY + i), _mm_loadu_ps(MinZ + i),
+                                  _mm_loadu_ps(MaxX + i), _mm_loadu_ps(MaxY + i), _mm_loadu_ps(MaxZ + i));
+        SL_CULL_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        aabb3f A = Aabb3f(Vec3f(MinX[i], MinY[i], MinZ[i]), Vec3f(MaxX[i], MaxY[i], MaxZ[i]));
+        if (sl_frustum_test_aabb(Frustum, A))
+            *Dest++ = i;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_aabbs_by_aabb(aabb3f Range, aabb3f* Boxes, i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    for (i32 i = 0; i < Count; i++)
+    {
+        // NOTE(scott): no branches in the test, so this loop vectorizes as is
+        aabb3f B = Boxes[i];
+        int Keep = (B.Min.X <= Range.Max.X) & (B.Max.X >= Range.Min.X) &
+            (B.Min.Y <= Range.Max.Y) & (B.Max.Y >= Range.Min.Y) &
+            (B.Min.Z <= Range.Max.Z) & (B.Max.Z >= Range.Min.Z);
+        *Dest = i;
+        Dest += Keep;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_aabb2fs(aabb2f Range, aabb2f* Boxes, i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    // NOTE(scott): an aabb2f is exactly 4 floats, so compare whole boxes at once:
+    // (Min.X, Min.Y) <= (Range.Max.X, Range.Max.Y) and (Max.X, Max.Y) >= Range.Min.
+    // The lanes that only need one side compare against infinity, so boxes with
+    // infinite extents pass exactly when OverlapsAabb2f() says they do.
+    __m128 Lo = _mm_setr_ps(-INFINITY, -INFINITY, Range.Min.X, Range.Min.Y);
+    __m128 Hi = _mm_setr_ps(Range.Max.X, Range.Max.Y, INFINITY, INFINITY);
+    for (; i + 4 <= Count; i += 4)
+    {
+        int Mask = 0;
+        for (i32 Lane = 0; Lane < 4; Lane++)
+        {
+            __m128 B = _mm_loadu_ps(&Boxes[i + Lane].Min.X);
+            __m128 Ok = _mm_and_ps(_mm_cmpge_ps(B, Lo), _mm_cmple_ps(B, Hi));
+            Mask |= (_mm_movemask_ps(Ok) == 0xF) << Lane;
+        }
+        SL_CULL_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (OverlapsAabb2f(Range, Boxes[i]))
+            *Dest++ = i;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+void sl_cull_points2f(aabb2f Range, vec2f* Points, i32 Count, i32** Out)
+{
+    i32* Dest = sl_cull_reserve(Out, Count);
+    for (i32 i = 0; i < Count; i++)
+    {
+        vec2f P = Points[i];
+        int Keep = (P.X >= Range.Min.X) & (P.X <= Range.Max.X) &
+            (P.Y >= Range.Min.Y) & (P.Y <= Range.Max.Y);
+        *Dest = i;
+        Dest += Keep;
+    }
+    sl_cull_commit(Out, Dest);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_BOUNDS_IMPL
+
+#endif // SL_BOUNDS_H
@@ -0,0 +1,245 @@
+#ifndef SL_CPU_H
+#define SL_CPU_H
+
+//
+// Runtime CPU feature detection
+//
+// sl_cpu_features() runs CPUID (and XGETBV, so AVX only counts when the OS
+// saves the upper registers) once and hands back a mask of SL_CPU_* bits.
+//
+// Kernels that have wider versions than the build's baseline pick one at call
+// time through a table of function pointers:
+//
+//     typedef struct my_kernels { void (*Run)(float*, int); } my_kernels;
+//     static const my_kernels MyScalar = { RunScalar };
+//     static const my_kernels MyAvx2   = { RunAvx2 };
+//
+//     void Run(float* A, int N)
+//     {
+//         const my_kernels* K = (sl_cpu_features() & SL_CPU_AVX2) ? &MyAvx2 : &MyScalar;
+//         K->Run(A, N);
+//     }
+//
+// and the wide versions are compiled with SL_TARGET("avx2") so the rest of the
+// program doesn't need -mavx2.  Wide and scalar versions are expected to give
+// bit-identical results unless the header that owns them says otherwise.
+//
+// sl_cpu_override() masks features off, which is how tests run the fallbacks on
+// a machine that has everything.
+//
+// C compatible.  Define SL_CPU_IMPL in one file before including this to get the
+// implementation.
+//
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SL_CPU_X86 1
+#endif
+
+// NOTE(scott): MSVC lets you use any intrinsic anywhere, GCC and Clang need the
+// function tagged with the instruction sets it uses
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SL_TARGET(isa)
+#else
+#define SL_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#define SL_CPU_SSE2         (1u << 0)
+#define SL_CPU_SSE3         (1u << 1)
+#define SL_CPU_SSSE3        (1u << 2)
+#define SL_CPU_SSE41        (1u << 3)
+#define SL_CPU_SSE42        (1u << 4)
+#define SL_CPU_POPCNT       (1u << 5)
+#define SL_CPU_AVX          (1u << 6)
+#define SL_CPU_F16C         (1u << 7)
+#define SL_CPU_FMA          (1u << 8)
+#define SL_CPU_AVX2         (1u << 9)
+#define SL_CPU_BMI2         (1u << 10)
+#define SL_CPU_AVX512F      (1u << 11)
+#define SL_CPU_AVX512BW     (1u << 12)
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+unsigned int sl_cpu_features(void);
+
+// masks the detected features with Mask until called again, ~0u puts everything back
+void sl_cpu_override(unsigned int Mask);
+
+// space separated names of the features in Features, returns the length written
+int sl_cpu_describe(unsigned int Features, char* Buffer, int Size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_CPU_IMPL
+
+#include <stdio.h>
+
+#if defined(SL_CPU_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// NOTE(scott): bit 31 marks that detection has run.  Detection always comes up
+// with the same answer so two threads racing through it is harmless.
+#define SL_CPU_DETECTED (1u << 31)
+
+static volatile unsigned int sl_cpu_detected_features;
+static volatile unsigned int sl_cpu_feature_mask = ~0u;
+
+#if defined(SL_CPU_X86)
+
+static void
+sl_cpuid(unsigned int Leaf, unsigned int SubLeaf, unsigned int* Regs)
+{
+#if defined(_MSC_VER)
+    int R[4];
+    __cpuidex(R, (int)Leaf, (int)SubLeaf);
+    Regs[0] = R[0]; Regs[1] = R[1]; Regs[2] = R[2]; Regs[3] = R[3];
+#else
+    __cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+}
+
+static unsigned long long
+sl_xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int Lo, Hi;
+    __asm__ __volatile__("xgetbv" : "=a"(Lo), "=d"(Hi) : "c"(0));
+    return ((unsigned long long)Hi << 32) | Lo;
+#endif
+}
+
+static unsigned int
+sl_cpu_detect(void)
+{
+    unsigned int Result = 0;
+    unsigned int Regs[4];
+
+    sl_cpuid(0, 0, Regs);
+    unsigned int MaxLeaf = Regs[0];
+    if (MaxLeaf < 1)
+        return Result;
+
+    sl_cpuid(1, 0, Regs);
+    unsigned int Ecx1 = Regs[2];
+    unsigned int Edx1 = Regs[3];
+
+    if (Edx1 & (1u << 26)) Result |= SL_CPU_SSE2;
+    if (Ecx1 & (1u << 0))  Result |= SL_CPU_SSE3;
+    if (Ecx1 & (1u << 9))  Result |= SL_CPU_SSSE3;
+    if (Ecx1 & (1u << 19)) Result |= SL_CPU_SSE41;
+    if (Ecx1 & (1u << 20)) Result |= SL_CPU_SSE42;
+    if (Ecx1 & (1u << 23)) Result |= SL_CPU_POPCNT;
+
+    // AVX state has to be enabled by the OS (XCR0 bits 1 and 2) before any of
+    // the VEX encoded instructions are usable
+    int OsAvx = 0;
+    int OsAvx512 = 0;
+    if (Ecx1 & (1u << 27))
+    {
+        unsigned long long Xcr0 = sl_xgetbv();
+        OsAvx = (Xcr0 & 0x6) == 0x6;
+        OsAvx512 = (Xcr0 & 0xe6) == 0xe6;
+    }
+
+    if (OsAvx)
+    {
+        if (Ecx1 & (1u << 28)) Result |= SL_CPU_AVX;
+        if (Ecx1 & (1u << 29)) Result |= SL_CPU_F16C;
+        if (Ecx1 & (1u << 12)) Result |= SL_CPU_FMA;
+    }
+
+    if (MaxLeaf >= 7)
+    {
+        sl_cpuid(7, 0, Regs);
+        unsigned int Ebx7 = Regs[1];
+
+        if (Ebx7 & (1u << 8)) Result |= SL_CPU_BMI2;
+        if (OsAvx && (Ebx7 & (1u << 5))) Result |= SL_CPU_AVX2;
+        if (OsAvx512 && (Ebx7 & (1u << 16))) Result |= SL_CPU_AVX512F;
+        if (OsAvx512 && (Ebx7 & (1u << 30))) Result |= SL_CPU_AVX512BW;
+    }
+
+    return Result;
+}
+
+#else
+
+static unsigned int
+sl_cpu_detect(void)
+{
+    return 0;
+}
+
+#endif // SL_CPU_X86
+
+unsigned int sl_cpu_features(void)
+{
+    unsigned int Features = sl_cpu_detected_features;
+    if (!(Features & SL_CPU_DETECTED))
+    {
+        Features = sl_cpu_detect() | SL_CPU_DETECTED;
+        sl_cpu_detected_features = Features;
+    }
+    return Features & sl_cpu_feature_mask & ~SL_CPU_DETECTED;
+}
+
+void sl_cpu_override(unsigned int Mask)
+{
+    sl_cpu_feature_mask = Mask;
+}
+
+int sl_cpu_describe(unsigned int Features, char* Buffer, int Size)
+{
+    static const char* Names[] = {
+        "sse2", "sse3", "ssse3", "sse4.1", "sse4.2", "popcnt", "avx",
+        "f16c", "fma", "avx2", "bmi2", "avx512f", "avx512bw",
+    };
+
+    int Length = 0;
+    if (Size > 0)
+        Buffer[0] = 0;
+
+    for (int i = 0; i < (int)(sizeof(Names) / sizeof(Names[0])); i++)
+    {
+        if (!(Features & (1u << i)))
+            continue;
+
+        int Written = snprintf(Buffer + Length, Size > Length ? Size - Length : 0,
+                               Length ? " %s" : "%s", Names[i]);
+        if (Written < 0 || Length + Written >= Size)
+        {
+            // drop the partial name snprintf left behind
+            if (Length < Size)
+                Buffer[Length] = 0;
+            break;
+        }
+        Length += Written;
+    }
+
+    return Length;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_CPU_IMPL
+
+#endif // SL_CPU_H
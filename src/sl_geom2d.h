@@ -0,0 +1,685 @@
+#ifndef SL_GEOM2D_H
+#define SL_GEOM2D_H
+
+//
+// 2D geometry queries
+//
+// Point in polygon, segment intersection, point to segment distance, polygon
+// area / centroid and convex hulls on vec2f, each as a single query and as a
+// batch kernel over a whole array.  Like the culling in sl_bounds.h the batch
+// kernels come in AoS flavors (arrays of vec2f / segment2f) and SoA flavors
+// (one array per component), run 4 at a time when SL_SSE2 is defined, and the
+// filters append indices to a dyn_array:
+//
+//     i32* Inside = NULL;    // dyn_array
+//     sl_points_in_polygon2f(Fence, da_len(Fence), Positions, da_len(Positions), &Inside);
+//     for (i32 i = 0; i < da_len(Inside); i++)
+//         Alert(Vehicles + Inside[i]);
+//     da_clear(Inside);
+//
+// Polygons are a list of vertices, closed implicitly (the last vertex connects
+// back to the first), in either winding.  Containment is even-odd, so self
+// intersecting polygons and holes joined by a seam behave the usual way.
+// Points exactly on an edge may land either side, but the batch and single
+// versions always agree with each other, FMA or not (the implementation keeps
+// contraction off for itself, see SL_NO_CONTRACT_BEGIN in sl.h).
+//
+// Segments count as intersecting when they share any point, touching end
+// points and overlapping collinear segments included.
+//
+// Define SL_GEOM2D_IMPL in one file before including this to get the
+// implementation.  Needs sl.h and dyn_array.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct segment2f
+{
+    vec2f A;
+    vec2f B;
+} segment2f;
+
+segment2f Segment2f(vec2f A, vec2f B);
+
+// positive when the vertices go counter clockwise
+real32 SignedAreaPolygon2f(vec2f* Points, i32 Count);
+
+// area weighted, the average of the vertices when the area is zero
+vec2f CentroidPolygon2f(vec2f* Points, i32 Count);
+
+bool ContainsPointPolygon2f(vec2f* Points, i32 Count, vec2f P);
+
+// Hit, which may be NULL, gets a point the two have in common
+bool IntersectSegments2f(segment2f A, segment2f B, vec2f* Hit);
+
+real32 DistanceToSegment2f(vec2f P, segment2f S);
+
+// appends the hull counter clockwise, without collinear points or repeating the
+// first vertex, to the dyn_array *Hull
+void sl_convex_hull2f(vec2f* Points, i32 Count, vec2f** Hull);
+
+//
+// Batch kernels
+//
+// The filters append the index of every element that passes to the dyn_array
+// *Out, in increasing order.  *Out is not cleared first.
+//
+
+void sl_points_in_polygon2f(vec2f* Polygon, i32 VertexCount, vec2f* Points, i32 Count, i32** Out);
+void sl_points_in_polygon2f_soa(vec2f* Polygon, i32 VertexCount, real32* X, real32* Y, i32 Count, i32** Out);
+
+// segments that intersect Query
+void sl_intersect_segments2f(segment2f Query, segment2f* Segments, i32 Count, i32** Out);
+void sl_intersect_segments2f_soa(segment2f Query, real32* AX, real32* AY, real32* BX, real32* BY,
+                                 i32 Count, i32** Out);
+
+// Distances[i] = distance from point i to the nearest point on the polyline,
+// Closed adds the edge from the last vertex back to the first
+void sl_distance_to_polyline2f(vec2f* Line, i32 VertexCount, bool Closed,
+                               vec2f* Points, i32 Count, real32* Distances);
+void sl_distance_to_polyline2f_soa(vec2f* Line, i32 VertexCount, bool Closed,
+                                   real32* X, real32* Y, i32 Count, real32* Distances);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_GEOM2D_IMPL
+
+#include <stdlib.h>
+
+SL_NO_CONTRACT_BEGIN
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+segment2f Segment2f(vec2f A, vec2f B)
+{
+    segment2f Result;
+    Result.A = A;
+    Result.B = B;
+    return Result;
+}
+
+// NOTE(scott): area and centroid sum in doubles relative to the first vertex, so
+// big polygons far from the origin don't lose the small terms
+real32 SignedAreaPolygon2f(vec2f* Points, i32 Count)
+{
+    if (Count < 3)
+        return 0.f;
+    real64 OX = Points[0].X, OY = Points[0].Y;
+    real64 Sum = 0;
+    for (i32 i = 1; i + 1 < Count; i++)
+    {
+        real64 AX = Points[i].X - OX, AY = Points[i].Y - OY;
+        real64 BX = Points[i + 1].X - OX, BY = Points[i + 1].Y - OY;
+        Sum += AX*BY - BX*AY;
+    }
+    return (real32)(0.5 * Sum);
+}
+
+vec2f CentroidPolygon2f(vec2f* Points, i32 Count)
+{
+    vec2f Result = {0};
+    if (Count <= 0)
+        return Result;
+
+    real64 OX = Points[0].X, OY = Points[0].Y;
+    real64 Area = 0, CX = 0, CY = 0;
+    for (i32 i = 1; i + 1 < Count; i++)
+    {
+        real64 AX = Points[i].X - OX, AY = Points[i].Y - OY;
+        real64 BX = Points[i + 1].X - OX, BY = Points[i + 1].Y - OY;
+        real64 Cross = AX*BY - BX*AY;
+        Area += Cross;
+        CX += (AX + BX) * Cross;
+        CY += (AY + BY) * Cross;
+    }
+
+    if (Area != 0)
+    {
+        Result.X = (real32)(OX + CX / (3 * Area));
+        Result.Y = (real32)(OY + CY / (3 * Area));
+    }
+    else
+    {
+        real64 SX = 0, SY = 0;
+        for (i32 i = 0; i < Count; i++)
+        {
+            SX += Points[i].X;
+            SY += Points[i].Y;
+        }
+        Result.X = (real32)(SX / Count);
+        Result.Y = (real32)(SY / Count);
+    }
+    return Result;
+}
+
+//
+// Point in polygon
+//
+// NOTE(scott): crossing number.  A ray from P going +X flips Inside at every edge
+// it crosses: the edge has to straddle P.Y (one end above, one not) and cross
+// the ray right of P.X.  The crossing X is Xi + (P.Y - Yi) * Slope with the
+// slope done once per edge, and the scalar and SIMD versions do exactly the same
+// float ops so they always agree.
+//
+
+typedef struct sl_polygon_edges
+{
+    real32* X;      // start of each edge
+    real32* Y;
+    real32* EndY;
+    real32* Slope;  // dx / dy, 0 for horizontal edges (they never straddle)
+    i32 Count;
+    real32 MinX, MinY, MaxX, MaxY;
+} sl_polygon_edges;
+
+internal real32
+sl_edge_slope(vec2f A, vec2f B)
+{
+    return (B.Y != A.Y) ? (B.X - A.X) / (B.Y - A.Y) : 0.f;
+}
+
+// NOTE(scott): the edge table comes out of scratch memory, pop it when done
+internal sl_polygon_edges
+sl_polygon_edges_build(vec2f* Polygon, i32 Count)
+{
+    sl_polygon_edges Edges;
+    Edges.Count = Count;
+    Edges.X = (real32*)sl_scratch_alloc(sizeof(real32) * 4 * (size_t)(Count > 0 ? Count : 1));
+    Edges.Y = Edges.X + Count;
+    Edges.EndY = Edges.Y + Count;
+    Edges.Slope = Edges.EndY + Count;
+    Edges.MinX = Edges.MinY = 3.402823466e+38f;
+    Edges.MaxX = Edges.MaxY = -3.402823466e+38f;
+    for (i32 i = 0, j = Count - 1; i < Count; j = i++)
+    {
+        vec2f A = Polygon[j], B = Polygon[i];
+        Edges.X[i] = A.X;
+        Edges.Y[i] = A.Y;
+        Edges.EndY[i] = B.Y;
+        Edges.Slope[i] = sl_edge_slope(A, B);
+        Edges.MinX = B.X < Edges.MinX ? B.X : Edges.MinX;
+        Edges.MinY = B.Y < Edges.MinY ? B.Y : Edges.MinY;
+        Edges.MaxX = B.X > Edges.MaxX ? B.X : Edges.MaxX;
+        Edges.MaxY = B.Y > Edges.MaxY ? B.Y : Edges.MaxY;
+    }
+    return Edges;
+}
+
+internal bool
+sl_polygon_edges_contain(sl_polygon_edges* Edges, real32 PX, real32 PY)
+{
+    // NOTE(scott): the SIMD version skips points outside the bounds, do the same
+    // so rounding in CrossX can't make them disagree
+    if (!(PX >= Edges->MinX && PX <= Edges->MaxX && PY >= Edges->MinY && PY <= Edges->MaxY))
+        return false;
+    bool Inside = false;
+    for (i32 e = 0; e < Edges->Count; e++)
+    {
+        bool Straddles = (Edges->Y[e] > PY) != (Edges->EndY[e] > PY);
+        real32 CrossX = Edges->X[e] + (PY - Edges->Y[e]) * Edges->Slope[e];
+        Inside ^= Straddles & (PX < CrossX);
+    }
+    return Inside;
+}
+
+bool ContainsPointPolygon2f(vec2f* Points, i32 Count, vec2f P)
+{
+    bool Inside = false;
+    bool Left = false, Right = false;
+    for (i32 i = 0, j = Count - 1; i < Count; j = i++)
+    {
+        vec2f A = Points[j], B = Points[i];
+        bool Straddles = (A.Y > P.Y) != (B.Y > P.Y);
+        real32 CrossX = A.X + (P.Y - A.Y) * sl_edge_slope(A, B);
+        Inside ^= Straddles & (P.X < CrossX);
+        Left |= B.X <= P.X;
+        Right |= B.X >= P.X;
+    }
+    // outside the bounds in X, same as the batch versions (in Y nothing straddles)
+    return Inside && Left && Right;
+}
+
+//
+// Segments
+//
+
+// > 0 when C is left of A->B
+internal real32
+sl_orient2f(vec2f A, vec2f B, vec2f C)
+{
+    return (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+}
+
+internal bool
+sl_in_box2f(vec2f P, segment2f S)
+{
+    return P.X >= fminf(S.A.X, S.B.X) && P.X <= fmaxf(S.A.X, S.B.X) &&
+        P.Y >= fminf(S.A.Y, S.B.Y) && P.Y <= fmaxf(S.A.Y, S.B.Y);
+}
+
+// NOTE(scott): each segment's end points have to be on opposite sides of (or on)
+// the other's line.  For collinear segments that's always true, so the bounding
+// boxes have to overlap too; for everything else that's implied anyway.
+bool IntersectSegments2f(segment2f A, segment2f B, vec2f* Hit)
+{
+    real32 D1 = sl_orient2f(A.A, A.B, B.A), D2 = sl_orient2f(A.A, A.B, B.B);
+    real32 D3 = sl_orient2f(B.A, B.B, A.A), D4 = sl_orient2f(B.A, B.B, A.B);
+    bool Straddle1 = (D1 <= 0 && D2 >= 0) || (D1 >= 0 && D2 <= 0);
+    bool Straddle2 = (D3 <= 0 && D4 >= 0) || (D3 >= 0 && D4 <= 0);
+    bool Boxes = fminf(A.A.X, A.B.X) <= fmaxf(B.A.X, B.B.X) && fmaxf(A.A.X, A.B.X) >= fminf(B.A.X, B.B.X) &&
+        fminf(A.A.Y, A.B.Y) <= fmaxf(B.A.Y, B.B.Y) && fmaxf(A.A.Y, A.B.Y) >= fminf(B.A.Y, B.B.Y);
+    if (!(Straddle1 && Straddle2 && Boxes))
+        return false;
+
+    if (Hit)
+    {
+        if (D3 != D4)
+        {
+            real32 T = D3 / (D3 - D4);
+            Hit->X = A.A.X + T * (A.B.X - A.A.X);
+            Hit->Y = A.A.Y + T * (A.B.Y - A.A.Y);
+        }
+        else
+        {
+            // collinear, the overlap starts at one of the end points
+            if (sl_in_box2f(A.A, B))
+                *Hit = A.A;
+            else if (sl_in_box2f(A.B, B))
+                *Hit = A.B;
+            else if (sl_in_box2f(B.A, A))
+                *Hit = B.A;
+            else
+                *Hit = B.B;
+        }
+    }
+    return true;
+}
+
+// NOTE(scott): project onto the segment with the 1 / length squared done once,
+// same ops as the batch version
+internal real32
+sl_distance_sq_to_segment(real32 PX, real32 PY, real32 AX, real32 AY, real32 DX, real32 DY, real32 InvLengthSq)
+{
+    real32 T = ((PX - AX) * DX + (PY - AY) * DY) * InvLengthSq;
+    T = T < 0.f ? 0.f : (T > 1.f ? 1.f : T);
+    real32 QX = PX - (AX + T * DX);
+    real32 QY = PY - (AY + T * DY);
+    return QX*QX + QY*QY;
+}
+
+internal real32
+sl_inv_length_sq(real32 DX, real32 DY)
+{
+    real32 LengthSq = DX*DX + DY*DY;
+    return LengthSq > 0.f ? 1.f / LengthSq : 0.f;
+}
+
+real32 DistanceToSegment2f(vec2f P, segment2f S)
+{
+    real32 DX = S.B.X - S.A.X, DY = S.B.Y - S.A.Y;
+    return sqrtf(sl_distance_sq_to_segment(P.X, P.Y, S.A.X, S.A.Y, DX, DY, sl_inv_length_sq(DX, DY)));
+}
+
+//
+// Convex hull
+//
+
+internal int
+sl_compare_xy(const void* A, const void* B)
+{
+    const vec2f* P = (const vec2f*)A;
+    const vec2f* Q = (const vec2f*)B;
+    if (P->X != Q->X)
+        return P->X < Q->X ? -1 : 1;
+    if (P->Y != Q->Y)
+        return P->Y < Q->Y ? -1 : 1;
+    return 0;
+}
+
+// NOTE(scott): Andrew's monotone chain.  Sort by X, build the lower hull left to
+// right and the upper hull right to left, popping anything that isn't a strict
+// left turn.  The chains are built straight in the dyn_array.
+void sl_convex_hull2f(vec2f* Points, i32 Count, vec2f** Hull)
+{
+    if (Count <= 0)
+        return;
+
+    sl_scratch_mark Mark = sl_scratch_push();
+    vec2f* Sorted = (vec2f*)sl_scratch_alloc(sizeof(vec2f) * (size_t)Count);
+    memcpy(Sorted, Points, sizeof(vec2f) * (size_t)Count);
+    qsort(Sorted, (size_t)Count, sizeof(vec2f), sl_compare_xy);
+
+    i32 Base = da_len(*Hull);
+    if (da_cap(*Hull) < Base + 2 * Count)
+        *Hull = _da_init(*Hull, Base + 2 * Count);
+    vec2f* H = *Hull + Base;
+    i32 K = 0;
+
+    for (i32 i = 0; i < Count; i++)
+    {
+        while (K >= 2 && sl_orient2f(H[K - 2], H[K - 1], Sorted[i]) <= 0)
+            K--;
+        H[K++] = Sorted[i];
+    }
+    for (i32 i = Count - 2, Lower = K + 1; i >= 0; i--)
+    {
+        while (K >= Lower && sl_orient2f(H[K - 2], H[K - 1], Sorted[i]) <= 0)
+            K--;
+        H[K++] = Sorted[i];
+    }
+
+    // the upper chain ends back at the first point
+    if (K > 1)
+        K--;
+    // all the points the same, keep one
+    if (K == 2 && sl_compare_xy(H, H + 1) == 0)
+        K = 1;
+
+    _da_hdr(*Hull) = Base + K;
+    sl_scratch_pop(Mark);
+}
+
+//
+// Batch kernels
+//
+
+// NOTE(scott): same as in sl_bounds.h, grow *Out so Count more indices fit, write
+// straight into it and set the length once at the end
+internal i32*
+sl_geom2d_reserve(i32** Out, i32 Count)
+{
+    i32 Len = da_len(*Out);
+    if (da_cap(*Out) < Len + Count)
+    {
+        i32 NewCap = da_cap(*Out) * 2;
+        if (NewCap < Len + Count)
+            NewCap = Len + Count;
+        if (NewCap < 16)
+            NewCap = 16;
+        *Out = _da_init(*Out, NewCap);
+    }
+    return *Out + Len;
+}
+
+internal void
+sl_geom2d_commit(i32** Out, i32* End)
+{
+    if (*Out)
+        _da_hdr(*Out) = (i32)(End - *Out);
+}
+
+#ifdef SL_SSE2
+
+#define SL_GEOM2D_EMIT(Dest, Mask, Base) \
+    if (Mask) { \
+        if ((Mask) & 1) *(Dest)++ = (Base) + 0; \
+        if ((Mask) & 2) *(Dest)++ = (Base) + 1; \
+        if ((Mask) & 4) *(Dest)++ = (Base) + 2; \
+        if ((Mask) & 8) *(Dest)++ = (Base) + 3; \
+    }
+
+// lanes inside the polygon
+internal inline int
+sl_points_in_polygon4(sl_polygon_edges* Edges, __m128 PX, __m128 PY)
+{
+    // NOTE(scott): most points in a geofence check are nowhere near the fence,
+    // skip the edges when all four are outside its bounds
+    __m128 InBounds = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(PX, _mm_set1_ps(Edges->MinX)),
+                                            _mm_cmple_ps(PX, _mm_set1_ps(Edges->MaxX))),
+                                 _mm_and_ps(_mm_cmpge_ps(PY, _mm_set1_ps(Edges->MinY)),
+                                            _mm_cmple_ps(PY, _mm_set1_ps(Edges->MaxY))));
+    if (!_mm_movemask_ps(InBounds))
+        return 0;
+
+    __m128 Inside = _mm_setzero_ps();
+    for (i32 e = 0; e < Edges->Count; e++)
+    {
+        __m128 Y = _mm_set1_ps(Edges->Y[e]);
+        __m128 Straddles = _mm_xor_ps(_mm_cmpgt_ps(Y, PY), _mm_cmpgt_ps(_mm_set1_ps(Edges->EndY[e]), PY));
+        __m128 CrossX = _mm_add_ps(_mm_set1_ps(Edges->X[e]), _mm_mul_ps(_mm_sub_ps(PY, Y), _mm_set1_ps(Edges->Slope[e])));
+        Inside = _mm_xor_ps(Inside, _mm_and_ps(Straddles, _mm_cmplt_ps(PX, CrossX)));
+    }
+    return _mm_movemask_ps(_mm_and_ps(Inside, InBounds));
+}
+
+// lanes whose segment intersects Query
+internal inline int
+sl_intersect_segments4(segment2f Query, __m128 AX, __m128 AY, __m128 BX, __m128 BY)
+{
+    __m128 Zero = _mm_setzero_ps();
+    __m128 QAX = _mm_set1_ps(Query.A.X), QAY = _mm_set1_ps(Query.A.Y);
+    __m128 QBX = _mm_set1_ps(Query.B.X), QBY = _mm_set1_ps(Query.B.Y);
+    __m128 QDX = _mm_sub_ps(QBX, QAX), QDY = _mm_sub_ps(QBY, QAY);
+    __m128 DX = _mm_sub_ps(BX, AX), DY = _mm_sub_ps(BY, AY);
+
+    __m128 D1 = _mm_sub_ps(_mm_mul_ps(QDX, _mm_sub_ps(AY, QAY)), _mm_mul_ps(QDY, _mm_sub_ps(AX, QAX)));
+    __m128 D2 = _mm_sub_ps(_mm_mul_ps(QDX, _mm_sub_ps(BY, QAY)), _mm_mul_ps(QDY, _mm_sub_ps(BX, QAX)));
+    __m128 D3 = _mm_sub_ps(_mm_mul_ps(DX, _mm_sub_ps(QAY, AY)), _mm_mul_ps(DY, _mm_sub_ps(QAX, AX)));
+    __m128 D4 = _mm_sub_ps(_mm_mul_ps(DX, _mm_sub_ps(QBY, AY)), _mm_mul_ps(DY, _mm_sub_ps(QBX, AX)));
+
+    __m128 Straddle1 = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(D1, Zero), _mm_cmpge_ps(D2, Zero)),
+                                 _mm_and_ps(_mm_cmpge_ps(D1, Zero), _mm_cmple_ps(D2, Zero)));
+    __m128 Straddle2 = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(D3, Zero), _mm_cmpge_ps(D4, Zero)),
+                                 _mm_and_ps(_mm_cmpge_ps(D3, Zero), _mm_cmple_ps(D4, Zero)));
+
+    __m128 Boxes = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(_mm_min_ps(AX, BX), _mm_set1_ps(fmaxf(Query.A.X, Query.B.X))),
+                   _mm_cmpge_ps(_mm_max_ps(AX, BX), _mm_set1_ps(fminf(Query.A.X, Query.B.X)))),
+        _mm_and_ps(_mm_cmple_ps(_mm_min_ps(AY, BY), _mm_set1_ps(fmaxf(Query.A.Y, Query.B.Y))),
+                   _mm_cmpge_ps(_mm_max_ps(AY, BY), _mm_set1_ps(fminf(Query.A.Y, Query.B.Y)))));
+
+    return _mm_movemask_ps(_mm_and_ps(_mm_and_ps(Straddle1, Straddle2), Boxes));
+}
+
+// squared distance from 4 points to the nearest segment
+internal inline __m128
+sl_distance_sq_to_polyline4(real32* Segs, i32 SegCount, __m128 PX, __m128 PY)
+{
+    __m128 Zero = _mm_setzero_ps(), One = _mm_set1_ps(1.f);
+    __m128 Best = _mm_set1_ps(3.402823466e+38f);
+    for (i32 s = 0; s < SegCount; s++, Segs += 5)
+    {
+        __m128 AX = _mm_set1_ps(Segs[0]), AY = _mm_set1_ps(Segs[1]);
+        __m128 DX = _mm_set1_ps(Segs[2]), DY = _mm_set1_ps(Segs[3]);
+        __m128 T = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(PX, AX), DX), _mm_mul_ps(_mm_sub_ps(PY, AY), DY)),
+                              _mm_set1_ps(Segs[4]));
+        T = _mm_min_ps(_mm_max_ps(T, Zero), One);
+        __m128 QX = _mm_sub_ps(PX, _mm_add_ps(AX, _mm_mul_ps(T, DX)));
+        __m128 QY = _mm_sub_ps(PY, _mm_add_ps(AY, _mm_mul_ps(T, DY)));
+        Best = _mm_min_ps(Best, _mm_add_ps(_mm_mul_ps(QX, QX), _mm_mul_ps(QY, QY)));
+    }
+    return Best;
+}
+
+#endif // SL_SSE2
+
+void sl_points_in_polygon2f(vec2f* Polygon, i32 VertexCount, vec2f* Points, i32 Count, i32** Out)
+{
+    sl_scratch_mark Mark = sl_scratch_push();
+    sl_polygon_edges Edges = sl_polygon_edges_build(Polygon, VertexCount);
+    i32* Dest = sl_geom2d_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        // x0 y0 x1 y1, x2 y2 x3 y3 -> x0 x1 x2 x3, y0 y1 y2 y3
+        __m128 P01 = _mm_loadu_ps(&Points[i].X);
+        __m128 P23 = _mm_loadu_ps(&Points[i + 2].X);
+        __m128 PX = _mm_shuffle_ps(P01, P23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 PY = _mm_shuffle_ps(P01, P23, _MM_SHUFFLE(3, 1, 3, 1));
+        int Mask = sl_points_in_polygon4(&Edges, PX, PY);
+        SL_GEOM2D_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (sl_polygon_edges_contain(&Edges, Points[i].X, Points[i].Y))
+            *Dest++ = i;
+    }
+    sl_geom2d_commit(Out, Dest);
+    sl_scratch_pop(Mark);
+}
+
+void sl_points_in_polygon2f_soa(vec2f* Polygon, i32 VertexCount, real32* X, real32* Y, i32 Count, i32** Out)
+{
+    sl_scratch_mark Mark = sl_scratch_push();
+    sl_polygon_edges Edges = sl_polygon_edges_build(Polygon, VertexCount);
+    i32* Dest = sl_geom2d_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        int Mask = sl_points_in_polygon4(&Edges, _mm_loadu_ps(X + i), _mm_loadu_ps(Y + i));
+        SL_GEOM2D_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (sl_polygon_edges_contain(&Edges, X[i], Y[i]))
+            *Dest++ = i;
+    }
+    sl_geom2d_commit(Out, Dest);
+    sl_scratch_pop(Mark);
+}
+
+void sl_intersect_segments2f(segment2f Query, segment2f* Segments, i32 Count, i32** Out)
+{
+    i32* Dest = sl_geom2d_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        // NOTE(scott): a segment2f is exactly 4 floats, transpose 4 of them
+        __m128 AX = _mm_loadu_ps(&Segments[i + 0].A.X);
+        __m128 AY = _mm_loadu_ps(&Segments[i + 1].A.X);
+        __m128 BX = _mm_loadu_ps(&Segments[i + 2].A.X);
+        __m128 BY = _mm_loadu_ps(&Segments[i + 3].A.X);
+        _MM_TRANSPOSE4_PS(AX, AY, BX, BY);
+        int Mask = sl_intersect_segments4(Query, AX, AY, BX, BY);
+        SL_GEOM2D_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (IntersectSegments2f(Query, Segments[i], NULL))
+            *Dest++ = i;
+    }
+    sl_geom2d_commit(Out, Dest);
+}
+
+void sl_intersect_segments2f_soa(segment2f Query, real32* AX, real32* AY, real32* BX, real32* BY,
+                                 i32 Count, i32** Out)
+{
+    i32* Dest = sl_geom2d_reserve(Out, Count);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        int Mask = sl_intersect_segments4(Query, _mm_loadu_ps(AX + i), _mm_loadu_ps(AY + i),
+                                          _mm_loadu_ps(BX + i), _mm_loadu_ps(BY + i));
+        SL_GEOM2D_EMIT(Dest, Mask, i);
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        if (IntersectSegments2f(Query, Segment2f(Vec2f(AX[i], AY[i]), Vec2f(BX[i], BY[i])), NULL))
+            *Dest++ = i;
+    }
+    sl_geom2d_commit(Out, Dest);
+}
+
+// NOTE(scott): per segment A.X, A.Y, D.X, D.Y, 1 / |D|^2, out of scratch memory
+internal real32*
+sl_polyline_segments(vec2f* Line, i32 VertexCount, bool Closed, i32* SegCount)
+{
+    i32 Count = VertexCount < 2 ? (VertexCount == 1 ? 1 : 0) : (Closed ? VertexCount : VertexCount - 1);
+    real32* Segs = (real32*)sl_scratch_alloc(sizeof(real32) * 5 * (size_t)(Count ? Count : 1));
+    for (i32 s = 0; s < Count; s++)
+    {
+        // a single vertex is a zero length segment
+        vec2f A = Line[s], B = Line[VertexCount > 1 ? (s + 1) % VertexCount : 0];
+        real32* Seg = Segs + 5 * s;
+        Seg[0] = A.X;
+        Seg[1] = A.Y;
+        Seg[2] = B.X - A.X;
+        Seg[3] = B.Y - A.Y;
+        Seg[4] = sl_inv_length_sq(Seg[2], Seg[3]);
+    }
+    *SegCount = Count;
+    return Segs;
+}
+
+internal real32
+sl_distance_to_polyline1(real32* Segs, i32 SegCount, real32 PX, real32 PY)
+{
+    real32 Best = 3.402823466e+38f;
+    for (i32 s = 0; s < SegCount; s++, Segs += 5)
+    {
+        real32 D = sl_distance_sq_to_segment(PX, PY, Segs[0], Segs[1], Segs[2], Segs[3], Segs[4]);
+        Best = D < Best ? D : Best;
+    }
+    return sqrtf(Best);
+}
+
+void sl_distance_to_polyline2f(vec2f* Line, i32 VertexCount, bool Closed,
+                               vec2f* Points, i32 Count, real32* Distances)
+{
+    sl_scratch_mark Mark = sl_scratch_push();
+    i32 SegCount;
+    real32* Segs = sl_polyline_segments(Line, VertexCount, Closed, &SegCount);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 P01 = _mm_loadu_ps(&Points[i].X);
+        __m128 P23 = _mm_loadu_ps(&Points[i + 2].X);
+        __m128 PX = _mm_shuffle_ps(P01, P23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 PY = _mm_shuffle_ps(P01, P23, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(Distances + i, _mm_sqrt_ps(sl_distance_sq_to_polyline4(Segs, SegCount, PX, PY)));
+    }
+#endif
+    for (; i < Count; i++)
+        Distances[i] = sl_distance_to_polyline1(Segs, SegCount, Points[i].X, Points[i].Y);
+    sl_scratch_pop(Mark);
+}
+
+void sl_distance_to_polyline2f_soa(vec2f* Line, i32 VertexCount, bool Closed,
+                                   real32* X, real32* Y, i32 Count, real32* Distances)
+{
+    sl_scratch_mark Mark = sl_scratch_push();
+    i32 SegCount;
+    real32* Segs = sl_polyline_segments(Line, VertexCount, Closed, &SegCount);
+    i32 i = 0;
+#ifdef SL_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 Best = sl_distance_sq_to_polyline4(Segs, SegCount, _mm_loadu_ps(X + i), _mm_loadu_ps(Y + i));
+        _mm_storeu_ps(Distances + i, _mm_sqrt_ps(Best));
+    }
+#endif
+    for (; i < Count; i++)
+        Distances[i] = sl_distance_to_polyline1(Segs, SegCount, X[i], Y[i]);
+    sl_scratch_pop(Mark);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+SL_NO_CONTRACT_END
+
+#endif // SL_GEOM2D_IMPL
+
+#endif // SL_GEOM2D_H
@@ -0,0 +1,443 @@
+#ifndef SL_HASH_H
+#define SL_HASH_H
+
+//
+// Hashing and string interning
+//
+// sl_hash64() is XXH64: fast, well distributed and not cryptographic.  Long
+// inputs go through four independent accumulators 32 bytes at a time, so the
+// multiplies for different lanes overlap in the pipeline.  Results match the
+// reference xxHash implementation for the same seed, so hashes can be stored
+// or compared with other tools.
+//
+//     u64 H = sl_hash64(Data, Size, 0);
+//
+// or a piece at a time, which gives the same answer as hashing it all at once:
+//
+//     sl_hash_state State;
+//     sl_hash_init(&State, 0);
+//     sl_hash_update(&State, Header, sizeof(Header));
+//     sl_hash_update(&State, Body, BodySize);
+//     u64 H = sl_hash_final(&State);
+//
+// The intern table keeps one copy of every distinct string and hands back a
+// small integer ID and a canonical pointer for it.  Interning the same text
+// again returns the same ID and pointer, so names that repeat (INI sections and
+// keys, asset paths) compare as integers instead of with strcmp:
+//
+//     sl_intern_table Names = {0};
+//     i32 Window = sl_intern(&Names, "window");
+//     ...
+//     if (sl_intern(&Names, Section) == Window)
+//
+// IDs count up from 0 and canonical pointers stay valid until sl_intern_free().
+// The table isn't thread safe.
+//
+// C compatible.  Define SL_HASH_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_hash_state
+{
+    unsigned long long Total;
+    unsigned long long Lanes[4];
+    unsigned char Buffer[32];
+    int Buffered;
+} sl_hash_state;
+
+unsigned long long sl_hash64(const void* Data, size_t Length, unsigned long long Seed);
+unsigned long long sl_hash_string(const char* String);
+
+void sl_hash_init(sl_hash_state* State, unsigned long long Seed);
+void sl_hash_update(sl_hash_state* State, const void* Data, size_t Length);
+unsigned long long sl_hash_final(const sl_hash_state* State);
+
+typedef struct sl_intern_entry
+{
+    const char* String;
+    unsigned long long Hash;
+    int Length;
+} sl_intern_entry;
+
+typedef struct sl_intern_table
+{
+    sl_intern_entry* Entries;   // dyn_array, indexed by ID
+    int* Slots;                 // open addressing, ID + 1, 0 is empty
+    int SlotCount;
+    struct sl_intern_block* Blocks;
+} sl_intern_table;
+
+// ID of String, adding it if it's new
+int sl_intern(sl_intern_table* Table, const char* String);
+int sl_intern_range(sl_intern_table* Table, const char* String, int Length);
+
+// ID of String or -1, never adds
+int sl_intern_find(sl_intern_table* Table, const char* String);
+int sl_intern_find_range(sl_intern_table* Table, const char* String, int Length);
+
+// canonical copy of String, equal strings give equal pointers
+const char* sl_intern_str(sl_intern_table* Table, const char* String);
+
+const char* sl_intern_lookup(sl_intern_table* Table, int Id);
+int sl_intern_count(sl_intern_table* Table);
+void sl_intern_free(sl_intern_table* Table);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_HASH_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SL_HASH_P1 0x9E3779B185EBCA87ull
+#define SL_HASH_P2 0xC2B2AE3D27D4EB4Full
+#define SL_HASH_P3 0x165667B19E3779F9ull
+#define SL_HASH_P4 0x85EBCA77C2B2AE63ull
+#define SL_HASH_P5 0x27D4EB2F165667C5ull
+
+#define sl_rotl64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+// NOTE(scott): unaligned little endian loads, memcpy compiles down to a mov
+static unsigned long long
+sl_hash_read64(const unsigned char* P)
+{
+    unsigned long long Result;
+    memcpy(&Result, P, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    Result = __builtin_bswap64(Result);
+#endif
+    return Result;
+}
+
+static unsigned int
+sl_hash_read32(const unsigned char* P)
+{
+    unsigned int Result;
+    memcpy(&Result, P, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    Result = __builtin_bswap32(Result);
+#endif
+    return Result;
+}
+
+static unsigned long long
+sl_hash_round(unsigned long long Acc, unsigned long long Input)
+{
+    Acc += Input * SL_HASH_P2;
+    Acc = sl_rotl64(Acc, 31);
+    return Acc * SL_HASH_P1;
+}
+
+static unsigned long long
+sl_hash_merge(unsigned long long Acc, unsigned long long Lane)
+{
+    Acc ^= sl_hash_round(0, Lane);
+    return Acc * SL_HASH_P1 + SL_HASH_P4;
+}
+
+// runs whole 32 byte stripes, returns the bytes consumed
+static size_t
+sl_hash_stripes(unsigned long long* Lanes, const unsigned char* P, size_t Length)
+{
+    unsigned long long V1 = Lanes[0], V2 = Lanes[1], V3 = Lanes[2], V4 = Lanes[3];
+    const unsigned char* Start = P;
+    const unsigned char* Limit = P + (Length & ~(size_t)31);
+    while (P < Limit)
+    {
+        V1 = sl_hash_round(V1, sl_hash_read64(P));
+        V2 = sl_hash_round(V2, sl_hash_read64(P + 8));
+        V3 = sl_hash_round(V3, sl_hash_read64(P + 16));
+        V4 = sl_hash_round(V4, sl_hash_read64(P + 24));
+        P += 32;
+    }
+    Lanes[0] = V1; Lanes[1] = V2; Lanes[2] = V3; Lanes[3] = V4;
+    return (size_t)(P - Start);
+}
+
+static unsigned long long
+sl_hash_finish(unsigned long long H, const unsigned char* P, size_t Length)
+{
+    while (Length >= 8)
+    {
+        H ^= sl_hash_round(0, sl_hash_read64(P));
+        H = sl_rotl64(H, 27) * SL_HASH_P1 + SL_HASH_P4;
+        P += 8;
+        Length -= 8;
+    }
+    if (Length >= 4)
+    {
+        H ^= (unsigned long long)sl_hash_read32(P) * SL_HASH_P1;
+        H = sl_rotl64(H, 23) * SL_HASH_P2 + SL_HASH_P3;
+        P += 4;
+        Length -= 4;
+    }
+    while (Length > 0)
+    {
+        H ^= (*P) * SL_HASH_P5;
+        H = sl_rotl64(H, 11) * SL_HASH_P1;
+        P++;
+        Length--;
+    }
+
+    H ^= H >> 33;
+    H *= SL_HASH_P2;
+    H ^= H >> 29;
+    H *= SL_HASH_P3;
+    H ^= H >> 32;
+    return H;
+}
+
+static unsigned long long
+sl_hash_converge(const unsigned long long* Lanes)
+{
+    unsigned long long H = sl_rotl64(Lanes[0], 1) + sl_rotl64(Lanes[1], 7) +
+                           sl_rotl64(Lanes[2], 12) + sl_rotl64(Lanes[3], 18);
+    H = sl_hash_merge(H, Lanes[0]);
+    H = sl_hash_merge(H, Lanes[1]);
+    H = sl_hash_merge(H, Lanes[2]);
+    H = sl_hash_merge(H, Lanes[3]);
+    return H;
+}
+
+unsigned long long sl_hash64(const void* Data, size_t Length, unsigned long long Seed)
+{
+    const unsigned char* P = (const unsigned char*)Data;
+    unsigned long long H;
+
+    if (Length >= 32)
+    {
+        unsigned long long Lanes[4] = { Seed + SL_HASH_P1 + SL_HASH_P2, Seed + SL_HASH_P2, Seed, Seed - SL_HASH_P1 };
+        size_t Done = sl_hash_stripes(Lanes, P, Length);
+        H = sl_hash_converge(Lanes);
+        H += (unsigned long long)Length;
+        return sl_hash_finish(H, P + Done, Length - Done);
+    }
+
+    H = Seed + SL_HASH_P5 + (unsigned long long)Length;
+    return sl_hash_finish(H, P, Length);
+}
+
+unsigned long long sl_hash_string(const char* String)
+{
+    return sl_hash64(String, strlen(String), 0);
+}
+
+void sl_hash_init(sl_hash_state* State, unsigned long long Seed)
+{
+    memset(State, 0, sizeof(*State));
+    State->Lanes[0] = Seed + SL_HASH_P1 + SL_HASH_P2;
+    State->Lanes[1] = Seed + SL_HASH_P2;
+    State->Lanes[2] = Seed;
+    State->Lanes[3] = Seed - SL_HASH_P1;
+}
+
+void sl_hash_update(sl_hash_state* State, const void* Data, size_t Length)
+{
+    const unsigned char* P = (const unsigned char*)Data;
+    State->Total += Length;
+
+    // top up a partial stripe first
+    if (State->Buffered)
+    {
+        size_t Take = 32 - (size_t)State->Buffered;
+        if (Take > Length)
+            Take = Length;
+        memcpy(State->Buffer + State->Buffered, P, Take);
+        State->Buffered += (int)Take;
+        P += Take;
+        Length -= Take;
+        if (State->Buffered < 32)
+            return;
+        sl_hash_stripes(State->Lanes, State->Buffer, 32);
+        State->Buffered = 0;
+    }
+
+    size_t Done = sl_hash_stripes(State->Lanes, P, Length);
+    memcpy(State->Buffer, P + Done, Length - Done);
+    State->Buffered = (int)(Length - Done);
+}
+
+unsigned long long sl_hash_final(const sl_hash_state* State)
+{
+    unsigned long long H;
+    if (State->Total >= 32)
+        H = sl_hash_converge(State->Lanes);
+    else
+        H = State->Lanes[2] + SL_HASH_P5;   // Lanes[2] is still the seed
+    H += State->Total;
+    return sl_hash_finish(H, State->Buffer, (size_t)State->Buffered);
+}
+
+//
+// Interning
+//
+
+#define SL_INTERN_BLOCK_SIZE (64 * 1024)
+
+typedef struct sl_intern_block
+{
+    struct sl_intern_block* Next;
+    size_t Used;
+    size_t Size;
+} sl_intern_block;
+
+// NOTE(scott): strings live in big blocks that are never moved or freed until
+// the table is, which is what keeps the canonical pointers stable
+static char*
+sl_intern_store(sl_intern_table* Table, const char* String, int Length)
+{
+    sl_intern_block* Block = Table->Blocks;
+    size_t Need = (size_t)Length + 1;
+    if (!Block || Block->Used + Need > Block->Size)
+    {
+        size_t Size = Need > SL_INTERN_BLOCK_SIZE ? Need : SL_INTERN_BLOCK_SIZE;
+        Block = (sl_intern_block*)malloc(sizeof(sl_intern_block) + Size);
+        Block->Used = 0;
+        Block->Size = Size;
+        Block->Next = Table->Blocks;
+        Table->Blocks = Block;
+    }
+
+    char* Result = (char*)(Block + 1) + Block->Used;
+    memcpy(Result, String, (size_t)Length);
+    Result[Length] = 0;
+    Block->Used += Need;
+    return Result;
+}
+
+static int
+sl_intern_probe(sl_intern_table* Table, const char* String, int Length, unsigned long long Hash)
+{
+    if (!Table->SlotCount)
+        return -1;
+
+    int Mask = Table->SlotCount - 1;
+    for (int i = (int)(Hash & (unsigned long long)Mask);; i = (i + 1) & Mask)
+    {
+        int Slot = Table->Slots[i];
+        if (!Slot)
+            return -(i + 2);   // empty slot i, encoded so it can't be an ID
+
+        sl_intern_entry* Entry = Table->Entries + Slot - 1;
+        if (Entry->Hash == Hash && Entry->Length == Length && memcmp(Entry->String, String, (size_t)Length) == 0)
+            return Slot - 1;
+    }
+}
+
+static void
+sl_intern_grow(sl_intern_table* Table)
+{
+    int SlotCount = Table->SlotCount ? Table->SlotCount * 2 : 64;
+    int* Slots = (int*)calloc((size_t)SlotCount, sizeof(int));
+    int Mask = SlotCount - 1;
+
+    for (int Id = 0; Id < da_len(Table->Entries); Id++)
+    {
+        int i = (int)(Table->Entries[Id].Hash & (unsigned long long)Mask);
+        while (Slots[i])
+            i = (i + 1) & Mask;
+        Slots[i] = Id + 1;
+    }
+
+    free(Table->Slots);
+    Table->Slots = Slots;
+    Table->SlotCount = SlotCount;
+}
+
+int sl_intern_range(sl_intern_table* Table, const char* String, int Length)
+{
+    unsigned long long Hash = sl_hash64(String, (size_t)Length, 0);
+    int Found = sl_intern_probe(Table, String, Length, Hash);
+    if (Found >= 0)
+        return Found;
+
+    // keep the load under 1/2 so probes stay short
+    if ((da_len(Table->Entries) + 1) * 2 > Table->SlotCount)
+    {
+        sl_intern_grow(Table);
+        Found = sl_intern_probe(Table, String, Length, Hash);
+    }
+
+    sl_intern_entry Entry;
+    Entry.String = sl_intern_store(Table, String, Length);
+    Entry.Hash = Hash;
+    Entry.Length = Length;
+
+    int Id = da_len(Table->Entries);
+    da_append(Table->Entries, Entry);
+    Table->Slots[-(Found + 2)] = Id + 1;
+    return Id;
+}
+
+int sl_intern(sl_intern_table* Table, const char* String)
+{
+    return sl_intern_range(Table, String, (int)strlen(String));
+}
+
+int sl_intern_find_range(sl_intern_table* Table, const char* String, int Length)
+{
+    int Found = sl_intern_probe(Table, String, Length, sl_hash64(String, (size_t)Length, 0));
+    return Found >= 0 ? Found : -1;
+}
+
+int sl_intern_find(sl_intern_table* Table, const char* String)
+{
+    return sl_intern_find_range(Table, String, (int)strlen(String));
+}
+
+const char* sl_intern_str(sl_intern_table* Table, const char* String)
+{
+    // NOTE(scott): interning can move Entries, so no indexing it in one expression
+    int Id = sl_intern(Table, String);
+    return Table->Entries[Id].String;
+}
+
+const char* sl_intern_lookup(sl_intern_table* Table, int Id)
+{
+    if (Id < 0 || Id >= da_len(Table->Entries))
+        return NULL;
+    return Table->Entries[Id].String;
+}
+
+int sl_intern_count(sl_intern_table* Table)
+{
+    return da_len(Table->Entries);
+}
+
+void sl_intern_free(sl_intern_table* Table)
+{
+    sl_intern_block* Block = Table->Blocks;
+    while (Block)
+    {
+        sl_intern_block* Next = Block->Next;
+        free(Block);
+        Block = Next;
+    }
+    da_delete(Table->Entries);
+    free(Table->Slots);
+    memset(Table, 0, sizeof(*Table));
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_HASH_IMPL
+
+#endif // SL_HASH_H
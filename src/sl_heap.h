@@ -0,0 +1,262 @@
+#ifndef SL_HEAP_H
+#define SL_HEAP_H
+
+//
+// Priority queues
+//
+// A d-ary heap (4 children per node by default) kept in dyn_arrays, generated
+// per type so the comparison is inlined like the sorts in sl_sort.h:
+//
+//     typedef struct event { double Time; int Id; } event;
+//     #define EventBefore(A, B) ((A)->Time < (B)->Time)
+//     SL_HEAP_DEFINE(event_queue, event, EventBefore)
+//
+//     event_queue Queue = {0};
+//     int Handle = event_queue_push(&Queue, Event);
+//     ...
+//     event Next;
+//     while (event_queue_pop(&Queue, &Next))
+//         Run(&Next);
+//     event_queue_free(&Queue);
+//
+// Less(A, B) gets two const Type* and says A comes out first.  Four children
+// per node makes the heap half as deep as a binary one and the children of a
+// node sit next to each other, so a sift down touches fewer cache lines.
+//
+// Every push returns a handle that stays valid until the item leaves the heap,
+// for changing an item's priority or taking it out early:
+//
+//     Name_push(Heap, Item)                  handle
+//     Name_top(Heap)                         next item or NULL, stays in the heap
+//     Name_pop(Heap, &Out)                   0 when empty
+//     Name_get(Heap, Handle)                 the item for a handle
+//     Name_update(Heap, Handle, Item)        new priority, either direction
+//     Name_remove(Heap, Handle, &Out)        Out may be NULL
+//     Name_heapify(Heap, Items, Count)       bulk build in O(n), handles 0..Count-1
+//     Name_push_bounded(Heap, Item, K, &Evicted)  top-k, see below
+//     Name_count(Heap), Name_clear(Heap), Name_free(Heap)
+//
+// push_bounded() keeps at most K items by evicting the top, so order the heap
+// with the worst item on top: for the 10 nearest points, make Less "farther"
+// and the heap ends up holding the 10 closest.  It returns the handle or -1 if
+// the item wasn't good enough to keep.  An item pushed out leaves the heap like a
+// pop, its handle is dead and comes back in *Evicted (-1 when nothing left,
+// Evicted may be NULL); the new item always gets a handle of its own.
+//
+// C compatible.  Everything is generated by the macro, there is no
+// implementation to define.  Needs dyn_array.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+
+#ifndef SL_HEAP_ARITY
+#define SL_HEAP_ARITY 4
+#endif
+
+#if defined(__GNUC__)
+#define SL_HEAP_UNUSED __attribute__((unused))
+#else
+#define SL_HEAP_UNUSED
+#endif
+
+// NOTE(scott): free handles are chained through Positions as -2 - Next, so
+// anything negative is free and -1 ends the chain
+#define SL_HEAP_DEFINE(Name, Type, Less) \
+    typedef struct Name \
+    { \
+        Type* Items;        /* dyn_array, the heap */ \
+        int* Handles;       /* dyn_array, handle of each item */ \
+        int* Positions;     /* dyn_array, item index of each handle */ \
+        int FreeHandle; \
+    } Name; \
+    \
+    static SL_HEAP_UNUSED void Name##_place_(Name* Heap, int Index, const Type* Item, int Handle) \
+    { \
+        Heap->Items[Index] = *Item; \
+        Heap->Handles[Index] = Handle; \
+        Heap->Positions[Handle] = Index; \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_sift_up_(Name* Heap, int Index) \
+    { \
+        Type Item = Heap->Items[Index]; \
+        int Handle = Heap->Handles[Index]; \
+        while (Index > 0) \
+        { \
+            int Parent = (Index - 1) / SL_HEAP_ARITY; \
+            if (!Less(&Item, &Heap->Items[Parent])) \
+                break; \
+            Name##_place_(Heap, Index, &Heap->Items[Parent], Heap->Handles[Parent]); \
+            Index = Parent; \
+        } \
+        Name##_place_(Heap, Index, &Item, Handle); \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_sift_down_(Name* Heap, int Index) \
+    { \
+        int Count = da_len(Heap->Items); \
+        Type Item = Heap->Items[Index]; \
+        int Handle = Heap->Handles[Index]; \
+        for (;;) \
+        { \
+            int First = Index * SL_HEAP_ARITY + 1; \
+            if (First >= Count) \
+                break; \
+            int Last = First + SL_HEAP_ARITY < Count ? First + SL_HEAP_ARITY : Count; \
+            int Best = First; \
+            for (int Child = First + 1; Child < Last; Child++) \
+            { \
+                if (Less(&Heap->Items[Child], &Heap->Items[Best])) \
+                    Best = Child; \
+            } \
+            if (!Less(&Heap->Items[Best], &Item)) \
+                break; \
+            Name##_place_(Heap, Index, &Heap->Items[Best], Heap->Handles[Best]); \
+            Index = Best; \
+        } \
+        Name##_place_(Heap, Index, &Item, Handle); \
+    } \
+    \
+    static SL_HEAP_UNUSED int Name##_new_handle_(Name* Heap) \
+    { \
+        if (!Heap->Positions) \
+            Heap->FreeHandle = -1; \
+        int Handle = Heap->FreeHandle; \
+        if (Handle >= 0) \
+        { \
+            Heap->FreeHandle = -2 - Heap->Positions[Handle]; \
+            return Handle; \
+        } \
+        Handle = da_len(Heap->Positions); \
+        da_append(Heap->Positions, -1); \
+        return Handle; \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_free_handle_(Name* Heap, int Handle) \
+    { \
+        Heap->Positions[Handle] = -2 - Heap->FreeHandle; \
+        Heap->FreeHandle = Handle; \
+    } \
+    \
+    static SL_HEAP_UNUSED int Name##_count(const Name* Heap) \
+    { \
+        return da_len(Heap->Items); \
+    } \
+    \
+    static SL_HEAP_UNUSED Type* Name##_top(Name* Heap) \
+    { \
+        return da_len(Heap->Items) ? Heap->Items : NULL; \
+    } \
+    \
+    static SL_HEAP_UNUSED Type* Name##_get(Name* Heap, int Handle) \
+    { \
+        return Heap->Items + Heap->Positions[Handle]; \
+    } \
+    \
+    static SL_HEAP_UNUSED int Name##_push(Name* Heap, Type Item) \
+    { \
+        int Handle = Name##_new_handle_(Heap); \
+        int Index = da_len(Heap->Items); \
+        da_append(Heap->Items, Item); \
+        da_append(Heap->Handles, Handle); \
+        Heap->Positions[Handle] = Index; \
+        Name##_sift_up_(Heap, Index); \
+        return Handle; \
+    } \
+    \
+    /* takes the item at Index out, the last item fills the hole */ \
+    static SL_HEAP_UNUSED void Name##_remove_at_(Name* Heap, int Index, Type* Out) \
+    { \
+        if (Out) \
+            *Out = Heap->Items[Index]; \
+        Name##_free_handle_(Heap, Heap->Handles[Index]); \
+        int Last = _da_hdr(Heap->Items) - 1; \
+        _da_hdr(Heap->Items)--; \
+        _da_hdr(Heap->Handles)--; \
+        if (Index == Last) \
+            return; \
+        Name##_place_(Heap, Index, &Heap->Items[Last], Heap->Handles[Last]); \
+        if (Index > 0 && Less(&Heap->Items[Index], &Heap->Items[(Index - 1) / SL_HEAP_ARITY])) \
+            Name##_sift_up_(Heap, Index); \
+        else \
+            Name##_sift_down_(Heap, Index); \
+    } \
+    \
+    static SL_HEAP_UNUSED int Name##_pop(Name* Heap, Type* Out) \
+    { \
+        if (!da_len(Heap->Items)) \
+            return 0; \
+        Name##_remove_at_(Heap, 0, Out); \
+        return 1; \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_remove(Name* Heap, int Handle, Type* Out) \
+    { \
+        Name##_remove_at_(Heap, Heap->Positions[Handle], Out); \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_update(Name* Heap, int Handle, Type Item) \
+    { \
+        int Index = Heap->Positions[Handle]; \
+        int Earlier = Less(&Item, &Heap->Items[Index]); \
+        Heap->Items[Index] = Item; \
+        if (Earlier) \
+            Name##_sift_up_(Heap, Index); \
+        else \
+            Name##_sift_down_(Heap, Index); \
+    } \
+    \
+    static SL_HEAP_UNUSED int Name##_push_bounded(Name* Heap, Type Item, int K, int* Evicted) \
+    { \
+        if (Evicted) \
+            *Evicted = -1; \
+        if (da_len(Heap->Items) < K) \
+            return Name##_push(Heap, Item); \
+        /* full: only something that would sit below the top gets in */ \
+        if (K <= 0 || !Less(&Heap->Items[0], &Item)) \
+            return -1; \
+        /* new handle before the old one is freed, so they never match */ \
+        int Handle = Name##_new_handle_(Heap); \
+        if (Evicted) \
+            *Evicted = Heap->Handles[0]; \
+        Name##_free_handle_(Heap, Heap->Handles[0]); \
+        Name##_place_(Heap, 0, &Item, Handle); \
+        Name##_sift_down_(Heap, 0); \
+        return Handle; \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_clear(Name* Heap) \
+    { \
+        da_clear(Heap->Items); \
+        da_clear(Heap->Handles); \
+        da_clear(Heap->Positions); \
+        Heap->FreeHandle = -1; \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_heapify(Name* Heap, const Type* Items, int Count) \
+    { \
+        Name##_clear(Heap); \
+        for (int i = 0; i < Count; i++) \
+        { \
+            da_append(Heap->Items, Items[i]); \
+            da_append(Heap->Handles, i); \
+            da_append(Heap->Positions, i); \
+        } \
+        /* Floyd: sift down every parent, last first */ \
+        for (int i = (Count - 2) / SL_HEAP_ARITY; i >= 0 && Count > 1; i--) \
+            Name##_sift_down_(Heap, i); \
+    } \
+    \
+    static SL_HEAP_UNUSED void Name##_free(Name* Heap) \
+    { \
+        da_delete(Heap->Items); \
+        da_delete(Heap->Handles); \
+        da_delete(Heap->Positions); \
+        Heap->Items = NULL; \
+        Heap->Handles = NULL; \
+        Heap->Positions = NULL; \
+        Heap->FreeHandle = -1; \
+    }
+
+#endif // SL_HEAP_H
@@ -0,0 +1,733 @@
+#ifndef SL_JOB_H
+#define SL_JOB_H
+
+//
+// Job system
+//
+// A worker pool with one thread per core.  Every worker owns a work-stealing
+// deque (Chase-Lev): it pushes and pops jobs at the bottom of its own deque and
+// idle workers steal from the top of everyone else's, so work spreads out
+// without a shared queue everybody fights over.
+//
+// Jobs are counted, not handled.  Submitting a job bumps a counter, finishing it
+// drops the counter, and sl_job_wait() runs other jobs until the counter hits
+// zero.  A job can wait on a counter too, which is how dependencies are built:
+//
+//     sl_job_init(0);                              // one thread per core
+//
+//     sl_job_counter Loaded = {0};
+//     for (int i = 0; i < FileCount; i++)
+//         sl_job_run(LoadFile, &Files[i], &Loaded);
+//
+//     sl_job_counter Built = {0};
+//     sl_job_run_after(&Loaded, BuildIndex, &Index, &Built);
+//     sl_job_wait(&Built);
+//
+//     sl_job_shutdown();
+//
+// For data parallel work over a dyn_array, sl_parallel_for() splits the range
+// into chunks and calls Fn once per chunk with [Begin, End):
+//
+//     static void Normalize(void* Array, int Begin, int End, void* UserData)
+//     {
+//         NozQuatArray((quat*)Array + Begin, (quat*)Array + Begin, End - Begin);
+//     }
+//     sl_parallel_for(Rotations, 4096, Normalize, NULL);
+//
+// and sl_parallel_reduce() does the same with a partial result per chunk that
+// is folded together in chunk order, so a floating point sum comes out the same
+// no matter how many threads ran it.
+//
+// Chunk should be big enough that a chunk takes at least a few microseconds;
+// the ranges are split in halves so stealing hands out big pieces first.
+//
+// The thread that calls sl_job_init() becomes worker 0 and must be the one that
+// calls sl_job_shutdown().  Jobs submitted from threads outside the pool go
+// through a locked queue.  Before sl_job_init() (or with a pool of one) every
+// call runs inline on the calling thread, so code can use these unconditionally.
+//
+// C compatible.  Define SL_JOB_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h and pthreads (or Win32).
+//
+
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_job_counter
+{
+    volatile int Value;
+} sl_job_counter;
+
+typedef void sl_job_fn(void* Data);
+typedef void sl_range_fn(void* Array, int Begin, int End, void* UserData);
+typedef void sl_reduce_fn(void* Array, int Begin, int End, void* Partial, void* UserData);
+typedef void sl_combine_fn(void* Into, const void* From, void* UserData);
+
+// ThreadCount includes the calling thread, 0 means one per core
+void sl_job_init(int ThreadCount);
+void sl_job_shutdown(void);
+
+// 1 when the pool isn't running
+int sl_job_thread_count(void);
+// 0 .. sl_job_thread_count() - 1 on pool threads, -1 anywhere else
+int sl_job_thread_index(void);
+
+// Counter may be NULL for fire and forget jobs
+void sl_job_run(sl_job_fn* Fn, void* Data, sl_job_counter* Counter);
+// Fn doesn't start until Dependency reaches zero
+void sl_job_run_after(sl_job_counter* Dependency, sl_job_fn* Fn, void* Data, sl_job_counter* Counter);
+// runs queued jobs until Counter reaches zero
+void sl_job_wait(sl_job_counter* Counter);
+
+void sl_parallel_for_range(void* Array, int Count, int Chunk, sl_range_fn* Fn, void* UserData);
+
+// Result holds the identity on the way in and the answer on the way out
+void sl_parallel_reduce_range(void* Array, int Count, int Chunk, sl_reduce_fn* Fn, sl_combine_fn* Combine,
+                              void* Result, int ResultSize, void* UserData);
+
+#define sl_parallel_for(__da_list, __chunk, __fn, __user_data) \
+    sl_parallel_for_range((void*)(__da_list), da_len(__da_list), (__chunk), (__fn), (__user_data))
+
+#define sl_parallel_reduce(__da_list, __chunk, __fn, __combine, __result, __user_data) \
+    sl_parallel_reduce_range((void*)(__da_list), da_len(__da_list), (__chunk), (__fn), (__combine), \
+                             (__result), (int)sizeof(*(__result)), (__user_data))
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_JOB_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+#define sl_job_pause() _mm_pause()
+#else
+#define sl_job_pause()
+#endif
+
+#ifndef SL_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define SL_THREAD_LOCAL __declspec(thread)
+#else
+#define SL_THREAD_LOCAL __thread
+#endif
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// NOTE(scott): all the shared state goes through these.  Everything is
+// sequentially consistent except where the deque says otherwise.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define sl_atomic_load(p)           (_ReadWriteBarrier(), *(p))
+#define sl_atomic_store(p, v)       (_ReadWriteBarrier(), *(p) = (v), MemoryBarrier())
+#define sl_atomic_add(p, v)         InterlockedAdd((volatile LONG*)(p), (v))
+#define sl_atomic_cas64(p, e, d)    (InterlockedCompareExchange64((volatile LONG64*)(p), (d), (e)) == (e))
+#define sl_atomic_fence()           MemoryBarrier()
+#else
+#define sl_atomic_load(p)           __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define sl_atomic_store(p, v)       __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define sl_atomic_add(p, v)         __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define sl_atomic_cas64(p, e, d)    sl_atomic_cas64_(p, e, d)
+#define sl_atomic_fence()           __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static int
+sl_atomic_cas64_(volatile long long* P, long long Expected, long long Desired)
+{
+    return __atomic_compare_exchange_n(P, &Expected, Desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+#endif
+
+#define SL_JOB_DEQUE_SIZE   4096
+#define SL_JOB_INJECT_SIZE  1024
+#define SL_JOB_SPINS        256
+
+typedef struct sl_job
+{
+    void (*Exec)(struct sl_job* Job);
+    sl_job_fn* Fn;
+    void* Data;
+    sl_job_counter* Counter;
+    sl_job_counter* Dependency;
+    int Begin;
+    int End;
+} sl_job;
+
+// NOTE(scott): Top and Bottom sit on their own cache lines, the thieves hammer
+// Top and the owner hammers Bottom
+typedef struct sl_job_deque
+{
+    volatile long long Top;
+    char Pad0[64 - sizeof(long long)];
+    volatile long long Bottom;
+    char Pad1[64 - sizeof(long long)];
+    sl_job Jobs[SL_JOB_DEQUE_SIZE];
+} sl_job_deque;
+
+#if defined(_WIN32)
+typedef HANDLE sl_job_thread;
+typedef SRWLOCK sl_job_mutex;
+typedef CONDITION_VARIABLE sl_job_cond;
+#define sl_job_lock(m)          AcquireSRWLockExclusive(m)
+#define sl_job_unlock(m)        ReleaseSRWLockExclusive(m)
+#define sl_job_sleep(c, m)      SleepConditionVariableSRW((c), (m), INFINITE, 0)
+#define sl_job_wake_one(c)      WakeConditionVariable(c)
+#define sl_job_wake_all(c)      WakeAllConditionVariable(c)
+#define sl_job_yield()          SwitchToThread()
+#else
+typedef pthread_t sl_job_thread;
+typedef pthread_mutex_t sl_job_mutex;
+typedef pthread_cond_t sl_job_cond;
+#define sl_job_lock(m)          pthread_mutex_lock(m)
+#define sl_job_unlock(m)        pthread_mutex_unlock(m)
+#define sl_job_sleep(c, m)      pthread_cond_wait((c), (m))
+#define sl_job_wake_one(c)      pthread_cond_signal(c)
+#define sl_job_wake_all(c)      pthread_cond_broadcast(c)
+#define sl_job_yield()          sched_yield()
+#endif
+
+typedef struct sl_job_pool
+{
+    int ThreadCount;
+    sl_job_deque* Deques;
+    sl_job_thread* Threads;
+
+    // jobs from threads outside the pool
+    sl_job_mutex InjectLock;
+    sl_job Inject[SL_JOB_INJECT_SIZE];
+    int InjectHead;
+    volatile int InjectCount;
+
+    sl_job_mutex SleepLock;
+    sl_job_cond SleepCond;
+    volatile int Sleepers;
+    volatile int Quit;
+} sl_job_pool;
+
+static sl_job_pool* sl_job_global_pool;
+static SL_THREAD_LOCAL int sl_job_thread_id = -1;
+static SL_THREAD_LOCAL unsigned int sl_job_rng;
+
+//
+// Deque
+//
+// NOTE(scott): this is the Chase-Lev deque with the fences from Le et al.,
+// "Correct and Efficient Work-Stealing for Weak Memory Models".  Jobs are copied
+// by value; a thief that loses the race on Top throws its copy away, and the
+// owner never reuses a slot while Top still points at it, so a copy that wins
+// the race is always whole.
+//
+
+static int
+sl_job_deque_push(sl_job_deque* Deque, sl_job* Job)
+{
+    long long Bottom = Deque->Bottom;
+    long long Top = sl_atomic_load(&Deque->Top);
+    if (Bottom - Top >= SL_JOB_DEQUE_SIZE)
+        return 0;
+
+    Deque->Jobs[Bottom & (SL_JOB_DEQUE_SIZE - 1)] = *Job;
+    sl_atomic_store(&Deque->Bottom, Bottom + 1);
+    return 1;
+}
+
+static int
+sl_job_deque_pop(sl_job_deque* Deque, sl_job* Job)
+{
+    long long Bottom = Deque->Bottom - 1;
+    sl_atomic_store(&Deque->Bottom, Bottom);
+    sl_atomic_fence();
+    long long Top = sl_atomic_load(&Deque->Top);
+
+    if (Top > Bottom)
+    {
+        sl_atomic_store(&Deque->Bottom, Bottom + 1);
+        return 0;
+    }
+
+    *Job = Deque->Jobs[Bottom & (SL_JOB_DEQUE_SIZE - 1)];
+    if (Top == Bottom)
+    {
+        // last one, race the thieves for it
+        int Won = sl_atomic_cas64(&Deque->Top, Top, Top + 1);
+        sl_atomic_store(&Deque->Bottom, Bottom + 1);
+        return Won;
+    }
+    return 1;
+}
+
+static int
+sl_job_deque_steal(sl_job_deque* Deque, sl_job* Job)
+{
+    long long Top = sl_atomic_load(&Deque->Top);
+    sl_atomic_fence();
+    long long Bottom = sl_atomic_load(&Deque->Bottom);
+    if (Top >= Bottom)
+        return 0;
+
+    *Job = Deque->Jobs[Top & (SL_JOB_DEQUE_SIZE - 1)];
+    return sl_atomic_cas64(&Deque->Top, Top, Top + 1);
+}
+
+static int
+sl_job_deque_empty(sl_job_deque* Deque)
+{
+    return sl_atomic_load(&Deque->Top) >= sl_atomic_load(&Deque->Bottom);
+}
+
+//
+// Scheduling
+//
+
+static void
+sl_job_execute(sl_job* Job)
+{
+    if (Job->Dependency)
+        sl_job_wait(Job->Dependency);
+
+    Job->Exec(Job);
+
+    if (Job->Counter)
+        sl_atomic_add(&Job->Counter->Value, -1);
+}
+
+static void
+sl_job_exec_user(sl_job* Job)
+{
+    Job->Fn(Job->Data);
+}
+
+static int
+sl_job_find(sl_job_pool* Pool, sl_job* Job)
+{
+    int Self = sl_job_thread_id;
+    if (Self >= 0 && sl_job_deque_pop(&Pool->Deques[Self], Job))
+        return 1;
+
+    if (sl_atomic_load(&Pool->InjectCount) > 0)
+    {
+        int Found = 0;
+        sl_job_lock(&Pool->InjectLock);
+        if (Pool->InjectCount > 0)
+        {
+            *Job = Pool->Inject[Pool->InjectHead];
+            Pool->InjectHead = (Pool->InjectHead + 1) % SL_JOB_INJECT_SIZE;
+            sl_atomic_add(&Pool->InjectCount, -1);
+            Found = 1;
+        }
+        sl_job_unlock(&Pool->InjectLock);
+        if (Found)
+            return 1;
+    }
+
+    // start at a random victim so the thieves don't all pile onto worker 0
+    unsigned int X = sl_job_rng ? sl_job_rng : 0x9e3779b9u + (unsigned int)Self;
+    X ^= X << 13; X ^= X >> 17; X ^= X << 5;
+    sl_job_rng = X;
+
+    int Count = Pool->ThreadCount;
+    int Start = (int)(X % (unsigned int)Count);
+    for (int i = 0; i < Count; i++)
+    {
+        int Victim = (Start + i) % Count;
+        if (Victim != Self && sl_job_deque_steal(&Pool->Deques[Victim], Job))
+            return 1;
+    }
+    return 0;
+}
+
+static int
+sl_job_any_queued(sl_job_pool* Pool)
+{
+    if (sl_atomic_load(&Pool->InjectCount) > 0)
+        return 1;
+    for (int i = 0; i < Pool->ThreadCount; i++)
+        if (!sl_job_deque_empty(&Pool->Deques[i]))
+            return 1;
+    return 0;
+}
+
+static void
+sl_job_submit(sl_job* Job)
+{
+    sl_job_pool* Pool = sl_job_global_pool;
+    if (Job->Counter)
+        sl_atomic_add(&Job->Counter->Value, 1);
+
+    if (!Pool || Pool->ThreadCount == 1)
+    {
+        sl_job_execute(Job);
+        return;
+    }
+
+    int Queued = 0;
+    int Self = sl_job_thread_id;
+    if (Self >= 0)
+    {
+        Queued = sl_job_deque_push(&Pool->Deques[Self], Job);
+    }
+    else
+    {
+        sl_job_lock(&Pool->InjectLock);
+        if (Pool->InjectCount < SL_JOB_INJECT_SIZE)
+        {
+            Pool->Inject[(Pool->InjectHead + Pool->InjectCount) % SL_JOB_INJECT_SIZE] = *Job;
+            sl_atomic_add(&Pool->InjectCount, 1);
+            Queued = 1;
+        }
+        sl_job_unlock(&Pool->InjectLock);
+    }
+
+    // NOTE(scott): a full queue means there's already plenty for everyone to do
+    if (!Queued)
+    {
+        sl_job_execute(Job);
+        return;
+    }
+
+    // NOTE(scott): a worker going to sleep bumps Sleepers and then looks for
+    // work again under SleepLock.  Either it sees this job or we see it, so no
+    // wakeups get lost.
+    if (sl_atomic_load(&Pool->Sleepers) > 0)
+    {
+        sl_job_lock(&Pool->SleepLock);
+        sl_job_wake_one(&Pool->SleepCond);
+        sl_job_unlock(&Pool->SleepLock);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI
+#else
+static void*
+#endif
+sl_job_worker(void* Param)
+{
+    sl_job_pool* Pool = sl_job_global_pool;
+    sl_job_thread_id = (int)(size_t)Param;
+
+    int Idle = 0;
+    while (!sl_atomic_load(&Pool->Quit))
+    {
+        sl_job Job;
+        if (sl_job_find(Pool, &Job))
+        {
+            sl_job_execute(&Job);
+            Idle = 0;
+            continue;
+        }
+
+        if (++Idle < SL_JOB_SPINS)
+        {
+            sl_job_pause();
+            continue;
+        }
+
+        sl_job_lock(&Pool->SleepLock);
+        sl_atomic_add(&Pool->Sleepers, 1);
+        if (!sl_job_any_queued(Pool) && !sl_atomic_load(&Pool->Quit))
+            sl_job_sleep(&Pool->SleepCond, &Pool->SleepLock);
+        sl_atomic_add(&Pool->Sleepers, -1);
+        sl_job_unlock(&Pool->SleepLock);
+        Idle = 0;
+    }
+
+    return 0;
+}
+
+static int
+sl_job_core_count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return (int)Info.dwNumberOfProcessors;
+#else
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return Count > 0 ? (int)Count : 1;
+#endif
+}
+
+void sl_job_init(int ThreadCount)
+{
+    if (sl_job_global_pool)
+        return;
+
+    if (ThreadCount <= 0)
+        ThreadCount = sl_job_core_count();
+
+    sl_job_pool* Pool = (sl_job_pool*)calloc(1, sizeof(sl_job_pool));
+    Pool->ThreadCount = ThreadCount;
+    Pool->Deques = (sl_job_deque*)calloc((size_t)ThreadCount, sizeof(sl_job_deque));
+    Pool->Threads = (sl_job_thread*)calloc((size_t)ThreadCount, sizeof(sl_job_thread));
+#if defined(_WIN32)
+    InitializeSRWLock(&Pool->InjectLock);
+    InitializeSRWLock(&Pool->SleepLock);
+    InitializeConditionVariable(&Pool->SleepCond);
+#else
+    pthread_mutex_init(&Pool->InjectLock, NULL);
+    pthread_mutex_init(&Pool->SleepLock, NULL);
+    pthread_cond_init(&Pool->SleepCond, NULL);
+#endif
+
+    sl_job_global_pool = Pool;
+    sl_job_thread_id = 0;
+
+    for (int i = 1; i < ThreadCount; i++)
+    {
+#if defined(_WIN32)
+        Pool->Threads[i] = CreateThread(NULL, 0, sl_job_worker, (void*)(size_t)i, 0, NULL);
+#else
+        pthread_create(&Pool->Threads[i], NULL, sl_job_worker, (void*)(size_t)i);
+#endif
+    }
+}
+
+void sl_job_shutdown(void)
+{
+    sl_job_pool* Pool = sl_job_global_pool;
+    if (!Pool)
+        return;
+
+    // finish whatever is still queued before pulling the workers down
+    sl_job Job;
+    while (sl_job_find(Pool, &Job))
+        sl_job_execute(&Job);
+
+    sl_job_lock(&Pool->SleepLock);
+    sl_atomic_store(&Pool->Quit, 1);
+    sl_job_wake_all(&Pool->SleepCond);
+    sl_job_unlock(&Pool->SleepLock);
+
+    for (int i = 1; i < Pool->ThreadCount; i++)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(Pool->Threads[i], INFINITE);
+        CloseHandle(Pool->Threads[i]);
+#else
+        pthread_join(Pool->Threads[i], NULL);
+#endif
+    }
+
+#if !defined(_WIN32)
+    pthread_mutex_destroy(&Pool->InjectLock);
+    pthread_mutex_destroy(&Pool->SleepLock);
+    pthread_cond_destroy(&Pool->SleepCond);
+#endif
+    free(Pool->Threads);
+    free(Pool->Deques);
+    free(Pool);
+    sl_job_global_pool = NULL;
+    sl_job_thread_id = -1;
+}
+
+int sl_job_thread_count(void)
+{
+    return sl_job_global_pool ? sl_job_global_pool->ThreadCount : 1;
+}
+
+int sl_job_thread_index(void)
+{
+    return sl_job_thread_id;
+}
+
+void sl_job_run(sl_job_fn* Fn, void* Data, sl_job_counter* Counter)
+{
+    sl_job_run_after(NULL, Fn, Data, Counter);
+}
+
+void sl_job_run_after(sl_job_counter* Dependency, sl_job_fn* Fn, void* Data, sl_job_counter* Counter)
+{
+    sl_job Job;
+    memset(&Job, 0, sizeof(Job));
+    Job.Exec = sl_job_exec_user;
+    Job.Fn = Fn;
+    Job.Data = Data;
+    Job.Counter = Counter;
+    Job.Dependency = Dependency;
+    sl_job_submit(&Job);
+}
+
+void sl_job_wait(sl_job_counter* Counter)
+{
+    sl_job_pool* Pool = sl_job_global_pool;
+    int Idle = 0;
+    while (sl_atomic_load(&Counter->Value) > 0)
+    {
+        sl_job Job;
+        if (Pool && sl_job_find(Pool, &Job))
+        {
+            sl_job_execute(&Job);
+            Idle = 0;
+        }
+        else if (++Idle < SL_JOB_SPINS)
+        {
+            sl_job_pause();
+        }
+        else
+        {
+            sl_job_yield();
+        }
+    }
+}
+
+//
+// Parallel for / reduce
+//
+
+typedef struct sl_parallel_range
+{
+    void* Array;
+    int Count;
+    int Chunk;
+    sl_range_fn* Fn;
+    sl_reduce_fn* Reduce;
+    char* Partials;
+    int PartialSize;
+    void* UserData;
+    sl_job_counter Counter;
+} sl_parallel_range;
+
+// NOTE(scott): Begin / End on these jobs are chunk numbers.  A job keeps the
+// left half and hands the right half to the deque until it's down to one chunk,
+// so the first things a thief finds are the biggest pieces.
+static void
+sl_job_exec_range(sl_job* Job)
+{
+    sl_parallel_range* Range = (sl_parallel_range*)Job->Data;
+    int Begin = Job->Begin;
+    int End = Job->End;
+
+    while (End - Begin > 1)
+    {
+        int Mid = Begin + (End - Begin) / 2;
+        sl_job Right = *Job;
+        Right.Dependency = NULL;
+        Right.Begin = Mid;
+        Right.End = End;
+        sl_job_submit(&Right);
+        End = Mid;
+    }
+
+    int First = Begin * Range->Chunk;
+    int Last = First + Range->Chunk;
+    if (Last > Range->Count)
+        Last = Range->Count;
+
+    if (Range->Reduce)
+        Range->Reduce(Range->Array, First, Last, Range->Partials + (size_t)Begin * Range->PartialSize, Range->UserData);
+    else
+        Range->Fn(Range->Array, First, Last, Range->UserData);
+}
+
+static void
+sl_parallel_run(sl_parallel_range* Range)
+{
+    int Chunks = (Range->Count + Range->Chunk - 1) / Range->Chunk;
+
+    sl_job Job;
+    memset(&Job, 0, sizeof(Job));
+    Job.Exec = sl_job_exec_range;
+    Job.Data = Range;
+    Job.Counter = &Range->Counter;
+    Job.Begin = 0;
+    Job.End = Chunks;
+    sl_job_submit(&Job);
+    sl_job_wait(&Range->Counter);
+}
+
+void sl_parallel_for_range(void* Array, int Count, int Chunk, sl_range_fn* Fn, void* UserData)
+{
+    if (Count <= 0)
+        return;
+    if (Chunk <= 0)
+        Chunk = 1;
+
+    if (sl_job_thread_count() == 1 || Count <= Chunk)
+    {
+        for (int First = 0; First < Count; First += Chunk)
+            Fn(Array, First, Count - First < Chunk ? Count : First + Chunk, UserData);
+        return;
+    }
+
+    sl_parallel_range Range;
+    memset(&Range, 0, sizeof(Range));
+    Range.Array = Array;
+    Range.Count = Count;
+    Range.Chunk = Chunk;
+    Range.Fn = Fn;
+    Range.UserData = UserData;
+    sl_parallel_run(&Range);
+}
+
+void sl_parallel_reduce_range(void* Array, int Count, int Chunk, sl_reduce_fn* Fn, sl_combine_fn* Combine,
+                              void* Result, int ResultSize, void* UserData)
+{
+    if (Count <= 0)
+        return;
+    if (Chunk <= 0)
+        Chunk = 1;
+
+    // NOTE(scott): chunk boundaries don't depend on the thread count, so the
+    // same input folds the same way on one core or sixty four
+    int Chunks = (Count + Chunk - 1) / Chunk;
+    char* Partials = (char*)malloc((size_t)Chunks * ResultSize);
+    for (int i = 0; i < Chunks; i++)
+        memcpy(Partials + (size_t)i * ResultSize, Result, ResultSize);
+
+    if (sl_job_thread_count() == 1 || Chunks == 1)
+    {
+        for (int i = 0; i < Chunks; i++)
+        {
+            int Last = (i + 1) * Chunk < Count ? (i + 1) * Chunk : Count;
+            Fn(Array, i * Chunk, Last, Partials + (size_t)i * ResultSize, UserData);
+        }
+    }
+    else
+    {
+        sl_parallel_range Range;
+        memset(&Range, 0, sizeof(Range));
+        Range.Array = Array;
+        Range.Count = Count;
+        Range.Chunk = Chunk;
+        Range.Reduce = Fn;
+        Range.Partials = Partials;
+        Range.PartialSize = ResultSize;
+        Range.UserData = UserData;
+        sl_parallel_run(&Range);
+    }
+
+    for (int i = 0; i < Chunks; i++)
+        Combine(Result, Partials + (size_t)i * ResultSize, UserData);
+    free(Partials);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_JOB_IMPL
+
+#endif // SL_JOB_H
@@ -0,0 +1,582 @@
+#ifndef SL_KDTREE_H
+#define SL_KDTREE_H
+
+//
+// Spatial index over vec3f points
+//
+// A k-d tree built by median split on the longest axis.  Each node also keeps
+// the bounding box of the points under it, which is what the queries prune
+// with.  That means when points move you can call sl_kdtree_refit() to redo the
+// boxes bottom up without touching the tree shape.  Queries stay exact, they
+// just get slower as the tree drifts from the points, so rebuild once things
+// have moved a lot.
+//
+// Nodes are one flat array in depth first order: the left child of node i is
+// always i + 1, and children come after their parent.  The points are copied
+// into tree order so a leaf's points are contiguous in memory.
+//
+// Usage:
+//     vec3f* Points = NULL;  // dyn_array
+//     ...
+//     sl_kdtree Tree = sl_kdtree_build(Points);
+//
+//     i32* Hits = NULL;
+//     sl_kdtree_radius(&Tree, P, 10.f, &Hits);   // appends indices into Points
+//
+//     // Points moved
+//     sl_kdtree_refit(&Tree, Points);
+//
+//     sl_kdtree_free(&Tree);
+//
+// Big builds split the subtrees across the job system once sl_job_init() has
+// run, and come out the same as a serial build.
+//
+// Define SL_KDTREE_IMPL in one file before including this to get the
+// implementation.  Needs sl.h, dyn_array.h and sl_job.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+#include "sl_job.h"
+
+#include <string.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#ifndef SL_KDTREE_LEAF_SIZE
+#define SL_KDTREE_LEAF_SIZE 8
+#endif
+
+// NOTE(scott): plenty for a balanced tree, 2^64 points
+#define SL_KDTREE_MAX_DEPTH 64
+
+// subtrees with at least this many points build on the job system
+#ifndef SL_KDTREE_PARALLEL_MIN
+#define SL_KDTREE_PARALLEL_MIN (32 * 1024)
+#endif
+
+typedef struct sl_kd_node
+{
+    vec3f Min;
+    vec3f Max;
+    i32 Begin;      // range in sl_kdtree.Points
+    i32 End;
+    i32 Right;      // right child, 0 for a leaf (the root is never a right child)
+} sl_kd_node;
+
+typedef struct sl_kdtree
+{
+    sl_kd_node* Nodes;  // dyn_array
+    vec3f* Points;      // dyn_array, points in tree order
+    i32* Index;         // dyn_array, tree order -> index in the source array
+} sl_kdtree;
+
+sl_kdtree sl_kdtree_build(vec3f* Points);
+void sl_kdtree_free(sl_kdtree* Tree);
+
+// NOTE(scott): Points must be the same array (same length, same order) the tree
+// was built from, just with new positions
+void sl_kdtree_refit(sl_kdtree* Tree, vec3f* Points);
+
+// returns the source index of the closest point, -1 if the tree is empty
+i32 sl_kdtree_nearest(sl_kdtree* Tree, vec3f P, real32* OutDistSq);
+
+// fills up to K results sorted nearest first, returns how many were found.
+// OutDistSq may be NULL.
+i32 sl_kdtree_knn(sl_kdtree* Tree, vec3f P, i32 K, i32* OutIndex, real32* OutDistSq);
+
+// these append source indices to the dyn_array *Out, in no particular order
+void sl_kdtree_radius(sl_kdtree* Tree, vec3f P, real32 Radius, i32** Out);
+void sl_kdtree_box(sl_kdtree* Tree, vec3f Min, vec3f Max, i32** Out);
+
+// NOTE(scott): K results per query, laid out query after query.  Queries that
+// find fewer than K points pad with -1.
+void sl_kdtree_knn_batch(sl_kdtree* Tree, vec3f* Queries, i32 QueryCount, i32 K,
+                         i32* OutIndex, real32* OutDistSq);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_KDTREE_IMPL
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+internal inline real32
+sl_kd_dist_sq(vec3f A, vec3f B)
+{
+    real32 X = A.X - B.X, Y = A.Y - B.Y, Z = A.Z - B.Z;
+    return X*X + Y*Y + Z*Z;
+}
+
+// squared distance from P to the closest point of the box, 0 if inside
+internal inline real32
+sl_kd_box_dist_sq(sl_kd_node* Node, vec3f P)
+{
+    real32 Result = 0.f;
+    for (i32 i = 0; i < 3; i++)
+    {
+        real32 D = 0.f;
+        if (P.E[i] < Node->Min.E[i])
+            D = Node->Min.E[i] - P.E[i];
+        else if (P.E[i] > Node->Max.E[i])
+            D = P.E[i] - Node->Max.E[i];
+        Result += D*D;
+    }
+    return Result;
+}
+
+// squared distance from P to the farthest corner of the box
+internal inline real32
+sl_kd_box_max_dist_sq(sl_kd_node* Node, vec3f P)
+{
+    real32 Result = 0.f;
+    for (i32 i = 0; i < 3; i++)
+    {
+        real32 A = P.E[i] - Node->Min.E[i];
+        real32 B = Node->Max.E[i] - P.E[i];
+        real32 D = A > B ? A : B;
+        Result += D*D;
+    }
+    return Result;
+}
+
+internal void
+sl_kd_compute_bounds(sl_kdtree* Tree, sl_kd_node* Node)
+{
+    vec3f Min = Tree->Points[Node->Begin];
+    vec3f Max = Min;
+    for (i32 i = Node->Begin + 1; i < Node->End; i++)
+    {
+        vec3f P = Tree->Points[i];
+        for (i32 Axis = 0; Axis < 3; Axis++)
+        {
+            if (P.E[Axis] < Min.E[Axis]) Min.E[Axis] = P.E[Axis];
+            if (P.E[Axis] > Max.E[Axis]) Max.E[Axis] = P.E[Axis];
+        }
+    }
+    Node->Min = Min;
+    Node->Max = Max;
+}
+
+internal inline void
+sl_kd_swap(sl_kdtree* Tree, i32 A, i32 B)
+{
+    vec3f P = Tree->Points[A];
+    Tree->Points[A] = Tree->Points[B];
+    Tree->Points[B] = P;
+
+    i32 I = Tree->Index[A];
+    Tree->Index[A] = Tree->Index[B];
+    Tree->Index[B] = I;
+}
+
+// quickselect so the element at Nth is in sorted position along Axis, with
+// everything before it <= and everything after it >=
+internal void
+sl_kd_select(sl_kdtree* Tree, i32 Begin, i32 End, i32 Nth, i32 Axis)
+{
+    vec3f* P = Tree->Points;
+    i32 Lo = Begin, Hi = End - 1;
+    while (Hi > Lo)
+    {
+        // median of three pivot
+        i32 Mid = Lo + (Hi - Lo) / 2;
+        if (P[Mid].E[Axis] < P[Lo].E[Axis]) sl_kd_swap(Tree, Mid, Lo);
+        if (P[Hi].E[Axis] < P[Lo].E[Axis]) sl_kd_swap(Tree, Hi, Lo);
+        if (P[Hi].E[Axis] < P[Mid].E[Axis]) sl_kd_swap(Tree, Hi, Mid);
+        real32 Pivot = P[Mid].E[Axis];
+
+        i32 i = Lo, j = Hi;
+        while (i <= j)
+        {
+            while (P[i].E[Axis] < Pivot) i++;
+            while (P[j].E[Axis] > Pivot) j--;
+            if (i <= j)
+            {
+                sl_kd_swap(Tree, i, j);
+                i++;
+                j--;
+            }
+        }
+
+        if (Nth <= j)
+            Hi = j;
+        else if (Nth >= i)
+            Lo = i;
+        else
+            break;
+    }
+}
+
+// NOTE(scott): the split is always at the middle, so the shape of a subtree
+// only depends on how many points it has.  Sizes at one depth differ by at most
+// one, so this walks down carrying the counts for N and N + 1.
+internal void
+sl_kd_node_counts(i32 N, i32* CountN, i32* CountN1)
+{
+    if (N + 1 <= SL_KDTREE_LEAF_SIZE)
+    {
+        *CountN = 1;
+        *CountN1 = 1;
+        return;
+    }
+    if (N <= SL_KDTREE_LEAF_SIZE)
+    {
+        // N + 1 splits into two leaves
+        *CountN = 1;
+        *CountN1 = 3;
+        return;
+    }
+    i32 Half, HalfPlusOne;
+    sl_kd_node_counts(N / 2, &Half, &HalfPlusOne);
+    if (N % 2 == 0)
+    {
+        *CountN = 1 + 2 * Half;
+        *CountN1 = 1 + Half + HalfPlusOne;
+    }
+    else
+    {
+        *CountN = 1 + Half + HalfPlusOne;
+        *CountN1 = 1 + 2 * HalfPlusOne;
+    }
+}
+
+internal i32
+sl_kd_node_count(i32 N)
+{
+    i32 CountN, CountN1;
+    sl_kd_node_counts(N, &CountN, &CountN1);
+    return CountN;
+}
+
+typedef struct sl_kd_build_job
+{
+    sl_kdtree* Tree;
+    i32 NodeIndex;
+    i32 Begin;
+    i32 End;
+} sl_kd_build_job;
+
+internal void sl_kd_build_job_fn(void* Data);
+
+internal void
+sl_kd_build_node(sl_kdtree* Tree, i32 NodeIndex, i32 Begin, i32 End)
+{
+    sl_kd_node* Node = Tree->Nodes + NodeIndex;
+    Node->Begin = Begin;
+    Node->End = End;
+    Node->Right = 0;
+    sl_kd_compute_bounds(Tree, Node);
+
+    if (End - Begin <= SL_KDTREE_LEAF_SIZE)
+        return;
+
+    i32 Axis = 0;
+    real32 Extent = Node->Max.X - Node->Min.X;
+    if (Node->Max.Y - Node->Min.Y > Extent) { Axis = 1; Extent = Node->Max.Y - Node->Min.Y; }
+    if (Node->Max.Z - Node->Min.Z > Extent) { Axis = 2; }
+
+    i32 Mid = Begin + (End - Begin) / 2;
+    sl_kd_select(Tree, Begin, End, Mid, Axis);
+
+    i32 Right = NodeIndex + 1 + sl_kd_node_count(Mid - Begin);
+    Node->Right = Right;
+
+    // NOTE(scott): the two halves own disjoint points and nodes, so big ones
+    // hand the left half to another thread and build the right one here
+    if (End - Begin >= SL_KDTREE_PARALLEL_MIN)
+    {
+        sl_kd_build_job Left = { Tree, NodeIndex + 1, Begin, Mid };
+        sl_job_counter Done = {0};
+        sl_job_run(sl_kd_build_job_fn, &Left, &Done);
+        sl_kd_build_node(Tree, Right, Mid, End);
+        sl_job_wait(&Done);
+    }
+    else
+    {
+        sl_kd_build_node(Tree, NodeIndex + 1, Begin, Mid);
+        sl_kd_build_node(Tree, Right, Mid, End);
+    }
+}
+
+internal void
+sl_kd_build_job_fn(void* Data)
+{
+    sl_kd_build_job* Job = (sl_kd_build_job*)Data;
+    sl_kd_build_node(Job->Tree, Job->NodeIndex, Job->Begin, Job->End);
+}
+
+sl_kdtree sl_kdtree_build(vec3f* Points)
+{
+    sl_kdtree Tree = {0};
+
+    i32 Count = da_len(Points);
+    if (Count == 0)
+        return Tree;
+
+    Tree.Points = _da_init(Tree.Points, Count);
+    Tree.Index = _da_init(Tree.Index, Count);
+    memcpy(Tree.Points, Points, sizeof(vec3f) * Count);
+    for (i32 i = 0; i < Count; i++)
+        Tree.Index[i] = i;
+    _da_hdr(Tree.Points) = Count;
+    _da_hdr(Tree.Index) = Count;
+
+    i32 NodeCount = sl_kd_node_count(Count);
+    Tree.Nodes = _da_init(Tree.Nodes, NodeCount);
+    _da_hdr(Tree.Nodes) = NodeCount;
+
+    sl_kd_build_node(&Tree, 0, 0, Count);
+
+    return Tree;
+}
+
+void sl_kdtree_free(sl_kdtree* Tree)
+{
+    da_delete(Tree->Nodes);
+    da_delete(Tree->Points);
+    da_delete(Tree->Index);
+    Tree->Nodes = NULL;
+    Tree->Points = NULL;
+    Tree->Index = NULL;
+}
+
+void sl_kdtree_refit(sl_kdtree* Tree, vec3f* Points)
+{
+    i32 Count = da_len(Tree->Points);
+    sl_assert(da_len(Points) == Count);
+
+    for (i32 i = 0; i < Count; i++)
+        Tree->Points[i] = Points[Tree->Index[i]];
+
+    // children always come after their parent, so walking backwards visits
+    // both children before the node that contains them
+    for (i32 i = da_len(Tree->Nodes) - 1; i >= 0; i--)
+    {
+        sl_kd_node* Node = Tree->Nodes + i;
+        if (!Node->Right)
+        {
+            sl_kd_compute_bounds(Tree, Node);
+            continue;
+        }
+
+        sl_kd_node* L = Node + 1;
+        sl_kd_node* R = Tree->Nodes + Node->Right;
+        for (i32 Axis = 0; Axis < 3; Axis++)
+        {
+            Node->Min.E[Axis] = L->Min.E[Axis] < R->Min.E[Axis] ? L->Min.E[Axis] : R->Min.E[Axis];
+            Node->Max.E[Axis] = L->Max.E[Axis] > R->Max.E[Axis] ? L->Max.E[Axis] : R->Max.E[Axis];
+        }
+    }
+}
+
+i32 sl_kdtree_knn(sl_kdtree* Tree, vec3f P, i32 K, i32* OutIndex, real32* OutDistSq)
+{
+    if (K <= 0 || !Tree->Nodes)
+        return 0;
+
+    // NOTE(scott): the K best so far are kept sorted by insertion, fine for
+    // the small K's this gets used with
+    i32 Found = 0;
+    real32 LocalDist[64];
+    real32* Dist = OutDistSq ? OutDistSq : (K <= 64 ? LocalDist : (real32*)malloc(sizeof(real32) * K));
+    real32 Worst = 3.402823466e+38f;
+
+    i32 Stack[SL_KDTREE_MAX_DEPTH * 2];
+    real32 StackDist[SL_KDTREE_MAX_DEPTH * 2];
+    i32 Top = 0;
+    Stack[Top] = 0;
+    StackDist[Top++] = 0.f;
+
+    while (Top)
+    {
+        Top--;
+        if (StackDist[Top] > Worst)
+            continue;
+
+        sl_kd_node* Node = Tree->Nodes + Stack[Top];
+        if (!Node->Right)
+        {
+            for (i32 i = Node->Begin; i < Node->End; i++)
+            {
+                real32 D = sl_kd_dist_sq(P, Tree->Points[i]);
+                if (Found == K && D >= Worst)
+                    continue;
+
+                i32 Slot = (Found < K) ? Found++ : K - 1;
+                while (Slot > 0 && Dist[Slot - 1] > D)
+                {
+                    Dist[Slot] = Dist[Slot - 1];
+                    OutIndex[Slot] = OutIndex[Slot - 1];
+                    Slot--;
+                }
+                Dist[Slot] = D;
+                OutIndex[Slot] = Tree->Index[i];
+
+                if (Found == K)
+                    Worst = Dist[K - 1];
+            }
+            continue;
+        }
+
+        // push the far child first so the near one is searched first
+        i32 Near = Stack[Top] + 1;
+        i32 Far = Node->Right;
+        real32 NearDist = sl_kd_box_dist_sq(Tree->Nodes + Near, P);
+        real32 FarDist = sl_kd_box_dist_sq(Tree->Nodes + Far, P);
+        if (FarDist < NearDist)
+        {
+            i32 T = Near; Near = Far; Far = T;
+            real32 TD = NearDist; NearDist = FarDist; FarDist = TD;
+        }
+
+        if (FarDist <= Worst)
+        {
+            Stack[Top] = Far;
+            StackDist[Top++] = FarDist;
+        }
+        if (NearDist <= Worst)
+        {
+            Stack[Top] = Near;
+            StackDist[Top++] = NearDist;
+        }
+    }
+
+    if (Dist != OutDistSq && Dist != LocalDist)
+        free(Dist);
+
+    return Found;
+}
+
+i32 sl_kdtree_nearest(sl_kdtree* Tree, vec3f P, real32* OutDistSq)
+{
+    i32 Result = -1;
+    real32 DistSq = 0.f;
+    sl_kdtree_knn(Tree, P, 1, &Result, &DistSq);
+    if (OutDistSq)
+        *OutDistSq = DistSq;
+    return Result;
+}
+
+void sl_kdtree_radius(sl_kdtree* Tree, vec3f P, real32 Radius, i32** Out)
+{
+    if (!Tree->Nodes)
+        return;
+
+    real32 RadiusSq = Radius * Radius;
+
+    i32 Stack[SL_KDTREE_MAX_DEPTH * 2];
+    i32 Top = 0;
+    Stack[Top++] = 0;
+
+    while (Top)
+    {
+        i32 NodeIndex = Stack[--Top];
+        sl_kd_node* Node = Tree->Nodes + NodeIndex;
+        if (sl_kd_box_dist_sq(Node, P) > RadiusSq)
+            continue;
+
+        // whole box inside the sphere, take everything without testing
+        if (sl_kd_box_max_dist_sq(Node, P) <= RadiusSq)
+        {
+            for (i32 i = Node->Begin; i < Node->End; i++)
+            {
+                da_append(*Out, Tree->Index[i]);
+            }
+            continue;
+        }
+
+        if (!Node->Right)
+        {
+            for (i32 i = Node->Begin; i < Node->End; i++)
+            {
+                if (sl_kd_dist_sq(P, Tree->Points[i]) <= RadiusSq)
+                {
+                    da_append(*Out, Tree->Index[i]);
+                }
+            }
+            continue;
+        }
+
+        Stack[Top++] = Node->Right;
+        Stack[Top++] = NodeIndex + 1;
+    }
+}
+
+void sl_kdtree_box(sl_kdtree* Tree, vec3f Min, vec3f Max, i32** Out)
+{
+    if (!Tree->Nodes)
+        return;
+
+    i32 Stack[SL_KDTREE_MAX_DEPTH * 2];
+    i32 Top = 0;
+    Stack[Top++] = 0;
+
+    while (Top)
+    {
+        i32 NodeIndex = Stack[--Top];
+        sl_kd_node* Node = Tree->Nodes + NodeIndex;
+
+        if (Node->Max.X < Min.X || Node->Min.X > Max.X ||
+            Node->Max.Y < Min.Y || Node->Min.Y > Max.Y ||
+            Node->Max.Z < Min.Z || Node->Min.Z > Max.Z)
+            continue;
+
+        bool Contained = Node->Min.X >= Min.X && Node->Max.X <= Max.X &&
+            Node->Min.Y >= Min.Y && Node->Max.Y <= Max.Y &&
+            Node->Min.Z >= Min.Z && Node->Max.Z <= Max.Z;
+
+        if (Contained || !Node->Right)
+        {
+            for (i32 i = Node->Begin; i < Node->End; i++)
+            {
+                vec3f Q = Tree->Points[i];
+                if (Contained ||
+                    (Q.X >= Min.X && Q.X <= Max.X &&
+                     Q.Y >= Min.Y && Q.Y <= Max.Y &&
+                     Q.Z >= Min.Z && Q.Z <= Max.Z))
+                {
+                    da_append(*Out, Tree->Index[i]);
+                }
+            }
+            continue;
+        }
+
+        Stack[Top++] = Node->Right;
+        Stack[Top++] = NodeIndex + 1;
+    }
+}
+
+void sl_kdtree_knn_batch(sl_kdtree* Tree, vec3f* Queries, i32 QueryCount, i32 K,
+                         i32* OutIndex, real32* OutDistSq)
+{
+    for (i32 q = 0; q < QueryCount; q++)
+    {
+        i32* Index = OutIndex + q * K;
+        real32* Dist = OutDistSq ? OutDistSq + q * K : NULL;
+
+        i32 Found = sl_kdtree_knn(Tree, Queries[q], K, Index, Dist);
+        for (i32 i = Found; i < K; i++)
+        {
+            Index[i] = -1;
+            if (Dist)
+                Dist[i] = 0.f;
+        }
+    }
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_KDTREE_IMPL
+
+#endif // SL_KDTREE_H
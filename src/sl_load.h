@@ -0,0 +1,342 @@
+#ifndef SL_LOAD_H
+#define SL_LOAD_H
+
+//
+// Parallel tuple loading
+//
+// sl_parse_tuples() on every core.  The text is cut into chunks that start on
+// a line outside braces, each chunk is parsed as a job into its own dyn_array,
+// and the chunk arrays are copied in order into the output with one parallel
+// pass:
+//
+//     sl_job_init(0);
+//
+//     vec3f* Points = NULL;
+//     sl_parse_error Error;
+//     if (sl_load_tuples_file_da("points.txt", 3, Points, &Error) != 0)
+//         printf("points.txt:%d:%d: %s\n", Error.Line, Error.Column, Error.Message);
+//
+// The file is mapped rather than read, and each job finds where its own chunk
+// starts, so nothing waits for the whole file to be in memory before parsing
+// starts.  sl_load_tuples() does the same for text that's already in memory.
+//
+// The result and the errors are the same as sl_parse_tuples() on the whole
+// text, braced tuples that run over several lines included.
+//
+// Without sl_job_init() everything runs on the calling thread.
+//
+// C compatible.  Define SL_LOAD_IMPL in one file before including this to get the
+// implementation.  Needs sl_parse.h (and so sl_cpu.h), sl_job.h and dyn_array.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+#include "sl_parse.h"
+#include "sl_job.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// bytes per job, big enough that a chunk is worth a job and small enough that
+// there are plenty of them to go round
+#ifndef SL_LOAD_CHUNK_SIZE
+#define SL_LOAD_CHUNK_SIZE (1024 * 1024)
+#endif
+
+int sl_load_tuples(const char* Text, size_t Length, int Width, void** List, int ElementSize, sl_parse_error* Error);
+int sl_load_tuples_file(const char* Path, int Width, void** List, int ElementSize, sl_parse_error* Error);
+
+#define sl_load_tuples_da(Text, Length, Width, List, Error) \
+    sl_load_tuples((Text), (Length), (Width), (void**)&(List), (int)sizeof(*(List)), (Error))
+
+#define sl_load_tuples_file_da(Path, Width, List, Error) \
+    sl_load_tuples_file((Path), (Width), (void**)&(List), (int)sizeof(*(List)), (Error))
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_LOAD_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_load_chunk
+{
+    const char* Base;       // the whole text
+    const char* End;
+    size_t From;            // where the chunk would start and stop if tuples
+    size_t To;              // never ran over a line, the job finds the real cuts
+    const char* Text;       // what the job parsed
+    size_t Length;
+    int Width;
+    int ElementSize;
+    void* List;             // this chunk's tuples
+    int Start;              // where they go in the output
+    int Failed;
+    sl_parse_error Error;
+    char* Output;
+} sl_load_chunk;
+
+// NOTE(scott): the real start of a chunk is the first line start at or after
+// From that's outside braces.  Knowing the brace depth for sure means reading
+// everything before it, so this guesses from what comes next instead: if the
+// first brace is a '{' we started outside one, if it's a '}' we were inside a
+// tuple and the chunk starts on the first line after it closes.  Comment lines
+// are skipped since they can hold braces.  For text that parses the guess is
+// always right; sl_load_tuples() checks it anyway.  The search gives up after a
+// chunk's worth of text with no braces and takes the first line start.
+static const char*
+sl_load_chunk_start(const char* From, const char* End)
+{
+    const char* Newline = (const char*)memchr(From, '\n', (size_t)(End - From));
+    if (!Newline)
+        return End;
+    const char* Start = Newline + 1;
+    const char* Limit = (size_t)(End - Start) > SL_LOAD_CHUNK_SIZE ? Start + SL_LOAD_CHUNK_SIZE : End;
+
+    int Inside = -1;        // not known until the first brace
+    int LineStart = 1;
+    for (const char* P = Start; P < Limit; P++)
+    {
+        char c = *P;
+        if (c == '\n')
+        {
+            if (!Inside)
+                return P + 1;
+            LineStart = 1;
+        }
+        else if ((c == '#' || c == ';') && LineStart && Inside != 1)
+        {
+            const char* Eol = (const char*)memchr(P, '\n', (size_t)(Limit - P));
+            if (!Eol)
+                break;
+            P = Eol - 1;
+        }
+        else if (c == '{' || c == '}')
+        {
+            if (c == '{' && Inside < 0)
+                return Start;
+            Inside = c == '{';
+            LineStart = 0;
+        }
+        else if (c != ' ' && c != ',' && c != '\t' && c != '\r')
+        {
+            LineStart = 0;
+        }
+    }
+    return Start;
+}
+
+static void
+sl_load_parse_chunk(void* Data)
+{
+    sl_load_chunk* Chunk = (sl_load_chunk*)Data;
+    const char* Begin = Chunk->From ? sl_load_chunk_start(Chunk->Base + Chunk->From, Chunk->End) : Chunk->Base;
+    const char* Stop = (Chunk->Base + Chunk->To < Chunk->End) ? sl_load_chunk_start(Chunk->Base + Chunk->To, Chunk->End) : Chunk->End;
+    if (Stop < Begin)
+        Stop = Begin;
+
+    Chunk->Text = Begin;
+    Chunk->Length = (size_t)(Stop - Begin);
+    Chunk->Failed = sl_parse_tuples(Chunk->Text, Chunk->Length, Chunk->Width, &Chunk->List,
+                                    Chunk->ElementSize, &Chunk->Error) != 0;
+}
+
+static void
+sl_load_copy_chunks(void* Array, int Begin, int End, void* UserData)
+{
+    sl_load_chunk* Chunks = (sl_load_chunk*)Array;
+    for (int i = Begin; i < End; i++)
+    {
+        sl_load_chunk* Chunk = Chunks + i;
+        size_t Size = (size_t)da_len(Chunk->List) * (size_t)Chunk->ElementSize;
+        if (Size)
+            memcpy(Chunk->Output + (size_t)Chunk->Start * (size_t)Chunk->ElementSize, Chunk->List, Size);
+    }
+}
+
+int sl_load_tuples(const char* Text, size_t Length, int Width, void** List, int ElementSize, sl_parse_error* Error)
+{
+    // NOTE(scott): one chunk is just the serial parse, skip the bookkeeping
+    if (Length <= SL_LOAD_CHUNK_SIZE || sl_job_thread_count() == 1)
+        return sl_parse_tuples(Text, Length, Width, List, ElementSize, Error);
+
+    // every job finds its own cuts, so parsing starts with the first job and
+    // nothing reads the whole text up front
+    int Count = (int)((Length + SL_LOAD_CHUNK_SIZE - 1) / SL_LOAD_CHUNK_SIZE);
+    sl_load_chunk* Chunks = (sl_load_chunk*)calloc((size_t)Count, sizeof(sl_load_chunk));
+    sl_job_counter Parsed = {0};
+    for (int i = 0; i < Count; i++)
+    {
+        sl_load_chunk* Chunk = Chunks + i;
+        Chunk->Base = Text;
+        Chunk->End = Text + Length;
+        Chunk->From = (size_t)i * SL_LOAD_CHUNK_SIZE;
+        Chunk->To = (size_t)(i + 1) * SL_LOAD_CHUNK_SIZE;
+        Chunk->Width = Width;
+        Chunk->ElementSize = ElementSize;
+        sl_job_run(sl_load_parse_chunk, Chunk, &Parsed);
+    }
+    sl_job_wait(&Parsed);
+
+    // NOTE(scott): a chunk's start is only known to be right once every chunk
+    // before it has parsed: a cut inside a tuple leaves the chunk before it with
+    // a missing '}'.  The first chunk that failed, or that doesn't stop where the
+    // next one starts, is parsed again from its start to the end of the text,
+    // which is what a serial parse would do from there.  For text that parses
+    // that never happens, and for text that doesn't it stops at the error.
+    int Used = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        sl_load_chunk* Chunk = Chunks + i;
+        Used++;
+        int Seam = i + 1 < Count && Chunks[i + 1].Text != Chunk->Text + Chunk->Length;
+        if (Chunk->Failed || Seam)
+        {
+            if (i + 1 < Count)
+            {
+                da_delete(Chunk->List);
+                Chunk->List = NULL;
+                Chunk->Length = (size_t)(Text + Length - Chunk->Text);
+                Chunk->Failed = sl_parse_tuples(Chunk->Text, Chunk->Length, Width, &Chunk->List,
+                                                ElementSize, &Chunk->Error) != 0;
+            }
+            break;
+        }
+    }
+
+    // lay the chunks out in order, stopping after the first one that failed so
+    // the output matches what a serial parse would have kept
+    int First = da_len(*List);
+    int Total = First;
+    int Failed = Chunks[Used - 1].Failed ? Used - 1 : -1;
+    for (int i = 0; i < Used; i++)
+    {
+        Chunks[i].Start = Total;
+        Total += da_len(Chunks[i].List);
+    }
+
+    if (Total > First)
+    {
+        if (Total > da_cap(*List))
+            *List = _da_resize(*List, (size_t)ElementSize, (size_t)Total);
+        for (int i = 0; i < Used; i++)
+            Chunks[i].Output = (char*)*List;
+        sl_parallel_for_range(Chunks, Used, 1, sl_load_copy_chunks, NULL);
+        _da_hdr(*List) = Total;
+    }
+
+    if (Failed >= 0 && Error)
+    {
+        // chunk errors are relative to the chunk, move them to the whole text
+        sl_load_chunk* Chunk = Chunks + Failed;
+        size_t Before = (size_t)(Chunk->Text - Text);
+        int Lines = 0;
+        for (const char* Q = Text; (Q = (const char*)memchr(Q, '\n', (size_t)(Chunk->Text - Q))) != NULL; Q++)
+            Lines++;
+
+        *Error = Chunk->Error;
+        Error->Offset += Before;
+        Error->Line += Lines;
+    }
+
+    for (int i = 0; i < Count; i++)
+    {
+        da_delete(Chunks[i].List);
+    }
+    free(Chunks);
+
+    return Failed >= 0 ? -1 : 0;
+}
+
+int sl_load_tuples_file(const char* Path, int Width, void** List, int ElementSize, sl_parse_error* Error)
+{
+    const char* Text = NULL;
+    size_t Length = 0;
+
+#if defined(_WIN32)
+    HANDLE File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER FileSize;
+    HANDLE Mapping = NULL;
+    if (File != INVALID_HANDLE_VALUE && GetFileSizeEx(File, &FileSize))
+    {
+        Length = (size_t)FileSize.QuadPart;
+        Mapping = Length ? CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+        if (Mapping)
+            Text = (const char*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    int Opened = File != INVALID_HANDLE_VALUE && (!Length || Text);
+    if (Mapping)
+        CloseHandle(Mapping);
+    if (File != INVALID_HANDLE_VALUE)
+        CloseHandle(File);
+#else
+    int File = open(Path, O_RDONLY);
+    struct stat Stat;
+    int Opened = File >= 0 && fstat(File, &Stat) == 0;
+    if (Opened && Stat.st_size > 0)
+    {
+        Length = (size_t)Stat.st_size;
+        void* Base = mmap(NULL, Length, PROT_READ, MAP_PRIVATE, File, 0);
+        if (Base == MAP_FAILED)
+            Opened = 0;
+        else
+        {
+            madvise(Base, Length, MADV_SEQUENTIAL);
+            Text = (const char*)Base;
+        }
+    }
+    if (File >= 0)
+        close(File);
+#endif
+
+    if (!Opened)
+    {
+        if (Error)
+        {
+            memset(Error, 0, sizeof(*Error));
+            Error->Message = "couldn't open the file";
+        }
+        return -1;
+    }
+    if (!Length)
+        return 0;
+
+    int Result = sl_load_tuples(Text, Length, Width, List, ElementSize, Error);
+
+#if defined(_WIN32)
+    UnmapViewOfFile(Text);
+#else
+    munmap((void*)Text, Length);
+#endif
+    return Result;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_LOAD_IMPL
+
+#endif // SL_LOAD_H
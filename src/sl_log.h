@@ -0,0 +1,800 @@
+#ifndef SL_LOG_H
+#define SL_LOG_H
+
+//
+// Logging with deferred formatting
+//
+// A log call doesn't format anything.  It copies the format string pointer, a
+// timestamp and the raw argument values into a ring buffer owned by the calling
+// thread and returns.  A background thread drains every thread's buffer in
+// timestamp order, does the printf style formatting and writes the result with
+// buffered I/O.  The hot path never takes a lock, never calls into stdio and
+// never makes a syscall.
+//
+//     sl_log_init(stderr);
+//     SL_LOG_INFO("loaded %s in %.2f ms", Path, Ms);
+//     SL_LOG_WARN("camera at %v looking along %.3v", Position, Forward);
+//     sl_log_shutdown();                          // flushes and joins
+//
+// Formats are printf's, plus %v for vec2f / vec3f / vec4f / quat which prints
+// "{ x, y, z }" using the precision given (6 by default).  Arguments are typed at
+// compile time, so a mismatch like an int printed with %f is converted rather
+// than read as garbage.  '*' widths aren't supported.
+//
+// The format must be a string literal (or otherwise outlive the logger); only
+// the pointer is stored.  String arguments are copied, up to SL_LOG_MAX_STRING
+// bytes.
+//
+// When a thread's buffer is full the message is dropped and counted instead of
+// waiting; the writer reports how many went missing.  A thread's buffer is
+// freed once the thread has exited and everything in it has been written.  Before sl_log_init() or
+// after sl_log_shutdown() messages are formatted and written to stderr right
+// away, so logging is always safe to call.  A message logged on another thread
+// while shutdown is running can be lost.
+//
+// Needs sl.h (for the vector types) and C++11 variadic templates.  Define
+// SL_LOG_IMPL in one file before including this to get the implementation.
+//
+
+#include "sl.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef SL_LOG_BUFFER_SIZE
+#define SL_LOG_BUFFER_SIZE (64 * 1024)      // per thread, power of two
+#endif
+
+#ifndef SL_LOG_MAX_STRING
+#define SL_LOG_MAX_STRING 512
+#endif
+
+enum sl_log_level
+{
+    SL_LOG_LEVEL_DEBUG,
+    SL_LOG_LEVEL_INFO,
+    SL_LOG_LEVEL_WARN,
+    SL_LOG_LEVEL_ERROR,
+};
+
+// starts the writer thread, Out stays open until shutdown
+void sl_log_init(FILE* Out);
+void sl_log_shutdown();
+
+// blocks until everything logged so far has been written
+void sl_log_flush();
+
+// messages below Level are thrown away on the calling thread
+void sl_log_set_level(sl_log_level Level);
+
+// messages dropped because a thread's buffer was full
+u64 sl_log_dropped_count();
+
+#define SL_LOG_DEBUG(...)   sl_log(SL_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define SL_LOG_INFO(...)    sl_log(SL_LOG_LEVEL_INFO, __VA_ARGS__)
+#define SL_LOG_WARN(...)    sl_log(SL_LOG_LEVEL_WARN, __VA_ARGS__)
+#define SL_LOG_ERROR(...)   sl_log(SL_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+//
+// Record encoding
+//
+// NOTE(scott): a record is a header followed by one tagged slot per argument.
+// Every slot is a multiple of 8 bytes so the next header is always aligned.
+//
+
+enum sl_log_arg_type
+{
+    SL_LOG_ARG_INT,
+    SL_LOG_ARG_UINT,
+    SL_LOG_ARG_REAL,
+    SL_LOG_ARG_STRING,
+    SL_LOG_ARG_POINTER,
+    SL_LOG_ARG_VEC2,
+    SL_LOG_ARG_VEC3,
+    SL_LOG_ARG_VEC4,
+};
+
+typedef struct sl_log_record
+{
+    u32 Size;               // whole record in bytes, 0 marks a wrap to the start of the buffer
+    u16 ArgCount;
+    u8 Level;
+    u8 Unused;
+    u64 Time;               // ns
+    const char* Format;
+} sl_log_record;
+
+// hands back Size bytes of the calling thread's buffer, NULL when it's full
+u8* sl_log_reserve(u32 Size);
+void sl_log_commit(u32 Size);
+
+// formats straight to the output, used before init / after shutdown
+void sl_log_write_now(u8* Record);
+
+bool sl_log_enabled(sl_log_level Level);
+u64 sl_log_now();
+
+inline u32 sl_log_arg_size(i64) { return 16; }
+inline u32 sl_log_arg_size(u64) { return 16; }
+inline u32 sl_log_arg_size(real64) { return 16; }
+inline u32 sl_log_arg_size(const void*) { return 16; }
+inline u32 sl_log_arg_size(vec2f) { return 16; }
+inline u32 sl_log_arg_size(vec3f) { return 24; }
+inline u32 sl_log_arg_size(vec4f) { return 24; }
+inline u32 sl_log_arg_size(const char* S)
+{
+    size_t Length = S ? strlen(S) : 0;
+    if (Length > SL_LOG_MAX_STRING)
+        Length = SL_LOG_MAX_STRING;
+    return 8 + ((cast(u32)Length + 8) & ~7u);
+}
+
+inline u8* sl_log_put_tag(u8* At, sl_log_arg_type Type, u32 Extra = 0)
+{
+    u32 Tag[2] = { cast(u32)Type, Extra };
+    memcpy(At, Tag, 8);
+    return At + 8;
+}
+
+inline u8* sl_log_put(u8* At, i64 V) { At = sl_log_put_tag(At, SL_LOG_ARG_INT); memcpy(At, &V, 8); return At + 8; }
+inline u8* sl_log_put(u8* At, u64 V) { At = sl_log_put_tag(At, SL_LOG_ARG_UINT); memcpy(At, &V, 8); return At + 8; }
+inline u8* sl_log_put(u8* At, real64 V) { At = sl_log_put_tag(At, SL_LOG_ARG_REAL); memcpy(At, &V, 8); return At + 8; }
+inline u8* sl_log_put(u8* At, const void* V) { At = sl_log_put_tag(At, SL_LOG_ARG_POINTER); memcpy(At, &V, sizeof(V)); return At + 8; }
+inline u8* sl_log_put(u8* At, vec2f V) { At = sl_log_put_tag(At, SL_LOG_ARG_VEC2); memcpy(At, &V, 8); return At + 8; }
+inline u8* sl_log_put(u8* At, vec3f V) { At = sl_log_put_tag(At, SL_LOG_ARG_VEC3); memcpy(At, &V, 12); return At + 16; }
+inline u8* sl_log_put(u8* At, vec4f V) { At = sl_log_put_tag(At, SL_LOG_ARG_VEC4); memcpy(At, &V, 16); return At + 16; }
+inline u8* sl_log_put(u8* At, const char* S)
+{
+    u32 Length = S ? cast(u32)strlen(S) : 0;
+    if (Length > SL_LOG_MAX_STRING)
+        Length = SL_LOG_MAX_STRING;
+    At = sl_log_put_tag(At, SL_LOG_ARG_STRING, Length);
+    if (Length)
+        memcpy(At, S, Length);
+    memset(At + Length, 0, ((Length + 8) & ~7u) - Length);
+    return At + ((Length + 8) & ~7u);
+}
+
+// NOTE(scott): everything funnels into the handful of stored types above
+template <typename T> struct sl_log_stored { typedef T type; };
+template <> struct sl_log_stored<bool> { typedef i64 type; };
+template <> struct sl_log_stored<char> { typedef i64 type; };
+template <> struct sl_log_stored<signed char> { typedef i64 type; };
+template <> struct sl_log_stored<short> { typedef i64 type; };
+template <> struct sl_log_stored<int> { typedef i64 type; };
+template <> struct sl_log_stored<long> { typedef i64 type; };
+template <> struct sl_log_stored<long long> { typedef i64 type; };
+template <> struct sl_log_stored<unsigned char> { typedef u64 type; };
+template <> struct sl_log_stored<unsigned short> { typedef u64 type; };
+template <> struct sl_log_stored<unsigned int> { typedef u64 type; };
+template <> struct sl_log_stored<unsigned long> { typedef u64 type; };
+template <> struct sl_log_stored<unsigned long long> { typedef u64 type; };
+template <> struct sl_log_stored<float> { typedef real64 type; };
+template <> struct sl_log_stored<double> { typedef real64 type; };
+template <> struct sl_log_stored<char*> { typedef const char* type; };
+template <> struct sl_log_stored<quat> { typedef vec4f type; };
+template <typename T> struct sl_log_stored<T*> { typedef const void* type; };
+template <typename T> struct sl_log_stored<const T*> { typedef const void* type; };
+template <> struct sl_log_stored<const char*> { typedef const char* type; };
+template <size_t N> struct sl_log_stored<char[N]> { typedef const char* type; };
+template <size_t N> struct sl_log_stored<const char[N]> { typedef const char* type; };
+
+template <typename T>
+inline typename sl_log_stored<T>::type sl_log_store(const T& V)
+{
+    return (typename sl_log_stored<T>::type)V;
+}
+
+inline vec4f sl_log_store(const quat& Q)
+{
+    vec4f Result = { Q.x, Q.y, Q.z, Q.w };
+    return Result;
+}
+
+inline u32 sl_log_args_size() { return 0; }
+template <typename T, typename... Rest>
+inline u32 sl_log_args_size(const T& First, const Rest&... Others)
+{
+    return sl_log_arg_size(sl_log_store(First)) + sl_log_args_size(Others...);
+}
+
+inline u8* sl_log_put_args(u8* At) { return At; }
+template <typename T, typename... Rest>
+inline u8* sl_log_put_args(u8* At, const T& First, const Rest&... Others)
+{
+    return sl_log_put_args(sl_log_put(At, sl_log_store(First)), Others...);
+}
+
+template <typename... Args>
+void sl_log(sl_log_level Level, const char* Format, const Args&... Arguments)
+{
+    if (!sl_log_enabled(Level))
+        return;
+
+    u32 Size = cast(u32)sizeof(sl_log_record) + sl_log_args_size(Arguments...);
+    u8* Buffer = sl_log_reserve(Size);
+    if (!Buffer)
+        return;
+
+    sl_log_record Header;
+    Header.Size = Size;
+    Header.ArgCount = cast(u16)sizeof...(Args);
+    Header.Level = cast(u8)Level;
+    Header.Unused = 0;
+    Header.Time = sl_log_now();
+    Header.Format = Format;
+    memcpy(Buffer, &Header, sizeof(Header));
+    sl_log_put_args(Buffer + sizeof(Header), Arguments...);
+
+    sl_log_commit(Size);
+}
+
+//
+// Implementation
+//
+#ifdef SL_LOG_IMPL
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define sl_log_load(p)              (_ReadWriteBarrier(), *(p))
+#define sl_log_store_release(p, v)  (_ReadWriteBarrier(), *(p) = (v))
+#define sl_log_cas_ptr(p, e, d)     (InterlockedCompareExchangePointer((PVOID volatile*)(p), (d), (e)) == (e))
+#define sl_log_add(p, v)            InterlockedExchangeAdd64((volatile LONG64*)(p), (v))
+#else
+#define sl_log_load(p)              __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define sl_log_store_release(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define sl_log_cas_ptr(p, e, d)     __sync_bool_compare_and_swap((p), (e), (d))
+#define sl_log_add(p, v)            __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#endif
+
+SL_STATIC_ASSERT((SL_LOG_BUFFER_SIZE & (SL_LOG_BUFFER_SIZE - 1)) == 0);
+
+// NOTE(scott): single producer (the owning thread), single consumer (the
+// writer).  Write and Read only ever grow; the offset into Data is the low bits.
+typedef struct sl_log_buffer
+{
+    struct sl_log_buffer* Next;
+    volatile int Retired;           // the owning thread has exited
+    u8 Pad0[64 - sizeof(void*) - sizeof(int)];
+    volatile u64 Write;
+    u8 Pad1[64 - sizeof(u64)];
+    volatile u64 Read;
+    u8 Pad2[64 - sizeof(u64)];
+    u8 Data[SL_LOG_BUFFER_SIZE];
+} sl_log_buffer;
+
+global sl_log_buffer* volatile sl_log_buffers;
+global SL_THREAD_LOCAL sl_log_buffer* sl_log_thread_buffer;
+global SL_THREAD_LOCAL u64 sl_log_pending_write;
+global volatile int sl_log_min_level;
+global volatile int sl_log_running;
+global volatile int sl_log_quit;
+global volatile u64 sl_log_dropped;
+global volatile u64 sl_log_dropped_reported;
+global volatile u64 sl_log_flushed;         // drains done, bumped after each one's fflush
+global FILE* sl_log_out;
+global u64 sl_log_start;
+
+#if defined(_WIN32)
+global HANDLE sl_log_thread;
+global DWORD sl_log_key;
+#else
+global pthread_t sl_log_thread;
+global pthread_key_t sl_log_key;
+#endif
+global bool sl_log_key_made;
+
+u64 sl_log_now()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER Counter, Frequency;
+    QueryPerformanceCounter(&Counter);
+    QueryPerformanceFrequency(&Frequency);
+    return cast(u64)((real64)Counter.QuadPart * 1e9 / (real64)Frequency.QuadPart);
+#else
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return cast(u64)Now.tv_sec * 1000000000ull + cast(u64)Now.tv_nsec;
+#endif
+}
+
+internal void
+sl_log_sleep_ms(int Ms)
+{
+#if defined(_WIN32)
+    Sleep(Ms);
+#else
+    struct timespec Duration = { 0, Ms * 1000000L };
+    nanosleep(&Duration, 0);
+#endif
+}
+
+bool sl_log_enabled(sl_log_level Level)
+{
+    return cast(int)Level >= sl_log_min_level;
+}
+
+void sl_log_set_level(sl_log_level Level)
+{
+    sl_log_min_level = cast(int)Level;
+}
+
+// NOTE(scott): runs on a logging thread as it exits.  The writer frees the
+// buffer once it has drained it, and if a later destructor on this thread logs
+// again it gets a new one.
+#if defined(_WIN32)
+internal VOID WINAPI
+#else
+internal void
+#endif
+sl_log_thread_exit(void* Data)
+{
+    sl_log_buffer* Buffer = cast(sl_log_buffer*)Data;
+    if (sl_log_thread_buffer == Buffer)
+        sl_log_thread_buffer = 0;
+    sl_log_store_release(&Buffer->Retired, 1);
+}
+
+internal sl_log_buffer*
+sl_log_thread_init()
+{
+    sl_log_buffer* Buffer = cast(sl_log_buffer*)calloc(1, sizeof(sl_log_buffer));
+
+    sl_log_buffer* Head;
+    do
+    {
+        Head = sl_log_load(&sl_log_buffers);
+        Buffer->Next = Head;
+    } while (!sl_log_cas_ptr(&sl_log_buffers, Head, Buffer));
+
+#if defined(_WIN32)
+    FlsSetValue(sl_log_key, Buffer);
+#else
+    pthread_setspecific(sl_log_key, Buffer);
+#endif
+    sl_log_thread_buffer = Buffer;
+    return Buffer;
+}
+
+// NOTE(scott): before init and after shutdown there's no writer to drain the
+// ring, so records go to a thread local scratch record and get written out on
+// commit
+global SL_THREAD_LOCAL u64 sl_log_direct[(sizeof(sl_log_record) + 64 * 24 + SL_LOG_MAX_STRING * 8) / 8];
+global SL_THREAD_LOCAL bool sl_log_is_direct;
+
+u8* sl_log_reserve(u32 Size)
+{
+    if (!sl_log_load(&sl_log_running))
+    {
+        if (Size > sizeof(sl_log_direct))
+            return 0;
+        sl_log_is_direct = true;
+        return cast(u8*)sl_log_direct;
+    }
+    sl_log_is_direct = false;
+
+    sl_log_buffer* Buffer = sl_log_thread_buffer;
+    if (!Buffer)
+        Buffer = sl_log_thread_init();
+
+    u64 Write = Buffer->Write;
+    u64 Read = sl_log_load(&Buffer->Read);
+    u64 Offset = Write & (SL_LOG_BUFFER_SIZE - 1);
+
+    // records never straddle the end, a zero size marker sends the reader back
+    // to the start
+    u64 Skip = (Offset + Size > SL_LOG_BUFFER_SIZE) ? SL_LOG_BUFFER_SIZE - Offset : 0;
+    if (Size > SL_LOG_BUFFER_SIZE / 2 || (Write + Skip + Size) - Read > SL_LOG_BUFFER_SIZE)
+    {
+        sl_log_add(&sl_log_dropped, 1);
+        return 0;
+    }
+
+    if (Skip)
+    {
+        u32 Marker = 0;
+        memcpy(Buffer->Data + Offset, &Marker, sizeof(Marker));
+        Write += Skip;
+    }
+
+    sl_log_pending_write = Write;
+    return Buffer->Data + (Write & (SL_LOG_BUFFER_SIZE - 1));
+}
+
+void sl_log_commit(u32 Size)
+{
+    if (sl_log_is_direct)
+    {
+        sl_log_write_now(cast(u8*)sl_log_direct);
+        return;
+    }
+
+    // publish after the record is written so the writer never sees half of it
+    sl_log_store_release(&sl_log_thread_buffer->Write, sl_log_pending_write + Size);
+}
+
+u64 sl_log_dropped_count()
+{
+    return sl_log_load(&sl_log_dropped);
+}
+
+//
+// Formatting
+//
+
+typedef struct sl_log_line
+{
+    char* At;
+    char* End;
+} sl_log_line;
+
+internal void
+sl_log_append(sl_log_line* Line, const char* Format, ...)
+{
+    va_list Args;
+    va_start(Args, Format);
+    int Written = vsnprintf(Line->At, Line->End - Line->At, Format, Args);
+    va_end(Args);
+
+    if (Written > 0)
+        Line->At += (Written < Line->End - Line->At) ? Written : (Line->End - Line->At) - 1;
+}
+
+internal const char*
+sl_log_level_name(int Level)
+{
+    switch (Level)
+    {
+        case SL_LOG_LEVEL_DEBUG: return "DEBUG";
+        case SL_LOG_LEVEL_INFO:  return "INFO ";
+        case SL_LOG_LEVEL_WARN:  return "WARN ";
+        case SL_LOG_LEVEL_ERROR: return "ERROR";
+    }
+    return "?    ";
+}
+
+// NOTE(scott): walks the printf format, and for every conversion rebuilds the
+// spec with the length modifier that matches the stored argument type
+internal int
+sl_log_format(u8* Record, char* Out, int OutSize)
+{
+    sl_log_record Header;
+    memcpy(&Header, Record, sizeof(Header));
+    u8* Arg = Record + sizeof(Header);
+    u8* ArgEnd = Record + Header.Size;
+
+    sl_log_line Line = { Out, Out + OutSize };
+    sl_log_append(&Line, "[%12.6f] %s ", (real64)(Header.Time - sl_log_start) * 1e-9, sl_log_level_name(Header.Level));
+
+    for (const char* c = Header.Format; *c && Line.At < Line.End - 1; c++)
+    {
+        if (*c != '%')
+        {
+            *Line.At++ = *c;
+            continue;
+        }
+        if (c[1] == '%')
+        {
+            *Line.At++ = '%';
+            c++;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion
+        char Spec[32];
+        int SpecLength = 0;
+        Spec[SpecLength++] = '%';
+        c++;
+        while (*c && strchr("-+ #0", *c) && SpecLength < 8)
+            Spec[SpecLength++] = *c++;
+        while (*c >= '0' && *c <= '9' && SpecLength < 16)
+            Spec[SpecLength++] = *c++;
+        int Precision = -1;
+        if (*c == '.')
+        {
+            Spec[SpecLength++] = *c++;
+            Precision = 0;
+            while (*c >= '0' && *c <= '9' && SpecLength < 24)
+            {
+                Precision = Precision * 10 + (*c - '0');
+                Spec[SpecLength++] = *c++;
+            }
+        }
+        while (*c && strchr("hljztL", *c))
+            c++;
+        char Conversion = *c;
+        if (!Conversion)
+            break;
+
+        if (Arg >= ArgEnd)
+        {
+            sl_log_append(&Line, "(missing)");
+            continue;
+        }
+
+        u32 Tag[2];
+        memcpy(Tag, Arg, 8);
+        u8* Value = Arg + 8;
+        Arg += 8 + ((Tag[0] == SL_LOG_ARG_STRING) ? ((Tag[1] + 8) & ~7u) :
+                    (Tag[0] == SL_LOG_ARG_VEC3 || Tag[0] == SL_LOG_ARG_VEC4) ? 16 : 8);
+
+        i64 Int = 0;
+        real64 Real = 0;
+        real32 Vec[4] = { 0, 0, 0, 0 };
+        int VecCount = 0;
+        switch (Tag[0])
+        {
+            case SL_LOG_ARG_INT:    memcpy(&Int, Value, 8); Real = (real64)Int; break;
+            case SL_LOG_ARG_UINT:   memcpy(&Int, Value, 8); Real = (real64)(u64)Int; break;
+            case SL_LOG_ARG_REAL:   memcpy(&Real, Value, 8); Int = (i64)Real; break;
+            case SL_LOG_ARG_POINTER: memcpy(&Int, Value, 8); break;
+            case SL_LOG_ARG_VEC2:   memcpy(Vec, Value, 8); VecCount = 2; break;
+            case SL_LOG_ARG_VEC3:   memcpy(Vec, Value, 12); VecCount = 3; break;
+            case SL_LOG_ARG_VEC4:   memcpy(Vec, Value, 16); VecCount = 4; break;
+        }
+
+        Spec[SpecLength] = 0;
+        switch (Conversion)
+        {
+            case 'd': case 'i':
+                strcpy(Spec + SpecLength, "lld");
+                sl_log_append(&Line, Spec, (long long)Int);
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                Spec[SpecLength] = 'l'; Spec[SpecLength + 1] = 'l';
+                Spec[SpecLength + 2] = Conversion; Spec[SpecLength + 3] = 0;
+                sl_log_append(&Line, Spec, (unsigned long long)Int);
+                break;
+            case 'c':
+                strcpy(Spec + SpecLength, "c");
+                sl_log_append(&Line, Spec, (int)Int);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                Spec[SpecLength] = Conversion; Spec[SpecLength + 1] = 0;
+                sl_log_append(&Line, Spec, Real);
+                break;
+            case 's':
+                strcpy(Spec + SpecLength, "s");
+                sl_log_append(&Line, Spec, Tag[0] == SL_LOG_ARG_STRING ? (const char*)Value : "(not a string)");
+                break;
+            case 'p':
+                sl_log_append(&Line, "%p", (void*)(size_t)Int);
+                break;
+            case 'v':
+                if (!VecCount)
+                {
+                    sl_log_append(&Line, "(not a vector)");
+                    break;
+                }
+                sl_log_append(&Line, "{ ");
+                for (int i = 0; i < VecCount; i++)
+                    sl_log_append(&Line, i ? ", %.*f" : "%.*f", Precision >= 0 ? Precision : 6, (real64)Vec[i]);
+                sl_log_append(&Line, " }");
+                break;
+            default:
+                sl_log_append(&Line, "(bad format)");
+                break;
+        }
+    }
+
+    if (Line.At >= Line.End - 1)
+        Line.At = Line.End - 2;
+    *Line.At++ = '\n';
+    *Line.At = 0;
+    return cast(int)(Line.At - Out);
+}
+
+void sl_log_write_now(u8* Record)
+{
+    char Line[4096];
+    int Length = sl_log_format(Record, Line, sizeof(Line));
+    fwrite(Line, 1, Length, stderr);
+}
+
+//
+// Writer
+//
+
+// first record in Buffer past any wrap marker, NULL when it's empty
+internal u8*
+sl_log_peek(sl_log_buffer* Buffer, u64* Read)
+{
+    u64 Write = sl_log_load(&Buffer->Write);
+    while (*Read < Write)
+    {
+        u64 Offset = *Read & (SL_LOG_BUFFER_SIZE - 1);
+        u32 Size;
+        memcpy(&Size, Buffer->Data + Offset, sizeof(Size));
+        if (Size)
+            return Buffer->Data + Offset;
+        *Read += SL_LOG_BUFFER_SIZE - Offset;
+    }
+    return 0;
+}
+
+// NOTE(scott): unlinks and frees the buffers of exited threads once they're
+// empty.  Producers only ever push at the head, so the links behind it belong
+// to the writer; the head itself needs a CAS in case a thread is pushing.  Only
+// the writer walks the list, so nothing else can be looking at a freed buffer.
+internal void
+sl_log_free_retired()
+{
+    sl_log_buffer* Prev = 0;
+    sl_log_buffer* Buffer = sl_log_load(&sl_log_buffers);
+    while (Buffer)
+    {
+        sl_log_buffer* Next = Buffer->Next;
+        if (!sl_log_load(&Buffer->Retired) || Buffer->Read != sl_log_load(&Buffer->Write))
+        {
+            Prev = Buffer;
+            Buffer = Next;
+            continue;
+        }
+
+        if (Prev)
+        {
+            Prev->Next = Next;
+        }
+        else if (!sl_log_cas_ptr(&sl_log_buffers, Buffer, Next))
+        {
+            // a new buffer went in front of it
+            Prev = sl_log_load(&sl_log_buffers);
+            while (Prev->Next != Buffer)
+                Prev = Prev->Next;
+            Prev->Next = Next;
+        }
+        free(Buffer);
+        Buffer = Next;
+    }
+}
+
+// NOTE(scott): every buffer is already in time order, so a k-way merge on the
+// heads puts the output in time order across threads.  Only this thread moves
+// Read and unlinks buffers, so it merges straight off the list.
+internal int
+sl_log_drain()
+{
+    int Written = 0;
+    char Line[4096];
+    for (;;)
+    {
+        sl_log_buffer* Best = 0;
+        u8* BestRecord = 0;
+        u64 BestRead = 0;
+        u64 BestTime = 0;
+        for (sl_log_buffer* Buffer = sl_log_load(&sl_log_buffers); Buffer; Buffer = Buffer->Next)
+        {
+            u64 Read = Buffer->Read;
+            u8* Record = sl_log_peek(Buffer, &Read);
+            if (!Record)
+                continue;
+            u64 Time;
+            memcpy(&Time, Record + offsetof(sl_log_record, Time), sizeof(Time));
+            if (!Best || Time < BestTime)
+            {
+                Best = Buffer;
+                BestRecord = Record;
+                BestRead = Read;
+                BestTime = Time;
+            }
+        }
+        if (!Best)
+            break;
+
+        int Length = sl_log_format(BestRecord, Line, sizeof(Line));
+        fwrite(Line, 1, Length, sl_log_out);
+
+        u32 Size;
+        memcpy(&Size, BestRecord, sizeof(Size));
+        sl_log_store_release(&Best->Read, BestRead + Size);
+        Written++;
+    }
+
+    u64 Dropped = sl_log_dropped_count();
+    if (Dropped != sl_log_dropped_reported)
+    {
+        fprintf(sl_log_out, "[sl_log] %llu messages dropped, buffers were full\n",
+                (unsigned long long)(Dropped - sl_log_dropped_reported));
+        sl_log_dropped_reported = Dropped;
+        Written++;
+    }
+
+    if (Written)
+        fflush(sl_log_out);
+    sl_log_store_release(&sl_log_flushed, sl_log_flushed + 1);
+
+    sl_log_free_retired();
+    return Written;
+}
+
+#if defined(_WIN32)
+internal DWORD WINAPI
+#else
+internal void*
+#endif
+sl_log_writer(void* Param)
+{
+    while (!sl_log_load(&sl_log_quit))
+    {
+        if (!sl_log_drain())
+            sl_log_sleep_ms(1);
+    }
+    sl_log_drain();
+    return 0;
+}
+
+void sl_log_init(FILE* Out)
+{
+    if (sl_log_running)
+        return;
+
+    if (!sl_log_key_made)
+    {
+#if defined(_WIN32)
+        sl_log_key = FlsAlloc(sl_log_thread_exit);
+#else
+        pthread_key_create(&sl_log_key, sl_log_thread_exit);
+#endif
+        sl_log_key_made = true;
+    }
+
+    sl_log_out = Out ? Out : stderr;
+    sl_log_start = sl_log_now();
+    sl_log_quit = 0;
+    sl_log_dropped_reported = sl_log_dropped_count();
+
+#if defined(_WIN32)
+    sl_log_thread = CreateThread(0, 0, sl_log_writer, 0, 0, 0);
+#else
+    pthread_create(&sl_log_thread, 0, sl_log_writer, 0);
+#endif
+    sl_log_store_release(&sl_log_running, 1);
+}
+
+void sl_log_flush()
+{
+    if (!sl_log_load(&sl_log_running))
+        return;
+
+    // NOTE(scott): the drain running now may have started before our records
+    // were committed, the one after it can't have.  Each drain bumps the count
+    // after its fflush, so two bumps means it's all out of stdio as well.
+    u64 Target = sl_log_load(&sl_log_flushed) + 2;
+    while (sl_log_load(&sl_log_flushed) < Target && sl_log_load(&sl_log_running))
+        sl_log_sleep_ms(1);
+}
+
+void sl_log_shutdown()
+{
+    if (!sl_log_load(&sl_log_running))
+        return;
+
+    // NOTE(scott): stop taking new records first so nothing lands after the
+    // final drain
+    sl_log_store_release(&sl_log_running, 0);
+    sl_log_store_release(&sl_log_quit, 1);
+#if defined(_WIN32)
+    WaitForSingleObject(sl_log_thread, INFINITE);
+    CloseHandle(sl_log_thread);
+#else
+    pthread_join(sl_log_thread, 0);
+#endif
+    fflush(sl_log_out);
+}
+
+#endif // SL_LOG_IMPL
+
+#endif // SL_LOG_H
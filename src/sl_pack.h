@@ -0,0 +1,674 @@
+#ifndef SL_PACK_H
+#define SL_PACK_H
+
+//
+// Compressed vector storage
+//
+// Smaller stand-ins for vec3f / vec4f when full floats are more precision than
+// the data needs:
+//
+//     vec3h / vec4h     half floats, 6 / 8 bytes
+//     i16 snorm16       [-1, 1] in 16 bits
+//     u32 1010102       xyz in 10 bits each + 2 bit w, unorm or snorm
+//     u32 oct normal    unit vector in two snorm16s (octahedral mapping)
+//     vec3q             position quantized to 16 bits per axis inside a box
+//
+// Each format has a scalar encode / decode and a batch kernel over arrays.  The
+// half kernels pick an F16C version at run time when the CPU has it (see
+// sl_cpu.h) and the snorm16 kernels use SSE2.  The scalar paths round the same
+// way the hardware does (nearest even) so every path gives bit-identical results.
+//
+// The flat kernels work on runs of floats, so a vec3f array is just 3 * Count
+// floats:
+//     EncodeHalfArray(&Halves[0].X, &Points[0].X, 3 * da_len(Points));
+//
+// The *_da helpers take a dyn_array and return a new dyn_array of the same
+// length that the caller da_delete()s.
+//
+// Define SL_PACK_IMPL in one file before including this to get the
+// implementation.  Needs sl.h, dyn_array.h and sl_cpu.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+#include "sl_cpu.h"
+
+#include <string.h>
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef union vec3h
+{
+    struct
+    {
+        u16 X, Y, Z;
+    };
+    u16 E[3];
+} vec3h;
+
+typedef union vec4h
+{
+    struct
+    {
+        u16 X, Y, Z, W;
+    };
+    u16 E[4];
+} vec4h;
+
+// NOTE(scott): 0 maps to the box Min and 65535 to the box Max
+typedef union vec3q
+{
+    struct
+    {
+        u16 X, Y, Z;
+    };
+    u16 E[3];
+} vec3q;
+
+//
+// Scalar
+//
+
+u16 Real32ToHalf(real32 F);
+real32 HalfToReal32(u16 H);
+
+i16 Real32ToSnorm16(real32 F);
+real32 Snorm16ToReal32(i16 S);
+
+// xyz in the low 30 bits (x lowest), w in the top 2, same as GL's *_2_10_10_10_REV
+u32 PackUnorm1010102(vec4f V);
+vec4f UnpackUnorm1010102(u32 P);
+u32 PackSnorm1010102(vec4f V);
+vec4f UnpackSnorm1010102(u32 P);
+
+// N should be unit length.  Low 16 bits hold u, high 16 bits hold v.
+u32 EncodeOctNormal(vec3f N);
+vec3f DecodeOctNormal(u32 P);
+
+vec3q QuantizePosition(vec3f P, vec3f Min, vec3f Max);
+vec3f DequantizePosition(vec3q Q, vec3f Min, vec3f Max);
+
+//
+// Batch
+//
+
+void EncodeHalfArray(u16* Out, real32* In, i32 Count);
+void DecodeHalfArray(real32* Out, u16* In, i32 Count);
+
+void EncodeSnorm16Array(i16* Out, real32* In, i32 Count);
+void DecodeSnorm16Array(real32* Out, i16* In, i32 Count);
+
+void PackUnorm1010102Array(u32* Out, vec4f* In, i32 Count);
+void UnpackUnorm1010102Array(vec4f* Out, u32* In, i32 Count);
+void PackSnorm1010102Array(u32* Out, vec4f* In, i32 Count);
+void UnpackSnorm1010102Array(vec4f* Out, u32* In, i32 Count);
+
+void EncodeOctNormalArray(u32* Out, vec3f* In, i32 Count);
+void DecodeOctNormalArray(vec3f* Out, u32* In, i32 Count);
+
+void QuantizePositionArray(vec3q* Out, vec3f* In, i32 Count, vec3f Min, vec3f Max);
+void DequantizePositionArray(vec3f* Out, vec3q* In, i32 Count, vec3f Min, vec3f Max);
+
+//
+// dyn_array helpers
+//
+
+vec3h* sl_vec3f_to_half_da(vec3f* In);
+vec3f* sl_half_to_vec3f_da(vec3h* In);
+u32* sl_normals_to_oct_da(vec3f* In);
+vec3f* sl_oct_to_normals_da(u32* In);
+
+// NOTE(scott): fills *Min / *Max with the bounds it quantized against, keep them
+// around to decode
+vec3q* sl_quantize_positions_da(vec3f* In, vec3f* Min, vec3f* Max);
+vec3f* sl_dequantize_positions_da(vec3q* In, vec3f Min, vec3f Max);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_PACK_IMPL
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+internal inline u32
+sl_real32_bits(real32 F)
+{
+    u32 Result;
+    memcpy(&Result, &F, sizeof(Result));
+    return Result;
+}
+
+internal inline real32
+sl_bits_real32(u32 U)
+{
+    real32 Result;
+    memcpy(&Result, &U, sizeof(Result));
+    return Result;
+}
+
+u16 Real32ToHalf(real32 F)
+{
+    // NOTE(scott): round to nearest even, after Fabian Giesen's float_to_half_fast3_rtne.
+    // NaNs keep their top payload bits and get the quiet bit, like vcvtps2ph.
+    u32 Bits = sl_real32_bits(F);
+    u32 Sign = (Bits >> 16) & 0x8000;
+    u32 Abs = Bits & 0x7fffffff;
+    u32 Result;
+
+    if (Abs >= ((127 + 16) << 23))
+    {
+        if (Abs > 0x7f800000)
+            Result = 0x7e00 | ((Abs >> 13) & 0x3ff);
+        else
+            Result = 0x7c00;
+    }
+    else if (Abs < (113 << 23))
+    {
+        // subnormal or zero, let the FPU do the rounding
+        const u32 DenormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+        real32 Shifted = sl_bits_real32(Abs) + sl_bits_real32(DenormMagic);
+        Result = sl_real32_bits(Shifted) - DenormMagic;
+    }
+    else
+    {
+        u32 MantOdd = (Abs >> 13) & 1;
+        Abs += ((u32)(15 - 127) << 23) + 0xfff;
+        Abs += MantOdd;
+        Result = Abs >> 13;
+    }
+
+    return (u16)(Result | Sign);
+}
+
+real32 HalfToReal32(u16 H)
+{
+    const u32 ShiftedExp = 0x7c00 << 13;
+    u32 Bits = (u32)(H & 0x7fff) << 13;
+    u32 Exp = Bits & ShiftedExp;
+    Bits += (127 - 15) << 23;
+
+    if (Exp == ShiftedExp)
+    {
+        // Inf / NaN
+        Bits += (128 - 16) << 23;
+        if (H & 0x3ff)
+            Bits |= 0x400000;
+    }
+    else if (Exp == 0)
+    {
+        // subnormal
+        Bits += 1 << 23;
+        Bits = sl_real32_bits(sl_bits_real32(Bits) - sl_bits_real32(113 << 23));
+    }
+
+    Bits |= (u32)(H & 0x8000) << 16;
+    return sl_bits_real32(Bits);
+}
+
+i16 Real32ToSnorm16(real32 F)
+{
+    // NOTE(scott): clamp the way maxps/minps do (NaN goes to -1) and round
+    // with lrintf, nearest even like cvtps2dq, so the SSE2 kernel matches
+    if (!(F >= -1.f))
+        F = -1.f;
+    if (F > 1.f)
+        F = 1.f;
+    return (i16)lrintf(F * 32767.f);
+}
+
+real32 Snorm16ToReal32(i16 S)
+{
+    real32 Result = (real32)S * (1.f / 32767.f);
+    return Result < -1.f ? -1.f : Result;
+}
+
+internal inline u32
+sl_pack_unorm(real32 F, u32 Max)
+{
+    return (u32)lrintf(Clamp01(F) * (real32)Max);
+}
+
+internal inline u32
+sl_pack_snorm(real32 F, i32 Max, u32 Mask)
+{
+    return (u32)(i32)lrintf(Clamp(F, -1.f, 1.f) * (real32)Max) & Mask;
+}
+
+internal inline real32
+sl_unpack_snorm(u32 Bits, i32 BitCount)
+{
+    // sign extend the field
+    i32 Shift = 32 - BitCount;
+    i32 Value = (i32)(Bits << Shift) >> Shift;
+    real32 Result = (real32)Value / (real32)((1 << (BitCount - 1)) - 1);
+    return Result < -1.f ? -1.f : Result;
+}
+
+u32 PackUnorm1010102(vec4f V)
+{
+    return sl_pack_unorm(V.X, 1023) |
+        (sl_pack_unorm(V.Y, 1023) << 10) |
+        (sl_pack_unorm(V.Z, 1023) << 20) |
+        (sl_pack_unorm(V.W, 3) << 30);
+}
+
+vec4f UnpackUnorm1010102(u32 P)
+{
+    vec4f Result;
+    Result.X = (real32)(P & 0x3ff) / 1023.f;
+    Result.Y = (real32)((P >> 10) & 0x3ff) / 1023.f;
+    Result.Z = (real32)((P >> 20) & 0x3ff) / 1023.f;
+    Result.W = (real32)(P >> 30) / 3.f;
+    return Result;
+}
+
+u32 PackSnorm1010102(vec4f V)
+{
+    return sl_pack_snorm(V.X, 511, 0x3ff) |
+        (sl_pack_snorm(V.Y, 511, 0x3ff) << 10) |
+        (sl_pack_snorm(V.Z, 511, 0x3ff) << 20) |
+        (sl_pack_snorm(V.W, 1, 0x3) << 30);
+}
+
+vec4f UnpackSnorm1010102(u32 P)
+{
+    vec4f Result;
+    Result.X = sl_unpack_snorm(P & 0x3ff, 10);
+    Result.Y = sl_unpack_snorm((P >> 10) & 0x3ff, 10);
+    Result.Z = sl_unpack_snorm((P >> 20) & 0x3ff, 10);
+    Result.W = sl_unpack_snorm(P >> 30, 2);
+    return Result;
+}
+
+u32 EncodeOctNormal(vec3f N)
+{
+    // project onto the octahedron |x| + |y| + |z| = 1, then fold the lower
+    // half over the diagonals
+    real32 L1 = fabsf(N.X) + fabsf(N.Y) + fabsf(N.Z);
+    real32 InvL1 = L1 > 0.f ? 1.f / L1 : 0.f;
+    real32 U = N.X * InvL1;
+    real32 V = N.Y * InvL1;
+    if (N.Z < 0.f)
+    {
+        real32 FoldU = (1.f - fabsf(V)) * (U >= 0.f ? 1.f : -1.f);
+        real32 FoldV = (1.f - fabsf(U)) * (V >= 0.f ? 1.f : -1.f);
+        U = FoldU;
+        V = FoldV;
+    }
+    return (u32)(u16)Real32ToSnorm16(U) | ((u32)(u16)Real32ToSnorm16(V) << 16);
+}
+
+vec3f DecodeOctNormal(u32 P)
+{
+    real32 U = Snorm16ToReal32((i16)(P & 0xffff));
+    real32 V = Snorm16ToReal32((i16)(P >> 16));
+    real32 Z = 1.f - fabsf(U) - fabsf(V);
+    if (Z < 0.f)
+    {
+        real32 FoldU = (1.f - fabsf(V)) * (U >= 0.f ? 1.f : -1.f);
+        real32 FoldV = (1.f - fabsf(U)) * (V >= 0.f ? 1.f : -1.f);
+        U = FoldU;
+        V = FoldV;
+    }
+    real32 InvLen = 1.f / sqrtf(U*U + V*V + Z*Z);
+    return Vec3f(U * InvLen, V * InvLen, Z * InvLen);
+}
+
+internal inline u16
+sl_quantize_axis(real32 P, real32 Min, real32 Scale)
+{
+    return (u16)lrintf(Clamp((P - Min) * Scale, 0.f, 65535.f));
+}
+
+vec3q QuantizePosition(vec3f P, vec3f Min, vec3f Max)
+{
+    vec3q Result;
+    for (i32 i = 0; i < 3; i++)
+    {
+        real32 Extent = Max.E[i] - Min.E[i];
+        real32 Scale = Extent > 0.f ? 65535.f / Extent : 0.f;
+        Result.E[i] = sl_quantize_axis(P.E[i], Min.E[i], Scale);
+    }
+    return Result;
+}
+
+vec3f DequantizePosition(vec3q Q, vec3f Min, vec3f Max)
+{
+    vec3f Result;
+    for (i32 i = 0; i < 3; i++)
+    {
+        Result.E[i] = Min.E[i] + (real32)Q.E[i] * ((Max.E[i] - Min.E[i]) / 65535.f);
+    }
+    return Result;
+}
+
+//
+// Batch
+//
+
+internal void
+sl_encode_half_scalar(u16* Out, real32* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i] = Real32ToHalf(In[i]);
+    }
+}
+
+internal void
+sl_decode_half_scalar(real32* Out, u16* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i] = HalfToReal32(In[i]);
+    }
+}
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+
+SL_TARGET("avx,f16c") internal void
+sl_encode_half_f16c(u16* Out, real32* In, i32 Count)
+{
+    i32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256 F = _mm256_loadu_ps(In + i);
+        _mm_storeu_si128((__m128i*)(Out + i), _mm256_cvtps_ph(F, _MM_FROUND_TO_NEAREST_INT));
+    }
+    sl_encode_half_scalar(Out + i, In + i, Count - i);
+}
+
+SL_TARGET("avx,f16c") internal void
+sl_decode_half_f16c(real32* Out, u16* In, i32 Count)
+{
+    i32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128i H = _mm_loadu_si128((__m128i*)(In + i));
+        _mm256_storeu_ps(Out + i, _mm256_cvtph_ps(H));
+    }
+    sl_decode_half_scalar(Out + i, In + i, Count - i);
+}
+
+#endif
+
+typedef struct sl_pack_kernels
+{
+    void (*EncodeHalf)(u16* Out, real32* In, i32 Count);
+    void (*DecodeHalf)(real32* Out, u16* In, i32 Count);
+} sl_pack_kernels;
+
+global const sl_pack_kernels sl_pack_kernels_scalar = { sl_encode_half_scalar, sl_decode_half_scalar };
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+global const sl_pack_kernels sl_pack_kernels_f16c = { sl_encode_half_f16c, sl_decode_half_f16c };
+#endif
+
+internal inline const sl_pack_kernels*
+sl_pack_get_kernels()
+{
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    if (sl_cpu_features() & SL_CPU_F16C)
+        return &sl_pack_kernels_f16c;
+#endif
+    return &sl_pack_kernels_scalar;
+}
+
+void EncodeHalfArray(u16* Out, real32* In, i32 Count)
+{
+    sl_pack_get_kernels()->EncodeHalf(Out, In, Count);
+}
+
+void DecodeHalfArray(real32* Out, u16* In, i32 Count)
+{
+    sl_pack_get_kernels()->DecodeHalf(Out, In, Count);
+}
+
+void EncodeSnorm16Array(i16* Out, real32* In, i32 Count)
+{
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 Lo = _mm_set1_ps(-1.f);
+    __m128 Hi = _mm_set1_ps(1.f);
+    __m128 Scale = _mm_set1_ps(32767.f);
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128 A = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(In + i), Lo), Hi);
+        __m128 B = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(In + i + 4), Lo), Hi);
+        __m128i IA = _mm_cvtps_epi32(_mm_mul_ps(A, Scale));
+        __m128i IB = _mm_cvtps_epi32(_mm_mul_ps(B, Scale));
+        _mm_storeu_si128((__m128i*)(Out + i), _mm_packs_epi32(IA, IB));
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = Real32ToSnorm16(In[i]);
+    }
+}
+
+void DecodeSnorm16Array(real32* Out, i16* In, i32 Count)
+{
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 Scale = _mm_set1_ps(1.f / 32767.f);
+    __m128 Lo = _mm_set1_ps(-1.f);
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128i S = _mm_loadu_si128((__m128i*)(In + i));
+        // sign extend 16 -> 32 by unpacking into the high half and shifting back down
+        __m128i A = _mm_srai_epi32(_mm_unpacklo_epi16(S, S), 16);
+        __m128i B = _mm_srai_epi32(_mm_unpackhi_epi16(S, S), 16);
+        _mm_storeu_ps(Out + i, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(A), Scale), Lo));
+        _mm_storeu_ps(Out + i + 4, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(B), Scale), Lo));
+    }
+#endif
+    for (; i < Count; i++)
+    {
+        Out[i] = Snorm16ToReal32(In[i]);
+    }
+}
+
+void PackUnorm1010102Array(u32* Out, vec4f* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = PackUnorm1010102(In[i]);
+}
+
+void UnpackUnorm1010102Array(vec4f* Out, u32* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = UnpackUnorm1010102(In[i]);
+}
+
+void PackSnorm1010102Array(u32* Out, vec4f* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = PackSnorm1010102(In[i]);
+}
+
+void UnpackSnorm1010102Array(vec4f* Out, u32* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = UnpackSnorm1010102(In[i]);
+}
+
+void EncodeOctNormalArray(u32* Out, vec3f* In, i32 Count)
+{
+    i32 i = 0;
+#ifdef SL_SSE2
+    // NOTE(scott): same operations in the same order as EncodeOctNormal, the
+    // sign flips are exact so this matches it bit for bit
+    __m128 SignBit = _mm_set1_ps(-0.f);
+    __m128 Zero = _mm_setzero_ps();
+    __m128 One = _mm_set1_ps(1.f);
+    __m128 Lo = _mm_set1_ps(-1.f);
+    __m128 Scale = _mm_set1_ps(32767.f);
+    for (; i + 4 <= Count; i += 4)
+    {
+        // 4 vec3f are 3 loads, shuffle them apart into X, Y and Z
+        real32* F = &In[i].X;
+        __m128 A = _mm_loadu_ps(F);         // x0 y0 z0 x1
+        __m128 B = _mm_loadu_ps(F + 4);     // y1 z1 x2 y2
+        __m128 C = _mm_loadu_ps(F + 8);     // z2 x3 y3 z3
+        __m128 X = _mm_shuffle_ps(A, _mm_shuffle_ps(B, C, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 Y = _mm_shuffle_ps(_mm_shuffle_ps(A, B, _MM_SHUFFLE(0, 0, 1, 1)),
+                                  _mm_shuffle_ps(B, C, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 Z = _mm_shuffle_ps(_mm_shuffle_ps(A, B, _MM_SHUFFLE(1, 1, 2, 2)), C, _MM_SHUFFLE(3, 0, 2, 0));
+
+        __m128 L1 = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(SignBit, X), _mm_andnot_ps(SignBit, Y)),
+                               _mm_andnot_ps(SignBit, Z));
+        __m128 InvL1 = _mm_and_ps(_mm_cmpgt_ps(L1, Zero), _mm_div_ps(One, L1));
+        __m128 U = _mm_mul_ps(X, InvL1);
+        __m128 V = _mm_mul_ps(Y, InvL1);
+
+        __m128 FoldU = _mm_xor_ps(_mm_sub_ps(One, _mm_andnot_ps(SignBit, V)), _mm_and_ps(_mm_cmpnge_ps(U, Zero), SignBit));
+        __m128 FoldV = _mm_xor_ps(_mm_sub_ps(One, _mm_andnot_ps(SignBit, U)), _mm_and_ps(_mm_cmpnge_ps(V, Zero), SignBit));
+        __m128 Lower = _mm_cmplt_ps(Z, Zero);
+        U = _mm_or_ps(_mm_and_ps(Lower, FoldU), _mm_andnot_ps(Lower, U));
+        V = _mm_or_ps(_mm_and_ps(Lower, FoldV), _mm_andnot_ps(Lower, V));
+
+        __m128i IU = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(U, Lo), One), Scale));
+        __m128i IV = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(V, Lo), One), Scale));
+        __m128i Packed = _mm_packs_epi32(IU, IV);
+        _mm_storeu_si128((__m128i*)(Out + i), _mm_unpacklo_epi16(Packed, _mm_srli_si128(Packed, 8)));
+    }
+#endif
+    for (; i < Count; i++)
+        Out[i] = EncodeOctNormal(In[i]);
+}
+
+void DecodeOctNormalArray(vec3f* Out, u32* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = DecodeOctNormal(In[i]);
+}
+
+void QuantizePositionArray(vec3q* Out, vec3f* In, i32 Count, vec3f Min, vec3f Max)
+{
+    real32 Scale[3];
+    for (i32 Axis = 0; Axis < 3; Axis++)
+    {
+        real32 Extent = Max.E[Axis] - Min.E[Axis];
+        Scale[Axis] = Extent > 0.f ? 65535.f / Extent : 0.f;
+    }
+
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i].X = sl_quantize_axis(In[i].X, Min.X, Scale[0]);
+        Out[i].Y = sl_quantize_axis(In[i].Y, Min.Y, Scale[1]);
+        Out[i].Z = sl_quantize_axis(In[i].Z, Min.Z, Scale[2]);
+    }
+}
+
+void DequantizePositionArray(vec3f* Out, vec3q* In, i32 Count, vec3f Min, vec3f Max)
+{
+    real32 SX = (Max.X - Min.X) / 65535.f;
+    real32 SY = (Max.Y - Min.Y) / 65535.f;
+    real32 SZ = (Max.Z - Min.Z) / 65535.f;
+
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i].X = Min.X + (real32)In[i].X * SX;
+        Out[i].Y = Min.Y + (real32)In[i].Y * SY;
+        Out[i].Z = Min.Z + (real32)In[i].Z * SZ;
+    }
+}
+
+//
+// dyn_array helpers
+//
+
+// NOTE(scott): a new dyn_array with length Count
+#define sl_pack_make_da(__da_list, __count) \
+    if ((__count) > 0) { (__da_list) = _da_init(__da_list, (__count)); _da_hdr(__da_list) = (__count); }
+
+vec3h* sl_vec3f_to_half_da(vec3f* In)
+{
+    vec3h* Result = NULL;
+    i32 Count = da_len(In);
+    sl_pack_make_da(Result, Count);
+    if (Count)
+        EncodeHalfArray(Result[0].E, In[0].E, 3 * Count);
+    return Result;
+}
+
+vec3f* sl_half_to_vec3f_da(vec3h* In)
+{
+    vec3f* Result = NULL;
+    i32 Count = da_len(In);
+    sl_pack_make_da(Result, Count);
+    if (Count)
+        DecodeHalfArray(Result[0].E, In[0].E, 3 * Count);
+    return Result;
+}
+
+u32* sl_normals_to_oct_da(vec3f* In)
+{
+    u32* Result = NULL;
+    i32 Count = da_len(In);
+    sl_pack_make_da(Result, Count);
+    EncodeOctNormalArray(Result, In, Count);
+    return Result;
+}
+
+vec3f* sl_oct_to_normals_da(u32* In)
+{
+    vec3f* Result = NULL;
+    i32 Count = da_len(In);
+    sl_pack_make_da(Result, Count);
+    DecodeOctNormalArray(Result, In, Count);
+    return Result;
+}
+
+vec3q* sl_quantize_positions_da(vec3f* In, vec3f* Min, vec3f* Max)
+{
+    vec3q* Result = NULL;
+    i32 Count = da_len(In);
+
+    *Min = Vec3f(0.f, 0.f, 0.f);
+    *Max = Vec3f(0.f, 0.f, 0.f);
+    if (!Count)
+        return Result;
+
+    *Min = *Max = In[0];
+    for (i32 i = 1; i < Count; i++)
+    {
+        for (i32 Axis = 0; Axis < 3; Axis++)
+        {
+            if (In[i].E[Axis] < Min->E[Axis]) Min->E[Axis] = In[i].E[Axis];
+            if (In[i].E[Axis] > Max->E[Axis]) Max->E[Axis] = In[i].E[Axis];
+        }
+    }
+
+    sl_pack_make_da(Result, Count);
+    QuantizePositionArray(Result, In, Count, *Min, *Max);
+    return Result;
+}
+
+vec3f* sl_dequantize_positions_da(vec3q* In, vec3f Min, vec3f Max)
+{
+    vec3f* Result = NULL;
+    i32 Count = da_len(In);
+    sl_pack_make_da(Result, Count);
+    DequantizePositionArray(Result, In, Count, Min, Max);
+    return Result;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_PACK_IMPL
+
+#endif // SL_PACK_H
@@ -0,0 +1,481 @@
+#ifndef SL_PARSE_H
+#define SL_PARSE_H
+
+//
+// Bulk number parsing
+//
+// Parses a whole buffer of numbers or tuples straight into dyn_arrays, for
+// point files and the like where calling ParseVec3f() per line is the slow part.
+//
+//     read_file_result File = ReadEntireFile("points.txt", false);
+//
+//     vec3f* Points = NULL;
+//     sl_parse_error Error;
+//     if (sl_parse_tuples_da((char*)File.contents, File.size, 3, Points, &Error) != 0)
+//         printf("points.txt:%d:%d: %s\n", Error.Line, Error.Column, Error.Message);
+//
+// A tuple is either Width numbers in braces, "{ 1, 2, 3 }", or Width numbers
+// without braces; numbers are separated by commas and/or whitespace.  Unbraced
+// tuples can't run over the end of a line, so a short line is an error instead
+// of silently shifting every value after it.  Lines starting with '#' or ';' are
+// comments.
+//
+// sl_parse_tuples() writes each tuple to the first Width floats of an element
+// (AoS, any element type that starts with Width floats, like vec3f) and
+// sl_parse_tuples_soa() appends component i to Columns[i].  sl_parse_floats()
+// takes every number in the buffer regardless of braces and lines.
+//
+// Numbers are [+-]digits[.digits][e[+-]digits].  The digit runs and separators
+// are found 16 bytes at a time with SSE2 (when sl_cpu.h finds it) and the digits are folded 8 at a time
+// in a 64-bit register, then scaled with one exact double multiply or divide,
+// so the results are bit for bit what (float)strtod() gives.  Numbers with more
+// than 19 digits or a big exponent go through strtod itself.
+//
+// On an error everything parsed up to that point is kept, the function returns
+// -1 and Error (if not NULL) says where: a byte offset into Text plus a 1 based
+// line and column.
+//
+// C compatible.  Define SL_PARSE_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h and sl_cpu.h.  Define SL_NO_SIMD for the
+// scalar path.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+#include "sl_cpu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SL_PARSE_MAX_WIDTH 16
+
+typedef struct sl_parse_error
+{
+    size_t Offset;
+    int Line;
+    int Column;
+    const char* Message;
+} sl_parse_error;
+
+int sl_parse_floats(const char* Text, size_t Length, float** Values, sl_parse_error* Error);
+int sl_parse_tuples(const char* Text, size_t Length, int Width, void** List, int ElementSize, sl_parse_error* Error);
+int sl_parse_tuples_soa(const char* Text, size_t Length, int Width, float** Columns, sl_parse_error* Error);
+
+#define sl_parse_tuples_da(Text, Length, Width, List, Error) \
+    sl_parse_tuples((Text), (Length), (Width), (void**)&(List), (int)sizeof(*(List)), (Error))
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_PARSE_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+#include <emmintrin.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static int sl_parse_ctz(unsigned int x) { unsigned long i; _BitScanForward(&i, x); return (int)i; }
+#else
+#define sl_parse_ctz(x) __builtin_ctz(x)
+#endif
+
+static const double sl_parse_pow10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static int
+sl_parse_is_digit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+static int
+sl_parse_is_separator(char c)
+{
+    return c == ' ' || c == ',' || c == '\t' || c == '\r';
+}
+
+// NOTE(scott): eight ASCII digits to their value with three multiplies, the high
+// digit is in the low byte since we load little endian
+static unsigned long long
+sl_parse_eight_digits(const char* P)
+{
+    unsigned long long Value;
+    memcpy(&Value, P, 8);
+    Value -= 0x3030303030303030ull;
+    Value = (Value * 10) + (Value >> 8);
+    Value = (((Value & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+             (((Value >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return Value;
+}
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+
+// NOTE(scott): both stop at the first byte that doesn't belong, or where fewer
+// than 16 are left for the scalar loop to finish
+
+SL_TARGET("sse2") static const char*
+sl_parse_digit_run_sse2(const char* P, const char* End)
+{
+    const __m128i Zero = _mm_set1_epi8('0');
+    const __m128i Limit = _mm_set1_epi8((char)(0x80 + 10));
+    const __m128i Flip = _mm_set1_epi8((char)0x80);
+    while (End - P >= 16)
+    {
+        // (c - '0') < 10 unsigned, done as a signed compare with the top bit flipped
+        __m128i Chars = _mm_loadu_si128((const __m128i*)P);
+        __m128i Digits = _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(Chars, Zero), Flip), Limit);
+        unsigned int Mask = (unsigned int)_mm_movemask_epi8(Digits);
+        if (Mask != 0xffff)
+            return P + sl_parse_ctz(~Mask);
+        P += 16;
+    }
+    return P;
+}
+
+SL_TARGET("sse2") static const char*
+sl_parse_skip_separators_sse2(const char* P, const char* End)
+{
+    const __m128i Space = _mm_set1_epi8(' ');
+    const __m128i Comma = _mm_set1_epi8(',');
+    const __m128i Tab = _mm_set1_epi8('\t');
+    const __m128i Return = _mm_set1_epi8('\r');
+    while (End - P >= 16)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i*)P);
+        __m128i Separators = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, Space), _mm_cmpeq_epi8(Chars, Comma)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(Chars, Tab), _mm_cmpeq_epi8(Chars, Return)));
+        unsigned int Mask = (unsigned int)_mm_movemask_epi8(Separators);
+        if (Mask != 0xffff)
+            return P + sl_parse_ctz(~Mask);
+        P += 16;
+    }
+    return P;
+}
+
+#endif
+
+// NOTE(scott): looked up once per call and passed down, the scanners run once
+// per number and a feature check each time would cost more than they save
+static int
+sl_parse_wide(void)
+{
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    return (sl_cpu_features() & SL_CPU_SSE2) != 0;
+#else
+    return 0;
+#endif
+}
+
+// length of the run of digits at P
+static size_t
+sl_parse_digit_run(const char* P, const char* End, int Wide)
+{
+    const char* Start = P;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    if (Wide)
+        P = sl_parse_digit_run_sse2(P, End);
+#endif
+    while (P < End && sl_parse_is_digit(*P))
+        P++;
+    return (size_t)(P - Start);
+}
+
+static const char*
+sl_parse_skip_separators(const char* P, const char* End, int Wide)
+{
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    // NOTE(scott): most gaps are a byte or two, only go wide past the first few
+    if (Wide && End - P >= 16 && sl_parse_is_separator(P[0]) && sl_parse_is_separator(P[1]))
+        P = sl_parse_skip_separators_sse2(P, End);
+#endif
+    while (P < End && sl_parse_is_separator(*P))
+        P++;
+    return P;
+}
+
+// folds a digit run into Mantissa, Count is how many digits there were
+static const char*
+sl_parse_digits(const char* P, const char* End, unsigned long long* Mantissa, int* Count, int Wide)
+{
+    size_t Run = sl_parse_digit_run(P, End, Wide);
+    unsigned long long Value = *Mantissa;
+    *Count += (int)Run;
+
+    // NOTE(scott): past 19 digits this overflows, the caller sees Count and
+    // throws the value away
+    while (Run >= 8)
+    {
+        Value = Value * 100000000ull + sl_parse_eight_digits(P);
+        P += 8;
+        Run -= 8;
+    }
+    while (Run--)
+    {
+        Value = Value * 10 + (unsigned long long)(*P - '0');
+        P++;
+    }
+
+    *Mantissa = Value;
+    return P;
+}
+
+// returns the end of the number or NULL if there isn't one at P
+static const char*
+sl_parse_number(const char* P, const char* End, float* Result, int Wide)
+{
+    const char* Start = P;
+    int Negative = 0;
+    if (P < End && (*P == '-' || *P == '+'))
+    {
+        Negative = *P == '-';
+        P++;
+    }
+
+    unsigned long long Mantissa = 0;
+    int Digits = 0;
+    int Exponent = 0;
+    P = sl_parse_digits(P, End, &Mantissa, &Digits, Wide);
+    if (P < End && *P == '.')
+    {
+        int Fraction = 0;
+        P = sl_parse_digits(P + 1, End, &Mantissa, &Fraction, Wide);
+        Digits += Fraction;
+        Exponent = -Fraction;
+    }
+    if (!Digits)
+        return NULL;
+
+    if (P < End && (*P == 'e' || *P == 'E'))
+    {
+        const char* E = P + 1;
+        int ExponentNegative = 0;
+        if (E < End && (*E == '-' || *E == '+'))
+        {
+            ExponentNegative = *E == '-';
+            E++;
+        }
+        if (E == End || !sl_parse_is_digit(*E))
+            return NULL;
+
+        int Value = 0;
+        while (E < End && sl_parse_is_digit(*E))
+        {
+            if (Value < 100000)
+                Value = Value * 10 + (*E - '0');
+            E++;
+        }
+        Exponent += ExponentNegative ? -Value : Value;
+        P = E;
+    }
+
+    // NOTE(scott): a mantissa under 2^53 and a power of ten under 1e23 are both
+    // exact doubles, so one multiply or divide rounds correctly
+    if (Digits <= 19 && Mantissa <= (1ull << 53) && Exponent >= -22 && Exponent <= 22)
+    {
+        double Value = (double)Mantissa;
+        Value = Exponent < 0 ? Value / sl_parse_pow10[-Exponent] : Value * sl_parse_pow10[Exponent];
+        *Result = (float)(Negative ? -Value : Value);
+        return P;
+    }
+
+    // NOTE(scott): Text isn't terminated, so strtod gets a copy, on the heap for
+    // the odd number that doesn't fit on the stack
+    char Local[128];
+    size_t Size = (size_t)(P - Start);
+    char* Buffer = Size < sizeof(Local) ? Local : (char*)malloc(Size + 1);
+    if (!Buffer)
+        return NULL;
+    memcpy(Buffer, Start, Size);
+    Buffer[Size] = 0;
+    *Result = (float)strtod(Buffer, NULL);
+    if (Buffer != Local)
+        free(Buffer);
+    return P;
+}
+
+typedef struct sl_parse_sink
+{
+    void** List;
+    int ElementSize;
+    float** Columns;
+} sl_parse_sink;
+
+static void
+sl_parse_emit(sl_parse_sink* Sink, const float* Tuple, int Width)
+{
+    if (Sink->Columns)
+    {
+        for (int i = 0; i < Width; i++)
+        {
+            da_append(Sink->Columns[i], Tuple[i]);
+        }
+        return;
+    }
+
+    void* List = *Sink->List;
+    int Length = da_len(List);
+    if (Length == da_cap(List))
+        List = _da_resize(List, (size_t)Sink->ElementSize, Length ? (size_t)Length * 2 : 16);
+
+    char* Element = (char*)List + (size_t)Length * (size_t)Sink->ElementSize;
+    memcpy(Element, Tuple, sizeof(float) * (size_t)Width);
+    memset(Element + sizeof(float) * Width, 0, (size_t)Sink->ElementSize - sizeof(float) * Width);
+    _da_hdr(List)++;
+    *Sink->List = List;
+}
+
+static int
+sl_parse_fail(const char* Text, const char* At, const char* Message, sl_parse_error* Error)
+{
+    if (Error)
+    {
+        Error->Offset = (size_t)(At - Text);
+        Error->Line = 1;
+        Error->Column = 1;
+        for (const char* P = Text; P < At; P++)
+        {
+            if (*P == '\n')
+            {
+                Error->Line++;
+                Error->Column = 1;
+            }
+            else
+            {
+                Error->Column++;
+            }
+        }
+        Error->Message = Message;
+    }
+    return -1;
+}
+
+// NOTE(scott): Grouped is off for sl_parse_floats, then braces and newlines are
+// just more separators
+static int
+sl_parse_run(const char* Text, size_t Length, int Width, int Grouped, sl_parse_sink* Sink, sl_parse_error* Error)
+{
+    assert(Width >= 1 && Width <= SL_PARSE_MAX_WIDTH);
+
+    const char* P = Text;
+    const char* End = Text + Length;
+    const char* TupleStart = P;
+    float Tuple[SL_PARSE_MAX_WIDTH];
+    int Count = 0;
+    int Braced = 0;
+    int LineStart = 1;
+    int Wide = sl_parse_wide();
+
+    for (;;)
+    {
+        P = sl_parse_skip_separators(P, End, Wide);
+        if (P == End)
+            break;
+
+        char c = *P;
+        if (c == '\n')
+        {
+            if (Grouped && !Braced && Count)
+                return sl_parse_fail(Text, P, "line ended in the middle of a tuple", Error);
+            LineStart = 1;
+            P++;
+            continue;
+        }
+        if ((c == '#' || c == ';') && LineStart && !Braced)
+        {
+            const char* Newline = (const char*)memchr(P, '\n', (size_t)(End - P));
+            P = Newline ? Newline : End;
+            continue;
+        }
+        LineStart = 0;
+
+        if (c == '{' || c == '}')
+        {
+            if (Grouped)
+            {
+                if (c == '{' && (Braced || Count))
+                    return sl_parse_fail(Text, P, "unexpected '{'", Error);
+                if (c == '}' && !Braced)
+                    return sl_parse_fail(Text, P, "unexpected '}'", Error);
+                if (c == '}' && Count != Width)
+                    return sl_parse_fail(Text, P, "too few numbers in tuple", Error);
+                if (c == '}')
+                {
+                    sl_parse_emit(Sink, Tuple, Width);
+                    Count = 0;
+                }
+                Braced = c == '{';
+                TupleStart = P;
+            }
+            P++;
+            continue;
+        }
+
+        if (Count == Width)
+            return sl_parse_fail(Text, P, "too many numbers in tuple", Error);
+
+        const char* Next = sl_parse_number(P, End, &Tuple[Count], Wide);
+        if (!Next || (Next < End && !sl_parse_is_separator(*Next) && *Next != '\n' && *Next != '}' && *Next != '{'))
+            return sl_parse_fail(Text, P, "expected a number", Error);
+
+        if (!Count && !Braced)
+            TupleStart = P;
+        Count++;
+        P = Next;
+
+        if (Count == Width && !Braced)
+        {
+            sl_parse_emit(Sink, Tuple, Width);
+            Count = 0;
+        }
+    }
+
+    if (Braced)
+        return sl_parse_fail(Text, TupleStart, "missing '}'", Error);
+    if (Count)
+        return sl_parse_fail(Text, TupleStart, "too few numbers in tuple", Error);
+    return 0;
+}
+
+int sl_parse_floats(const char* Text, size_t Length, float** Values, sl_parse_error* Error)
+{
+    sl_parse_sink Sink = { (void**)Values, (int)sizeof(float), NULL };
+    return sl_parse_run(Text, Length, 1, 0, &Sink, Error);
+}
+
+int sl_parse_tuples(const char* Text, size_t Length, int Width, void** List, int ElementSize, sl_parse_error* Error)
+{
+    assert(ElementSize >= (int)sizeof(float) * Width);
+    sl_parse_sink Sink = { List, ElementSize, NULL };
+    return sl_parse_run(Text, Length, Width, 1, &Sink, Error);
+}
+
+int sl_parse_tuples_soa(const char* Text, size_t Length, int Width, float** Columns, sl_parse_error* Error)
+{
+    sl_parse_sink Sink = { NULL, 0, Columns };
+    return sl_parse_run(Text, Length, Width, 1, &Sink, Error);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_PARSE_IMPL
+
+#endif // SL_PARSE_H
@@ -0,0 +1,491 @@
+#ifndef SL_POOL_H
+#define SL_POOL_H
+
+//
+// Pool allocator
+//
+// A malloc replacement for lots of small objects.  Requests up to 8KB are
+// rounded up to one of 32 size classes (four per power of two) and carved out
+// of 64KB slabs that only ever hold that class, so churn can't fragment them.
+// Free objects are kept on intrusive lists: the first bytes of a free object
+// point to the next one.
+//
+// Every thread caches free objects per class, so the common alloc and free are
+// a list pop or push with no locking.  When a thread's cache runs dry it takes
+// a whole batch from the shared pool, and when it gets too full it hands a
+// batch back, so threads that free what others allocated don't leak into one
+// cache forever.
+//
+//     node* Node = sl_pool_new(node);
+//     ...
+//     sl_pool_free(Node);
+//
+// Anything bigger than 8KB gets its own block from the system.  Pointers from
+// sl_pool_alloc() can only be freed with sl_pool_free(), never with free().
+//
+// To put the dyn_arrays on it, define the hooks before every include of
+// dyn_array.h (all files have to agree):
+//
+//     #include "sl_pool.h"
+//     #define da_alloc(Size) sl_pool_alloc(Size)
+//     #define da_realloc(Ptr, Size) sl_pool_realloc(Ptr, Size)
+//     #define da_free(Ptr) sl_pool_free(Ptr)
+//     #include "dyn_array.h"
+//
+// and every container built on dyn_arrays (the job queues, the parsers, the
+// intern table's entries) allocates from the pool too.
+//
+// Threads that exit with objects in their cache should call
+// sl_pool_thread_flush() first to give them back.  Slabs are never returned to
+// the system.
+//
+// Define SL_POOL_DEBUG to poison freed memory (0xdd) and fresh allocations (0xcd)
+// and assert on writes after free and double frees.
+//
+// C compatible.  Define SL_POOL_IMPL in one file before including this to get the
+// implementation.
+//
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SL_POOL_SLAB_SIZE   (64 * 1024)
+#define SL_POOL_MAX_SMALL   8192
+#define SL_POOL_CLASS_COUNT 32
+
+void* sl_pool_alloc(size_t Size);
+void* sl_pool_realloc(void* Ptr, size_t Size);
+void sl_pool_free(void* Ptr);
+
+// bytes actually available at Ptr, at least what was asked for
+size_t sl_pool_usable_size(void* Ptr);
+
+// gives this thread's cached objects back to the shared pool
+void sl_pool_thread_flush(void);
+
+// slab and big block bytes taken from the system so far
+size_t sl_pool_reserved_bytes(void);
+
+#define sl_pool_new(Type) ((Type*)sl_pool_alloc(sizeof(Type)))
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_POOL_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <malloc.h>
+#include <intrin.h>
+#else
+#include <sched.h>
+#endif
+
+#ifndef SL_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define SL_THREAD_LOCAL __declspec(thread)
+#else
+#define SL_THREAD_LOCAL __thread
+#endif
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define sl_pool_try_lock(p)     (InterlockedExchange((volatile LONG*)(p), 1) == 0)
+#define sl_pool_unlock(p)       InterlockedExchange((volatile LONG*)(p), 0)
+#define sl_pool_add(p, v)       InterlockedExchangeAdd64((volatile LONG64*)(p), (LONG64)(v))
+#define sl_pool_yield()         SwitchToThread()
+#else
+#define sl_pool_try_lock(p)     (__atomic_exchange_n((p), 1, __ATOMIC_ACQUIRE) == 0)
+#define sl_pool_unlock(p)       __atomic_store_n((p), 0, __ATOMIC_RELEASE)
+#define sl_pool_add(p, v)       __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+#define sl_pool_yield()         sched_yield()
+#endif
+
+#define SL_POOL_MAGIC       0x4c4f4f50u     // "POOL"
+#define SL_POOL_HEADER_SIZE 64
+#define SL_POOL_ARENA_SLABS 16
+#define SL_POOL_BATCH_BYTES (32 * 1024)
+
+#define SL_POOL_FREED 0xdd
+#define SL_POOL_FRESH 0xcd
+
+// NOTE(scott): sits at the start of every slab and big block, so masking any
+// pointer down to the slab size finds it
+typedef struct sl_pool_slab
+{
+    unsigned int Magic;
+    int Class;          // -1 for a big block
+    size_t Size;        // big blocks only
+} sl_pool_slab;
+
+// a free list chain; batches on the shared list are linked through the second
+// word of their first object
+typedef struct sl_pool_node
+{
+    struct sl_pool_node* Next;
+    struct sl_pool_node* NextBatch;
+} sl_pool_node;
+
+typedef struct sl_pool_class
+{
+    volatile long Lock;
+    sl_pool_node* Batches;
+    char* Bump;
+    char* BumpEnd;
+} sl_pool_class;
+
+typedef struct sl_pool_cache
+{
+    sl_pool_node* Head;
+    int Count;
+} sl_pool_cache;
+
+static sl_pool_class sl_pool_classes[SL_POOL_CLASS_COUNT];
+static volatile long sl_pool_arena_lock;
+static char* sl_pool_arena_next;
+static char* sl_pool_arena_end;
+static volatile long long sl_pool_reserved;
+
+static SL_THREAD_LOCAL sl_pool_cache sl_pool_caches[SL_POOL_CLASS_COUNT];
+
+static void
+sl_pool_lock(volatile long* Lock)
+{
+    int Spins = 0;
+    while (!sl_pool_try_lock(Lock))
+    {
+        // NOTE(scott): these are held for a few pointer swaps, but with more
+        // threads than cores the holder may be descheduled
+        if (++Spins > 64)
+        {
+            sl_pool_yield();
+            Spins = 0;
+        }
+    }
+}
+
+static void*
+sl_pool_system_alloc(size_t Size)
+{
+    void* Result = NULL;
+#if defined(_WIN32)
+    Result = _aligned_malloc(Size, SL_POOL_SLAB_SIZE);
+#else
+    if (posix_memalign(&Result, SL_POOL_SLAB_SIZE, Size) != 0)
+        Result = NULL;
+#endif
+    if (Result)
+        sl_pool_add(&sl_pool_reserved, (long long)Size);
+    return Result;
+}
+
+static void
+sl_pool_system_free(void* Ptr, size_t Size)
+{
+    sl_pool_add(&sl_pool_reserved, -(long long)Size);
+#if defined(_WIN32)
+    _aligned_free(Ptr);
+#else
+    free(Ptr);
+#endif
+}
+
+// 16 byte steps up to 128, then four classes per power of two up to 8KB
+static int
+sl_pool_size_class(size_t Size)
+{
+    if (Size <= 128)
+        return Size ? (int)((Size - 1) >> 4) : 0;
+
+    size_t Rounded = Size - 1;
+    int Shift = 63;
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanReverse64(&Index, Rounded);
+    Shift = (int)Index;
+#else
+    Shift = 63 - __builtin_clzll((unsigned long long)Rounded);
+#endif
+    return (Shift - 7) * 4 + 8 + (int)((Rounded >> (Shift - 2)) & 3);
+}
+
+static size_t
+sl_pool_class_size(int Class)
+{
+    if (Class < 8)
+        return (size_t)(Class + 1) * 16;
+    int Group = (Class - 8) / 4;
+    int Step = (Class - 8) % 4;
+    return ((size_t)128 << Group) + (size_t)(Step + 1) * ((size_t)32 << Group);
+}
+
+static int
+sl_pool_batch_count(int Class)
+{
+    int Count = (int)(SL_POOL_BATCH_BYTES / sl_pool_class_size(Class));
+    return Count < 4 ? 4 : Count > 64 ? 64 : Count;
+}
+
+static sl_pool_slab*
+sl_pool_slab_of(void* Ptr)
+{
+    sl_pool_slab* Slab = (sl_pool_slab*)((size_t)Ptr & ~(size_t)(SL_POOL_SLAB_SIZE - 1));
+    assert(Slab->Magic == SL_POOL_MAGIC && "not a pool pointer");
+    return Slab;
+}
+
+static char*
+sl_pool_new_slab(int Class)
+{
+    sl_pool_lock(&sl_pool_arena_lock);
+    if (sl_pool_arena_next == sl_pool_arena_end)
+    {
+        // NOTE(scott): slabs come in arenas so the alignment waste is paid once
+        // per sixteen of them
+        char* Arena = (char*)sl_pool_system_alloc((size_t)SL_POOL_SLAB_SIZE * SL_POOL_ARENA_SLABS);
+        if (!Arena)
+        {
+            sl_pool_unlock(&sl_pool_arena_lock);
+            return NULL;
+        }
+        sl_pool_arena_next = Arena;
+        sl_pool_arena_end = Arena + (size_t)SL_POOL_SLAB_SIZE * SL_POOL_ARENA_SLABS;
+    }
+    char* Result = sl_pool_arena_next;
+    sl_pool_arena_next += SL_POOL_SLAB_SIZE;
+    sl_pool_unlock(&sl_pool_arena_lock);
+
+    sl_pool_slab* Slab = (sl_pool_slab*)Result;
+    Slab->Magic = SL_POOL_MAGIC;
+    Slab->Class = Class;
+    Slab->Size = 0;
+    return Result;
+}
+
+#ifdef SL_POOL_DEBUG
+static void
+sl_pool_poison(void* Ptr, size_t Size)
+{
+    memset((char*)Ptr + sizeof(sl_pool_node), SL_POOL_FREED, Size - sizeof(sl_pool_node));
+}
+
+static int
+sl_pool_is_poisoned(void* Ptr, size_t Size)
+{
+    const unsigned char* P = (const unsigned char*)Ptr;
+    for (size_t i = sizeof(sl_pool_node); i < Size; i++)
+    {
+        if (P[i] != SL_POOL_FREED)
+            return 0;
+    }
+    return 1;
+}
+#endif
+
+// fills an empty cache with one batch, from the shared list if there is one
+// or else fresh from a slab
+static void
+sl_pool_refill(int Class, sl_pool_cache* Cache)
+{
+    sl_pool_class* Shared = sl_pool_classes + Class;
+    size_t Size = sl_pool_class_size(Class);
+    int Batch = sl_pool_batch_count(Class);
+
+    sl_pool_lock(&Shared->Lock);
+    sl_pool_node* Head = Shared->Batches;
+    if (Head)
+    {
+        Shared->Batches = Head->NextBatch;
+        sl_pool_unlock(&Shared->Lock);
+
+        int Count = 0;
+        for (sl_pool_node* Node = Head; Node; Node = Node->Next)
+            Count++;
+        Cache->Head = Head;
+        Cache->Count = Count;
+        return;
+    }
+
+    sl_pool_node* First = NULL;
+    sl_pool_node** Link = &First;
+    int Count = 0;
+    while (Count < Batch)
+    {
+        if (Shared->Bump == Shared->BumpEnd)
+        {
+            char* Slab = sl_pool_new_slab(Class);
+            if (!Slab)
+                break;
+            Shared->Bump = Slab + SL_POOL_HEADER_SIZE;
+            Shared->BumpEnd = Shared->Bump + ((SL_POOL_SLAB_SIZE - SL_POOL_HEADER_SIZE) / Size) * Size;
+        }
+        sl_pool_node* Node = (sl_pool_node*)Shared->Bump;
+        Shared->Bump += Size;
+        *Link = Node;
+        Link = &Node->Next;
+        Count++;
+    }
+    *Link = NULL;
+    sl_pool_unlock(&Shared->Lock);
+
+#ifdef SL_POOL_DEBUG
+    for (sl_pool_node* Node = First; Node; Node = Node->Next)
+        sl_pool_poison(Node, Size);
+#endif
+
+    Cache->Head = First;
+    Cache->Count = Count;
+}
+
+static void
+sl_pool_push_batch(int Class, sl_pool_node* Head)
+{
+    sl_pool_class* Shared = sl_pool_classes + Class;
+    sl_pool_lock(&Shared->Lock);
+    Head->NextBatch = Shared->Batches;
+    Shared->Batches = Head;
+    sl_pool_unlock(&Shared->Lock);
+}
+
+static void*
+sl_pool_alloc_big(size_t Size)
+{
+    sl_pool_slab* Block = (sl_pool_slab*)sl_pool_system_alloc(SL_POOL_HEADER_SIZE + Size);
+    if (!Block)
+        return NULL;
+    Block->Magic = SL_POOL_MAGIC;
+    Block->Class = -1;
+    Block->Size = Size;
+    return (char*)Block + SL_POOL_HEADER_SIZE;
+}
+
+void* sl_pool_alloc(size_t Size)
+{
+    if (Size > SL_POOL_MAX_SMALL)
+        return sl_pool_alloc_big(Size);
+
+    int Class = sl_pool_size_class(Size);
+    sl_pool_cache* Cache = sl_pool_caches + Class;
+    if (!Cache->Head)
+    {
+        sl_pool_refill(Class, Cache);
+        if (!Cache->Head)
+            return NULL;
+    }
+
+    sl_pool_node* Node = Cache->Head;
+    Cache->Head = Node->Next;
+    Cache->Count--;
+
+#ifdef SL_POOL_DEBUG
+    assert(sl_pool_is_poisoned(Node, sl_pool_class_size(Class)) && "pool object written after it was freed");
+    memset(Node, SL_POOL_FRESH, sl_pool_class_size(Class));
+#endif
+    return Node;
+}
+
+void sl_pool_free(void* Ptr)
+{
+    if (!Ptr)
+        return;
+
+    sl_pool_slab* Slab = sl_pool_slab_of(Ptr);
+    if (Slab->Class < 0)
+    {
+        sl_pool_system_free(Slab, SL_POOL_HEADER_SIZE + Slab->Size);
+        return;
+    }
+
+    int Class = Slab->Class;
+#ifdef SL_POOL_DEBUG
+    // NOTE(scott): 16 byte objects are all free list links, nothing to check
+    assert((Class == 0 || !sl_pool_is_poisoned(Ptr, sl_pool_class_size(Class))) && "pool object freed twice");
+    sl_pool_poison(Ptr, sl_pool_class_size(Class));
+#endif
+
+    sl_pool_cache* Cache = sl_pool_caches + Class;
+    sl_pool_node* Node = (sl_pool_node*)Ptr;
+    Node->Next = Cache->Head;
+    Cache->Head = Node;
+    Cache->Count++;
+
+    // over two batches cached, the oldest one goes back to the shared pool
+    int Batch = sl_pool_batch_count(Class);
+    if (Cache->Count >= 2 * Batch)
+    {
+        sl_pool_node* Last = Cache->Head;
+        for (int i = 1; i < Batch; i++)
+            Last = Last->Next;
+        sl_pool_node* Rest = Last->Next;
+        Last->Next = NULL;
+        sl_pool_push_batch(Class, Rest);
+        Cache->Count = Batch;
+    }
+}
+
+size_t sl_pool_usable_size(void* Ptr)
+{
+    sl_pool_slab* Slab = sl_pool_slab_of(Ptr);
+    return Slab->Class < 0 ? Slab->Size : sl_pool_class_size(Slab->Class);
+}
+
+void* sl_pool_realloc(void* Ptr, size_t Size)
+{
+    if (!Ptr)
+        return sl_pool_alloc(Size);
+
+    size_t Usable = sl_pool_usable_size(Ptr);
+    // NOTE(scott): stay put if it still fits and we wouldn't be wasting over half
+    if (Size <= Usable && (Size > Usable / 2 || Usable <= 16))
+        return Ptr;
+
+    void* Result = sl_pool_alloc(Size);
+    if (!Result)
+        return NULL;
+    memcpy(Result, Ptr, Size < Usable ? Size : Usable);
+    sl_pool_free(Ptr);
+    return Result;
+}
+
+void sl_pool_thread_flush(void)
+{
+    for (int Class = 0; Class < SL_POOL_CLASS_COUNT; Class++)
+    {
+        sl_pool_cache* Cache = sl_pool_caches + Class;
+        if (Cache->Head)
+            sl_pool_push_batch(Class, Cache->Head);
+        Cache->Head = NULL;
+        Cache->Count = 0;
+    }
+}
+
+size_t sl_pool_reserved_bytes(void)
+{
+    return (size_t)sl_pool_add(&sl_pool_reserved, 0);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_POOL_IMPL
+
+#endif // SL_POOL_H
@@ -0,0 +1,392 @@
+#ifndef SL_PROFILE_H
+#define SL_PROFILE_H
+
+//
+// Profiling zones
+//
+// Drop a zone at the top of a block and it records when the block started and
+// how long it ran:
+//
+//     void UpdateParticles(particles* P)
+//     {
+//         SL_PROFILE_ZONE("UpdateParticles");
+//         ...
+//     }
+//
+// and at some point write everything out for chrome://tracing or Perfetto:
+//
+//     sl_profile_write_chrome_json("trace.json");
+//
+// Zones only exist when SL_PROFILE is defined.  Without it the macros expand to
+// nothing, so they can stay in shipping code.  sl.h and dyn_array.h have zones
+// in their hot paths (ParseIniFile, ReadEntireFile, _da_resize, the batch math)
+// that light up when those headers are built with SL_PROFILE too.
+//
+// Every thread writes to its own event buffer, so recording never takes a lock
+// or touches another thread's cache lines.  A buffer holds SL_PROFILE_MAX_EVENTS
+// events; after that new events are dropped and counted, not wrapped, so the
+// start of a trace is always intact.  Buffers outlive their threads so the
+// export sees everything that ran.
+//
+// Time comes from rdtsc on x86 (calibrated against the monotonic clock when the
+// trace is written) and clock_gettime / QueryPerformanceCounter elsewhere.
+// Define SL_PROFILE_NO_RDTSC if the TSC isn't invariant on your machines.
+//
+// Names must be string literals or otherwise outlive the export; only the
+// pointer is stored.
+//
+// SL_PROFILE_ZONE needs C++ or GCC / Clang (it's scoped with a destructor or
+// __attribute__((cleanup))).  Elsewhere use SL_PROFILE_BEGIN / SL_PROFILE_END.
+//
+// C compatible.  Define SL_PROFILE_IMPL in one file before including this to get
+// the implementation.
+//
+
+#if defined(SL_PROFILE)
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifndef SL_PROFILE_MAX_EVENTS
+#define SL_PROFILE_MAX_EVENTS (1 << 16)
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_profile_event
+{
+    const char* Name;
+    uint64_t Begin;
+    uint64_t End;
+} sl_profile_event;
+
+void sl_profile_record(const char* Name, uint64_t Begin, uint64_t End);
+
+// shows up as the track name in the trace viewer
+void sl_profile_set_thread_name(const char* Name);
+
+// 0 on success, -1 if the file couldn't be written
+int sl_profile_write_chrome_json(const char* Path);
+
+// events recorded / dropped so far across all threads
+int sl_profile_event_count(void);
+int sl_profile_dropped_count(void);
+
+// forget everything recorded so far, only while no other thread is recording
+void sl_profile_reset(void);
+
+static inline uint64_t
+sl_profile_ticks(void)
+{
+#if (defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)) && !defined(SL_PROFILE_NO_RDTSC)
+    return __rdtsc();
+#elif defined(_WIN32)
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+    return (uint64_t)Counter.QuadPart;
+#else
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+#endif
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#define SL_PROFILE_CAT2(a, b) a##b
+#define SL_PROFILE_CAT(a, b) SL_PROFILE_CAT2(a, b)
+
+#if defined(__cplusplus)
+
+struct sl_profile_zone
+{
+    const char* Name;
+    uint64_t Begin;
+    sl_profile_zone(const char* ZoneName) : Name(ZoneName), Begin(sl_profile_ticks()) {}
+    ~sl_profile_zone() { sl_profile_record(Name, Begin, sl_profile_ticks()); }
+};
+
+#define SL_PROFILE_ZONE(Name) \
+    sl_profile_zone SL_PROFILE_CAT(sl_profile_zone_, __LINE__)(Name)
+
+#elif defined(__GNUC__)
+
+typedef struct sl_profile_zone
+{
+    const char* Name;
+    uint64_t Begin;
+} sl_profile_zone;
+
+static inline void
+sl_profile_zone_end(sl_profile_zone* Zone)
+{
+    sl_profile_record(Zone->Name, Zone->Begin, sl_profile_ticks());
+}
+
+#define SL_PROFILE_ZONE(Name) \
+    sl_profile_zone SL_PROFILE_CAT(sl_profile_zone_, __LINE__) \
+        __attribute__((cleanup(sl_profile_zone_end))) = { (Name), sl_profile_ticks() }
+
+#else
+
+// NOTE(scott): plain C without cleanup has nothing to hang the end of a scope on
+#define SL_PROFILE_ZONE(Name)
+
+#endif
+
+#define SL_PROFILE_BEGIN(Var)       uint64_t Var = sl_profile_ticks()
+#define SL_PROFILE_END(Var, Name)   sl_profile_record((Name), (Var), sl_profile_ticks())
+
+#else // SL_PROFILE
+
+#define SL_PROFILE_ZONE(Name)
+#define SL_PROFILE_BEGIN(Var)
+#define SL_PROFILE_END(Var, Name)
+
+#endif // SL_PROFILE
+
+//
+// Implementation
+//
+#if defined(SL_PROFILE_IMPL) && defined(SL_PROFILE)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SL_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define SL_THREAD_LOCAL __declspec(thread)
+#else
+#define SL_THREAD_LOCAL __thread
+#endif
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_profile_buffer
+{
+    struct sl_profile_buffer* Next;
+    int ThreadId;
+    const char* ThreadName;
+    volatile int Count;
+    volatile int Dropped;
+    sl_profile_event Events[SL_PROFILE_MAX_EVENTS];
+} sl_profile_buffer;
+
+static sl_profile_buffer* volatile sl_profile_buffers;
+static volatile int sl_profile_next_thread_id;
+static SL_THREAD_LOCAL sl_profile_buffer* sl_profile_thread_buffer;
+
+// NOTE(scott): the first tick / nanosecond pair is taken when the first thread
+// starts recording, the second when the trace is written.  Dividing the two
+// spans gives the tick rate over the whole run, which beats a short
+// calibration loop at startup.
+static volatile int sl_profile_base_set;
+static uint64_t sl_profile_base_ticks;
+static uint64_t sl_profile_base_ns;
+
+static uint64_t
+sl_profile_now_ns(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER Counter, Frequency;
+    QueryPerformanceCounter(&Counter);
+    QueryPerformanceFrequency(&Frequency);
+    return (uint64_t)((double)Counter.QuadPart * 1e9 / (double)Frequency.QuadPart);
+#else
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+#endif
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define sl_profile_cas_ptr(p, e, d) (InterlockedCompareExchangePointer((PVOID volatile*)(p), (d), (e)) == (e))
+#define sl_profile_add(p, v)        InterlockedAdd((volatile LONG*)(p), (v))
+#define sl_profile_load(p)          (_ReadWriteBarrier(), *(p))
+#define sl_profile_store(p, v)      (_ReadWriteBarrier(), *(p) = (v))
+#else
+#define sl_profile_cas_ptr(p, e, d) __sync_bool_compare_and_swap((p), (e), (d))
+#define sl_profile_add(p, v)        __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define sl_profile_load(p)          __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define sl_profile_store(p, v)      __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+static sl_profile_buffer*
+sl_profile_thread_init(void)
+{
+    if (!sl_profile_load(&sl_profile_base_set))
+    {
+        // NOTE(scott): two threads can both get here; whichever stores last
+        // wins and both pairs are equally good
+        sl_profile_base_ticks = sl_profile_ticks();
+        sl_profile_base_ns = sl_profile_now_ns();
+        sl_profile_store(&sl_profile_base_set, 1);
+    }
+
+    sl_profile_buffer* Buffer = (sl_profile_buffer*)calloc(1, sizeof(sl_profile_buffer));
+    Buffer->ThreadId = sl_profile_add(&sl_profile_next_thread_id, 1);
+
+    // lock free push onto the list of every buffer
+    sl_profile_buffer* Head;
+    do
+    {
+        Head = sl_profile_buffers;
+        Buffer->Next = Head;
+    } while (!sl_profile_cas_ptr(&sl_profile_buffers, Head, Buffer));
+
+    sl_profile_thread_buffer = Buffer;
+    return Buffer;
+}
+
+void sl_profile_record(const char* Name, uint64_t Begin, uint64_t End)
+{
+    sl_profile_buffer* Buffer = sl_profile_thread_buffer;
+    if (!Buffer)
+        Buffer = sl_profile_thread_init();
+
+    int Count = Buffer->Count;
+    if (Count == SL_PROFILE_MAX_EVENTS)
+    {
+        Buffer->Dropped++;
+        return;
+    }
+
+    sl_profile_event* Event = Buffer->Events + Count;
+    Event->Name = Name;
+    Event->Begin = Begin;
+    Event->End = End;
+
+    // publish after the event is written so the exporter never sees half of one
+    sl_profile_store(&Buffer->Count, Count + 1);
+}
+
+void sl_profile_set_thread_name(const char* Name)
+{
+    sl_profile_buffer* Buffer = sl_profile_thread_buffer;
+    if (!Buffer)
+        Buffer = sl_profile_thread_init();
+    Buffer->ThreadName = Name;
+}
+
+int sl_profile_event_count(void)
+{
+    int Result = 0;
+    for (sl_profile_buffer* Buffer = sl_profile_buffers; Buffer; Buffer = Buffer->Next)
+        Result += sl_profile_load(&Buffer->Count);
+    return Result;
+}
+
+int sl_profile_dropped_count(void)
+{
+    int Result = 0;
+    for (sl_profile_buffer* Buffer = sl_profile_buffers; Buffer; Buffer = Buffer->Next)
+        Result += Buffer->Dropped;
+    return Result;
+}
+
+void sl_profile_reset(void)
+{
+    for (sl_profile_buffer* Buffer = sl_profile_buffers; Buffer; Buffer = Buffer->Next)
+    {
+        sl_profile_store(&Buffer->Count, 0);
+        Buffer->Dropped = 0;
+    }
+}
+
+static void
+sl_profile_write_string(FILE* File, const char* String)
+{
+    fputc('"', File);
+    for (const char* c = String ? String : "?"; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fprintf(File, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            fprintf(File, "\\u%04x", (unsigned char)*c);
+        else
+            fputc(*c, File);
+    }
+    fputc('"', File);
+}
+
+int sl_profile_write_chrome_json(const char* Path)
+{
+    FILE* File = fopen(Path, "w");
+    if (!File)
+        return -1;
+
+    double TicksPerUs = 1.0;
+    if (sl_profile_load(&sl_profile_base_set))
+    {
+        // NOTE(scott): too short a run gives a noisy rate, stretch it to 10ms
+        uint64_t EndNs = sl_profile_now_ns();
+        while (EndNs - sl_profile_base_ns < 10000000ull)
+            EndNs = sl_profile_now_ns();
+        uint64_t EndTicks = sl_profile_ticks();
+        TicksPerUs = (double)(EndTicks - sl_profile_base_ticks) / ((double)(EndNs - sl_profile_base_ns) / 1000.0);
+    }
+
+    fprintf(File, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    int First = 1;
+    for (sl_profile_buffer* Buffer = sl_profile_buffers; Buffer; Buffer = Buffer->Next)
+    {
+        if (Buffer->ThreadName)
+        {
+            fprintf(File, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    First ? "" : ",\n", Buffer->ThreadId);
+            sl_profile_write_string(File, Buffer->ThreadName);
+            fprintf(File, "}}");
+            First = 0;
+        }
+
+        int Count = sl_profile_load(&Buffer->Count);
+        for (int i = 0; i < Count; i++)
+        {
+            sl_profile_event* Event = Buffer->Events + i;
+            double Ts = (double)(int64_t)(Event->Begin - sl_profile_base_ticks) / TicksPerUs;
+            double Dur = (double)(Event->End - Event->Begin) / TicksPerUs;
+
+            fprintf(File, "%s{\"name\":", First ? "" : ",\n");
+            sl_profile_write_string(File, Event->Name);
+            fprintf(File, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    Buffer->ThreadId, Ts, Dur);
+            First = 0;
+        }
+    }
+
+    fprintf(File, "\n]}\n");
+    int Failed = ferror(File);
+    fclose(File);
+    return Failed ? -1 : 0;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_PROFILE_IMPL && SL_PROFILE
+
+#endif // SL_PROFILE_H
@@ -0,0 +1,681 @@
+#ifndef SL_RANDOM_H
+#define SL_RANDOM_H
+
+//
+// Random numbers
+//
+// A generator you own instead of rand(), which is slow, shares one lock and one
+// stream with the whole process, and isn't much good:
+//
+//     sl_random Rng;
+//     sl_random_seed(&Rng, 1234);
+//     real32 Jitter = sl_random_range(&Rng, -0.5f, 0.5f);
+//     i32 Pick = sl_random_below(&Rng, da_len(Items));
+//
+//     // one stream per thread, none of them overlap
+//     sl_random Mine = sl_random_stream(1234, ThreadIndex);
+//
+//     // batches, appended to dyn_arrays
+//     vec3f* Directions = NULL;
+//     sl_random_vec3f_sphere_da(&Mine, &Directions, 100000);
+//     sl_random_fill_normal(&Mine, Noise, Count, 0.f, 0.1f);
+//
+// The single value calls use xoshiro256** (64 bit output, period 2^256 - 1).
+// The batch calls run 8 xoshiro128++ generators side by side, 2 SSE2 registers
+// per state word, which only needs adds, shifts and xors so it maps straight
+// onto SIMD where PCG's 64 bit multiply doesn't.  The 8 lanes start 2^64 steps
+// apart and sl_random_jump() moves all of it 2^96 (2^128 for the scalar part),
+// so the streams from sl_random_stream() never overlap either.
+//
+// Floats take the top 24 bits, so uniforms are multiples of 2^-24 in [0, 1).
+// Normals are Box-Muller, two for every two uniforms, with SSE2 log and sincos
+// good to a few ulp.  Batches come in whole groups of 8 values and the rest
+// of a group past Count is dropped, so a batch of 5 costs the same as 8.
+// Without SIMD the same lanes run one at a time and give the same integers and
+// uniforms bit for bit.
+//
+// Define SL_RANDOM_IMPL in one file before including this to get the
+// implementation.  Needs sl.h and dyn_array.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct sl_random
+{
+    u64 S[4];               // xoshiro256**, the single value calls
+    u32 Lanes[4][8];        // xoshiro128++ x 8, the batch calls, word by lane
+} sl_random;
+
+void sl_random_seed(sl_random* R, u64 Seed);
+
+// seeded like sl_random_seed() then jumped Stream times
+sl_random sl_random_stream(u64 Seed, u32 Stream);
+
+// skips far enough ahead that what comes next can't overlap the old stream
+void sl_random_jump(sl_random* R);
+
+u64 sl_random_u64(sl_random* R);
+u32 sl_random_u32(sl_random* R);
+real32 sl_random_real32(sl_random* R);      // [0, 1)
+real64 sl_random_real64(sl_random* R);      // [0, 1)
+real32 sl_random_range(sl_random* R, real32 Min, real32 Max);
+
+// uniform in [0, Bound), without the modulo bias
+u32 sl_random_below(sl_random* R, u32 Bound);
+
+// mean 0, standard deviation 1
+real32 sl_random_normal(sl_random* R);
+
+//
+// Batch
+//
+
+void sl_random_fill_u32(sl_random* R, u32* Out, i32 Count);
+
+// [Min, Max), though Max itself can come out of the rounding in Min + (Max - Min) * U
+void sl_random_fill_real32(sl_random* R, real32* Out, i32 Count, real32 Min, real32 Max);
+void sl_random_fill_normal(sl_random* R, real32* Out, i32 Count, real32 Mean, real32 StdDev);
+
+//
+// dyn_array helpers, these append Count items
+//
+
+void sl_random_vec2f_box_da(sl_random* R, vec2f** List, i32 Count, vec2f Min, vec2f Max);
+void sl_random_vec3f_box_da(sl_random* R, vec3f** List, i32 Count, vec3f Min, vec3f Max);
+
+// uniform on the surface of the unit sphere
+void sl_random_vec3f_sphere_da(sl_random* R, vec3f** List, i32 Count);
+
+// uniform unit quaternions, i.e. uniformly random rotations
+void sl_random_quat_da(sl_random* R, quat** List, i32 Count);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_RANDOM_IMPL
+
+#include <string.h>
+#include <math.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// NOTE(scott): lanes are 2^64 apart from each other, streams 2^96
+global const u32 sl_random_lane_jump[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+global const u32 sl_random_lane_long_jump[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+global const u64 sl_random_jump128[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                          0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+internal inline u64
+sl_random_rotl64(u64 X, int K)
+{
+    return (X << K) | (X >> (64 - K));
+}
+
+internal inline u32
+sl_random_rotl32(u32 X, int K)
+{
+    return (X << K) | (X >> (32 - K));
+}
+
+internal u64
+sl_random_splitmix64(u64* X)
+{
+    u64 Z = (*X += 0x9e3779b97f4a7c15ULL);
+    Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebULL;
+    return Z ^ (Z >> 31);
+}
+
+// one lane of xoshiro128++, S is that lane's 4 words
+internal inline u32
+sl_random_lane_next(u32* S)
+{
+    u32 Result = sl_random_rotl32(S[0] + S[3], 7) + S[0];
+    u32 T = S[1] << 9;
+    S[2] ^= S[0];
+    S[3] ^= S[1];
+    S[1] ^= S[2];
+    S[0] ^= S[3];
+    S[2] ^= T;
+    S[3] = sl_random_rotl32(S[3], 11);
+    return Result;
+}
+
+internal void
+sl_random_lane_jump_by(u32* S, const u32* Jump)
+{
+    u32 Acc[4] = { 0, 0, 0, 0 };
+    for (i32 w = 0; w < 4; w++)
+    {
+        for (i32 b = 0; b < 32; b++)
+        {
+            if (Jump[w] & (1u << b))
+            {
+                for (i32 k = 0; k < 4; k++)
+                    Acc[k] ^= S[k];
+            }
+            sl_random_lane_next(S);
+        }
+    }
+    memcpy(S, Acc, sizeof(Acc));
+}
+
+void sl_random_seed(sl_random* R, u64 Seed)
+{
+    u64 X = Seed;
+    for (i32 k = 0; k < 4; k++)
+        R->S[k] = sl_random_splitmix64(&X);
+
+    u64 A = sl_random_splitmix64(&X);
+    u64 B = sl_random_splitmix64(&X);
+    u32 Lane[4] = { (u32)A, (u32)(A >> 32), (u32)B, (u32)(B >> 32) };
+    if (!(Lane[0] | Lane[1] | Lane[2] | Lane[3]))
+        Lane[0] = 1;
+    for (i32 l = 0; l < 8; l++)
+    {
+        for (i32 w = 0; w < 4; w++)
+            R->Lanes[w][l] = Lane[w];
+        sl_random_lane_jump_by(Lane, sl_random_lane_jump);
+    }
+}
+
+void sl_random_jump(sl_random* R)
+{
+    u64 Acc[4] = { 0, 0, 0, 0 };
+    for (i32 w = 0; w < 4; w++)
+    {
+        for (i32 b = 0; b < 64; b++)
+        {
+            if (sl_random_jump128[w] & (1ULL << b))
+            {
+                for (i32 k = 0; k < 4; k++)
+                    Acc[k] ^= R->S[k];
+            }
+            sl_random_u64(R);
+        }
+    }
+    memcpy(R->S, Acc, sizeof(Acc));
+
+    for (i32 l = 0; l < 8; l++)
+    {
+        u32 Lane[4] = { R->Lanes[0][l], R->Lanes[1][l], R->Lanes[2][l], R->Lanes[3][l] };
+        sl_random_lane_jump_by(Lane, sl_random_lane_long_jump);
+        for (i32 w = 0; w < 4; w++)
+            R->Lanes[w][l] = Lane[w];
+    }
+}
+
+sl_random sl_random_stream(u64 Seed, u32 Stream)
+{
+    sl_random Result;
+    sl_random_seed(&Result, Seed);
+    for (u32 i = 0; i < Stream; i++)
+        sl_random_jump(&Result);
+    return Result;
+}
+
+u64 sl_random_u64(sl_random* R)
+{
+    u64* S = R->S;
+    u64 Result = sl_random_rotl64(S[1] * 5, 7) * 9;
+    u64 T = S[1] << 17;
+    S[2] ^= S[0];
+    S[3] ^= S[1];
+    S[1] ^= S[2];
+    S[0] ^= S[3];
+    S[2] ^= T;
+    S[3] = sl_random_rotl64(S[3], 45);
+    return Result;
+}
+
+u32 sl_random_u32(sl_random* R)
+{
+    return (u32)(sl_random_u64(R) >> 32);
+}
+
+real32 sl_random_real32(sl_random* R)
+{
+    return (real32)(sl_random_u64(R) >> 40) * (1.f / 16777216.f);
+}
+
+real64 sl_random_real64(sl_random* R)
+{
+    return (real64)(sl_random_u64(R) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+real32 sl_random_range(sl_random* R, real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * sl_random_real32(R);
+}
+
+u32 sl_random_below(sl_random* R, u32 Bound)
+{
+    // NOTE(scott): Lemire's multiply and shift, only redraws in the sliver that
+    // would be biased
+    u64 M = (u64)sl_random_u32(R) * Bound;
+    u32 Low = (u32)M;
+    if (Low < Bound)
+    {
+        u32 Threshold = (0u - Bound) % Bound;
+        while (Low < Threshold)
+        {
+            M = (u64)sl_random_u32(R) * Bound;
+            Low = (u32)M;
+        }
+    }
+    return (u32)(M >> 32);
+}
+
+real32 sl_random_normal(sl_random* R)
+{
+    real32 U1 = 1.f - sl_random_real32(R);      // (0, 1], no log(0)
+    real32 U2 = sl_random_real32(R);
+    return sqrtf(-2.f * logf(U1)) * cosf((real32)(2.0 * SL_PI) * U2);
+}
+
+//
+// Batch kernels
+//
+// NOTE(scott): every kernel works in groups of 8, one value per lane, in lane
+// order.  Whatever is left of the last group past Count is thrown away.
+//
+
+#ifdef SL_SSE2
+
+internal inline __m128i
+sl_random_rotl4(__m128i X, int K)
+{
+    return _mm_or_si128(_mm_slli_epi32(X, K), _mm_srli_epi32(X, 32 - K));
+}
+
+// 4 lanes of xoshiro128++ at once, S is one register per state word
+internal inline __m128i
+sl_random_next4(__m128i* S)
+{
+    __m128i Result = _mm_add_epi32(sl_random_rotl4(_mm_add_epi32(S[0], S[3]), 7), S[0]);
+    __m128i T = _mm_slli_epi32(S[1], 9);
+    S[2] = _mm_xor_si128(S[2], S[0]);
+    S[3] = _mm_xor_si128(S[3], S[1]);
+    S[1] = _mm_xor_si128(S[1], S[2]);
+    S[0] = _mm_xor_si128(S[0], S[3]);
+    S[2] = _mm_xor_si128(S[2], T);
+    S[3] = sl_random_rotl4(S[3], 11);
+    return Result;
+}
+
+internal inline void
+sl_random_load_lanes(sl_random* R, __m128i* Lo, __m128i* Hi)
+{
+    for (i32 w = 0; w < 4; w++)
+    {
+        Lo[w] = _mm_loadu_si128((__m128i*)&R->Lanes[w][0]);
+        Hi[w] = _mm_loadu_si128((__m128i*)&R->Lanes[w][4]);
+    }
+}
+
+internal inline void
+sl_random_store_lanes(sl_random* R, __m128i* Lo, __m128i* Hi)
+{
+    for (i32 w = 0; w < 4; w++)
+    {
+        _mm_storeu_si128((__m128i*)&R->Lanes[w][0], Lo[w]);
+        _mm_storeu_si128((__m128i*)&R->Lanes[w][4], Hi[w]);
+    }
+}
+
+// top 24 bits to [0, 1)
+internal inline __m128
+sl_random_unit4(__m128i X)
+{
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(X, 8)), _mm_set1_ps(1.f / 16777216.f));
+}
+
+// NOTE(scott): Cephes logf, the way sse_mathfun does it.  Only ever sees
+// (0, 1] here so there's no handling for zero, negatives or infinity.
+internal inline __m128
+sl_random_log4(__m128 X)
+{
+    __m128 One = _mm_set1_ps(1.f);
+    __m128i Bits = _mm_castps_si128(X);
+    __m128 E = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(Bits, 23), _mm_set1_epi32(0x7e)));
+    X = _mm_or_ps(_mm_and_ps(X, _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000))), _mm_set1_ps(0.5f));
+
+    // mantissa in [sqrt(1/2), sqrt(2)), then x - 1
+    __m128 Small = _mm_cmplt_ps(X, _mm_set1_ps(0.707106781186547524f));
+    __m128 Extra = _mm_and_ps(X, Small);
+    X = _mm_sub_ps(X, One);
+    E = _mm_sub_ps(E, _mm_and_ps(One, Small));
+    X = _mm_add_ps(X, Extra);
+
+    __m128 Z = _mm_mul_ps(X, X);
+    __m128 Y = _mm_set1_ps(7.0376836292E-2f);
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(-1.1514610310E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(1.1676998740E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(-1.2420140846E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(1.4249322787E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(-1.6668057665E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(2.0000714765E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(-2.4999993993E-1f));
+    Y = _mm_add_ps(_mm_mul_ps(Y, X), _mm_set1_ps(3.3333331174E-1f));
+    Y = _mm_mul_ps(_mm_mul_ps(Y, X), Z);
+
+    Y = _mm_add_ps(Y, _mm_mul_ps(E, _mm_set1_ps(-2.12194440E-4f)));
+    Y = _mm_sub_ps(Y, _mm_mul_ps(Z, _mm_set1_ps(0.5f)));
+    X = _mm_add_ps(X, Y);
+    return _mm_add_ps(X, _mm_mul_ps(E, _mm_set1_ps(0.693359375f)));
+}
+
+// NOTE(scott): Cephes sincosf, reduced to an octant with the 3 part Cody-Waite
+// constants.  Good for the [-pi, pi) it gets here.
+internal inline void
+sl_random_sincos4(__m128 X, __m128* Sin, __m128* Cos)
+{
+    __m128 SignMask = _mm_set1_ps(-0.f);
+    __m128 SinSign = _mm_and_ps(X, SignMask);
+    X = _mm_andnot_ps(SignMask, X);
+
+    __m128i J = _mm_cvttps_epi32(_mm_mul_ps(X, _mm_set1_ps(1.27323954473516f)));     // 4 / pi
+    J = _mm_and_si128(_mm_add_epi32(J, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 Y = _mm_cvtepi32_ps(J);
+
+    __m128 SwapSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(J, _mm_set1_epi32(4)), 29));
+    __m128 CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(J, _mm_set1_epi32(2)),
+                                                                      _mm_set1_epi32(4)), 29));
+    __m128 PolyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(J, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    SinSign = _mm_xor_ps(SinSign, SwapSin);
+
+    X = _mm_sub_ps(X, _mm_mul_ps(Y, _mm_set1_ps(0.78515625f)));
+    X = _mm_sub_ps(X, _mm_mul_ps(Y, _mm_set1_ps(2.4187564849853515625e-4f)));
+    X = _mm_sub_ps(X, _mm_mul_ps(Y, _mm_set1_ps(3.77489497744594108e-8f)));
+    __m128 Z = _mm_mul_ps(X, X);
+
+    __m128 C = _mm_set1_ps(2.443315711809948E-005f);
+    C = _mm_add_ps(_mm_mul_ps(C, Z), _mm_set1_ps(-1.388731625493765E-003f));
+    C = _mm_add_ps(_mm_mul_ps(C, Z), _mm_set1_ps(4.166664568298827E-002f));
+    C = _mm_mul_ps(_mm_mul_ps(C, Z), Z);
+    C = _mm_add_ps(_mm_sub_ps(C, _mm_mul_ps(Z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+    __m128 S = _mm_set1_ps(-1.9515295891E-4f);
+    S = _mm_add_ps(_mm_mul_ps(S, Z), _mm_set1_ps(8.3321608736E-3f));
+    S = _mm_add_ps(_mm_mul_ps(S, Z), _mm_set1_ps(-1.6666654611E-1f));
+    S = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(S, Z), X), X);
+
+    __m128 SinPart = _mm_or_ps(_mm_and_ps(PolyMask, S), _mm_andnot_ps(PolyMask, C));
+    __m128 CosPart = _mm_or_ps(_mm_and_ps(PolyMask, C), _mm_andnot_ps(PolyMask, S));
+    *Sin = _mm_xor_ps(SinPart, SinSign);
+    *Cos = _mm_xor_ps(CosPart, CosSign);
+}
+
+#endif // SL_SSE2
+
+// one group of 8 values from the lanes, without SIMD
+internal inline void
+sl_random_group(sl_random* R, u32* Out)
+{
+    for (i32 l = 0; l < 8; l++)
+    {
+        u32 Lane[4] = { R->Lanes[0][l], R->Lanes[1][l], R->Lanes[2][l], R->Lanes[3][l] };
+        Out[l] = sl_random_lane_next(Lane);
+        for (i32 w = 0; w < 4; w++)
+            R->Lanes[w][l] = Lane[w];
+    }
+}
+
+void sl_random_fill_u32(sl_random* R, u32* Out, i32 Count)
+{
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128i Lo[4], Hi[4];
+    sl_random_load_lanes(R, Lo, Hi);
+    for (; i + 8 <= Count; i += 8)
+    {
+        _mm_storeu_si128((__m128i*)(Out + i), sl_random_next4(Lo));
+        _mm_storeu_si128((__m128i*)(Out + i + 4), sl_random_next4(Hi));
+    }
+    sl_random_store_lanes(R, Lo, Hi);
+#else
+    for (; i + 8 <= Count; i += 8)
+        sl_random_group(R, Out + i);
+#endif
+    if (i < Count)
+    {
+        u32 Tail[8];
+        sl_random_group(R, Tail);
+        memcpy(Out + i, Tail, sizeof(u32) * (Count - i));
+    }
+}
+
+void sl_random_fill_real32(sl_random* R, real32* Out, i32 Count, real32 Min, real32 Max)
+{
+    SL_PROFILE_ZONE("sl_random_fill_real32");
+    real32 Scale = Max - Min;
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128i Lo[4], Hi[4];
+    sl_random_load_lanes(R, Lo, Hi);
+    __m128 VMin = _mm_set1_ps(Min), VScale = _mm_set1_ps(Scale);
+    for (; i + 8 <= Count; i += 8)
+    {
+        _mm_storeu_ps(Out + i, _mm_add_ps(VMin, _mm_mul_ps(VScale, sl_random_unit4(sl_random_next4(Lo)))));
+        _mm_storeu_ps(Out + i + 4, _mm_add_ps(VMin, _mm_mul_ps(VScale, sl_random_unit4(sl_random_next4(Hi)))));
+    }
+    sl_random_store_lanes(R, Lo, Hi);
+#endif
+    for (; i < Count; i += 8)
+    {
+        u32 Group[8];
+        sl_random_group(R, Group);
+        for (i32 k = 0; k < 8 && i + k < Count; k++)
+            Out[i + k] = Min + Scale * ((real32)(Group[k] >> 8) * (1.f / 16777216.f));
+    }
+}
+
+// NOTE(scott): 16 normals from 2 groups, the cosines then the sines
+internal void
+sl_random_normal_group(sl_random* R, real32* Out, real32 Mean, real32 StdDev)
+{
+    u32 A[8], B[8];
+    sl_random_group(R, A);
+    sl_random_group(R, B);
+    for (i32 k = 0; k < 8; k++)
+    {
+        real32 U1 = 1.f - (real32)(A[k] >> 8) * (1.f / 16777216.f);
+        real32 Angle = (real32)(2.0 * SL_PI) * ((real32)(B[k] >> 8) * (1.f / 16777216.f)) - (real32)SL_PI;
+        real32 Radius = sqrtf(-2.f * logf(U1)) * StdDev;
+        Out[k] = Mean + Radius * cosf(Angle);
+        Out[k + 8] = Mean + Radius * sinf(Angle);
+    }
+}
+
+void sl_random_fill_normal(sl_random* R, real32* Out, i32 Count, real32 Mean, real32 StdDev)
+{
+    SL_PROFILE_ZONE("sl_random_fill_normal");
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128i Lo[4], Hi[4];
+    sl_random_load_lanes(R, Lo, Hi);
+    __m128 One = _mm_set1_ps(1.f), VMean = _mm_set1_ps(Mean), VStdDev = _mm_set1_ps(StdDev);
+    __m128 TwoPi = _mm_set1_ps((real32)(2.0 * SL_PI)), Pi = _mm_set1_ps((real32)SL_PI);
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m128i A[2] = { sl_random_next4(Lo), sl_random_next4(Hi) };
+        __m128i B[2] = { sl_random_next4(Lo), sl_random_next4(Hi) };
+        for (i32 h = 0; h < 2; h++)
+        {
+            __m128 U1 = _mm_sub_ps(One, sl_random_unit4(A[h]));
+            __m128 Angle = _mm_sub_ps(_mm_mul_ps(TwoPi, sl_random_unit4(B[h])), Pi);
+            __m128 Radius = _mm_mul_ps(_mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(-2.f), sl_random_log4(U1))), VStdDev);
+            __m128 Sin, Cos;
+            sl_random_sincos4(Angle, &Sin, &Cos);
+            _mm_storeu_ps(Out + i + 4 * h, _mm_add_ps(VMean, _mm_mul_ps(Radius, Cos)));
+            _mm_storeu_ps(Out + i + 8 + 4 * h, _mm_add_ps(VMean, _mm_mul_ps(Radius, Sin)));
+        }
+    }
+    sl_random_store_lanes(R, Lo, Hi);
+#endif
+    for (; i < Count; i += 16)
+    {
+        real32 Group[16];
+        sl_random_normal_group(R, Group, Mean, StdDev);
+        memcpy(Out + i, Group, sizeof(real32) * (Count - i < 16 ? Count - i : 16));
+    }
+}
+
+//
+// dyn_array helpers
+//
+
+// NOTE(scott): grows the list by Count and returns where the new items start
+internal void*
+sl_random_grow(void** List, size_t Size, i32 Count)
+{
+    i32 Old = da_len(*List);
+    if (Old + Count > da_cap(*List))
+    {
+        i32 Capacity = da_cap(*List) * 2;
+        *List = _da_resize(*List, Size, (size_t)(Capacity > Old + Count ? Capacity : Old + Count));
+    }
+    _da_hdr(*List) = Old + Count;
+    return (char*)*List + Size * Old;
+}
+
+void sl_random_vec2f_box_da(sl_random* R, vec2f** List, i32 Count, vec2f Min, vec2f Max)
+{
+    if (Count <= 0)
+        return;
+    vec2f* Out = (vec2f*)sl_random_grow((void**)List, sizeof(vec2f), Count);
+    sl_random_fill_real32(R, &Out[0].X, 2 * Count, 0.f, 1.f);
+    vec2f Scale = Vec2f(Max.X - Min.X, Max.Y - Min.Y);
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i].X = Min.X + Scale.X * Out[i].X;
+        Out[i].Y = Min.Y + Scale.Y * Out[i].Y;
+    }
+}
+
+void sl_random_vec3f_box_da(sl_random* R, vec3f** List, i32 Count, vec3f Min, vec3f Max)
+{
+    if (Count <= 0)
+        return;
+    vec3f* Out = (vec3f*)sl_random_grow((void**)List, sizeof(vec3f), Count);
+    sl_random_fill_real32(R, &Out[0].X, 3 * Count, 0.f, 1.f);
+    vec3f Scale = Vec3f(Max.X - Min.X, Max.Y - Min.Y, Max.Z - Min.Z);
+    for (i32 i = 0; i < Count; i++)
+    {
+        Out[i].X = Min.X + Scale.X * Out[i].X;
+        Out[i].Y = Min.Y + Scale.Y * Out[i].Y;
+        Out[i].Z = Min.Z + Scale.Z * Out[i].Z;
+    }
+}
+
+#define SL_RANDOM_CHUNK 64
+
+void sl_random_vec3f_sphere_da(sl_random* R, vec3f** List, i32 Count)
+{
+    if (Count <= 0)
+        return;
+    vec3f* Out = (vec3f*)sl_random_grow((void**)List, sizeof(vec3f), Count);
+
+    // NOTE(scott): Z uniform in [-1, 1] and an angle around it (Archimedes), one
+    // sincos each instead of normalizing 3 normals
+    real32 U[2 * SL_RANDOM_CHUNK];
+    for (i32 Start = 0; Start < Count; Start += SL_RANDOM_CHUNK)
+    {
+        i32 Chunk = Count - Start < SL_RANDOM_CHUNK ? Count - Start : SL_RANDOM_CHUNK;
+        sl_random_fill_real32(R, U, 2 * ((Chunk + 3) & ~3), 0.f, 1.f);
+        real32* V = U + ((Chunk + 3) & ~3);
+        vec3f* Dest = Out + Start;
+        i32 i = 0;
+#ifdef SL_SSE2
+        for (; i + 4 <= Chunk; i += 4)
+        {
+            __m128 Z = _mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_set1_ps(2.f), _mm_loadu_ps(U + i)));
+            __m128 Radius = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(Z, Z)), _mm_setzero_ps()));
+            __m128 Angle = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps((real32)(2.0 * SL_PI)), _mm_loadu_ps(V + i)),
+                                      _mm_set1_ps((real32)SL_PI));
+            __m128 Sin, Cos;
+            sl_random_sincos4(Angle, &Sin, &Cos);
+            real32 X[4], Y[4], Zs[4];
+            _mm_storeu_ps(X, _mm_mul_ps(Radius, Cos));
+            _mm_storeu_ps(Y, _mm_mul_ps(Radius, Sin));
+            _mm_storeu_ps(Zs, Z);
+            for (i32 k = 0; k < 4; k++)
+                Dest[i + k] = Vec3f(X[k], Y[k], Zs[k]);
+        }
+#endif
+        for (; i < Chunk; i++)
+        {
+            real32 Z = 1.f - 2.f * U[i];
+            real32 Radius = sqrtf(1.f - Z * Z > 0.f ? 1.f - Z * Z : 0.f);
+            real32 Angle = (real32)(2.0 * SL_PI) * V[i] - (real32)SL_PI;
+            Dest[i] = Vec3f(Radius * cosf(Angle), Radius * sinf(Angle), Z);
+        }
+    }
+}
+
+void sl_random_quat_da(sl_random* R, quat** List, i32 Count)
+{
+    if (Count <= 0)
+        return;
+    quat* Out = (quat*)sl_random_grow((void**)List, sizeof(quat), Count);
+
+    // NOTE(scott): Shoemake's subgroup algorithm, 3 uniforms per rotation
+    real32 U[3 * SL_RANDOM_CHUNK];
+    for (i32 Start = 0; Start < Count; Start += SL_RANDOM_CHUNK)
+    {
+        i32 Chunk = Count - Start < SL_RANDOM_CHUNK ? Count - Start : SL_RANDOM_CHUNK;
+        i32 Padded = (Chunk + 3) & ~3;
+        sl_random_fill_real32(R, U, 3 * Padded, 0.f, 1.f);
+        real32* V = U + Padded;
+        real32* W = V + Padded;
+        quat* Dest = Out + Start;
+        i32 i = 0;
+#ifdef SL_SSE2
+        __m128 TwoPi = _mm_set1_ps((real32)(2.0 * SL_PI)), Pi = _mm_set1_ps((real32)SL_PI);
+        for (; i + 4 <= Chunk; i += 4)
+        {
+            __m128 U1 = _mm_loadu_ps(U + i);
+            __m128 A = _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.f), U1));
+            __m128 B = _mm_sqrt_ps(U1);
+            __m128 S1, C1, S2, C2;
+            sl_random_sincos4(_mm_sub_ps(_mm_mul_ps(TwoPi, _mm_loadu_ps(V + i)), Pi), &S1, &C1);
+            sl_random_sincos4(_mm_sub_ps(_mm_mul_ps(TwoPi, _mm_loadu_ps(W + i)), Pi), &S2, &C2);
+            __m128 X = _mm_mul_ps(A, S1), Y = _mm_mul_ps(A, C1);
+            __m128 Z = _mm_mul_ps(B, S2), Q = _mm_mul_ps(B, C2);
+            _MM_TRANSPOSE4_PS(X, Y, Z, Q);
+            _mm_storeu_ps(Dest[i].E, X);
+            _mm_storeu_ps(Dest[i + 1].E, Y);
+            _mm_storeu_ps(Dest[i + 2].E, Z);
+            _mm_storeu_ps(Dest[i + 3].E, Q);
+        }
+#endif
+        for (; i < Chunk; i++)
+        {
+            real32 A = sqrtf(1.f - U[i]), B = sqrtf(U[i]);
+            real32 Angle1 = (real32)(2.0 * SL_PI) * V[i] - (real32)SL_PI;
+            real32 Angle2 = (real32)(2.0 * SL_PI) * W[i] - (real32)SL_PI;
+            Dest[i] = Quat(A * sinf(Angle1), A * cosf(Angle1), B * sinf(Angle2), B * cosf(Angle2));
+        }
+    }
+}
+
+#undef SL_RANDOM_CHUNK
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_RANDOM_IMPL
+
+#endif // SL_RANDOM_H
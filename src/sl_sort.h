@@ -0,0 +1,502 @@
+#ifndef SL_SORT_H
+#define SL_SORT_H
+
+//
+// Sorting and searching
+//
+// qsort() calls the comparator through a pointer for every comparison.  These
+// sorts are generated per type so the comparison is inlined:
+//
+//     #define PointLessX(A, B) ((A)->X < (B)->X)
+//     SL_SORT_DEFINE(SortPointsByX, vec3f, PointLessX)
+//
+// which defines, for Type* arrays:
+//
+//     SortPointsByX(Array, Count)                 introsort, not stable
+//     SortPointsByX_parallel(Array, Count)        sorted runs merged on the job system, stable
+//     SortPointsByX_lower_bound(Array, Count, &Key)   first index not less than Key
+//     SortPointsByX_upper_bound(Array, Count, &Key)   first index greater than Key
+//     SortPointsByX_find(Array, Count, &Key)      index of an element equal to Key or -1
+//
+// Less gets two const Type* and is a macro or an inline function.  The
+// introsort is median of three quicksort that falls back to heapsort when the
+// partitions go bad, with insertion sort for the small ranges, so it's
+// O(n log n) worst case.
+//
+// Integer and float keys can be radix sorted instead, which is O(n) and usually
+// several times faster than any comparison sort on big arrays:
+//
+//     sl_radix_sort_f32(Values, Count, NULL);
+//
+// and whole records can be sorted by one 32-bit field, e.g. points by Z:
+//
+//     sl_radix_sort_by_f32_key(Points, da_len(Points), sizeof(vec3f), offsetof(vec3f, Z));
+//
+// The radix sorts are stable and take an optional scratch buffer the size of
+// the input (NULL allocates one).  Floats sort in IEEE order, -0 before +0.
+//
+// The parallel sort sorts chunks as jobs and merges them in pairs, so it needs
+// Count elements of scratch memory.  It runs inline without sl_job_init().
+//
+// C compatible.  Define SL_SORT_IMPL in one file before including this to get the
+// radix sorts.  Needs sl_job.h and dyn_array.h.
+//
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sl_job.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void sl_radix_sort_u32(unsigned int* Keys, int Count, unsigned int* Scratch);
+void sl_radix_sort_i32(int* Keys, int Count, int* Scratch);
+void sl_radix_sort_f32(float* Keys, int Count, float* Scratch);
+
+// sorts Count records of Stride bytes by the 32-bit key at KeyOffset in each
+void sl_radix_sort_by_u32_key(void* Records, int Count, int Stride, int KeyOffset);
+void sl_radix_sort_by_i32_key(void* Records, int Count, int Stride, int KeyOffset);
+void sl_radix_sort_by_f32_key(void* Records, int Count, int Stride, int KeyOffset);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#if defined(__GNUC__)
+#define SL_SORT_UNUSED __attribute__((unused))
+#else
+#define SL_SORT_UNUSED
+#endif
+
+#define SL_SORT_INSERTION_LIMIT 24
+// NOTE(scott): below this the parallel sort just sorts, the jobs aren't worth it
+#define SL_SORT_PARALLEL_MIN    (64 * 1024)
+
+#define SL_SORT_DEFINE(Name, Type, Less) \
+    static SL_SORT_UNUSED void Name##_insertion_(Type* A, int Count) \
+    { \
+        for (int i = 1; i < Count; i++) \
+        { \
+            Type Value = A[i]; \
+            int j = i; \
+            while (j > 0 && Less(&Value, &A[j - 1])) \
+            { \
+                A[j] = A[j - 1]; \
+                j--; \
+            } \
+            A[j] = Value; \
+        } \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_sift_(Type* A, int Root, int Count) \
+    { \
+        Type Value = A[Root]; \
+        for (;;) \
+        { \
+            int Child = Root * 2 + 1; \
+            if (Child >= Count) \
+                break; \
+            if (Child + 1 < Count && Less(&A[Child], &A[Child + 1])) \
+                Child++; \
+            if (!Less(&Value, &A[Child])) \
+                break; \
+            A[Root] = A[Child]; \
+            Root = Child; \
+        } \
+        A[Root] = Value; \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_heap_(Type* A, int Count) \
+    { \
+        for (int i = Count / 2 - 1; i >= 0; i--) \
+            Name##_sift_(A, i, Count); \
+        for (int i = Count - 1; i > 0; i--) \
+        { \
+            Type Top = A[0]; \
+            A[0] = A[i]; \
+            A[i] = Top; \
+            Name##_sift_(A, 0, i); \
+        } \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_swap_(Type* A, Type* B) \
+    { \
+        Type T = *A; \
+        *A = *B; \
+        *B = T; \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_intro_(Type* A, int Count, int Depth) \
+    { \
+        while (Count > SL_SORT_INSERTION_LIMIT) \
+        { \
+            if (Depth-- == 0) \
+            { \
+                Name##_heap_(A, Count); \
+                return; \
+            } \
+            /* median of three to A[0], which also leaves sentinels at both ends */ \
+            int Mid = Count / 2; \
+            if (Less(&A[Mid], &A[0])) Name##_swap_(&A[Mid], &A[0]); \
+            if (Less(&A[Count - 1], &A[Mid])) Name##_swap_(&A[Count - 1], &A[Mid]); \
+            if (Less(&A[Mid], &A[0])) Name##_swap_(&A[Mid], &A[0]); \
+            Name##_swap_(&A[0], &A[Mid]); \
+            Type Pivot = A[0]; \
+            int i = 0, j = Count; \
+            for (;;) \
+            { \
+                do i++; while (Less(&A[i], &Pivot)); \
+                do j--; while (Less(&Pivot, &A[j])); \
+                if (i >= j) \
+                    break; \
+                Name##_swap_(&A[i], &A[j]); \
+            } \
+            Name##_swap_(&A[0], &A[j]); \
+            /* recurse into the smaller side so the stack stays O(log n) */ \
+            if (j < Count - j - 1) \
+            { \
+                Name##_intro_(A, j, Depth); \
+                A += j + 1; \
+                Count -= j + 1; \
+            } \
+            else \
+            { \
+                Name##_intro_(A + j + 1, Count - j - 1, Depth); \
+                Count = j; \
+            } \
+        } \
+        Name##_insertion_(A, Count); \
+    } \
+    \
+    static SL_SORT_UNUSED void Name(Type* A, int Count) \
+    { \
+        int Depth = 0; \
+        for (int n = Count; n > 1; n >>= 1) \
+            Depth += 2; \
+        Name##_intro_(A, Count, Depth); \
+    } \
+    \
+    static SL_SORT_UNUSED int Name##_lower_bound(const Type* A, int Count, const Type* Key) \
+    { \
+        int First = 0; \
+        while (Count > 0) \
+        { \
+            int Half = Count / 2; \
+            if (Less(&A[First + Half], Key)) \
+            { \
+                First += Half + 1; \
+                Count -= Half + 1; \
+            } \
+            else \
+            { \
+                Count = Half; \
+            } \
+        } \
+        return First; \
+    } \
+    \
+    static SL_SORT_UNUSED int Name##_upper_bound(const Type* A, int Count, const Type* Key) \
+    { \
+        int First = 0; \
+        while (Count > 0) \
+        { \
+            int Half = Count / 2; \
+            if (!Less(Key, &A[First + Half])) \
+            { \
+                First += Half + 1; \
+                Count -= Half + 1; \
+            } \
+            else \
+            { \
+                Count = Half; \
+            } \
+        } \
+        return First; \
+    } \
+    \
+    static SL_SORT_UNUSED int Name##_find(const Type* A, int Count, const Type* Key) \
+    { \
+        int i = Name##_lower_bound(A, Count, Key); \
+        return (i < Count && !Less(Key, &A[i])) ? i : -1; \
+    } \
+    \
+    /* stable merge of [Begin, Mid) and [Mid, End) from From into To */ \
+    static SL_SORT_UNUSED void Name##_merge_(const Type* From, Type* To, int Begin, int Mid, int End) \
+    { \
+        int i = Begin, j = Mid, k = Begin; \
+        while (i < Mid && j < End) \
+            To[k++] = Less(&From[j], &From[i]) ? From[j++] : From[i++]; \
+        while (i < Mid) \
+            To[k++] = From[i++]; \
+        while (j < End) \
+            To[k++] = From[j++]; \
+    } \
+    \
+    /* serial stable merge sort of A using Temp, the result ends up in A */ \
+    static SL_SORT_UNUSED void Name##_merge_sort_(Type* A, Type* Temp, int Count) \
+    { \
+        const int Small = 16; \
+        for (int i = 0; i < Count; i += Small) \
+            Name##_insertion_(A + i, Count - i < Small ? Count - i : Small); \
+        Type* From = A; \
+        Type* To = Temp; \
+        for (int Width = Small; Width < Count; Width *= 2) \
+        { \
+            for (int First = 0; First < Count; First += Width * 2) \
+            { \
+                int Mid = First + Width < Count ? First + Width : Count; \
+                int Last = Mid + Width < Count ? Mid + Width : Count; \
+                Name##_merge_(From, To, First, Mid, Last); \
+            } \
+            Type* Swap = From; \
+            From = To; \
+            To = Swap; \
+        } \
+        if (From != A) \
+            memcpy(A, From, sizeof(Type) * (size_t)Count); \
+    } \
+    \
+    typedef struct Name##_pass_ \
+    { \
+        Type* From; \
+        Type* To; \
+        int Count; \
+        int Width; \
+    } Name##_pass_; \
+    \
+    static SL_SORT_UNUSED void Name##_sort_runs_(void* Array, int Begin, int End, void* UserData) \
+    { \
+        Name##_pass_* Pass = (Name##_pass_*)UserData; \
+        for (int Run = Begin; Run < End; Run++) \
+        { \
+            int First = Run * Pass->Width; \
+            int Last = First + Pass->Width < Pass->Count ? First + Pass->Width : Pass->Count; \
+            /* merge sort rather than the introsort so the result is stable */ \
+            Name##_merge_sort_(Pass->From + First, Pass->To + First, Last - First); \
+        } \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_merge_runs_(void* Array, int Begin, int End, void* UserData) \
+    { \
+        Name##_pass_* Pass = (Name##_pass_*)UserData; \
+        for (int Pair = Begin; Pair < End; Pair++) \
+        { \
+            int First = Pair * Pass->Width * 2; \
+            int Mid = First + Pass->Width < Pass->Count ? First + Pass->Width : Pass->Count; \
+            int Last = Mid + Pass->Width < Pass->Count ? Mid + Pass->Width : Pass->Count; \
+            Name##_merge_(Pass->From, Pass->To, First, Mid, Last); \
+        } \
+    } \
+    \
+    static SL_SORT_UNUSED void Name##_parallel(Type* A, int Count) \
+    { \
+        Type* Temp = (Type*)malloc(sizeof(Type) * (size_t)(Count > 0 ? Count : 1)); \
+        int Threads = sl_job_thread_count(); \
+        if (Count < SL_SORT_PARALLEL_MIN || Threads == 1) \
+        { \
+            Name##_merge_sort_(A, Temp, Count); \
+            free(Temp); \
+            return; \
+        } \
+        /* a few runs per thread so stealing can even out the load */ \
+        int Runs = Threads * 4; \
+        Name##_pass_ Pass; \
+        Pass.From = A; \
+        Pass.To = Temp; \
+        Pass.Count = Count; \
+        Pass.Width = (Count + Runs - 1) / Runs; \
+        sl_parallel_for_range(NULL, Runs, 1, Name##_sort_runs_, &Pass); \
+        while (Pass.Width < Count) \
+        { \
+            int Pairs = (Count + Pass.Width * 2 - 1) / (Pass.Width * 2); \
+            sl_parallel_for_range(NULL, Pairs, 1, Name##_merge_runs_, &Pass); \
+            Type* Swap = Pass.From; \
+            Pass.From = Pass.To; \
+            Pass.To = Swap; \
+            Pass.Width *= 2; \
+        } \
+        if (Pass.From != A) \
+            memcpy(A, Pass.From, sizeof(Type) * (size_t)Count); \
+        free(Temp); \
+    }
+
+//
+// Implementation
+//
+#ifdef SL_SORT_IMPL
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// NOTE(scott): flips the bits so unsigned order matches signed or float order
+#define sl_radix_key_u32(x) (x)
+#define sl_radix_key_i32(x) ((x) ^ 0x80000000u)
+#define sl_radix_key_f32(x) ((x) ^ ((unsigned int)(-(int)((x) >> 31)) | 0x80000000u))
+
+// LSD radix sort of Keys carrying Values (may be NULL) along, 8 bits a pass.
+// Passes where every key has the same byte are skipped.  The result ends up
+// back in Keys/Values.
+static void
+sl_radix_sort_pairs(unsigned int* Keys, unsigned int* Values, int Count, unsigned int* KeyScratch, unsigned int* ValueScratch)
+{
+    unsigned int Histogram[4][256];
+    memset(Histogram, 0, sizeof(Histogram));
+    for (int i = 0; i < Count; i++)
+    {
+        unsigned int Key = Keys[i];
+        Histogram[0][Key & 0xff]++;
+        Histogram[1][(Key >> 8) & 0xff]++;
+        Histogram[2][(Key >> 16) & 0xff]++;
+        Histogram[3][Key >> 24]++;
+    }
+
+    unsigned int* From = Keys;
+    unsigned int* To = KeyScratch;
+    unsigned int* FromValues = Values;
+    unsigned int* ToValues = ValueScratch;
+    for (int Pass = 0; Pass < 4; Pass++)
+    {
+        unsigned int* Counts = Histogram[Pass];
+        int Shift = Pass * 8;
+        if (Counts[(From[0] >> Shift) & 0xff] == (unsigned int)Count)
+            continue;
+
+        unsigned int Offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            unsigned int n = Counts[b];
+            Counts[b] = Offset;
+            Offset += n;
+        }
+
+        if (Values)
+        {
+            for (int i = 0; i < Count; i++)
+            {
+                unsigned int Slot = Counts[(From[i] >> Shift) & 0xff]++;
+                To[Slot] = From[i];
+                ToValues[Slot] = FromValues[i];
+            }
+            unsigned int* Swap = FromValues;
+            FromValues = ToValues;
+            ToValues = Swap;
+        }
+        else
+        {
+            for (int i = 0; i < Count; i++)
+                To[Counts[(From[i] >> Shift) & 0xff]++] = From[i];
+        }
+
+        unsigned int* Swap = From;
+        From = To;
+        To = Swap;
+    }
+
+    if (From != Keys)
+    {
+        memcpy(Keys, From, sizeof(unsigned int) * (size_t)Count);
+        if (Values)
+            memcpy(Values, FromValues, sizeof(unsigned int) * (size_t)Count);
+    }
+}
+
+// Transform is one of the key macros above, applied on the way in and undone
+// on the way out (all of them are their own inverse except f32, handled below)
+static void
+sl_radix_sort_keys(unsigned int* Keys, int Count, unsigned int* Scratch, int Kind)
+{
+    if (Count < 2)
+        return;
+
+    for (int i = 0; i < Count; i++)
+    {
+        unsigned int x = Keys[i];
+        Keys[i] = Kind == 0 ? sl_radix_key_u32(x) : Kind == 1 ? sl_radix_key_i32(x) : sl_radix_key_f32(x);
+    }
+
+    unsigned int* Temp = Scratch ? Scratch : (unsigned int*)malloc(sizeof(unsigned int) * (size_t)Count);
+    sl_radix_sort_pairs(Keys, NULL, Count, Temp, NULL);
+    if (!Scratch)
+        free(Temp);
+
+    for (int i = 0; i < Count; i++)
+    {
+        unsigned int x = Keys[i];
+        if (Kind == 1)
+            Keys[i] = x ^ 0x80000000u;
+        else if (Kind == 2)
+            Keys[i] = x ^ ((x >> 31) ? 0x80000000u : 0xffffffffu);
+    }
+}
+
+void sl_radix_sort_u32(unsigned int* Keys, int Count, unsigned int* Scratch)
+{
+    sl_radix_sort_keys(Keys, Count, Scratch, 0);
+}
+
+void sl_radix_sort_i32(int* Keys, int Count, int* Scratch)
+{
+    sl_radix_sort_keys((unsigned int*)Keys, Count, (unsigned int*)Scratch, 1);
+}
+
+void sl_radix_sort_f32(float* Keys, int Count, float* Scratch)
+{
+    sl_radix_sort_keys((unsigned int*)Keys, Count, (unsigned int*)Scratch, 2);
+}
+
+// NOTE(scott): sorts (key, index) pairs and then moves the records once, so big
+// records are copied two times in total instead of once per pass
+static void
+sl_radix_sort_records(void* Records, int Count, int Stride, int KeyOffset, int Kind)
+{
+    if (Count < 2)
+        return;
+
+    unsigned int* Buffer = (unsigned int*)malloc(sizeof(unsigned int) * 4 * (size_t)Count);
+    unsigned int* Keys = Buffer;
+    unsigned int* Indices = Buffer + Count;
+    char* Base = (char*)Records;
+    for (int i = 0; i < Count; i++)
+    {
+        unsigned int x;
+        memcpy(&x, Base + (size_t)i * Stride + KeyOffset, sizeof(x));
+        Keys[i] = Kind == 0 ? sl_radix_key_u32(x) : Kind == 1 ? sl_radix_key_i32(x) : sl_radix_key_f32(x);
+        Indices[i] = (unsigned int)i;
+    }
+
+    sl_radix_sort_pairs(Keys, Indices, Count, Buffer + Count * 2, Buffer + Count * 3);
+
+    char* Sorted = (char*)malloc((size_t)Stride * (size_t)Count);
+    for (int i = 0; i < Count; i++)
+        memcpy(Sorted + (size_t)i * Stride, Base + (size_t)Indices[i] * Stride, (size_t)Stride);
+    memcpy(Records, Sorted, (size_t)Stride * (size_t)Count);
+
+    free(Sorted);
+    free(Buffer);
+}
+
+void sl_radix_sort_by_u32_key(void* Records, int Count, int Stride, int KeyOffset)
+{
+    sl_radix_sort_records(Records, Count, Stride, KeyOffset, 0);
+}
+
+void sl_radix_sort_by_i32_key(void* Records, int Count, int Stride, int KeyOffset)
+{
+    sl_radix_sort_records(Records, Count, Stride, KeyOffset, 1);
+}
+
+void sl_radix_sort_by_f32_key(void* Records, int Count, int Stride, int KeyOffset)
+{
+    sl_radix_sort_records(Records, Count, Stride, KeyOffset, 2);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_SORT_IMPL
+
+#endif // SL_SORT_H
@@ -0,0 +1,525 @@
+#ifndef SL_TRANSFORM_H
+#define SL_TRANSFORM_H
+
+//
+// Transform hierarchies
+//
+// Parent/child mat4f transforms that only recompute the world matrices of what
+// moved.  Nodes are kept in flat arrays in breadth first order, so every parent
+// comes before its children, the children of a node sit next to each other, and
+// the whole World array can go straight to a uniform buffer:
+//
+//     sl_transforms Scene = {0};
+//     sl_transform Body = sl_transform_add(&Scene, SL_TRANSFORM_NONE, BodyMatrix);
+//     sl_transform Arm = sl_transform_add(&Scene, Body, ArmMatrix);
+//     ...
+//     // every tick
+//     sl_transform_set_local(&Scene, Arm, TranslateMat4fByVec3f(ArmMatrix, Swing));
+//     sl_transform_update(&Scene);
+//     mat4f ArmWorld = sl_transform_world(&Scene, Arm);
+//     ...
+//     sl_transforms_free(&Scene);
+//
+// World = ParentWorld * Local, column vectors the same as MulMat4f(), and bit for
+// bit the same result whatever the build flags (both keep FMA contraction off
+// for themselves, see SL_NO_CONTRACT_BEGIN in sl.h).
+//
+// set_local() marks a node dirty.  update() sorts the dirty nodes, walks down
+// from them through the child ranges and recomputes only those subtrees, so the
+// cost follows how much moved and not how big the scene is.  A run of siblings
+// is one batch, multiplied 4 columns at a time with SSE2, with the parent's
+// columns staying in registers while the parent doesn't change.
+//
+// Handles stay valid until their node is removed.  The storage index of a node
+// changes when the hierarchy changes shape: add, remove and set_parent only
+// mark the order stale and the next update() rebuilds it in one O(n) pass, so
+// building a scene a node at a time stays linear.  remove() takes the whole
+// subtree with it at that point.  World matrices are as of the last update().
+//
+// Define SL_TRANSFORM_IMPL in one file before including this to get the
+// implementation.  Needs sl.h and dyn_array.h.
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef i32 sl_transform;
+#define SL_TRANSFORM_NONE -1
+
+typedef struct sl_transform_range
+{
+    i32 Start, End;
+} sl_transform_range;
+
+typedef struct sl_transforms
+{
+    // by index, in breadth first order once updated (all dyn_arrays)
+    mat4f* Local;
+    mat4f* World;
+    i32* Parent;            // index of the parent, -1 for roots
+    i32* ChildStart;        // children of i are [ChildStart[i], ChildStart[i + 1])
+    sl_transform* Handle;
+    u8* Flags;
+
+    // by handle
+    i32* Index;             // -1 once removed
+    sl_transform* FreeHandles;
+
+    i32* Dirty;             // indices set since the last update
+    sl_transform_range* Queue;
+    bool32 Stale;           // the order needs rebuilding
+} sl_transforms;
+
+sl_transform sl_transform_add(sl_transforms* T, sl_transform Parent, mat4f Local);
+
+// removes Node and everything under it.  The handles stay good until the next
+// update() and are dead after it (until add() hands them out again), adding
+// under a node that's going is a bug
+void sl_transform_remove(sl_transforms* T, sl_transform Node);
+
+// false if Parent is Node or one of its descendants, or is being removed
+bool sl_transform_set_parent(sl_transforms* T, sl_transform Node, sl_transform Parent);
+
+void sl_transform_set_local(sl_transforms* T, sl_transform Node, mat4f Local);
+mat4f sl_transform_local(sl_transforms* T, sl_transform Node);
+mat4f sl_transform_world(sl_transforms* T, sl_transform Node);
+sl_transform sl_transform_parent(sl_transforms* T, sl_transform Node);
+i32 sl_transform_count(sl_transforms* T);
+
+// brings every World matrix up to date, returns how many it recomputed
+i32 sl_transform_update(sl_transforms* T);
+
+// marks everything dirty, for when the world matrices can't be trusted
+void sl_transform_update_all(sl_transforms* T);
+
+void sl_transforms_free(sl_transforms* T);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_TRANSFORM_IMPL
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+
+SL_NO_CONTRACT_BEGIN
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SL_TRANSFORM_DIRTY   1
+#define SL_TRANSFORM_REMOVED 2
+
+internal void
+sl_transform_mark(sl_transforms* T, i32 i)
+{
+    if (!(T->Flags[i] & SL_TRANSFORM_DIRTY))
+    {
+        T->Flags[i] |= SL_TRANSFORM_DIRTY;
+        da_append(T->Dirty, i);
+    }
+}
+
+// index of a live handle, one removed before the last update has none
+internal i32
+sl_transform_index(sl_transforms* T, sl_transform Node)
+{
+    assert(Node >= 0 && Node < da_len(T->Index) && T->Index[Node] >= 0 && "transform handle was removed");
+    return T->Index[Node];
+}
+
+// NOTE(scott): remove() only flags the node, the rebuild drops what's under it,
+// so anything below a flagged node is going too.  Only pending while stale.
+internal bool
+sl_transform_removing(sl_transforms* T, i32 i)
+{
+    for (i32 p = T->Stale ? i : -1; p >= 0; p = T->Parent[p])
+    {
+        if (T->Flags[p] & SL_TRANSFORM_REMOVED)
+            return true;
+    }
+    return false;
+}
+
+sl_transform sl_transform_add(sl_transforms* T, sl_transform Parent, mat4f Local)
+{
+    i32 ParentIndex = Parent == SL_TRANSFORM_NONE ? -1 : sl_transform_index(T, Parent);
+    assert(!sl_transform_removing(T, ParentIndex) && "adding under a transform that's being removed");
+
+    sl_transform Handle;
+    i32 i = da_len(T->Local);
+    if (da_len(T->FreeHandles))
+    {
+        Handle = da_pop(T->FreeHandles);
+        T->Index[Handle] = i;
+    }
+    else
+    {
+        Handle = da_len(T->Index);
+        da_append(T->Index, i);
+    }
+
+    u8 Flags = 0;
+    da_append(T->Local, Local);
+    da_append(T->World, Local);
+    da_append(T->Parent, ParentIndex);
+    da_append(T->Handle, Handle);
+    da_append(T->Flags, Flags);
+    sl_transform_mark(T, i);
+    T->Stale = true;
+    return Handle;
+}
+
+void sl_transform_remove(sl_transforms* T, sl_transform Node)
+{
+    i32 i = sl_transform_index(T, Node);
+    T->Flags[i] |= SL_TRANSFORM_REMOVED;
+    T->Stale = true;
+}
+
+bool sl_transform_set_parent(sl_transforms* T, sl_transform Node, sl_transform Parent)
+{
+    i32 i = sl_transform_index(T, Node);
+    i32 ParentIndex = Parent == SL_TRANSFORM_NONE ? -1 : sl_transform_index(T, Parent);
+    if (sl_transform_removing(T, ParentIndex))
+        return false;
+
+    // NOTE(scott): Parent links are good even while the order is stale, walk up
+    // from the new parent to make sure this doesn't close a loop
+    for (i32 p = ParentIndex; p >= 0; p = T->Parent[p])
+    {
+        if (p == i)
+            return false;
+    }
+
+    if (T->Parent[i] != ParentIndex)
+    {
+        T->Parent[i] = ParentIndex;
+        sl_transform_mark(T, i);
+        T->Stale = true;
+    }
+    return true;
+}
+
+void sl_transform_set_local(sl_transforms* T, sl_transform Node, mat4f Local)
+{
+    i32 i = sl_transform_index(T, Node);
+    T->Local[i] = Local;
+    sl_transform_mark(T, i);
+}
+
+mat4f sl_transform_local(sl_transforms* T, sl_transform Node)
+{
+    return T->Local[sl_transform_index(T, Node)];
+}
+
+mat4f sl_transform_world(sl_transforms* T, sl_transform Node)
+{
+    return T->World[sl_transform_index(T, Node)];
+}
+
+sl_transform sl_transform_parent(sl_transforms* T, sl_transform Node)
+{
+    i32 p = T->Parent[sl_transform_index(T, Node)];
+    return p < 0 ? SL_TRANSFORM_NONE : T->Handle[p];
+}
+
+i32 sl_transform_count(sl_transforms* T)
+{
+    return da_len(T->Local);
+}
+
+void sl_transform_update_all(sl_transforms* T)
+{
+    for (i32 i = 0; i < da_len(T->Local); i++)
+        sl_transform_mark(T, i);
+}
+
+//
+// Rebuilding the order
+//
+
+// NOTE(scott): permutes an array into Order through scratch memory, the arrays
+// only ever shrink here so the dyn_array keeps its allocation
+#define sl_transform_permute(List, Order, Count) \
+    do { \
+        void* _Copy = sl_scratch_alloc(sizeof(*(List)) * da_len(List)); \
+        memcpy(_Copy, (List), sizeof(*(List)) * da_len(List)); \
+        for (i32 _k = 0; _k < (Count); _k++) \
+            memcpy((List) + _k, (char*)_Copy + sizeof(*(List)) * (Order)[_k], sizeof(*(List))); \
+        if (List) _da_hdr(List) = (Count); \
+    } while (0)
+
+internal void
+sl_transform_rebuild(sl_transforms* T)
+{
+    SL_PROFILE_ZONE("sl_transform_rebuild");
+    i32 Count = da_len(T->Local);
+    T->Stale = false;
+    if (!Count)
+        return;
+    sl_scratch_mark Mark = sl_scratch_push();
+
+    // children of each node, in their current order, as offsets into Kids
+    i32* KidStart = (i32*)sl_scratch_alloc(sizeof(i32) * (Count + 1));
+    i32* Kids = (i32*)sl_scratch_alloc(sizeof(i32) * (Count + 1));
+    i32* Order = (i32*)sl_scratch_alloc(sizeof(i32) * (Count + 1));
+    i32* NewIndex = (i32*)sl_scratch_alloc(sizeof(i32) * (Count + 1));
+    memset(KidStart, 0, sizeof(i32) * (Count + 1));
+    for (i32 i = 0; i < Count; i++)
+    {
+        if (T->Parent[i] >= 0 && !(T->Flags[i] & SL_TRANSFORM_REMOVED))
+            KidStart[T->Parent[i] + 1]++;
+    }
+    i32* Fill = NewIndex;   // borrowed until the order is known
+    for (i32 i = 0; i < Count; i++)
+    {
+        KidStart[i + 1] += KidStart[i];
+        Fill[i] = KidStart[i];
+    }
+    for (i32 i = 0; i < Count; i++)
+    {
+        if (T->Parent[i] >= 0 && !(T->Flags[i] & SL_TRANSFORM_REMOVED))
+            Kids[Fill[T->Parent[i]]++] = i;
+    }
+
+    // breadth first from the roots, anything under a removed node never gets
+    // reached and goes with it
+    i32 Kept = 0;
+    for (i32 i = 0; i < Count; i++)
+    {
+        if (T->Parent[i] < 0 && !(T->Flags[i] & SL_TRANSFORM_REMOVED))
+            Order[Kept++] = i;
+    }
+    i32 Roots = Kept;
+    for (i32 q = 0; q < Kept; q++)
+    {
+        i32 Node = Order[q];
+        for (i32 k = KidStart[Node]; k < KidStart[Node + 1]; k++)
+            Order[Kept++] = Kids[k];
+    }
+
+    for (i32 i = 0; i < Count; i++)
+        NewIndex[i] = -1;
+    for (i32 k = 0; k < Kept; k++)
+        NewIndex[Order[k]] = k;
+    for (i32 i = 0; i < Count; i++)
+    {
+        if (NewIndex[i] < 0)
+        {
+            T->Index[T->Handle[i]] = -1;
+            da_append(T->FreeHandles, T->Handle[i]);
+        }
+    }
+
+    // parents map through NewIndex before the arrays move
+    i32* OldParent = (i32*)sl_scratch_alloc(sizeof(i32) * (Count + 1));
+    memcpy(OldParent, T->Parent, sizeof(i32) * Count);
+    sl_transform_permute(T->Local, Order, Kept);
+    sl_transform_permute(T->World, Order, Kept);
+    sl_transform_permute(T->Handle, Order, Kept);
+    sl_transform_permute(T->Flags, Order, Kept);
+    if (T->Parent)
+        _da_hdr(T->Parent) = Kept;
+
+    T->ChildStart = _da_init(T->ChildStart, Kept + 1);
+    _da_hdr(T->ChildStart) = Kept + 1;
+    i32 Next = Roots;
+    da_clear(T->Dirty);
+    for (i32 k = 0; k < Kept; k++)
+    {
+        i32 Old = Order[k];
+        T->Parent[k] = OldParent[Old] < 0 ? -1 : NewIndex[OldParent[Old]];
+        T->Index[T->Handle[k]] = k;
+        T->ChildStart[k] = Next;
+        Next += KidStart[Old + 1] - KidStart[Old];
+        if (T->Flags[k] & SL_TRANSFORM_DIRTY)
+        {
+            da_append(T->Dirty, k);
+        }
+    }
+    T->ChildStart[Kept] = Next;
+
+    sl_scratch_pop(Mark);
+}
+
+//
+// Updating
+//
+
+// NOTE(scott): World[i] = World[Parent[i]] * Local[i] for a run of nodes.  Roots
+// only come first in the order so they're never in the middle of a run.
+internal void
+sl_transform_compute(sl_transforms* T, i32 Start, i32 End)
+{
+    mat4f* World = T->World;
+    mat4f* Local = T->Local;
+    i32* Parent = T->Parent;
+    i32 i = Start;
+    for (; i < End && Parent[i] < 0; i++)
+        World[i] = Local[i];
+
+#ifdef SL_SSE2
+    i32 Last = -1;
+    __m128 P0 = _mm_setzero_ps(), P1 = P0, P2 = P0, P3 = P0;
+    for (; i < End; i++)
+    {
+        if (Parent[i] != Last)
+        {
+            Last = Parent[i];
+            P0 = _mm_loadu_ps(World[Last].col[0].E);
+            P1 = _mm_loadu_ps(World[Last].col[1].E);
+            P2 = _mm_loadu_ps(World[Last].col[2].E);
+            P3 = _mm_loadu_ps(World[Last].col[3].E);
+        }
+        // same order of operations as Mul(), so this matches MulMat4f exactly
+        for (i32 c = 0; c < 4; c++)
+        {
+            real32* L = Local[i].col[c].E;
+            __m128 R = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(P0, _mm_set1_ps(L[0])),
+                                                        _mm_mul_ps(P1, _mm_set1_ps(L[1]))),
+                                             _mm_mul_ps(P2, _mm_set1_ps(L[2]))),
+                                  _mm_mul_ps(P3, _mm_set1_ps(L[3])));
+            _mm_storeu_ps(World[i].col[c].E, R);
+        }
+    }
+#else
+    for (; i < End; i++)
+        World[i] = MulMat4f(World[Parent[i]], Local[i]);
+#endif
+}
+
+internal int
+sl_transform_compare_index(const void* A, const void* B)
+{
+    i32 a = *(const i32*)A, b = *(const i32*)B;
+    return (a > b) - (a < b);
+}
+
+// NOTE(scott): joins a range onto the last one if that hasn't been taken yet
+internal void
+sl_transform_queue(sl_transforms* T, i32 Head, i32 Start, i32 End)
+{
+    if (Start >= End)
+        return;
+    i32 Tail = da_len(T->Queue) - 1;
+    if (Tail >= Head && T->Queue[Tail].End == Start)
+    {
+        T->Queue[Tail].End = End;
+    }
+    else
+    {
+        sl_transform_range Range = { Start, End };
+        da_append(T->Queue, Range);
+    }
+}
+
+i32 sl_transform_update(sl_transforms* T)
+{
+    SL_PROFILE_ZONE("sl_transform_update");
+    if (T->Stale)
+        sl_transform_rebuild(T);
+    i32 DirtyCount = da_len(T->Dirty);
+    if (!DirtyCount)
+        return 0;
+
+    // NOTE(scott): indices only go up from here.  Children always come after
+    // their parents and the children of a lower index come first, so taking
+    // whichever of the next dirty node and the next queued child range starts
+    // lower visits everything in order, each parent before its children.  A
+    // dirty node below the end of the last range was already covered by it.
+    i32 Count = da_len(T->Local);
+    if (DirtyCount > Count / 16)
+    {
+        // cheaper to pick them back up in order from the flags than to sort
+        da_clear(T->Dirty);
+        for (i32 i = 0; i < Count; i++)
+        {
+            if (T->Flags[i] & SL_TRANSFORM_DIRTY)
+            {
+                da_append(T->Dirty, i);
+            }
+        }
+    }
+    else
+    {
+        qsort(T->Dirty, DirtyCount, sizeof(i32), sl_transform_compare_index);
+    }
+    da_clear(T->Queue);
+    i32 Head = 0, d = 0, Done = 0, Computed = 0;
+    for (;;)
+    {
+        while (d < DirtyCount && T->Dirty[d] < Done)
+            d++;
+        i32 NextDirty = d < DirtyCount ? T->Dirty[d] : INT_MAX;
+
+        sl_transform_range Range;
+        if (Head < da_len(T->Queue) && T->Queue[Head].Start <= NextDirty)
+        {
+            Range = T->Queue[Head++];
+        }
+        else if (NextDirty != INT_MAX)
+        {
+            // a run of dirty nodes next to each other is one batch as well
+            Range.Start = NextDirty;
+            Range.End = NextDirty + 1;
+            i32 Limit = Head < da_len(T->Queue) ? T->Queue[Head].Start : INT_MAX;
+            for (d++; d < DirtyCount && T->Dirty[d] == Range.End && Range.End < Limit; d++)
+                Range.End++;
+        }
+        else
+        {
+            break;
+        }
+
+        // children that fell inside the range were done with it, parents first
+        sl_transform_compute(T, Range.Start, Range.End);
+        i32 FirstChild = T->ChildStart[Range.Start];
+        sl_transform_queue(T, Head, FirstChild > Range.End ? FirstChild : Range.End, T->ChildStart[Range.End]);
+        Computed += Range.End - Range.Start;
+        Done = Range.End;
+    }
+
+    for (i32 k = 0; k < DirtyCount; k++)
+        T->Flags[T->Dirty[k]] &= ~SL_TRANSFORM_DIRTY;
+    da_clear(T->Dirty);
+    return Computed;
+}
+
+void sl_transforms_free(sl_transforms* T)
+{
+    da_delete(T->Local);
+    da_delete(T->World);
+    da_delete(T->Parent);
+    da_delete(T->ChildStart);
+    da_delete(T->Handle);
+    da_delete(T->Flags);
+    da_delete(T->Index);
+    da_delete(T->FreeHandles);
+    da_delete(T->Dirty);
+    da_delete(T->Queue);
+    memset(T, 0, sizeof(*T));
+}
+
+#undef sl_transform_permute
+
+#if defined(__cplusplus)
+}
+#endif
+
+SL_NO_CONTRACT_END
+
+#endif // SL_TRANSFORM_IMPL
+
+#endif // SL_TRANSFORM_H
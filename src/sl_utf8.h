@@ -0,0 +1,660 @@
+#ifndef SL_UTF8_H
+#define SL_UTF8_H
+
+//
+// UTF-8 validation and decoding
+//
+// Checks text is well formed UTF-8 (no stray continuation bytes, truncated
+// sequences, overlong encodings, surrogates or code points past U+10FFFF) at
+// memory speed, and decodes it to UTF-32 or UTF-16:
+//
+//     size_t Bad;
+//     if (!sl_utf8_validate(File.contents, File.size, &Bad))
+//         printf("not UTF-8 at byte %zu\n", Bad);
+//
+//     unsigned int* CodePoints = NULL;     // dyn_array
+//     sl_utf8_to_utf32_da(File.contents, File.size, CodePoints, NULL);
+//
+// Validation is the lookup table method from simdjson / simdutf (Keiser and
+// Lemire): three 16 entry tables indexed by nibbles of each byte and the one
+// before it flag every bad two byte pattern, and the longer sequences are
+// checked by lining each byte up with the two and three before it.  It runs 32
+// bytes at a time with AVX2 or 16 with SSSE3 (picked at run time, see
+// sl_cpu.h), and blocks of plain ASCII skip the tables altogether.  When a
+// block fails, a scalar pass over just that block finds the exact byte.
+//
+// The decoders validate first, then convert with runs of ASCII widened 16
+// bytes at a time.  They never write more units than there are input bytes,
+// so a Length sized buffer is always big enough; sl_utf8_count_utf32/16 give
+// the exact size for text that is already known to be valid.
+//
+// ErrorOffset, wherever it's taken, gets the offset of the first byte of the
+// first bad sequence and may be NULL.
+//
+// sl.h checks text files with this when built with SL_UTF8_CHECK, see
+// ReadEntireFile and ParseIniFile.
+//
+// C compatible.  Define SL_UTF8_IMPL in one file before including this to get the
+// implementation.  Needs dyn_array.h and sl_cpu.h.
+//
+
+#include <stddef.h>
+#include "dyn_array.h"
+#include "sl_cpu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SL_UTF8_ERROR ((size_t)-1)
+
+// 1 when Text is valid UTF-8
+int sl_utf8_validate(const char* Text, size_t Length, size_t* ErrorOffset);
+
+// code points / UTF-16 units valid Text decodes to
+size_t sl_utf8_count_utf32(const char* Text, size_t Length);
+size_t sl_utf8_count_utf16(const char* Text, size_t Length);
+
+// Out needs room for Length units, returns the number written or SL_UTF8_ERROR
+size_t sl_utf8_to_utf32(const char* Text, size_t Length, unsigned int* Out, size_t* ErrorOffset);
+size_t sl_utf8_to_utf16(const char* Text, size_t Length, unsigned short* Out, size_t* ErrorOffset);
+
+// appends to a dyn_array of UnitSize (4 or 2) byte units, returns the number
+// appended or SL_UTF8_ERROR and leaves the list alone
+size_t sl_utf8_append(const char* Text, size_t Length, void** List, int UnitSize, size_t* ErrorOffset);
+
+#define sl_utf8_to_utf32_da(Text, Length, List, ErrorOffset) \
+    sl_utf8_append((Text), (Length), (void**)&(List), 4, (ErrorOffset))
+#define sl_utf8_to_utf16_da(Text, Length, List, ErrorOffset) \
+    sl_utf8_append((Text), (Length), (void**)&(List), 2, (ErrorOffset))
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_UTF8_IMPL
+
+#include <string.h>
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Scalar
+//
+
+// offset of the first bad sequence at or after From, which has to be the start
+// of a character, or Length when the rest is fine
+static size_t
+sl_utf8_find_error(const unsigned char* s, size_t From, size_t Length)
+{
+    size_t i = From;
+    while (i < Length)
+    {
+        // NOTE(scott): eight ASCII bytes at a time
+        if (i + 8 <= Length)
+        {
+            unsigned long long Word;
+            memcpy(&Word, s + i, 8);
+            if (!(Word & 0x8080808080808080ull))
+            {
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned int c = s[i];
+        if (c < 0x80)
+        {
+            i++;
+        }
+        else if (c < 0xc2)
+        {
+            // continuation byte or overlong two byte lead
+            return i;
+        }
+        else if (c < 0xe0)
+        {
+            if (i + 1 >= Length || (s[i + 1] & 0xc0) != 0x80)
+                return i;
+            i += 2;
+        }
+        else if (c < 0xf0)
+        {
+            if (i + 2 >= Length || (s[i + 1] & 0xc0) != 0x80 || (s[i + 2] & 0xc0) != 0x80)
+                return i;
+            if ((c == 0xe0 && s[i + 1] < 0xa0) ||   // overlong
+                (c == 0xed && s[i + 1] >= 0xa0))    // surrogate
+                return i;
+            i += 3;
+        }
+        else if (c < 0xf5)
+        {
+            if (i + 3 >= Length || (s[i + 1] & 0xc0) != 0x80 ||
+                (s[i + 2] & 0xc0) != 0x80 || (s[i + 3] & 0xc0) != 0x80)
+                return i;
+            if ((c == 0xf0 && s[i + 1] < 0x90) ||   // overlong
+                (c == 0xf4 && s[i + 1] >= 0x90))    // past U+10FFFF
+                return i;
+            i += 4;
+        }
+        else
+        {
+            return i;
+        }
+    }
+    return Length;
+}
+
+// decodes one character of valid text, returns its length
+static int
+sl_utf8_decode(const unsigned char* s, unsigned int* CodePoint)
+{
+    unsigned int c = s[0];
+    if (c < 0x80)
+    {
+        *CodePoint = c;
+        return 1;
+    }
+    if (c < 0xe0)
+    {
+        *CodePoint = ((c & 0x1f) << 6) | (s[1] & 0x3f);
+        return 2;
+    }
+    if (c < 0xf0)
+    {
+        *CodePoint = ((c & 0x0f) << 12) | ((s[1] & 0x3fu) << 6) | (s[2] & 0x3f);
+        return 3;
+    }
+    *CodePoint = ((c & 0x07) << 18) | ((s[1] & 0x3fu) << 12) | ((s[2] & 0x3fu) << 6) | (s[3] & 0x3f);
+    return 4;
+}
+
+static size_t
+sl_utf8_put_utf16(unsigned short* Out, unsigned int CodePoint)
+{
+    if (CodePoint < 0x10000)
+    {
+        Out[0] = (unsigned short)CodePoint;
+        return 1;
+    }
+    CodePoint -= 0x10000;
+    Out[0] = (unsigned short)(0xd800 + (CodePoint >> 10));
+    Out[1] = (unsigned short)(0xdc00 + (CodePoint & 0x3ff));
+    return 2;
+}
+
+static size_t
+sl_utf8_to_utf32_scalar(const unsigned char* s, size_t Length, unsigned int* Out)
+{
+    size_t i = 0, Count = 0;
+    while (i < Length)
+        i += sl_utf8_decode(s + i, Out + Count++);
+    return Count;
+}
+
+static size_t
+sl_utf8_to_utf16_scalar(const unsigned char* s, size_t Length, unsigned short* Out)
+{
+    size_t i = 0, Count = 0;
+    while (i < Length)
+    {
+        unsigned int CodePoint;
+        i += sl_utf8_decode(s + i, &CodePoint);
+        Count += sl_utf8_put_utf16(Out + Count, CodePoint);
+    }
+    return Count;
+}
+
+// continuation bytes and four byte leads
+static void
+sl_utf8_tally_scalar(const unsigned char* s, size_t Length, size_t* Continuations, size_t* FourByte)
+{
+    size_t C = 0, F = 0;
+    for (size_t i = 0; i < Length; i++)
+    {
+        C += (s[i] & 0xc0) == 0x80;
+        F += s[i] >= 0xf0;
+    }
+    *Continuations += C;
+    *FourByte += F;
+}
+
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+
+//
+// Validation tables
+//
+// NOTE(scott): each bit is one kind of error.  A byte pair is bad when the bit
+// is set in all three of: the table for the high nibble of the first byte, the
+// low nibble of the first byte and the high nibble of the second.
+//
+
+#define SL_UTF8_TOO_SHORT    (1 << 0)   // lead not followed by a continuation
+#define SL_UTF8_TOO_LONG     (1 << 1)   // ASCII followed by a continuation
+#define SL_UTF8_OVERLONG_3   (1 << 2)
+#define SL_UTF8_TOO_LARGE    (1 << 3)
+#define SL_UTF8_SURROGATE    (1 << 4)
+#define SL_UTF8_OVERLONG_2   (1 << 5)
+#define SL_UTF8_TOO_LARGE_1000 (1 << 6)
+#define SL_UTF8_OVERLONG_4   (1 << 6)
+#define SL_UTF8_TWO_CONTS    (1 << 7)   // continuation where a lead (or third / fourth byte) goes
+#define SL_UTF8_CARRY        (SL_UTF8_TOO_SHORT | SL_UTF8_TOO_LONG | SL_UTF8_TWO_CONTS)
+
+static const unsigned char sl_utf8_byte1_high[16] = {
+    SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG,
+    SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG, SL_UTF8_TOO_LONG,
+    SL_UTF8_TWO_CONTS, SL_UTF8_TWO_CONTS, SL_UTF8_TWO_CONTS, SL_UTF8_TWO_CONTS,
+    SL_UTF8_TOO_SHORT | SL_UTF8_OVERLONG_2,
+    SL_UTF8_TOO_SHORT,
+    SL_UTF8_TOO_SHORT | SL_UTF8_OVERLONG_3 | SL_UTF8_SURROGATE,
+    SL_UTF8_TOO_SHORT | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000 | SL_UTF8_OVERLONG_4,
+};
+
+static const unsigned char sl_utf8_byte1_low[16] = {
+    SL_UTF8_CARRY | SL_UTF8_OVERLONG_3 | SL_UTF8_OVERLONG_2 | SL_UTF8_OVERLONG_4,
+    SL_UTF8_CARRY | SL_UTF8_OVERLONG_2,
+    SL_UTF8_CARRY,
+    SL_UTF8_CARRY,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000 | SL_UTF8_SURROGATE,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+    SL_UTF8_CARRY | SL_UTF8_TOO_LARGE | SL_UTF8_TOO_LARGE_1000,
+};
+
+static const unsigned char sl_utf8_byte2_high[16] = {
+    SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT,
+    SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT,
+    SL_UTF8_TOO_LONG | SL_UTF8_OVERLONG_2 | SL_UTF8_TWO_CONTS | SL_UTF8_OVERLONG_3 | SL_UTF8_TOO_LARGE_1000 | SL_UTF8_OVERLONG_4,
+    SL_UTF8_TOO_LONG | SL_UTF8_OVERLONG_2 | SL_UTF8_TWO_CONTS | SL_UTF8_OVERLONG_3 | SL_UTF8_TOO_LARGE,
+    SL_UTF8_TOO_LONG | SL_UTF8_OVERLONG_2 | SL_UTF8_TWO_CONTS | SL_UTF8_SURROGATE | SL_UTF8_TOO_LARGE,
+    SL_UTF8_TOO_LONG | SL_UTF8_OVERLONG_2 | SL_UTF8_TWO_CONTS | SL_UTF8_SURROGATE | SL_UTF8_TOO_LARGE,
+    SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT, SL_UTF8_TOO_SHORT,
+};
+
+// NOTE(scott): the last bytes of a block can't be leads that need more bytes
+// than are left in it; subtracting these leaves non zero where they are
+static const unsigned char sl_utf8_max_tail[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+};
+
+//
+// SSSE3
+//
+
+SL_TARGET("ssse3") static inline __m128i
+sl_utf8_check_ssse3(__m128i In, __m128i Prev)
+{
+    const __m128i Low4 = _mm_set1_epi8(0x0f);
+    __m128i Prev1 = _mm_alignr_epi8(In, Prev, 15);
+    __m128i Byte1High = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)sl_utf8_byte1_high),
+                                         _mm_and_si128(_mm_srli_epi16(Prev1, 4), Low4));
+    __m128i Byte1Low = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)sl_utf8_byte1_low),
+                                        _mm_and_si128(Prev1, Low4));
+    __m128i Byte2High = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)sl_utf8_byte2_high),
+                                         _mm_and_si128(_mm_srli_epi16(In, 4), Low4));
+    __m128i Special = _mm_and_si128(_mm_and_si128(Byte1High, Byte1Low), Byte2High);
+
+    // a byte two after a three or four byte lead, or three after a four byte
+    // lead, has to be a continuation; the tables flag those as TWO_CONTS
+    __m128i Prev2 = _mm_alignr_epi8(In, Prev, 14);
+    __m128i Prev3 = _mm_alignr_epi8(In, Prev, 13);
+    __m128i Third = _mm_subs_epu8(Prev2, _mm_set1_epi8((char)(0xe0 - 0x80)));
+    __m128i Fourth = _mm_subs_epu8(Prev3, _mm_set1_epi8((char)(0xf0 - 0x80)));
+    __m128i Must23 = _mm_and_si128(_mm_or_si128(Third, Fourth), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(Must23, Special);
+}
+
+// start of the first 16 byte block with an error, SL_UTF8_ERROR when there isn't one
+SL_TARGET("ssse3") static size_t
+sl_utf8_find_block_ssse3(const unsigned char* s, size_t Length)
+{
+    const __m128i MaxTail = _mm_loadu_si128((const __m128i*)(sl_utf8_max_tail + 16));
+    __m128i Prev = _mm_setzero_si128();
+    __m128i PrevIncomplete = _mm_setzero_si128();
+    size_t i = 0;
+    for (;; i += 16)
+    {
+        __m128i In, Error;
+        if (i + 16 <= Length)
+        {
+            In = _mm_loadu_si128((const __m128i*)(s + i));
+        }
+        else
+        {
+            // NOTE(scott): the last block is padded with zeros, which is ASCII
+            // so anything cut short at the end shows up as TOO_SHORT.  There
+            // always is one, even if it's all padding, so a lead at the very
+            // end of a full block still gets caught by PrevIncomplete
+            unsigned char Tail[16] = {0};
+            memcpy(Tail, s + i, Length - i);
+            In = _mm_loadu_si128((const __m128i*)Tail);
+        }
+
+        if (_mm_movemask_epi8(In) == 0)
+        {
+            Error = PrevIncomplete;
+        }
+        else
+        {
+            Error = sl_utf8_check_ssse3(In, Prev);
+            PrevIncomplete = _mm_subs_epu8(In, MaxTail);
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(Error, _mm_setzero_si128())) != 0xffff)
+            return i;
+        if (i + 16 > Length)
+            return SL_UTF8_ERROR;
+        Prev = In;
+    }
+}
+
+//
+// AVX2
+//
+
+SL_TARGET("avx2") static inline __m256i
+sl_utf8_check_avx2(__m256i In, __m256i Prev)
+{
+    const __m256i Low4 = _mm256_set1_epi8(0x0f);
+    // NOTE(scott): alignr works within 128 bit lanes, so line up the previous
+    // block's top lane under this one's bottom lane first
+    __m256i Carried = _mm256_permute2x128_si256(Prev, In, 0x21);
+    __m256i Prev1 = _mm256_alignr_epi8(In, Carried, 15);
+    __m256i Byte1High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)sl_utf8_byte1_high)),
+                                            _mm256_and_si256(_mm256_srli_epi16(Prev1, 4), Low4));
+    __m256i Byte1Low = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)sl_utf8_byte1_low)),
+                                           _mm256_and_si256(Prev1, Low4));
+    __m256i Byte2High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)sl_utf8_byte2_high)),
+                                            _mm256_and_si256(_mm256_srli_epi16(In, 4), Low4));
+    __m256i Special = _mm256_and_si256(_mm256_and_si256(Byte1High, Byte1Low), Byte2High);
+
+    __m256i Prev2 = _mm256_alignr_epi8(In, Carried, 14);
+    __m256i Prev3 = _mm256_alignr_epi8(In, Carried, 13);
+    __m256i Third = _mm256_subs_epu8(Prev2, _mm256_set1_epi8((char)(0xe0 - 0x80)));
+    __m256i Fourth = _mm256_subs_epu8(Prev3, _mm256_set1_epi8((char)(0xf0 - 0x80)));
+    __m256i Must23 = _mm256_and_si256(_mm256_or_si256(Third, Fourth), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(Must23, Special);
+}
+
+SL_TARGET("avx2") static size_t
+sl_utf8_find_block_avx2(const unsigned char* s, size_t Length)
+{
+    const __m256i MaxTail = _mm256_loadu_si256((const __m256i*)sl_utf8_max_tail);
+    __m256i Prev = _mm256_setzero_si256();
+    __m256i PrevIncomplete = _mm256_setzero_si256();
+    size_t i = 0;
+    for (;; i += 32)
+    {
+        __m256i In, Error;
+        if (i + 32 <= Length)
+        {
+            In = _mm256_loadu_si256((const __m256i*)(s + i));
+        }
+        else
+        {
+            unsigned char Tail[32] = {0};
+            memcpy(Tail, s + i, Length - i);
+            In = _mm256_loadu_si256((const __m256i*)Tail);
+        }
+
+        if (_mm256_movemask_epi8(In) == 0)
+        {
+            Error = PrevIncomplete;
+        }
+        else
+        {
+            Error = sl_utf8_check_avx2(In, Prev);
+            PrevIncomplete = _mm256_subs_epu8(In, MaxTail);
+        }
+
+        if (!_mm256_testz_si256(Error, Error))
+            return i;
+        if (i + 32 > Length)
+            return SL_UTF8_ERROR;
+        Prev = In;
+    }
+}
+
+//
+// SSE2 decoding and counting
+//
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static int sl_utf8_ascii_prefix(int Mask) { unsigned long i; return _BitScanForward(&i, (unsigned long)Mask) ? (int)i : 16; }
+#else
+#define sl_utf8_ascii_prefix(Mask) ((Mask) ? __builtin_ctz(Mask) : 16)
+#endif
+
+SL_TARGET("sse2") static size_t
+sl_utf8_to_utf32_sse2(const unsigned char* s, size_t Length, unsigned int* Out)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    size_t i = 0, Count = 0;
+    while (i < Length)
+    {
+        if (i + 16 <= Length)
+        {
+            // NOTE(scott): widen all 16 and keep the ASCII in front of the first
+            // multi byte character; the rest gets overwritten.  Count never gets
+            // ahead of i, so the stores stay inside a Length sized buffer
+            __m128i In = _mm_loadu_si128((const __m128i*)(s + i));
+            __m128i Low = _mm_unpacklo_epi8(In, Zero);
+            __m128i High = _mm_unpackhi_epi8(In, Zero);
+            _mm_storeu_si128((__m128i*)(Out + Count), _mm_unpacklo_epi16(Low, Zero));
+            _mm_storeu_si128((__m128i*)(Out + Count + 4), _mm_unpackhi_epi16(Low, Zero));
+            _mm_storeu_si128((__m128i*)(Out + Count + 8), _mm_unpacklo_epi16(High, Zero));
+            _mm_storeu_si128((__m128i*)(Out + Count + 12), _mm_unpackhi_epi16(High, Zero));
+            int Ascii = sl_utf8_ascii_prefix(_mm_movemask_epi8(In));
+            i += Ascii;
+            Count += Ascii;
+            if (Ascii == 16)
+                continue;
+        }
+        i += sl_utf8_decode(s + i, Out + Count++);
+    }
+    return Count;
+}
+
+SL_TARGET("sse2") static size_t
+sl_utf8_to_utf16_sse2(const unsigned char* s, size_t Length, unsigned short* Out)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    size_t i = 0, Count = 0;
+    while (i < Length)
+    {
+        if (i + 16 <= Length)
+        {
+            __m128i In = _mm_loadu_si128((const __m128i*)(s + i));
+            _mm_storeu_si128((__m128i*)(Out + Count), _mm_unpacklo_epi8(In, Zero));
+            _mm_storeu_si128((__m128i*)(Out + Count + 8), _mm_unpackhi_epi8(In, Zero));
+            int Ascii = sl_utf8_ascii_prefix(_mm_movemask_epi8(In));
+            i += Ascii;
+            Count += Ascii;
+            if (Ascii == 16)
+                continue;
+        }
+        unsigned int CodePoint;
+        i += sl_utf8_decode(s + i, &CodePoint);
+        Count += sl_utf8_put_utf16(Out + Count, CodePoint);
+    }
+    return Count;
+}
+
+SL_TARGET("sse2") static void
+sl_utf8_tally_sse2(const unsigned char* s, size_t Length, size_t* Continuations, size_t* FourByte)
+{
+    // NOTE(scott): matches are -1 so subtracting them counts up per byte lane;
+    // the lanes get summed with sad every 255 blocks before they can wrap
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i BelowLead = _mm_set1_epi8((char)0xc0);
+    const __m128i BelowFour = _mm_set1_epi8((char)(0xf0 - 1));
+    size_t i = 0;
+    while (i + 16 <= Length)
+    {
+        __m128i C = Zero, F = Zero;
+        for (int Block = 0; Block < 255 && i + 16 <= Length; Block++, i += 16)
+        {
+            __m128i In = _mm_loadu_si128((const __m128i*)(s + i));
+            // signed compares: continuations are -128..-65, four byte leads -16..-1
+            C = _mm_sub_epi8(C, _mm_cmplt_epi8(In, BelowLead));
+            F = _mm_sub_epi8(F, _mm_and_si128(_mm_cmpgt_epi8(In, BelowFour), _mm_cmplt_epi8(In, Zero)));
+        }
+        C = _mm_sad_epu8(C, Zero);
+        F = _mm_sad_epu8(F, Zero);
+        *Continuations += (size_t)(_mm_cvtsi128_si32(C) + _mm_extract_epi16(C, 4));
+        *FourByte += (size_t)(_mm_cvtsi128_si32(F) + _mm_extract_epi16(F, 4));
+    }
+    sl_utf8_tally_scalar(s + i, Length - i, Continuations, FourByte);
+}
+
+#endif
+
+//
+// Entry points
+//
+
+int sl_utf8_validate(const char* Text, size_t Length, size_t* ErrorOffset)
+{
+    const unsigned char* s = (const unsigned char*)Text;
+    size_t From = 0;
+    if (!Length)
+        return 1;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    unsigned int Features = sl_cpu_features();
+    if (Features & (SL_CPU_AVX2 | SL_CPU_SSSE3))
+    {
+        size_t Block = (Features & SL_CPU_AVX2) ? sl_utf8_find_block_avx2(s, Length)
+                                                : sl_utf8_find_block_ssse3(s, Length);
+        if (Block == SL_UTF8_ERROR)
+            return 1;
+
+        // NOTE(scott): everything before the block was fine, but a character
+        // can start up to three bytes before it; back up to its lead
+        From = Block >= 3 ? Block - 3 : 0;
+        while (From < Block && (s[From] & 0xc0) == 0x80)
+            From++;
+    }
+#endif
+    size_t Error = sl_utf8_find_error(s, From, Length);
+    if (Error == Length)
+        return 1;
+    if (ErrorOffset)
+        *ErrorOffset = Error;
+    return 0;
+}
+
+static void
+sl_utf8_tally(const char* Text, size_t Length, size_t* Continuations, size_t* FourByte)
+{
+    *Continuations = 0;
+    *FourByte = 0;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    if (sl_cpu_features() & SL_CPU_SSE2)
+    {
+        sl_utf8_tally_sse2((const unsigned char*)Text, Length, Continuations, FourByte);
+        return;
+    }
+#endif
+    sl_utf8_tally_scalar((const unsigned char*)Text, Length, Continuations, FourByte);
+}
+
+size_t sl_utf8_count_utf32(const char* Text, size_t Length)
+{
+    size_t Continuations, FourByte;
+    sl_utf8_tally(Text, Length, &Continuations, &FourByte);
+    return Length - Continuations;
+}
+
+size_t sl_utf8_count_utf16(const char* Text, size_t Length)
+{
+    size_t Continuations, FourByte;
+    sl_utf8_tally(Text, Length, &Continuations, &FourByte);
+    return Length - Continuations + FourByte;
+}
+
+size_t sl_utf8_to_utf32(const char* Text, size_t Length, unsigned int* Out, size_t* ErrorOffset)
+{
+    if (!sl_utf8_validate(Text, Length, ErrorOffset))
+        return SL_UTF8_ERROR;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    if (sl_cpu_features() & SL_CPU_SSE2)
+        return sl_utf8_to_utf32_sse2((const unsigned char*)Text, Length, Out);
+#endif
+    return sl_utf8_to_utf32_scalar((const unsigned char*)Text, Length, Out);
+}
+
+size_t sl_utf8_to_utf16(const char* Text, size_t Length, unsigned short* Out, size_t* ErrorOffset)
+{
+    if (!sl_utf8_validate(Text, Length, ErrorOffset))
+        return SL_UTF8_ERROR;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+    if (sl_cpu_features() & SL_CPU_SSE2)
+        return sl_utf8_to_utf16_sse2((const unsigned char*)Text, Length, Out);
+#endif
+    return sl_utf8_to_utf16_scalar((const unsigned char*)Text, Length, Out);
+}
+
+size_t sl_utf8_append(const char* Text, size_t Length, void** List, int UnitSize, size_t* ErrorOffset)
+{
+    if (!sl_utf8_validate(Text, Length, ErrorOffset))
+        return SL_UTF8_ERROR;
+    if (!Length)
+        return 0;
+
+    // NOTE(scott): never more units than bytes, so grow by Length once and
+    // trim the length after
+    int Old = da_len(*List);
+    if ((size_t)Old + Length > (size_t)da_cap(*List))
+        *List = _da_resize(*List, (size_t)UnitSize, (size_t)Old + Length);
+
+    size_t Count;
+    if (UnitSize == 4)
+    {
+        unsigned int* Out = (unsigned int*)*List + Old;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+        if (sl_cpu_features() & SL_CPU_SSE2)
+            Count = sl_utf8_to_utf32_sse2((const unsigned char*)Text, Length, Out);
+        else
+#endif
+            Count = sl_utf8_to_utf32_scalar((const unsigned char*)Text, Length, Out);
+    }
+    else
+    {
+        unsigned short* Out = (unsigned short*)*List + Old;
+#if defined(SL_CPU_X86) && !defined(SL_NO_SIMD)
+        if (sl_cpu_features() & SL_CPU_SSE2)
+            Count = sl_utf8_to_utf16_sse2((const unsigned char*)Text, Length, Out);
+        else
+#endif
+            Count = sl_utf8_to_utf16_scalar((const unsigned char*)Text, Length, Out);
+    }
+    _da_hdr(*List) = Old + (int)Count;
+    return Count;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_UTF8_IMPL
+
+#endif // SL_UTF8_H
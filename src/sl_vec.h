@@ -0,0 +1,419 @@
+#ifndef SL_VEC_H
+#define SL_VEC_H
+
+//
+// Templated vector / matrix layer (C++14)
+//
+// vec<N, T> and mat<R, C, T> sit on top of the plain sl.h types.  Everything that
+// doesn't need a sqrt is constexpr so constant transforms fold at compile time.
+//
+// Arithmetic builds expression templates instead of temporaries.  Something like
+//     vec3 R = A*s + B - C;
+// is a single loop over the components when it's assigned, no intermediate vec3s.
+//
+// NOTE(scott): expressions hold references to their vec operands, so assign them
+// to a vec right away.  Don't keep one around in an `auto` past the statement
+// that built it or it will point at dead temporaries.
+//
+// Usage:
+//     sl::vec3 P = sl::vec3(ParseVec3f(s)) * 2.f + Offset;
+//     vec3f Back = P;
+//
+// The float instantiations convert implicitly to and from vec2f / vec3f / vec4f /
+// mat4f, and dvec3 does the same with vec3d.
+//
+
+#if !defined(__cplusplus)
+#error "sl_vec.h is C++ only"
+#endif
+
+#include "sl.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#if defined(_MSC_VER)
+#define SL_FORCE_INLINE __forceinline
+#else
+#define SL_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace sl
+{
+    template <int N, typename T> struct vec;
+
+    //
+    // Expression base
+    //
+    // Every vector expression derives from this so the operators below only
+    // match sl types.  E is the concrete expression, N/T the shape it produces.
+    //
+    template <typename E, int N, typename T>
+    struct vec_expr
+    {
+        constexpr SL_FORCE_INLINE const E& self() const { return static_cast<const E&>(*this); }
+        constexpr SL_FORCE_INLINE T operator[](int i) const { return self()[i]; }
+    };
+
+    // NOTE(scott): leaf vecs are held by reference, expression nodes by value
+    // since they're just a couple of references themselves
+    template <typename E> struct vec_operand { typedef const E type; };
+    template <int N, typename T> struct vec_operand<vec<N, T> > { typedef const vec<N, T>& type; };
+
+    template <typename Op, typename L, typename R, int N, typename T>
+    struct vec_binary : vec_expr<vec_binary<Op, L, R, N, T>, N, T>
+    {
+        typename vec_operand<L>::type Left;
+        typename vec_operand<R>::type Right;
+
+        constexpr SL_FORCE_INLINE vec_binary(const L& Left, const R& Right) : Left(Left), Right(Right) {}
+        constexpr SL_FORCE_INLINE T operator[](int i) const { return Op::apply(Left[i], Right[i]); }
+    };
+
+    template <typename Op, typename L, int N, typename T>
+    struct vec_scalar : vec_expr<vec_scalar<Op, L, N, T>, N, T>
+    {
+        typename vec_operand<L>::type Left;
+        T Scalar;
+
+        constexpr SL_FORCE_INLINE vec_scalar(const L& Left, T Scalar) : Left(Left), Scalar(Scalar) {}
+        constexpr SL_FORCE_INLINE T operator[](int i) const { return Op::apply(Left[i], Scalar); }
+    };
+
+    template <typename L, int N, typename T>
+    struct vec_negate : vec_expr<vec_negate<L, N, T>, N, T>
+    {
+        typename vec_operand<L>::type Left;
+
+        constexpr SL_FORCE_INLINE explicit vec_negate(const L& Left) : Left(Left) {}
+        constexpr SL_FORCE_INLINE T operator[](int i) const { return -Left[i]; }
+    };
+
+    struct op_add { template <typename T> static constexpr SL_FORCE_INLINE T apply(T A, T B) { return A + B; } };
+    struct op_sub { template <typename T> static constexpr SL_FORCE_INLINE T apply(T A, T B) { return A - B; } };
+    struct op_mul { template <typename T> static constexpr SL_FORCE_INLINE T apply(T A, T B) { return A * B; } };
+    struct op_div { template <typename T> static constexpr SL_FORCE_INLINE T apply(T A, T B) { return A / B; } };
+
+    //
+    // vec<N, T>
+    //
+
+    template <int N, typename T>
+    struct vec : vec_expr<vec<N, T>, N, T>
+    {
+        T E[N];
+
+        constexpr vec() : E() {}
+
+        // NOTE(scott): one value per component, or a single value splatted to all
+        template <typename... Args>
+        constexpr explicit vec(T First, Args... Rest) : E()
+        {
+            static_assert(sizeof...(Args) == 0 || sizeof...(Args) == N - 1, "wrong number of components");
+            const T Values[] = { First, static_cast<T>(Rest)... };
+            for (int i = 0; i < N; i++)
+                E[i] = Values[sizeof...(Args) == 0 ? 0 : i];
+        }
+
+        template <typename Expr>
+        constexpr SL_FORCE_INLINE vec(const vec_expr<Expr, N, T>& Other) : E()
+        {
+            for (int i = 0; i < N; i++)
+                E[i] = Other[i];
+        }
+
+        template <typename Expr>
+        constexpr SL_FORCE_INLINE vec& operator=(const vec_expr<Expr, N, T>& Other)
+        {
+            // NOTE(scott): evaluate into a copy first in case Other reads from *this
+            vec Tmp(Other);
+            *this = Tmp;
+            return *this;
+        }
+        constexpr vec& operator=(const vec& Other) = default;
+        constexpr vec(const vec& Other) = default;
+
+        template <typename Expr> constexpr SL_FORCE_INLINE vec& operator+=(const vec_expr<Expr, N, T>& B) { for (int i = 0; i < N; i++) E[i] += B[i]; return *this; }
+        template <typename Expr> constexpr SL_FORCE_INLINE vec& operator-=(const vec_expr<Expr, N, T>& B) { for (int i = 0; i < N; i++) E[i] -= B[i]; return *this; }
+        constexpr SL_FORCE_INLINE vec& operator*=(T S) { for (int i = 0; i < N; i++) E[i] *= S; return *this; }
+        constexpr SL_FORCE_INLINE vec& operator/=(T S) { for (int i = 0; i < N; i++) E[i] /= S; return *this; }
+
+        constexpr SL_FORCE_INLINE T operator[](int i) const { return E[i]; }
+        constexpr SL_FORCE_INLINE T& operator[](int i) { return E[i]; }
+
+        constexpr SL_FORCE_INLINE T x() const { return E[0]; }
+        constexpr SL_FORCE_INLINE T y() const { return E[1]; }
+        constexpr SL_FORCE_INLINE T z() const { static_assert(N > 2, "no z component"); return E[2]; }
+        constexpr SL_FORCE_INLINE T w() const { static_assert(N > 3, "no w component"); return E[3]; }
+
+        //
+        // sl.h interop
+        //
+        vec(const vec2f& V) : E() { static_assert(N == 2, "vec2f needs N == 2"); E[0] = V.X; E[1] = V.Y; }
+        vec(const vec3f& V) : E() { static_assert(N == 3, "vec3f needs N == 3"); E[0] = V.X; E[1] = V.Y; E[2] = V.Z; }
+        vec(const vec4f& V) : E() { static_assert(N == 4, "vec4f needs N == 4"); for (int i = 0; i < 4; i++) E[i] = V.E[i]; }
+        vec(const vec3d& V) : E() { static_assert(N == 3, "vec3d needs N == 3"); for (int i = 0; i < 3; i++) E[i] = static_cast<T>(V.E[i]); }
+
+        operator vec2f() const { static_assert(N == 2, "vec2f needs N == 2"); vec2f R; R.X = (real32)E[0]; R.Y = (real32)E[1]; return R; }
+        operator vec3f() const { static_assert(N == 3, "vec3f needs N == 3"); vec3f R; for (int i = 0; i < 3; i++) R.E[i] = (real32)E[i]; return R; }
+        operator vec4f() const { static_assert(N == 4, "vec4f needs N == 4"); vec4f R; for (int i = 0; i < 4; i++) R.E[i] = (real32)E[i]; return R; }
+        operator vec3d() const { static_assert(N == 3, "vec3d needs N == 3"); vec3d R; for (int i = 0; i < 3; i++) R.E[i] = (real64)E[i]; return R; }
+    };
+
+    typedef vec<2, float>  vec2;
+    typedef vec<3, float>  vec3;
+    typedef vec<4, float>  vec4;
+    typedef vec<2, double> dvec2;
+    typedef vec<3, double> dvec3;
+    typedef vec<4, double> dvec4;
+    typedef vec<2, int>    ivec2;
+    typedef vec<3, int>    ivec3;
+    typedef vec<4, int>    ivec4;
+
+    //
+    // Operators
+    //
+
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_binary<op_add, L, R, N, T>
+    operator+(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        return vec_binary<op_add, L, R, N, T>(A.self(), B.self());
+    }
+
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_binary<op_sub, L, R, N, T>
+    operator-(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        return vec_binary<op_sub, L, R, N, T>(A.self(), B.self());
+    }
+
+    template <typename L, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_negate<L, N, T>
+    operator-(const vec_expr<L, N, T>& A)
+    {
+        return vec_negate<L, N, T>(A.self());
+    }
+
+    template <typename L, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_scalar<op_mul, L, N, T>
+    operator*(const vec_expr<L, N, T>& A, T S)
+    {
+        return vec_scalar<op_mul, L, N, T>(A.self(), S);
+    }
+
+    template <typename L, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_scalar<op_mul, L, N, T>
+    operator*(T S, const vec_expr<L, N, T>& A)
+    {
+        return vec_scalar<op_mul, L, N, T>(A.self(), S);
+    }
+
+    template <typename L, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_scalar<op_div, L, N, T>
+    operator/(const vec_expr<L, N, T>& A, T S)
+    {
+        return vec_scalar<op_div, L, N, T>(A.self(), S);
+    }
+
+    // NOTE(scott): component-wise, like HadamardVec2f.  Dot products use dot().
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE vec_binary<op_mul, L, R, N, T>
+    hadamard(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        return vec_binary<op_mul, L, R, N, T>(A.self(), B.self());
+    }
+
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE bool
+    operator==(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        for (int i = 0; i < N; i++)
+            if (!(A[i] == B[i]))
+                return false;
+        return true;
+    }
+
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE bool
+    operator!=(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        return !(A == B);
+    }
+
+    //
+    // Functions
+    //
+
+    template <typename L, typename R, int N, typename T>
+    constexpr SL_FORCE_INLINE T
+    dot(const vec_expr<L, N, T>& A, const vec_expr<R, N, T>& B)
+    {
+        T Result = T();
+        for (int i = 0; i < N; i++)
+            Result += A[i] * B[i];
+        return Result;
+    }
+
+    template <typename L, typename R, typename T>
+    constexpr SL_FORCE_INLINE vec<3, T>
+    cross(const vec_expr<L, 3, T>& A, const vec_expr<R, 3, T>& B)
+    {
+        return vec<3, T>(A[1]*B[2] - A[2]*B[1],
+                         A[2]*B[0] - A[0]*B[2],
+                         A[0]*B[1] - A[1]*B[0]);
+    }
+
+    template <typename L, typename T>
+    constexpr SL_FORCE_INLINE vec<2, T>
+    perp(const vec_expr<L, 2, T>& A)
+    {
+        return vec<2, T>(-A[1], A[0]);
+    }
+
+    template <typename L, int N, typename T>
+    constexpr SL_FORCE_INLINE T
+    length_sq(const vec_expr<L, N, T>& A)
+    {
+        return dot(A, A);
+    }
+
+    template <typename L, int N, typename T>
+    SL_FORCE_INLINE T
+    length(const vec_expr<L, N, T>& A)
+    {
+        return static_cast<T>(sqrt(static_cast<double>(length_sq(A))));
+    }
+
+    template <typename L, int N, typename T>
+    SL_FORCE_INLINE vec<N, T>
+    normalize(const vec_expr<L, N, T>& A)
+    {
+        vec<N, T> Result(A);
+        T Len = length(Result);
+        if (Len != T())
+            Result /= Len;
+        return Result;
+    }
+
+    //
+    // mat<R, C, T>
+    //
+    // Column major to match mat4f, so col[j][i] is row i of column j.
+    //
+
+    template <int R, int C, typename T>
+    struct mat
+    {
+        vec<R, T> col[C];
+
+        constexpr mat() : col() {}
+
+        static constexpr mat identity()
+        {
+            static_assert(R == C, "identity needs a square matrix");
+            mat Result;
+            for (int i = 0; i < R; i++)
+                Result.col[i][i] = T(1);
+            return Result;
+        }
+
+        constexpr SL_FORCE_INLINE const vec<R, T>& operator[](int j) const { return col[j]; }
+        constexpr SL_FORCE_INLINE vec<R, T>& operator[](int j) { return col[j]; }
+
+        constexpr SL_FORCE_INLINE T at(int Row, int Col) const { return col[Col][Row]; }
+
+        mat(const mat4f& M) : col()
+        {
+            static_assert(R == 4 && C == 4, "mat4f needs a 4x4");
+            for (int j = 0; j < 4; j++)
+                for (int i = 0; i < 4; i++)
+                    col[j][i] = static_cast<T>(M.E[j*4 + i]);
+        }
+
+        operator mat4f() const
+        {
+            static_assert(R == 4 && C == 4, "mat4f needs a 4x4");
+            mat4f Result;
+            for (int j = 0; j < 4; j++)
+                for (int i = 0; i < 4; i++)
+                    Result.E[j*4 + i] = static_cast<real32>(col[j][i]);
+            return Result;
+        }
+    };
+
+    typedef mat<3, 3, float>  mat3;
+    typedef mat<4, 4, float>  mat4;
+    typedef mat<3, 3, double> dmat3;
+    typedef mat<4, 4, double> dmat4;
+
+    template <int R, int C, typename T, typename Expr>
+    constexpr SL_FORCE_INLINE vec<R, T>
+    operator*(const mat<R, C, T>& M, const vec_expr<Expr, C, T>& V)
+    {
+        vec<R, T> Result;
+        for (int j = 0; j < C; j++)
+        {
+            T S = V[j];
+            for (int i = 0; i < R; i++)
+                Result[i] += M.col[j][i] * S;
+        }
+        return Result;
+    }
+
+    template <int R, int K, int C, typename T>
+    constexpr SL_FORCE_INLINE mat<R, C, T>
+    operator*(const mat<R, K, T>& A, const mat<K, C, T>& B)
+    {
+        mat<R, C, T> Result;
+        for (int j = 0; j < C; j++)
+            Result.col[j] = A * B.col[j];
+        return Result;
+    }
+
+    template <int R, int C, typename T>
+    constexpr SL_FORCE_INLINE bool
+    operator==(const mat<R, C, T>& A, const mat<R, C, T>& B)
+    {
+        for (int j = 0; j < C; j++)
+            if (A.col[j] != B.col[j])
+                return false;
+        return true;
+    }
+
+    template <int R, int C, typename T>
+    constexpr SL_FORCE_INLINE mat<C, R, T>
+    transpose(const mat<R, C, T>& M)
+    {
+        mat<C, R, T> Result;
+        for (int j = 0; j < C; j++)
+            for (int i = 0; i < R; i++)
+                Result.col[i][j] = M.col[j][i];
+        return Result;
+    }
+
+    template <typename T>
+    constexpr mat<4, 4, T>
+    translation(const vec<3, T>& V)
+    {
+        mat<4, 4, T> Result = mat<4, 4, T>::identity();
+        Result.col[3][0] = V[0];
+        Result.col[3][1] = V[1];
+        Result.col[3][2] = V[2];
+        return Result;
+    }
+
+    template <typename T>
+    constexpr mat<4, 4, T>
+    scaling(const vec<3, T>& V)
+    {
+        mat<4, 4, T> Result = mat<4, 4, T>::identity();
+        Result.col[0][0] = V[0];
+        Result.col[1][1] = V[1];
+        Result.col[2][2] = V[2];
+        return Result;
+    }
+
+} // namespace sl
+
+#endif // SL_VEC_H
@@ -0,0 +1,441 @@
+#ifndef SL_VERTEX_H
+#define SL_VERTEX_H
+
+//
+// Interleaved vertex buffers
+//
+// Describe a vertex once, then pack separate arrays of floats (positions,
+// normals, UVs straight out of their dyn_arrays) into one interleaved buffer
+// ready to upload, converting each attribute to a smaller format on the way:
+//
+//     sl_vertex_layout Layout = {0};
+//     sl_vertex_layout_add(&Layout, 3, SL_VERTEX_FLOAT);          // position
+//     sl_vertex_layout_add(&Layout, 3, SL_VERTEX_OCT_NORMAL);     // normal
+//     sl_vertex_layout_add(&Layout, 2, SL_VERTEX_HALF);           // uv
+//
+//     real32* Sources[] = { &Positions[0].X, &Normals[0].X, &Uvs[0].X };
+//     sl_vertex_pack_da(&Layout, Sources, da_len(Positions), &VertexBuffer);
+//     glBufferData(GL_ARRAY_BUFFER, da_len(VertexBuffer), VertexBuffer, GL_DYNAMIC_DRAW);
+//
+// sl_vertex_unpack() goes the other way, back to one float array per attribute.
+// Everything works on plain CPU memory, nothing here touches a graphics API.
+//
+// Attributes start on 4 byte boundaries (what GL and Vulkan want) and the
+// layout keeps Offset and Stride up to date, which is what a
+// glVertexAttribPointer call needs.  sl_vertex_layout_pad() rounds the stride
+// up, e.g. to 16 or 32 bytes.  Padding bytes come out zero.
+//
+// The conversions are the batch kernels from sl_pack.h (F16C halfs, SSE2
+// snorm16, octahedral normals, 10:10:10:2) plus SSE2 kernels here for the 8 and
+// 16 bit normalized formats, all bit identical to their scalar versions.
+// Vertices go through in chunks of SL_VERTEX_CHUNK so each attribute is
+// converted into a small buffer that stays in L1 and then scattered into the
+// chunk of the output, one attribute at a time.
+//
+// Define SL_VERTEX_IMPL in one file before including this to get the
+// implementation.  Needs sl.h, dyn_array.h, sl_cpu.h and sl_pack.h (with
+// SL_PACK_IMPL defined somewhere).
+//
+
+#include "sl.h"
+#include "dyn_array.h"
+#include "sl_cpu.h"
+#include "sl_pack.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#ifndef SL_VERTEX_MAX_ATTRIBS
+#define SL_VERTEX_MAX_ATTRIBS 16
+#endif
+
+#ifndef SL_VERTEX_CHUNK
+#define SL_VERTEX_CHUNK 256
+#endif
+
+typedef enum sl_vertex_format
+{
+    SL_VERTEX_FLOAT,
+    SL_VERTEX_HALF,
+    SL_VERTEX_SNORM16,
+    SL_VERTEX_UNORM16,
+    SL_VERTEX_SNORM8,
+    SL_VERTEX_UNORM8,
+    SL_VERTEX_SNORM1010102,     // 3 or 4 components in a u32, a missing W is 0
+    SL_VERTEX_UNORM1010102,
+    SL_VERTEX_OCT_NORMAL,       // 3 components (a unit vector) in a u32
+    SL_VERTEX_FORMAT_COUNT
+} sl_vertex_format;
+
+typedef struct sl_vertex_attrib
+{
+    i32 Components;         // floats per vertex in the source array
+    sl_vertex_format Format;
+    i32 Offset;             // bytes from the start of the vertex
+    i32 Size;               // bytes in the vertex, before padding
+} sl_vertex_attrib;
+
+typedef struct sl_vertex_layout
+{
+    sl_vertex_attrib Attribs[SL_VERTEX_MAX_ATTRIBS];
+    i32 Count;
+    i32 Stride;
+} sl_vertex_layout;
+
+// bytes Components values take in Format
+i32 sl_vertex_format_size(sl_vertex_format Format, i32 Components);
+
+// appends an attribute, returns its index or -1 if the combination isn't valid
+i32 sl_vertex_layout_add(sl_vertex_layout* Layout, i32 Components, sl_vertex_format Format);
+
+// rounds the stride up to a multiple of Alignment, so vertices sit at that
+// alignment relative to the start of the buffer (the buffer's own address is up
+// to whoever allocates it)
+void sl_vertex_layout_pad(sl_vertex_layout* Layout, i32 Alignment);
+
+// Sources[i] holds Count * Components floats for attribute i; Out needs
+// Count * Stride bytes
+void sl_vertex_pack(const sl_vertex_layout* Layout, real32** Sources, i32 Count, void* Out);
+
+// Dests[i] gets Count * Components floats, a NULL Dest skips that attribute
+void sl_vertex_unpack(const sl_vertex_layout* Layout, const void* In, i32 Count, real32** Dests);
+
+// sets the u8 dyn_array *Buffer to exactly Count * Stride bytes and packs into
+// it, so a buffer rebuilt every frame only grows once.  NOTE(scott): dyn_array
+// data sits right after its 8 byte header, so the buffer is only 8 byte aligned
+// whatever the stride is padded to.  Fine for uploading; to read vertices back
+// with aligned 16 byte loads, sl_vertex_pack() into memory from an aligned
+// allocator instead.
+void sl_vertex_pack_da(const sl_vertex_layout* Layout, real32** Sources, i32 Count, u8** Buffer);
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Implementation
+//
+#ifdef SL_VERTEX_IMPL
+
+#include <string.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+i32 sl_vertex_format_size(sl_vertex_format Format, i32 Components)
+{
+    switch (Format)
+    {
+        case SL_VERTEX_FLOAT: return 4 * Components;
+        case SL_VERTEX_HALF:
+        case SL_VERTEX_SNORM16:
+        case SL_VERTEX_UNORM16: return 2 * Components;
+        case SL_VERTEX_SNORM8:
+        case SL_VERTEX_UNORM8: return Components;
+        case SL_VERTEX_SNORM1010102:
+        case SL_VERTEX_UNORM1010102:
+        case SL_VERTEX_OCT_NORMAL: return 4;
+        default: return 0;
+    }
+}
+
+i32 sl_vertex_layout_add(sl_vertex_layout* Layout, i32 Components, sl_vertex_format Format)
+{
+    if (Layout->Count >= SL_VERTEX_MAX_ATTRIBS || Components < 1 || Components > 4 ||
+        Format < 0 || Format >= SL_VERTEX_FORMAT_COUNT)
+        return -1;
+    if ((Format == SL_VERTEX_SNORM1010102 || Format == SL_VERTEX_UNORM1010102) && Components < 3)
+        return -1;
+    if (Format == SL_VERTEX_OCT_NORMAL && Components != 3)
+        return -1;
+
+    // NOTE(scott): attributes start 4 byte aligned, the stride follows the last
+    // one so padding from sl_vertex_layout_pad() gets undone by adding more
+    i32 End = 0;
+    if (Layout->Count)
+    {
+        sl_vertex_attrib* Last = Layout->Attribs + Layout->Count - 1;
+        End = Last->Offset + Last->Size;
+    }
+
+    sl_vertex_attrib* Attrib = Layout->Attribs + Layout->Count;
+    Attrib->Components = Components;
+    Attrib->Format = Format;
+    Attrib->Offset = (End + 3) & ~3;
+    Attrib->Size = sl_vertex_format_size(Format, Components);
+    Layout->Stride = (Attrib->Offset + Attrib->Size + 3) & ~3;
+    return Layout->Count++;
+}
+
+void sl_vertex_layout_pad(sl_vertex_layout* Layout, i32 Alignment)
+{
+    if (Alignment > 1)
+        Layout->Stride = (Layout->Stride + Alignment - 1) / Alignment * Alignment;
+}
+
+//
+// Normalized 8 / 16 bit conversions
+//
+// NOTE(scott): clamped and rounded the same way as Real32ToSnorm16 (NaN to the
+// bottom of the range, nearest even) so the SSE2 versions match exactly
+//
+
+internal inline i32
+sl_vertex_quantize(real32 F, real32 Lo, real32 Scale)
+{
+    if (!(F >= Lo))
+        F = Lo;
+    if (F > 1.f)
+        F = 1.f;
+    return (i32)lrintf(F * Scale);
+}
+
+internal void
+sl_vertex_encode_unorm16(u16* Out, real32* In, i32 Count)
+{
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 Lo = _mm_setzero_ps(), Hi = _mm_set1_ps(1.f), Scale = _mm_set1_ps(65535.f);
+    __m128i Bias = _mm_set1_epi32(32768);
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128i A = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(In + i), Lo), Hi), Scale));
+        __m128i B = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(In + i + 4), Lo), Hi), Scale));
+        // no unsigned 32 -> 16 pack in SSE2, shift into signed range and back
+        __m128i Packed = _mm_packs_epi32(_mm_sub_epi32(A, Bias), _mm_sub_epi32(B, Bias));
+        _mm_storeu_si128((__m128i*)(Out + i), _mm_xor_si128(Packed, _mm_set1_epi16((short)0x8000)));
+    }
+#endif
+    for (; i < Count; i++)
+        Out[i] = (u16)sl_vertex_quantize(In[i], 0.f, 65535.f);
+}
+
+internal void
+sl_vertex_encode_8(u8* Out, real32* In, i32 Count, bool Signed)
+{
+    real32 Lo = Signed ? -1.f : 0.f;
+    real32 Max = Signed ? 127.f : 255.f;
+    i32 i = 0;
+#ifdef SL_SSE2
+    __m128 VLo = _mm_set1_ps(Lo), VHi = _mm_set1_ps(1.f), Scale = _mm_set1_ps(Max);
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m128i I[4];
+        for (i32 k = 0; k < 4; k++)
+            I[k] = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(In + i + 4 * k), VLo), VHi), Scale));
+        __m128i Lo16 = _mm_packs_epi32(I[0], I[1]);
+        __m128i Hi16 = _mm_packs_epi32(I[2], I[3]);
+        __m128i Bytes = Signed ? _mm_packs_epi16(Lo16, Hi16) : _mm_packus_epi16(Lo16, Hi16);
+        _mm_storeu_si128((__m128i*)(Out + i), Bytes);
+    }
+#endif
+    for (; i < Count; i++)
+        Out[i] = (u8)sl_vertex_quantize(In[i], Lo, Max);
+}
+
+internal void
+sl_vertex_decode_unorm16(real32* Out, u16* In, i32 Count)
+{
+    for (i32 i = 0; i < Count; i++)
+        Out[i] = (real32)In[i] * (1.f / 65535.f);
+}
+
+internal void
+sl_vertex_decode_8(real32* Out, u8* In, i32 Count, bool Signed)
+{
+    if (Signed)
+    {
+        for (i32 i = 0; i < Count; i++)
+        {
+            real32 F = (real32)(i8)In[i] * (1.f / 127.f);
+            Out[i] = F < -1.f ? -1.f : F;
+        }
+    }
+    else
+    {
+        for (i32 i = 0; i < Count; i++)
+            Out[i] = (real32)In[i] * (1.f / 255.f);
+    }
+}
+
+//
+// Chunk conversion
+//
+
+// NOTE(scott): converts Count vertices of one attribute into Temp, tightly
+// packed at Attrib->Size bytes each
+internal void
+sl_vertex_encode_chunk(const sl_vertex_attrib* Attrib, real32* In, i32 Count, u8* Temp, vec4f* Wide)
+{
+    i32 Values = Count * Attrib->Components;
+    switch (Attrib->Format)
+    {
+        case SL_VERTEX_FLOAT: memcpy(Temp, In, sizeof(real32) * Values); break;
+        case SL_VERTEX_HALF: EncodeHalfArray((u16*)Temp, In, Values); break;
+        case SL_VERTEX_SNORM16: EncodeSnorm16Array((i16*)Temp, In, Values); break;
+        case SL_VERTEX_UNORM16: sl_vertex_encode_unorm16((u16*)Temp, In, Values); break;
+        case SL_VERTEX_SNORM8: sl_vertex_encode_8(Temp, In, Values, true); break;
+        case SL_VERTEX_UNORM8: sl_vertex_encode_8(Temp, In, Values, false); break;
+        case SL_VERTEX_OCT_NORMAL: EncodeOctNormalArray((u32*)Temp, (vec3f*)In, Count); break;
+        case SL_VERTEX_SNORM1010102:
+        case SL_VERTEX_UNORM1010102:
+        {
+            vec4f* Source = (vec4f*)In;
+            if (Attrib->Components == 3)
+            {
+                for (i32 i = 0; i < Count; i++)
+                {
+                    memcpy(Wide[i].E, In + 3 * i, sizeof(real32) * 3);
+                    Wide[i].W = 0.f;
+                }
+                Source = Wide;
+            }
+            if (Attrib->Format == SL_VERTEX_SNORM1010102)
+                PackSnorm1010102Array((u32*)Temp, Source, Count);
+            else
+                PackUnorm1010102Array((u32*)Temp, Source, Count);
+        } break;
+        default: break;
+    }
+}
+
+internal void
+sl_vertex_decode_chunk(const sl_vertex_attrib* Attrib, u8* Temp, i32 Count, real32* Out, vec4f* Wide)
+{
+    i32 Values = Count * Attrib->Components;
+    switch (Attrib->Format)
+    {
+        case SL_VERTEX_FLOAT: memcpy(Out, Temp, sizeof(real32) * Values); break;
+        case SL_VERTEX_HALF: DecodeHalfArray(Out, (u16*)Temp, Values); break;
+        case SL_VERTEX_SNORM16: DecodeSnorm16Array(Out, (i16*)Temp, Values); break;
+        case SL_VERTEX_UNORM16: sl_vertex_decode_unorm16(Out, (u16*)Temp, Values); break;
+        case SL_VERTEX_SNORM8: sl_vertex_decode_8(Out, Temp, Values, true); break;
+        case SL_VERTEX_UNORM8: sl_vertex_decode_8(Out, Temp, Values, false); break;
+        case SL_VERTEX_OCT_NORMAL: DecodeOctNormalArray((vec3f*)Out, (u32*)Temp, Count); break;
+        case SL_VERTEX_SNORM1010102:
+        case SL_VERTEX_UNORM1010102:
+        {
+            vec4f* Dest = Attrib->Components == 4 ? (vec4f*)Out : Wide;
+            if (Attrib->Format == SL_VERTEX_SNORM1010102)
+                UnpackSnorm1010102Array(Dest, (u32*)Temp, Count);
+            else
+                UnpackUnorm1010102Array(Dest, (u32*)Temp, Count);
+            if (Dest == Wide)
+            {
+                for (i32 i = 0; i < Count; i++)
+                    memcpy(Out + 3 * i, Wide[i].E, sizeof(real32) * 3);
+            }
+        } break;
+        default: break;
+    }
+}
+
+// NOTE(scott): constant size copies so the compiler turns each one into a move
+// or two instead of a memcpy call per vertex
+#define SL_VERTEX_SCATTER(Bytes) \
+    for (i32 i = 0; i < Count; i++) \
+        memcpy(Out + i * Stride, Temp + i * (Bytes), (Bytes));
+#define SL_VERTEX_GATHER(Bytes) \
+    for (i32 i = 0; i < Count; i++) \
+        memcpy(Temp + i * (Bytes), In + i * Stride, (Bytes));
+
+internal void
+sl_vertex_scatter(u8* Out, i32 Stride, u8* Temp, i32 Size, i32 Count)
+{
+    switch (Size)
+    {
+        case 4: SL_VERTEX_SCATTER(4) break;
+        case 6: SL_VERTEX_SCATTER(6) break;
+        case 8: SL_VERTEX_SCATTER(8) break;
+        case 12: SL_VERTEX_SCATTER(12) break;
+        case 16: SL_VERTEX_SCATTER(16) break;
+        default: SL_VERTEX_SCATTER(Size) break;
+    }
+}
+
+internal void
+sl_vertex_gather(u8* Temp, const u8* In, i32 Stride, i32 Size, i32 Count)
+{
+    switch (Size)
+    {
+        case 4: SL_VERTEX_GATHER(4) break;
+        case 6: SL_VERTEX_GATHER(6) break;
+        case 8: SL_VERTEX_GATHER(8) break;
+        case 12: SL_VERTEX_GATHER(12) break;
+        case 16: SL_VERTEX_GATHER(16) break;
+        default: SL_VERTEX_GATHER(Size) break;
+    }
+}
+
+void sl_vertex_pack(const sl_vertex_layout* Layout, real32** Sources, i32 Count, void* Out)
+{
+    SL_PROFILE_ZONE("sl_vertex_pack");
+    // NOTE(scott): 16 bytes a vertex is the most any one attribute takes
+    vec4f Temp[SL_VERTEX_CHUNK];
+    vec4f Wide[SL_VERTEX_CHUNK];
+
+    i32 Used = 0;
+    for (i32 a = 0; a < Layout->Count; a++)
+        Used += Layout->Attribs[a].Size;
+    bool Padded = Used != Layout->Stride;
+
+    u8* Dest = (u8*)Out;
+    for (i32 Start = 0; Start < Count; Start += SL_VERTEX_CHUNK)
+    {
+        i32 Chunk = Count - Start < SL_VERTEX_CHUNK ? Count - Start : SL_VERTEX_CHUNK;
+        u8* ChunkOut = Dest + (size_t)Start * Layout->Stride;
+        if (Padded)
+            memset(ChunkOut, 0, (size_t)Chunk * Layout->Stride);
+
+        for (i32 a = 0; a < Layout->Count; a++)
+        {
+            const sl_vertex_attrib* Attrib = Layout->Attribs + a;
+            real32* In = Sources[a] + (size_t)Start * Attrib->Components;
+            sl_vertex_encode_chunk(Attrib, In, Chunk, (u8*)Temp, Wide);
+            sl_vertex_scatter(ChunkOut + Attrib->Offset, Layout->Stride, (u8*)Temp, Attrib->Size, Chunk);
+        }
+    }
+}
+
+void sl_vertex_unpack(const sl_vertex_layout* Layout, const void* In, i32 Count, real32** Dests)
+{
+    SL_PROFILE_ZONE("sl_vertex_unpack");
+    vec4f Temp[SL_VERTEX_CHUNK];
+    vec4f Wide[SL_VERTEX_CHUNK];
+
+    const u8* Source = (const u8*)In;
+    for (i32 Start = 0; Start < Count; Start += SL_VERTEX_CHUNK)
+    {
+        i32 Chunk = Count - Start < SL_VERTEX_CHUNK ? Count - Start : SL_VERTEX_CHUNK;
+        const u8* ChunkIn = Source + (size_t)Start * Layout->Stride;
+        for (i32 a = 0; a < Layout->Count; a++)
+        {
+            const sl_vertex_attrib* Attrib = Layout->Attribs + a;
+            if (!Dests[a])
+                continue;
+            sl_vertex_gather((u8*)Temp, ChunkIn + Attrib->Offset, Layout->Stride, Attrib->Size, Chunk);
+            sl_vertex_decode_chunk(Attrib, (u8*)Temp, Chunk, Dests[a] + (size_t)Start * Attrib->Components, Wide);
+        }
+    }
+}
+
+void sl_vertex_pack_da(const sl_vertex_layout* Layout, real32** Sources, i32 Count, u8** Buffer)
+{
+    i32 Bytes = Count * Layout->Stride;
+    if (da_cap(*Buffer) < Bytes)
+        *Buffer = _da_init(*Buffer, Bytes);
+    if (*Buffer)
+        _da_hdr(*Buffer) = Bytes;
+    if (Count)
+        sl_vertex_pack(Layout, Sources, Count, *Buffer);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SL_VERTEX_IMPL
+
+#endif // SL_VERTEX_H
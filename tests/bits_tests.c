@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_CPU_IMPL
+#define SL_BITS_IMPL
+#include "sl_bits.h"
+
+#define TEST_RANDOM_SEED 424242u
+#include "test_random.h"
+
+// runs everything against a plain array of flags
+static void CheckAgainstFlags(int Count)
+{
+    static unsigned char FlagsA[5000], FlagsB[5000];
+    sl_bits A = {0}, B = {0}, R = {0};
+    sl_bits_resize(&A, Count);
+    sl_bits_resize(&B, Count);
+
+    int CountA = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        FlagsA[i] = (TestRandom() % 3) == 0;
+        FlagsB[i] = (TestRandom() % 2) == 0;
+        sl_bits_assign(&A, i, FlagsA[i]);
+        sl_bits_assign(&B, i, FlagsB[i]);
+        CountA += FlagsA[i];
+    }
+    assert(sl_bits_count(&A) == CountA);
+
+    for (int Op = 0; Op < 4; Op++)
+    {
+        switch (Op)
+        {
+            case 0: sl_bits_and(&R, &A, &B); break;
+            case 1: sl_bits_or(&R, &A, &B); break;
+            case 2: sl_bits_xor(&R, &A, &B); break;
+            case 3: sl_bits_andnot(&R, &A, &B); break;
+        }
+        int Expected = 0;
+        for (int i = 0; i < Count; i++)
+        {
+            int Bit = Op == 0 ? (FlagsA[i] & FlagsB[i]) : Op == 1 ? (FlagsA[i] | FlagsB[i]) :
+                      Op == 2 ? (FlagsA[i] ^ FlagsB[i]) : (FlagsA[i] & !FlagsB[i]);
+            assert((int)sl_bits_get(&R, i) == Bit);
+            Expected += Bit;
+        }
+        assert(R.Count == Count && sl_bits_count(&R) == Expected);
+    }
+
+    // find next visits exactly the set (and clear) bits
+    int Visited = 0, Previous = -1;
+    for (int i = sl_bits_next_set(&A, 0); i >= 0; i = sl_bits_next_set(&A, i + 1))
+    {
+        assert(FlagsA[i]);
+        for (int j = Previous + 1; j < i; j++)
+            assert(!FlagsA[j]);
+        Previous = i;
+        Visited++;
+    }
+    assert(Visited == CountA);
+
+    Visited = 0;
+    for (int i = sl_bits_next_clear(&A, 0); i >= 0; i = sl_bits_next_clear(&A, i + 1))
+    {
+        assert(!FlagsA[i] && i < Count);
+        Visited++;
+    }
+    assert(Visited == Count - CountA);
+
+    // compaction keeps the marked elements in order
+    int Values[5000];
+    for (int i = 0; i < Count; i++)
+        Values[i] = i;
+    int Kept = sl_bits_compact(Values, sizeof(int), &A);
+    assert(Kept == CountA);
+    for (int i = 0, k = 0; i < Count; i++)
+    {
+        if (FlagsA[i])
+            assert(Values[k++] == i);
+    }
+
+    sl_bits_free(&A);
+    sl_bits_free(&B);
+    sl_bits_free(&R);
+}
+
+int main(int argc, char** argv) {
+
+    sl_bits Bits = {0};
+    assert(sl_bits_count(&Bits) == 0 && sl_bits_next_set(&Bits, 0) == -1);
+
+    sl_bits_resize(&Bits, 100);
+    assert(Bits.Count == 100 && da_len(Bits.Words) == 2);
+    assert(sl_bits_count(&Bits) == 0);
+    sl_bits_set(&Bits, 0);
+    sl_bits_set(&Bits, 63);
+    sl_bits_set(&Bits, 64);
+    sl_bits_set(&Bits, 99);
+    assert(sl_bits_count(&Bits) == 4);
+    assert(sl_bits_next_set(&Bits, 1) == 63 && sl_bits_next_set(&Bits, 65) == 99);
+    sl_bits_toggle(&Bits, 63);
+    sl_bits_clear(&Bits, 64);
+    assert(sl_bits_next_set(&Bits, 1) == 99);
+
+    // the tail past Count stays clear through set_all and shrinking
+    sl_bits_set_all(&Bits);
+    assert(sl_bits_count(&Bits) == 100 && sl_bits_next_clear(&Bits, 0) == -1);
+    sl_bits_resize(&Bits, 70);
+    assert(sl_bits_count(&Bits) == 70);
+    sl_bits_resize(&Bits, 200);
+    assert(sl_bits_count(&Bits) == 70 && sl_bits_next_clear(&Bits, 0) == 70);
+    sl_bits_clear_all(&Bits);
+    assert(sl_bits_count(&Bits) == 0);
+    sl_bits_free(&Bits);
+
+    for (int i = 0; i < 130; i++)
+        sl_bits_push(&Bits, i % 5 == 0);
+    assert(Bits.Count == 130 && sl_bits_count(&Bits) == 26 && sl_bits_get(&Bits, 125));
+    sl_bits_free(&Bits);
+
+    // every kernel, on sizes around the word and vector edges
+    int Sizes[] = { 1, 63, 64, 65, 127, 128, 129, 255, 256, 257, 1000, 4999 };
+    unsigned int Overrides[] = { ~0u, ~SL_CPU_AVX2, ~(SL_CPU_AVX2 | SL_CPU_POPCNT), 0 };
+    for (int o = 0; o < 4; o++)
+    {
+        sl_cpu_override(Overrides[o]);
+        for (int s = 0; s < (int)(sizeof(Sizes) / sizeof(Sizes[0])); s++)
+            CheckAgainstFlags(Sizes[s]);
+    }
+    sl_cpu_override(~0u);
+
+    // dyn_array compaction
+    float* Values = NULL;
+    sl_bits Mask = {0};
+    for (int i = 0; i < 1000; i++)
+    {
+        da_append(Values, (float)i);
+        sl_bits_push(&Mask, i >= 100 && i < 300);
+    }
+    sl_bits_compact_da(Values, &Mask);
+    assert(da_len(Values) == 200 && Values[0] == 100 && Values[199] == 299);
+    da_delete(Values);
+    sl_bits_free(&Mask);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_HASH_IMPL
+#define SL_BLOB_IMPL
+#include "sl_blob.h"
+
+typedef struct point { float X, Y, Z; } point;
+typedef struct transform { float E[16]; } transform;
+
+static const char* Path = "sl_blob_tests.bin";
+
+int main(int argc, char** argv) {
+
+    assert(sizeof(sl_blob_header) == SL_BLOB_HEADER_SIZE);
+
+    point* Points = NULL;
+    for (int i = 0; i < 10000; i++)
+    {
+        point P = { (float)i, (float)i * 0.5f, -(float)i };
+        da_append(Points, P);
+    }
+
+    assert(sl_blob_write_da(Path, Points, SL_BLOB_VEC3F) == SL_BLOB_OK);
+
+    // mapped view is a dyn_array over the file
+    point* Mapped = NULL;
+    sl_blob_view View;
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, SL_BLOB_VERIFY, &View) == SL_BLOB_OK);
+    assert(da_len(Mapped) == 10000 && da_cap(Mapped) == 10000);
+    assert(memcmp(Mapped, Points, sizeof(point) * 10000) == 0);
+    assert(((size_t)Mapped & 15) == 0);
+
+    // in place edits stay out of the file
+    Mapped[0].X = 123.f;
+    sl_blob_unmap(&View);
+    assert(View.Base == NULL);
+
+    // heap copy
+    point* Read = NULL;
+    assert(sl_blob_read_da(Path, Read, SL_BLOB_VEC3F, SL_BLOB_VERIFY) == SL_BLOB_OK);
+    assert(da_len(Read) == 10000 && Read[0].X == 0.f);
+    assert(memcmp(Read, Points, sizeof(point) * 10000) == 0);
+    point Extra = { 1, 2, 3 };
+    da_append(Read, Extra);
+    assert(da_len(Read) == 10001);
+    da_delete(Read);
+
+    // wrong type or size is refused
+    transform* Transforms = NULL;
+    assert(sl_blob_map_da(Path, Transforms, SL_BLOB_MAT4F, 0, &View) == SL_BLOB_ERROR_TYPE);
+    assert(Transforms == NULL && View.Base == NULL);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC4F, 0, &View) == SL_BLOB_ERROR_TYPE);
+    assert(sl_blob_read_da(Path, Transforms, SL_BLOB_VEC3F, 0) == SL_BLOB_ERROR_TYPE);
+
+    // and so is the right tag and size with another alignment
+    assert(sl_blob_write(Path, Points, da_len(Points), (int)sizeof(point), 8, SL_BLOB_VEC3F) == SL_BLOB_OK);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_ERROR_TYPE);
+    assert(sl_blob_read_da(Path, Read, SL_BLOB_VEC3F, 0) == SL_BLOB_ERROR_TYPE);
+    assert(sl_blob_read(Path, SL_BLOB_VEC3F, (int)sizeof(point), 8, 0, (void**)&Read) == SL_BLOB_OK);
+    assert(da_len(Read) == 10000);
+    da_delete(Read);
+    Read = NULL;
+    assert(sl_blob_write_da(Path, Points, SL_BLOB_VEC3F) == SL_BLOB_OK);
+
+    // corrupt a payload byte: only caught when verifying
+    FILE* File = fopen(Path, "r+b");
+    fseek(File, SL_BLOB_HEADER_SIZE + 100, SEEK_SET);
+    fputc(0x55, File);
+    fclose(File);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_OK);
+    sl_blob_unmap(&View);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, SL_BLOB_VERIFY, &View) == SL_BLOB_ERROR_CHECKSUM);
+    assert(sl_blob_read_da(Path, Read, SL_BLOB_VEC3F, SL_BLOB_VERIFY) == SL_BLOB_ERROR_CHECKSUM);
+    assert(Read == NULL);
+
+    // short file
+    File = fopen(Path, "r+b");
+    fseek(File, 0, SEEK_END);
+    long Size = ftell(File);
+    fclose(File);
+    File = fopen(Path, "rb");
+    static char Bytes[200000];
+    assert(fread(Bytes, 1, Size, File) == (size_t)Size);
+    fclose(File);
+    File = fopen(Path, "wb");
+    fwrite(Bytes, 1, Size - 12, File);
+    fclose(File);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_ERROR_TRUNCATED);
+
+    // not ours at all
+    File = fopen(Path, "wb");
+    fputs("0.0, 1.0, 2.0\n", File);
+    fclose(File);
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_ERROR_FORMAT);
+    assert(sl_blob_read_da(Path, Read, SL_BLOB_VEC3F, 0) == SL_BLOB_ERROR_FORMAT);
+    assert(sl_blob_map_da("sl_blob_missing.bin", Mapped, SL_BLOB_VEC3F, 0, &View) == SL_BLOB_ERROR_IO);
+    assert(strcmp(sl_blob_error_string(SL_BLOB_ERROR_CHECKSUM), "checksum mismatch") == 0);
+
+    // empty arrays round trip as NULL
+    point* Empty = NULL;
+    assert(sl_blob_write_da(Path, Empty, SL_BLOB_VEC3F) == SL_BLOB_OK);
+    Mapped = Points;
+    assert(sl_blob_map_da(Path, Mapped, SL_BLOB_VEC3F, SL_BLOB_VERIFY, &View) == SL_BLOB_OK);
+    assert(Mapped == NULL && da_len(Mapped) == 0);
+    sl_blob_unmap(&View);
+    assert(sl_blob_read_da(Path, Read, SL_BLOB_VEC3F, SL_BLOB_VERIFY) == SL_BLOB_OK && Read == NULL);
+
+    remove(Path);
+    da_delete(Points);
+
+    printf("Passed\n");
+    return 0;
+}
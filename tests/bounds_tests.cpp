@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_BOUNDS_IMPL
+#include "sl_bounds.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+// OpenGL style perspective looking down -Z
+static mat4f Perspective(real32 FovY, real32 Aspect, real32 Near, real32 Far)
+{
+    mat4f Result = {0};
+    real32 F = 1.f / tanf(0.5f * FovY);
+    Result.E[0] = F / Aspect;
+    Result.E[5] = F;
+    Result.E[10] = (Far + Near) / (Near - Far);
+    Result.E[11] = -1.f;
+    Result.E[14] = 2.f * Far * Near / (Near - Far);
+    return Result;
+}
+
+int main(int argc, char** argv) {
+
+    srand(42);
+
+    sl_frustum Frustum = sl_frustum_from_mat4f(Perspective((real32)SL_PI_2, 1.f, 1.f, 100.f));
+
+    assert(sl_frustum_test_point(&Frustum, Vec3f(0, 0, -10)));
+    assert(!sl_frustum_test_point(&Frustum, Vec3f(0, 0, 10)));
+    assert(!sl_frustum_test_point(&Frustum, Vec3f(0, 0, -200)));
+    assert(!sl_frustum_test_point(&Frustum, Vec3f(20, 0, -10)));
+
+    sphere3f S = { Vec3f(12, 0, -10), 3.f };
+    assert(sl_frustum_test_sphere(&Frustum, S));
+    S.Radius = 1.f;
+    assert(!sl_frustum_test_sphere(&Frustum, S));
+
+    assert(sl_frustum_test_aabb(&Frustum, Aabb3f(Vec3f(-1, -1, -1.5f), Vec3f(1, 1, 5))));
+    assert(!sl_frustum_test_aabb(&Frustum, Aabb3f(Vec3f(-1, -1, 1), Vec3f(1, 1, 5))));
+
+    // batch kernels agree with the single tests, with a count that leaves a tail
+    const int Count = 1003;
+    sphere3f* Spheres = NULL;
+    aabb3f* Boxes = NULL;
+    real32 *X = NULL, *Y = NULL, *Z = NULL, *R = NULL;
+    real32 *MinX = NULL, *MinY = NULL, *MinZ = NULL, *MaxX = NULL, *MaxY = NULL, *MaxZ = NULL;
+    for (int i = 0; i < Count; i++)
+    {
+        sphere3f Sphere = { Vec3f(RandomReal32(-150, 150), RandomReal32(-150, 150), RandomReal32(-150, 50)), RandomReal32(0, 10) };
+        da_append(Spheres, Sphere);
+        da_append(X, Sphere.Center.X);
+        da_append(Y, Sphere.Center.Y);
+        da_append(Z, Sphere.Center.Z);
+        da_append(R, Sphere.Radius);
+
+        vec3f Min = Sphere.Center;
+        vec3f Max = Vec3f(Min.X + RandomReal32(0, 10), Min.Y + RandomReal32(0, 10), Min.Z + RandomReal32(0, 10));
+        da_append(Boxes, Aabb3f(Min, Max));
+        da_append(MinX, Min.X); da_append(MinY, Min.Y); da_append(MinZ, Min.Z);
+        da_append(MaxX, Max.X); da_append(MaxY, Max.Y); da_append(MaxZ, Max.Z);
+    }
+
+    int* Visible = NULL;
+    int* VisibleSoa = NULL;
+    sl_cull_spheres(&Frustum, Spheres, Count, &Visible);
+    sl_cull_spheres_soa(&Frustum, X, Y, Z, R, Count, &VisibleSoa);
+    int Expected = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (sl_frustum_test_sphere(&Frustum, Spheres[i]))
+        {
+            assert(Visible[Expected] == i);
+            assert(VisibleSoa[Expected] == i);
+            Expected++;
+        }
+    }
+    assert(Expected > 0 && Expected < Count);
+    assert(da_len(Visible) == Expected);
+    assert(da_len(VisibleSoa) == Expected);
+
+    da_clear(Visible);
+    da_clear(VisibleSoa);
+    sl_cull_aabbs(&Frustum, Boxes, Count, &Visible);
+    sl_cull_aabbs_soa(&Frustum, MinX, MinY, MinZ, MaxX, MaxY, MaxZ, Count, &VisibleSoa);
+    Expected = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (sl_frustum_test_aabb(&Frustum, Boxes[i]))
+        {
+            assert(Visible[Expected] == i);
+            assert(VisibleSoa[Expected] == i);
+            Expected++;
+        }
+    }
+    assert(da_len(Visible) == Expected);
+    assert(da_len(VisibleSoa) == Expected);
+
+    // results append rather than replace
+    sl_cull_aabbs_by_aabb(Aabb3f(Vec3f(-50, -50, -50), Vec3f(50, 50, 50)), Boxes, Count, &Visible);
+    int Overlapping = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (OverlapsAabb3f(Boxes[i], Aabb3f(Vec3f(-50, -50, -50), Vec3f(50, 50, 50))))
+        {
+            assert(Visible[Expected + Overlapping] == i);
+            Overlapping++;
+        }
+    }
+    assert(da_len(Visible) == Expected + Overlapping);
+
+    // 2D
+    aabb2f* Rects = NULL;
+    vec2f* Points = NULL;
+    for (int i = 0; i < Count; i++)
+    {
+        vec2f Min = Vec2f(RandomReal32(-100, 100), RandomReal32(-100, 100));
+        vec2f Max = Vec2f(Min.X + RandomReal32(0, 20), Min.Y + RandomReal32(0, 20));
+        da_append(Rects, Aabb2f(Min, Max));
+        da_append(Points, Min);
+    }
+
+    // unbounded boxes (a ground plane, a half space) at a SIMD index and in the tail
+    Rects[5] = Aabb2f(Vec2f(-INFINITY, -INFINITY), Vec2f(INFINITY, INFINITY));
+    Rects[6] = Aabb2f(Vec2f(-INFINITY, 0), Vec2f(0, INFINITY));
+    Rects[Count - 1] = Aabb2f(Vec2f(-INFINITY, -INFINITY), Vec2f(INFINITY, INFINITY));
+    Rects[Count - 2] = Aabb2f(Vec2f(50, -INFINITY), Vec2f(INFINITY, INFINITY));
+
+    aabb2f View = Aabb2f(Vec2f(-30, -10), Vec2f(40, 25));
+    da_clear(Visible);
+    da_clear(VisibleSoa);
+    sl_cull_aabb2fs(View, Rects, Count, &Visible);
+    sl_cull_points2f(View, Points, Count, &VisibleSoa);
+    int ExpectedRects = 0, ExpectedPoints = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (OverlapsAabb2f(View, Rects[i]))
+        {
+            assert(Visible[ExpectedRects] == i);
+            ExpectedRects++;
+        }
+        vec2f P = Points[i];
+        if (P.X >= View.Min.X && P.X <= View.Max.X && P.Y >= View.Min.Y && P.Y <= View.Max.Y)
+        {
+            assert(VisibleSoa[ExpectedPoints] == i);
+            ExpectedPoints++;
+        }
+    }
+    assert(da_len(Visible) == ExpectedRects);
+    assert(OverlapsAabb2f(View, Rects[5]) && OverlapsAabb2f(View, Rects[6]));
+    assert(Visible[da_len(Visible) - 1] == Count - 1);
+    assert(da_len(VisibleSoa) == ExpectedPoints);
+
+    sphere3f Around = SphereFromAabb3f(Aabb3f(Vec3f(-1, -1, -1), Vec3f(1, 1, 1)));
+    assert(Around.Center.X == 0.f && fabsf(Around.Radius - sqrtf(3.f)) < 1e-6f);
+
+    da_delete(Spheres);
+    da_delete(Boxes);
+    da_delete(X); da_delete(Y); da_delete(Z); da_delete(R);
+    da_delete(MinX); da_delete(MinY); da_delete(MinZ);
+    da_delete(MaxX); da_delete(MaxY); da_delete(MaxZ);
+    da_delete(Visible);
+    da_delete(VisibleSoa);
+    da_delete(Rects);
+    da_delete(Points);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define SL_CPU_IMPL
+#include "sl_cpu.h"
+
+int main(int argc, char** argv) {
+
+    unsigned int Features = sl_cpu_features();
+
+    // detection is cached and stable
+    assert(sl_cpu_features() == Features);
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // every x86-64 has SSE2
+    assert(Features & SL_CPU_SSE2);
+#endif
+
+    // the OS gate means the wide features can't show up without AVX
+    if (Features & (SL_CPU_AVX2 | SL_CPU_F16C | SL_CPU_FMA))
+        assert(Features & SL_CPU_AVX);
+
+    sl_cpu_override(~SL_CPU_AVX2);
+    assert(!(sl_cpu_features() & SL_CPU_AVX2));
+    assert((sl_cpu_features() | SL_CPU_AVX2) == (Features | SL_CPU_AVX2));
+    sl_cpu_override(0);
+    assert(sl_cpu_features() == 0);
+    sl_cpu_override(~0u);
+    assert(sl_cpu_features() == Features);
+
+    char Buffer[256];
+    int Length = sl_cpu_describe(SL_CPU_SSE2 | SL_CPU_AVX2, Buffer, sizeof(Buffer));
+    assert(Length == (int)strlen(Buffer));
+    assert(strcmp(Buffer, "sse2 avx2") == 0);
+
+    // truncation stops at a whole name
+    Length = sl_cpu_describe(SL_CPU_SSE2 | SL_CPU_AVX2, Buffer, 7);
+    assert(strcmp(Buffer, "sse2") == 0 && Length == 4);
+
+    assert(sl_cpu_describe(0, Buffer, sizeof(Buffer)) == 0 && Buffer[0] == 0);
+
+    sl_cpu_describe(Features, Buffer, sizeof(Buffer));
+    printf("%s\n", Buffer);
+
+    printf("Passed\n");
+    return 0;
+}
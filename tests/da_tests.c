@@ -16,7 +16,7 @@ void print_list(int* list) {
         printf("%d\n", list[i]);
 }
 
-void main(int argc, char** argv) {
+int main(int argc, char** argv) {
 
     struct MyType* list = NULL;
 
@@ -68,5 +68,23 @@ void main(int argc, char** argv) {
     assert(int_list[0] == 2);
     assert(int_list[1] == 1);
 
+    // removing the last element is fine
+    da_remove(int_list, 1);
+    assert(da_len(int_list) == 1);
+    assert(int_list[0] == 2);
+
+    // growth keeps everything and inserts shift the tail up
+    for (int i=0; i<100; i++) {
+        da_insert(int_list, i, 0);
+    }
+    assert(da_len(int_list) == 101);
+    assert(da_cap(int_list) >= 101);
+    assert(int_list[0] == 99);
+    assert(int_list[99] == 0);
+    assert(int_list[100] == 2);
+
+    da_delete(int_list);
+
     printf("Passed\n");
-}
\ No newline at end of file
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_GEOM2D_IMPL
+#include "sl_geom2d.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+static bool Near(real32 A, real32 B)
+{
+    return fabsf(A - B) <= 1e-4f * (1.f + fabsf(A) + fabsf(B));
+}
+
+int main(int argc, char** argv) {
+
+    srand(7);
+
+    // a 4x2 box, counter clockwise, and the same backwards
+    vec2f Box[4] = { Vec2f(0, 0), Vec2f(4, 0), Vec2f(4, 2), Vec2f(0, 2) };
+    vec2f BoxCw[4] = { Box[3], Box[2], Box[1], Box[0] };
+    assert(SignedAreaPolygon2f(Box, 4) == 8.f);
+    assert(SignedAreaPolygon2f(BoxCw, 4) == -8.f);
+    vec2f Center = CentroidPolygon2f(Box, 4);
+    assert(Center.X == 2.f && Center.Y == 1.f);
+    Center = CentroidPolygon2f(BoxCw, 4);
+    assert(Center.X == 2.f && Center.Y == 1.f);
+
+    // an L: the centroid is pulled towards the long arm
+    vec2f L[6] = { Vec2f(0, 0), Vec2f(2, 0), Vec2f(2, 1), Vec2f(1, 1), Vec2f(1, 3), Vec2f(0, 3) };
+    assert(SignedAreaPolygon2f(L, 6) == 4.f);
+    Center = CentroidPolygon2f(L, 6);
+    assert(Near(Center.X, 0.75f) && Near(Center.Y, 1.25f));
+
+    // far from the origin the area still comes out right
+    vec2f Far[4];
+    for (int i = 0; i < 4; i++)
+        Far[i] = Vec2f(Box[i].X + 100000.f, Box[i].Y + 100000.f);
+    assert(SignedAreaPolygon2f(Far, 4) == 8.f);
+
+    assert(ContainsPointPolygon2f(Box, 4, Vec2f(1, 1)));
+    assert(ContainsPointPolygon2f(BoxCw, 4, Vec2f(3.9f, 0.1f)));
+    assert(!ContainsPointPolygon2f(Box, 4, Vec2f(5, 1)));
+    assert(!ContainsPointPolygon2f(Box, 4, Vec2f(-1, 1)));
+    assert(!ContainsPointPolygon2f(Box, 4, Vec2f(1, 3)));
+    assert(!ContainsPointPolygon2f(L, 6, Vec2f(1.5f, 2)));
+    assert(ContainsPointPolygon2f(L, 6, Vec2f(0.5f, 2)));
+
+    // segments: crossing, touching, collinear overlapping, parallel, apart
+    vec2f Hit;
+    assert(IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(2, 2)), Segment2f(Vec2f(0, 2), Vec2f(2, 0)), &Hit));
+    assert(Near(Hit.X, 1) && Near(Hit.Y, 1));
+    assert(IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(1, 0)), Segment2f(Vec2f(1, 0), Vec2f(1, 5)), &Hit));
+    assert(Hit.X == 1 && Hit.Y == 0);
+    assert(IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(3, 0)), Segment2f(Vec2f(2, 0), Vec2f(5, 0)), &Hit));
+    assert(Hit.X >= 2 && Hit.X <= 3 && Hit.Y == 0);
+    assert(!IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(1, 0)), Segment2f(Vec2f(2, 0), Vec2f(3, 0)), NULL));
+    assert(!IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(2, 0)), Segment2f(Vec2f(0, 1), Vec2f(2, 1)), NULL));
+    assert(!IntersectSegments2f(Segment2f(Vec2f(0, 0), Vec2f(1, 1)), Segment2f(Vec2f(3, 0), Vec2f(2, 1)), NULL));
+
+    segment2f S = Segment2f(Vec2f(0, 0), Vec2f(4, 0));
+    assert(DistanceToSegment2f(Vec2f(2, 3), S) == 3.f);
+    assert(DistanceToSegment2f(Vec2f(-3, 4), S) == 5.f);
+    assert(DistanceToSegment2f(Vec2f(7, -4), S) == 5.f);
+    assert(DistanceToSegment2f(Vec2f(1, 1), Segment2f(Vec2f(1, 2), Vec2f(1, 2))) == 1.f);
+
+    // convex hull of a square full of points plus its corners
+    vec2f* Cloud = NULL;
+    for (int i = 0; i < 500; i++)
+    {
+        vec2f P = Vec2f(RandomReal32(-1, 1), RandomReal32(-1, 1));
+        da_append(Cloud, P);
+    }
+    vec2f Corners[4] = { Vec2f(-2, -2), Vec2f(2, -2), Vec2f(2, 2), Vec2f(-2, 2) };
+    for (int i = 0; i < 4; i++)
+    {
+        da_append(Cloud, Corners[i]);
+        vec2f Mid = Vec2f(0, Corners[i].Y);     // collinear, on the top and bottom edges
+        da_append(Cloud, Mid);
+    }
+    vec2f* Hull = NULL;
+    sl_convex_hull2f(Cloud, da_len(Cloud), &Hull);
+    assert(da_len(Hull) == 4);
+    assert(SignedAreaPolygon2f(Hull, da_len(Hull)) == 16.f);
+    for (int i = 0; i < da_len(Cloud); i++)
+        assert(ContainsPointPolygon2f(Hull, 4, Cloud[i]) || fabsf(Cloud[i].X) == 2 || fabsf(Cloud[i].Y) == 2);
+
+    // hull of random points: convex, counter clockwise, contains everything
+    da_clear(Hull);
+    for (int i = 0; i < da_len(Cloud); i++)
+        Cloud[i] = Vec2f(RandomReal32(-10, 10), RandomReal32(-5, 5));
+    sl_convex_hull2f(Cloud, da_len(Cloud), &Hull);
+    int H = da_len(Hull);
+    assert(H >= 3);
+    for (int i = 0; i < H; i++)
+    {
+        vec2f A = Hull[i], B = Hull[(i + 1) % H], C = Hull[(i + 2) % H];
+        assert((B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X) > 0);
+        for (int p = 0; p < da_len(Cloud); p++)
+            assert((B.X - A.X) * (Cloud[p].Y - A.Y) - (B.Y - A.Y) * (Cloud[p].X - A.X) >= -1e-4f);
+    }
+
+    // degenerate hulls: one point, the same point twice, appending after what's there
+    vec2f Same[3] = { Vec2f(1, 1), Vec2f(1, 1), Vec2f(1, 1) };
+    da_clear(Hull);
+    sl_convex_hull2f(Same, 3, &Hull);
+    assert(da_len(Hull) == 1);
+    sl_convex_hull2f(Box, 4, &Hull);
+    assert(da_len(Hull) == 5 && Hull[1].X == 0 && Hull[1].Y == 0);
+
+    // batch kernels agree with the single queries, with counts that leave a tail
+    const int Count = 2003;
+    vec2f* Star = NULL;
+    for (int i = 0; i < 37; i++)
+    {
+        real32 Angle = (real32)(2 * SL_PI * i / 37);
+        real32 Radius = (i & 1) ? 3.f : 10.f;
+        vec2f V = Vec2f(Radius * cosf(Angle), Radius * sinf(Angle));
+        da_append(Star, V);
+    }
+    vec2f* Points = NULL;
+    real32 *X = NULL, *Y = NULL;
+    segment2f* Segments = NULL;
+    real32 *AX = NULL, *AY = NULL, *BX = NULL, *BY = NULL;
+    for (int i = 0; i < Count; i++)
+    {
+        vec2f P = Vec2f(RandomReal32(-12, 12), RandomReal32(-12, 12));
+        if (i % 97 == 0)
+            P = Star[i % 37];   // right on a vertex
+        da_append(Points, P);
+        da_append(X, P.X);
+        da_append(Y, P.Y);
+
+        segment2f Seg = Segment2f(P, Vec2f(P.X + RandomReal32(-3, 3), P.Y + RandomReal32(-3, 3)));
+        if (i % 50 == 0)
+            Seg = Segment2f(Vec2f(-1, -1), Vec2f(5, 5));    // collinear with the query
+        da_append(Segments, Seg);
+        da_append(AX, Seg.A.X);
+        da_append(AY, Seg.A.Y);
+        da_append(BX, Seg.B.X);
+        da_append(BY, Seg.B.Y);
+    }
+
+    i32* Inside = NULL;
+    i32* InsideSoa = NULL;
+    sl_points_in_polygon2f(Star, da_len(Star), Points, Count, &Inside);
+    sl_points_in_polygon2f_soa(Star, da_len(Star), X, Y, Count, &InsideSoa);
+    assert(da_len(Inside) == da_len(InsideSoa));
+    int Next = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        bool In = ContainsPointPolygon2f(Star, da_len(Star), Points[i]);
+        if (In)
+        {
+            assert(Next < da_len(Inside) && Inside[Next] == i && InsideSoa[Next] == i);
+            Next++;
+        }
+    }
+    assert(Next == da_len(Inside) && Next > 100 && Next < Count / 2);
+
+    segment2f Query = Segment2f(Vec2f(0, 0), Vec2f(4, 4));
+    i32* Crossing = NULL;
+    i32* CrossingSoa = NULL;
+    sl_intersect_segments2f(Query, Segments, Count, &Crossing);
+    sl_intersect_segments2f_soa(Query, AX, AY, BX, BY, Count, &CrossingSoa);
+    assert(da_len(Crossing) == da_len(CrossingSoa));
+    Next = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (IntersectSegments2f(Query, Segments[i], NULL))
+        {
+            assert(Crossing[Next] == i && CrossingSoa[Next] == i);
+            Next++;
+        }
+    }
+    assert(Next == da_len(Crossing) && Next >= Count / 50);
+
+    real32* Distances = (real32*)malloc(sizeof(real32) * Count);
+    real32* DistancesSoa = (real32*)malloc(sizeof(real32) * Count);
+    for (int Closed = 0; Closed < 2; Closed++)
+    {
+        sl_distance_to_polyline2f(Star, da_len(Star), Closed, Points, Count, Distances);
+        sl_distance_to_polyline2f_soa(Star, da_len(Star), Closed, X, Y, Count, DistancesSoa);
+        int Edges = Closed ? da_len(Star) : da_len(Star) - 1;
+        for (int i = 0; i < Count; i++)
+        {
+            real32 Best = 1e30f;
+            for (int e = 0; e < Edges; e++)
+            {
+                real32 D = DistanceToSegment2f(Points[i], Segment2f(Star[e], Star[(e + 1) % da_len(Star)]));
+                Best = D < Best ? D : Best;
+            }
+            assert(Distances[i] == Best && DistancesSoa[i] == Best);
+        }
+    }
+    // a single vertex is just a point
+    sl_distance_to_polyline2f(Star, 1, false, Points, 5, Distances);
+    assert(Near(Distances[4], sqrtf((Points[4].X - 10) * (Points[4].X - 10) + Points[4].Y * Points[4].Y)));
+
+    free(Distances);
+    free(DistancesSoa);
+    da_delete(Cloud);
+    da_delete(Hull);
+    da_delete(Star);
+    da_delete(Points);
+    da_delete(X);
+    da_delete(Y);
+    da_delete(Segments);
+    da_delete(AX);
+    da_delete(AY);
+    da_delete(BX);
+    da_delete(BY);
+    da_delete(Inside);
+    da_delete(InsideSoa);
+    da_delete(Crossing);
+    da_delete(CrossingSoa);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_HASH_IMPL
+#include "sl_hash.h"
+
+int main(int argc, char** argv) {
+
+    // reference XXH64 values
+    assert(sl_hash64("", 0, 0) == 0xEF46DB3751D8E999ull);
+    assert(sl_hash64("a", 1, 0) == 0xD24EC4F1A98C6E5Bull);
+    assert(sl_hash64("abc", 3, 0) == 0x44BC2CF5AD770999ull);
+    assert(sl_hash_string("abc") == sl_hash64("abc", 3, 0));
+    assert(sl_hash64("abc", 3, 1) != sl_hash64("abc", 3, 0));
+
+    // 32 bytes and up go through the 4 lane stripes.  The buffer and the 101 byte
+    // values are xxhsum's self test, 32 and 33 are cross checked against a
+    // separate implementation of the spec that reproduces those.
+    const unsigned int Prime = 2654435761u;
+    unsigned char Sanity[101];
+    unsigned int ByteGen = Prime;
+    for (int i = 0; i < (int)sizeof(Sanity); i++)
+    {
+        Sanity[i] = (unsigned char)(ByteGen >> 24);
+        ByteGen *= ByteGen;
+    }
+    assert(sl_hash64(Sanity, 14, 0) == 0xCFFA8DB881BC3A3Dull);
+    assert(sl_hash64(Sanity, 14, Prime) == 0x5B9611585EFCC9CBull);
+    assert(sl_hash64(Sanity, 32, 0) == 0xAF5753D39159EDEEull);
+    assert(sl_hash64(Sanity, 32, Prime) == 0xDCAB9233B8CA7B0Full);
+    assert(sl_hash64(Sanity, 33, 0) == 0x6711CBDD8543BAA8ull);
+    assert(sl_hash64(Sanity, 33, Prime) == 0x66E9CECF2F1DE71Cull);
+    assert(sl_hash64(Sanity, 101, 0) == 0x0EAB543384F878ADull);
+    assert(sl_hash64(Sanity, 101, Prime) == 0xCAA65939306F1E21ull);
+
+    // streaming matches one shot for every split point and length
+    unsigned char Data[300];
+    for (int i = 0; i < (int)sizeof(Data); i++)
+        Data[i] = (unsigned char)(i * 131 + 7);
+
+    for (int Length = 0; Length <= (int)sizeof(Data); Length += 7)
+    {
+        unsigned long long Expected = sl_hash64(Data, Length, 42);
+        for (int Split = 0; Split <= Length; Split += 5)
+        {
+            sl_hash_state State;
+            sl_hash_init(&State, 42);
+            sl_hash_update(&State, Data, Split);
+            sl_hash_update(&State, Data + Split, Length - Split);
+            assert(sl_hash_final(&State) == Expected);
+        }
+
+        // and byte at a time
+        sl_hash_state State;
+        sl_hash_init(&State, 42);
+        for (int i = 0; i < Length; i++)
+            sl_hash_update(&State, Data + i, 1);
+        assert(sl_hash_final(&State) == Expected);
+    }
+
+    // every byte matters, even in the tail
+    for (int i = 0; i < 100; i++)
+    {
+        unsigned long long Before = sl_hash64(Data, 100, 0);
+        Data[i] ^= 1;
+        assert(sl_hash64(Data, 100, 0) != Before);
+        Data[i] ^= 1;
+    }
+
+    // interning
+    sl_intern_table Table = {0};
+    assert(sl_intern_find(&Table, "missing") == -1);
+    assert(sl_intern_lookup(&Table, 0) == NULL);
+
+    int Window = sl_intern(&Table, "window");
+    int Width = sl_intern(&Table, "width");
+    assert(Window == 0 && Width == 1);
+    assert(sl_intern(&Table, "window") == Window);
+    assert(sl_intern_range(&Table, "windows", 6) == Window);
+    assert(sl_intern_find(&Table, "width") == Width);
+    assert(sl_intern_find(&Table, "height") == -1);
+    assert(sl_intern_count(&Table) == 2);
+
+    char Copy[] = "window";
+    const char* Canonical = sl_intern_str(&Table, Copy);
+    assert(Canonical != Copy && Canonical == sl_intern_str(&Table, "window"));
+    assert(Canonical == sl_intern_lookup(&Table, Window));
+
+    // enough to force several rehashes and a couple of string blocks, with
+    // pointers staying put throughout
+    char Name[64];
+    for (int i = 0; i < 20000; i++)
+    {
+        sprintf(Name, "key_%d_with_some_padding_to_fill_blocks", i);
+        assert(sl_intern(&Table, Name) == i + 2);
+    }
+    assert(sl_intern_count(&Table) == 20002);
+    assert(sl_intern_lookup(&Table, Window) == Canonical);
+    for (int i = 0; i < 20000; i += 97)
+    {
+        sprintf(Name, "key_%d_with_some_padding_to_fill_blocks", i);
+        assert(sl_intern_find(&Table, Name) == i + 2);
+        assert(strcmp(sl_intern_lookup(&Table, i + 2), Name) == 0);
+    }
+
+    // empty strings and strings bigger than a block
+    int Empty = sl_intern(&Table, "");
+    assert(sl_intern(&Table, "") == Empty && sl_intern_lookup(&Table, Empty)[0] == 0);
+
+    static char Big[100 * 1024];
+    memset(Big, 'x', sizeof(Big) - 1);
+    int BigId = sl_intern(&Table, Big);
+    assert(strcmp(sl_intern_lookup(&Table, BigId), Big) == 0);
+    assert(sl_intern(&Table, "after_big") == BigId + 1);
+
+    sl_intern_free(&Table);
+    assert(sl_intern_count(&Table) == 0 && sl_intern_find(&Table, "window") == -1);
+
+    printf("Passed\n");
+    return 0;
+}
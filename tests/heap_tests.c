@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#include "sl_heap.h"
+
+typedef struct event
+{
+    double Time;
+    int Id;
+} event;
+
+#define EventBefore(A, B) ((A)->Time < (B)->Time)
+SL_HEAP_DEFINE(event_queue, event, EventBefore)
+
+// worst on top, for keeping the K smallest
+#define IntGreater(A, B) (*(A) > *(B))
+SL_HEAP_DEFINE(top_k, int, IntGreater)
+
+#define TEST_RANDOM_SEED 13579u
+#include "test_random.h"
+
+static int CompareInts(const void* A, const void* B)
+{
+    int X = *(const int*)A, Y = *(const int*)B;
+    return (X > Y) - (X < Y);
+}
+
+static void CheckHeap(event_queue* Queue)
+{
+    int Count = event_queue_count(Queue);
+    for (int i = 1; i < Count; i++)
+        assert(Queue->Items[(i - 1) / SL_HEAP_ARITY].Time <= Queue->Items[i].Time);
+    for (int i = 0; i < Count; i++)
+        assert(Queue->Positions[Queue->Handles[i]] == i);
+}
+
+// an evicted item's handle dies with it, the new item doesn't take it over
+static void CheckEviction(void)
+{
+    top_k Few = {0};
+    int Evicted;
+    int Popped[3];
+    int Held[3];
+    for (int i = 0; i < 3; i++)
+        Held[i] = top_k_push_bounded(&Few, 10 * (i + 1), 3, &Evicted);
+    assert(Evicted == -1);
+    assert(top_k_push_bounded(&Few, 40, 3, &Evicted) == -1 && Evicted == -1);
+    int Newest = top_k_push_bounded(&Few, 5, 3, &Evicted);
+    assert(Evicted == Held[2] && Newest != Held[2]);
+    assert(Few.Positions[Held[2]] < 0);
+    assert(*top_k_get(&Few, Newest) == 5);
+    // updates through the handles still held land on their own items
+    top_k_update(&Few, Held[0], 25);
+    top_k_update(&Few, Newest, 15);
+    assert(*top_k_get(&Few, Held[0]) == 25 && *top_k_get(&Few, Newest) == 15);
+    for (int i = 2; i >= 0; i--)
+        assert(top_k_pop(&Few, &Popped[i]));
+    assert(Popped[0] == 15 && Popped[1] == 20 && Popped[2] == 25);
+    top_k_free(&Few);
+}
+
+int main(int argc, char** argv) {
+
+    event_queue Queue = {0};
+    event Out;
+    assert(event_queue_count(&Queue) == 0 && event_queue_top(&Queue) == NULL);
+    assert(!event_queue_pop(&Queue, &Out));
+
+    // pops come out in order
+    for (int i = 0; i < 10000; i++)
+    {
+        event E = { (double)(TestRandom() % 100000), i };
+        event_queue_push(&Queue, E);
+    }
+    CheckHeap(&Queue);
+    double Last = -1;
+    int Popped = 0;
+    while (event_queue_pop(&Queue, &Out))
+    {
+        assert(Out.Time >= Last);
+        Last = Out.Time;
+        Popped++;
+    }
+    assert(Popped == 10000);
+
+    // handles follow their items through updates and removals
+    int Handles[1000];
+    double Times[1000];
+    for (int i = 0; i < 1000; i++)
+    {
+        event E = { (double)(TestRandom() % 1000), i };
+        Times[i] = E.Time;
+        Handles[i] = event_queue_push(&Queue, E);
+    }
+    for (int i = 0; i < 1000; i++)
+        assert(event_queue_get(&Queue, Handles[i])->Id == i);
+
+    for (int i = 0; i < 1000; i += 3)
+    {
+        // both directions
+        event E = { i % 2 ? -1.0 * i : 5000.0 + i, i };
+        Times[i] = E.Time;
+        event_queue_update(&Queue, Handles[i], E);
+    }
+    CheckHeap(&Queue);
+
+    int Removed = 0;
+    for (int i = 1; i < 1000; i += 7)
+    {
+        event E;
+        event_queue_remove(&Queue, Handles[i], &E);
+        assert(E.Id == i && E.Time == Times[i]);
+        Times[i] = -1e30;
+        Removed++;
+    }
+    CheckHeap(&Queue);
+    assert(event_queue_count(&Queue) == 1000 - Removed);
+    for (int i = 0; i < 1000; i++)
+    {
+        if (Times[i] != -1e30)
+            assert(event_queue_get(&Queue, Handles[i])->Time == Times[i]);
+    }
+
+    // freed handles get reused
+    event Extra = { 0.5, 5000 };
+    int ExtraHandle = event_queue_push(&Queue, Extra);
+    assert(ExtraHandle == Handles[995] && da_len(Queue.Positions) == 10000);
+    assert(event_queue_get(&Queue, ExtraHandle)->Id == 5000);
+
+    Last = -1e30;
+    while (event_queue_pop(&Queue, &Out))
+    {
+        assert(Out.Time >= Last);
+        Last = Out.Time;
+    }
+
+    // bulk build
+    event Bulk[5000];
+    for (int i = 0; i < 5000; i++)
+    {
+        Bulk[i].Time = (double)(TestRandom() % 777);
+        Bulk[i].Id = i;
+    }
+    event_queue_heapify(&Queue, Bulk, 5000);
+    CheckHeap(&Queue);
+    assert(event_queue_get(&Queue, 1234)->Id == 1234);
+    event_queue_heapify(&Queue, Bulk, 1);
+    assert(event_queue_count(&Queue) == 1);
+    event_queue_heapify(&Queue, Bulk, 0);
+    assert(event_queue_count(&Queue) == 0);
+    event_queue_free(&Queue);
+
+    // top-k keeps the 100 smallest
+    top_k Best = {0};
+    int* All = (int*)malloc(sizeof(int) * 100000);
+    for (int i = 0; i < 100000; i++)
+    {
+        All[i] = (int)(TestRandom() % 1000000);
+        top_k_push_bounded(&Best, All[i], 100, NULL);
+    }
+    assert(top_k_count(&Best) == 100);
+    qsort(All, 100000, sizeof(int), CompareInts);
+    int Kept[100];
+    for (int i = 99; i >= 0; i--)
+        assert(top_k_pop(&Best, &Kept[i]));
+    assert(memcmp(Kept, All, sizeof(Kept)) == 0);
+    int Evicted;
+    assert(top_k_push_bounded(&Best, 1, 0, &Evicted) == -1 && Evicted == -1);
+    top_k_free(&Best);
+    free(All);
+
+    CheckEviction();
+
+    printf("Passed\n");
+    return 0;
+}
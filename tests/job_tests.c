@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#include "sl_job.h"
+
+static void Square(void* Array, int Begin, int End, void* UserData)
+{
+    double* Values = (double*)Array;
+    for (int i = Begin; i < End; i++)
+        Values[i] = Values[i] * Values[i];
+}
+
+static void Sum(void* Array, int Begin, int End, void* Partial, void* UserData)
+{
+    double* Values = (double*)Array;
+    double* Total = (double*)Partial;
+    for (int i = Begin; i < End; i++)
+        *Total += Values[i];
+}
+
+static void AddDouble(void* Into, const void* From, void* UserData)
+{
+    *(double*)Into += *(const double*)From;
+}
+
+static void Touch(void* Array, int Begin, int End, void* UserData)
+{
+    int* Hits = (int*)Array;
+    for (int i = Begin; i < End; i++)
+        Hits[i]++;
+    assert(End - Begin <= *(int*)UserData);
+}
+
+static volatile int Stage;
+static int Order[3];
+
+static void First(void* Data)
+{
+    for (volatile int i = 0; i < 1000000; i++) {}
+    Order[0] = __atomic_add_fetch(&Stage, 1, __ATOMIC_SEQ_CST);
+}
+
+static void Second(void* Data)
+{
+    Order[(size_t)Data] = __atomic_add_fetch(&Stage, 1, __ATOMIC_SEQ_CST);
+}
+
+// parallel_for from inside a job, the waits have to help rather than block
+static void Nested(void* Data)
+{
+    int* Hits = (int*)Data;
+    int Chunk = 7;
+    sl_parallel_for_range(Hits, 1000, Chunk, Touch, &Chunk);
+}
+
+static void RunChecks(void)
+{
+    double* Values = NULL;
+    for (int i = 0; i < 100003; i++)
+    {
+        double V = (double)(i % 1000) * 0.001;
+        da_append(Values, V);
+    }
+
+    double Serial = 0;
+    for (int i = 0; i < da_len(Values); i++)
+        Serial += Values[i] * Values[i];
+
+    sl_parallel_for(Values, 1024, Square, NULL);
+
+    // chunked sums fold in chunk order, so they match a serial run of the same
+    // chunks bit for bit whatever the thread count
+    double Chunked = 0;
+    for (int c = 0; c < da_len(Values); c += 1000)
+    {
+        double Partial = 0;
+        for (int i = c; i < da_len(Values) && i < c + 1000; i++)
+            Partial += Values[i];
+        Chunked += Partial;
+    }
+
+    double Total = 0;
+    sl_parallel_reduce(Values, 1000, Sum, AddDouble, &Total, NULL);
+    assert(Total == Chunked);
+    assert(Total > Serial * 0.999999 && Total < Serial * 1.000001);
+    da_delete(Values);
+
+    // every element visited exactly once and no chunk bigger than asked for
+    int Hits[5000];
+    memset(Hits, 0, sizeof(Hits));
+    int Chunk = 3;
+    sl_parallel_for_range(Hits, 5000, Chunk, Touch, &Chunk);
+    for (int i = 0; i < 5000; i++)
+        assert(Hits[i] == 1);
+
+    // nothing to do
+    sl_parallel_for_range(Hits, 0, 16, Touch, &Chunk);
+
+    // dependencies
+    Stage = 0;
+    sl_job_counter FirstDone = {0};
+    sl_job_counter AllDone = {0};
+    sl_job_run(First, NULL, &FirstDone);
+    sl_job_run_after(&FirstDone, Second, (void*)1, &AllDone);
+    sl_job_run_after(&FirstDone, Second, (void*)2, &AllDone);
+    sl_job_wait(&AllDone);
+    assert(Order[0] == 1);
+    assert(Order[1] > 1 && Order[2] > 1);
+    assert(AllDone.Value == 0 && FirstDone.Value == 0);
+
+    int NestedHits[4][1000];
+    memset(NestedHits, 0, sizeof(NestedHits));
+    sl_job_counter NestedDone = {0};
+    for (int i = 0; i < 4; i++)
+        sl_job_run(Nested, NestedHits[i], &NestedDone);
+    sl_job_wait(&NestedDone);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 1000; j++)
+            assert(NestedHits[i][j] == 1);
+}
+
+int main(int argc, char** argv) {
+
+    // everything runs inline before the pool exists
+    assert(sl_job_thread_count() == 1);
+    RunChecks();
+
+    sl_job_init(8);
+    assert(sl_job_thread_count() == 8);
+    assert(sl_job_thread_index() == 0);
+    RunChecks();
+    sl_job_shutdown();
+
+    sl_job_init(0);
+    RunChecks();
+    sl_job_shutdown();
+    assert(sl_job_thread_count() == 1);
+
+    printf("Passed\n");
+    return 0;
+}
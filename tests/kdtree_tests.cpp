@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#define SL_KDTREE_IMPL
+#include "sl_kdtree.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+static real32 DistSq(vec3f A, vec3f B)
+{
+    real32 X = A.X - B.X, Y = A.Y - B.Y, Z = A.Z - B.Z;
+    return X*X + Y*Y + Z*Z;
+}
+
+static int CountBruteRadius(vec3f* Points, vec3f P, real32 Radius)
+{
+    int Result = 0;
+    for (int i = 0; i < da_len(Points); i++)
+        if (DistSq(Points[i], P) <= Radius * Radius)
+            Result++;
+    return Result;
+}
+
+// what the depth first build appends, the slow way
+static int BruteNodeCount(int N)
+{
+    if (N <= SL_KDTREE_LEAF_SIZE)
+        return 1;
+    return 1 + BruteNodeCount(N / 2) + BruteNodeCount(N - N / 2);
+}
+
+static void CheckQueries(sl_kdtree* Tree, vec3f* Points)
+{
+    for (int q = 0; q < 50; q++)
+    {
+        vec3f P = Vec3f(RandomReal32(-110, 110), RandomReal32(-110, 110), RandomReal32(-110, 110));
+
+        // nearest against brute force
+        int Best = 0;
+        for (int i = 1; i < da_len(Points); i++)
+            if (DistSq(Points[i], P) < DistSq(Points[Best], P))
+                Best = i;
+
+        real32 D;
+        int Nearest = sl_kdtree_nearest(Tree, P, &D);
+        assert(DistSq(Points[Nearest], P) == DistSq(Points[Best], P));
+        assert(D == DistSq(Points[Best], P));
+
+        // knn comes back sorted and nothing closer was skipped
+        int Index[8];
+        real32 Dist[8];
+        int Found = sl_kdtree_knn(Tree, P, 8, Index, Dist);
+        assert(Found == 8);
+        assert(Dist[0] == DistSq(Points[Best], P));
+        for (int i = 1; i < 8; i++)
+            assert(Dist[i - 1] <= Dist[i]);
+        int Closer = 0;
+        for (int i = 0; i < da_len(Points); i++)
+            if (DistSq(Points[i], P) < Dist[7])
+                Closer++;
+        assert(Closer <= 7);
+
+        // radius
+        int* Hits = NULL;
+        sl_kdtree_radius(Tree, P, 25.f, &Hits);
+        assert(da_len(Hits) == CountBruteRadius(Points, P, 25.f));
+        for (int i = 0; i < da_len(Hits); i++)
+            assert(DistSq(Points[Hits[i]], P) <= 25.f * 25.f);
+        da_delete(Hits);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    srand(1234);
+
+    sl_kdtree Empty = sl_kdtree_build(NULL);
+    assert(sl_kdtree_nearest(&Empty, Vec3f(0, 0, 0), NULL) == -1);
+
+    vec3f* Points = NULL;
+    for (int i = 0; i < 5000; i++)
+    {
+        vec3f P = Vec3f(RandomReal32(-100, 100), RandomReal32(-100, 100), RandomReal32(-100, 100));
+        da_append(Points, P);
+    }
+    // duplicates shouldn't upset the median split
+    for (int i = 0; i < 100; i++)
+    {
+        vec3f P = Vec3f(1, 2, 3);
+        da_append(Points, P);
+    }
+
+    sl_kdtree Tree = sl_kdtree_build(Points);
+    assert(da_len(Tree.Points) == da_len(Points));
+    CheckQueries(&Tree, Points);
+
+    // box
+    int* Hits = NULL;
+    sl_kdtree_box(&Tree, Vec3f(-10, -20, -30), Vec3f(10, 20, 30), &Hits);
+    int Expected = 0;
+    for (int i = 0; i < da_len(Points); i++)
+    {
+        vec3f P = Points[i];
+        if (P.X >= -10 && P.X <= 10 && P.Y >= -20 && P.Y <= 20 && P.Z >= -30 && P.Z <= 30)
+            Expected++;
+    }
+    assert(da_len(Hits) == Expected);
+    da_delete(Hits);
+
+    // batch matches single queries, and pads when there aren't K points
+    vec3f Queries[3] = { Vec3f(0, 0, 0), Vec3f(50, 50, 50), Vec3f(-99, 0, 99) };
+    int BatchIndex[3 * 4];
+    sl_kdtree_knn_batch(&Tree, Queries, 3, 4, BatchIndex, NULL);
+    for (int q = 0; q < 3; q++)
+    {
+        int Single[4];
+        sl_kdtree_knn(&Tree, Queries[q], 4, Single, NULL);
+        for (int i = 0; i < 4; i++)
+            assert(DistSq(Points[Single[i]], Queries[q]) == DistSq(Points[BatchIndex[q * 4 + i]], Queries[q]));
+    }
+
+    // move everything and refit, queries still have to be exact
+    for (int i = 0; i < da_len(Points); i++)
+    {
+        Points[i].X += RandomReal32(-5, 5);
+        Points[i].Y *= 1.05f;
+        Points[i].Z -= 3.f;
+    }
+    sl_kdtree_refit(&Tree, Points);
+    CheckQueries(&Tree, Points);
+
+    sl_kdtree_free(&Tree);
+    da_delete(Points);
+
+    vec3f* Few = NULL;
+    da_append(Few, Vec3f(1, 1, 1));
+    da_append(Few, Vec3f(2, 2, 2));
+    sl_kdtree Small = sl_kdtree_build(Few);
+    sl_kdtree_knn_batch(&Small, Queries, 1, 4, BatchIndex, NULL);
+    assert(BatchIndex[0] == 0 && BatchIndex[1] == 1 && BatchIndex[2] == -1 && BatchIndex[3] == -1);
+    sl_kdtree_free(&Small);
+    da_delete(Few);
+
+    // the node layout is worked out up front from the counts alone
+    for (int N = 1; N < 3000; N++)
+        assert(sl_kd_node_count(N) == BruteNodeCount(N));
+    assert(sl_kd_node_count(1000003) == BruteNodeCount(1000003));
+
+    // a parallel build is the same tree as a serial one, node for node
+    vec3f* Many = NULL;
+    for (int i = 0; i < 300001; i++)
+    {
+        vec3f P = Vec3f(RandomReal32(-100, 100), RandomReal32(-10, 10), RandomReal32(-1000, 1000));
+        da_append(Many, P);
+    }
+    sl_kdtree Serial = sl_kdtree_build(Many);
+    sl_job_init(4);
+    sl_kdtree Parallel = sl_kdtree_build(Many);
+    sl_job_shutdown();
+    assert(da_len(Parallel.Nodes) == da_len(Serial.Nodes) && da_len(Serial.Nodes) == BruteNodeCount(300001));
+    assert(memcmp(Parallel.Nodes, Serial.Nodes, sizeof(sl_kd_node) * da_len(Serial.Nodes)) == 0);
+    assert(memcmp(Parallel.Points, Serial.Points, sizeof(vec3f) * da_len(Many)) == 0);
+    assert(memcmp(Parallel.Index, Serial.Index, sizeof(int) * da_len(Many)) == 0);
+    CheckQueries(&Parallel, Many);
+    sl_kdtree_free(&Serial);
+    sl_kdtree_free(&Parallel);
+    da_delete(Many);
+
+    printf("Passed\n");
+    return 0;
+}
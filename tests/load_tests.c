@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// small chunks so the tests cover plenty of them
+#define SL_LOAD_CHUNK_SIZE 4096
+
+#define DYN_ARRAY_IMPL
+#define SL_CPU_IMPL
+#define SL_PARSE_IMPL
+#define SL_JOB_IMPL
+#define SL_LOAD_IMPL
+#include "sl_load.h"
+
+typedef struct point { float X, Y, Z; } point;
+
+static const char* Path = "sl_load_tests.txt";
+
+static char* MakeText(int Count, size_t* Length)
+{
+    char* Text = (char*)malloc((size_t)Count * 64 + 1);
+    size_t At = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        if (i % 1500 == 0)
+            At += sprintf(Text + At, "# block %d\n", i / 1500);
+        if (i % 3 == 0)
+            At += sprintf(Text + At, "{ %d.25, %d.5, -%d }\n", i, i + 1, i);
+        else if (i % 3 == 1)
+            At += sprintf(Text + At, "%d.25 %d.5 -%d", i, i + 1, i);
+        else
+            At += sprintf(Text + At, " { %d.25, %d.5, -%d }\n", i, i + 1, i);
+    }
+    *Length = At;
+    return Text;
+}
+
+// braced tuples over several lines, Shift moves them across the chunk cuts
+static const char MultiLineBlock[] = "{\n 16,\n 17,\n 18\n}\n# {\n1 2 3\n";
+
+static char* MakeMultiLineText(int Shift, int Blocks, size_t* Length)
+{
+    char* Text = (char*)malloc((size_t)Shift + (size_t)Blocks * sizeof(MultiLineBlock) + 1);
+    memset(Text, ' ', (size_t)Shift);
+    size_t At = (size_t)Shift;
+    for (int i = 0; i < Blocks; i++)
+        At += sprintf(Text + At, "%s", MultiLineBlock);
+    *Length = At;
+    return Text;
+}
+
+static void CheckSameAsSerial(const char* Text, size_t Length, int ExpectedResult)
+{
+    point* Serial = NULL;
+    sl_parse_error SerialError;
+    int SerialResult = sl_parse_tuples_da(Text, Length, 3, Serial, &SerialError);
+
+    point* Loaded = NULL;
+    sl_parse_error Error;
+    int Result = sl_load_tuples_da(Text, Length, 3, Loaded, &Error);
+
+    assert(SerialResult == ExpectedResult && Result == SerialResult);
+    assert(da_len(Loaded) == da_len(Serial));
+    assert(memcmp(Loaded, Serial, sizeof(point) * da_len(Serial)) == 0);
+    if (Result)
+    {
+        assert(Error.Offset == SerialError.Offset);
+        assert(Error.Line == SerialError.Line && Error.Column == SerialError.Column);
+        assert(strcmp(Error.Message, SerialError.Message) == 0);
+    }
+
+    da_delete(Serial);
+    da_delete(Loaded);
+}
+
+int main(int argc, char** argv) {
+
+    size_t Length;
+    char* Text = MakeText(20000, &Length);
+    assert(Length > 40 * SL_LOAD_CHUNK_SIZE);
+
+    // inline before the pool exists
+    CheckSameAsSerial(Text, Length, 0);
+
+    sl_job_init(4);
+
+    CheckSameAsSerial(Text, Length, 0);
+    CheckSameAsSerial(Text, SL_LOAD_CHUNK_SIZE / 2, -1);
+
+    // appends after what's there already
+    point* Points = NULL;
+    point First = { 1, 2, 3 };
+    da_append(Points, First);
+    assert(sl_load_tuples_da(Text, Length, 3, Points, NULL) == 0);
+    assert(da_len(Points) == 20001);
+    assert(Points[0].X == 1 && Points[1].X == 0.25f && Points[20000].Z == -19999);
+    for (int i = 1; i < 20001; i++)
+        assert(Points[i].X == (float)(i - 1) + 0.25f);
+    da_delete(Points);
+
+    // an error deep in the file is reported against the whole file, and the
+    // tuples before it are kept
+    char* Bad = strstr(Text, "{ 15000.25");
+    assert(Bad);
+    Bad[2] = 'x';
+    CheckSameAsSerial(Text, Length, -1);
+    Bad[2] = '1';
+
+    // tuples over several lines are never cut, wherever the cut falls in them
+    for (int Shift = 0; Shift < (int)sizeof(MultiLineBlock); Shift++)
+    {
+        size_t MultiLength;
+        char* MultiLine = MakeMultiLineText(Shift, 1000, &MultiLength);
+        assert(MultiLength > 4 * SL_LOAD_CHUNK_SIZE);
+        CheckSameAsSerial(MultiLine, MultiLength, 0);
+
+        Points = NULL;
+        assert(sl_load_tuples_da(MultiLine, MultiLength, 3, Points, NULL) == 0);
+        assert(da_len(Points) == 2000);
+        assert(Points[1998].X == 16 && Points[1998].Z == 18 && Points[1999].Z == 3);
+        da_delete(Points);
+        free(MultiLine);
+    }
+
+    // a tuple stretched over more than a chunk of lines leaves nothing for the
+    // cut to go on, the wrong guess has to be caught at the seam
+    size_t LongLength;
+    char* Long = MakeText(2000, &LongLength);
+    char* Stretched = (char*)malloc(2 * LongLength + 4 * SL_LOAD_CHUNK_SIZE);
+    size_t At = (size_t)sprintf(Stretched, "%s{ 1,\n", Long);
+    for (int i = 0; i < 3 * SL_LOAD_CHUNK_SIZE; i++)
+        At += (size_t)sprintf(Stretched + At, i % 2 ? "\n" : " ");
+    At += (size_t)sprintf(Stretched + At, "2, 3 }\n%s", Long);
+    CheckSameAsSerial(Stretched, At, 0);
+    free(Stretched);
+    free(Long);
+
+    // from a file
+    FILE* File = fopen(Path, "wb");
+    fwrite(Text, 1, Length, File);
+    fclose(File);
+    Points = NULL;
+    assert(sl_load_tuples_file_da(Path, 3, Points, NULL) == 0);
+    assert(da_len(Points) == 20000 && Points[19999].Y == 20000.5f);
+    da_delete(Points);
+    Points = NULL;
+
+    // empty and missing files
+    File = fopen(Path, "wb");
+    fclose(File);
+    assert(sl_load_tuples_file_da(Path, 3, Points, NULL) == 0 && Points == NULL);
+    remove(Path);
+
+    sl_parse_error Error;
+    assert(sl_load_tuples_file_da(Path, 3, Points, &Error) == -1);
+    assert(strcmp(Error.Message, "couldn't open the file") == 0);
+
+    sl_job_shutdown();
+    free(Text);
+
+    printf("Passed\n");
+    return 0;
+}
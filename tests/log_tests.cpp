@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <thread>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define SL_LOG_IMPL
+#include "sl_log.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#include "sl_job.h"
+
+// NOTE(scott): reads the file underneath the stream without flushing it, so
+// anything the writer left sitting in stdio doesn't count
+static char* ReadAll(FILE* File)
+{
+    long Size = ftell(File);
+    char* Result = (char*)malloc(Size + 1);
+#if defined(_WIN32)
+    fflush(File);
+    fseek(File, 0, SEEK_SET);
+    size_t Read = fread(Result, 1, Size, File);
+#else
+    ssize_t Read = pread(fileno(File), Result, Size, 0);
+    assert(Read >= 0);
+#endif
+    Result[Read] = 0;
+    return Result;
+}
+
+static int BufferCount()
+{
+    int Result = 0;
+    for (sl_log_buffer* Buffer = sl_log_buffers; Buffer; Buffer = Buffer->Next)
+        Result++;
+    return Result;
+}
+
+static int CountOf(const char* Haystack, const char* Needle)
+{
+    int Result = 0;
+    for (const char* At = strstr(Haystack, Needle); At; At = strstr(At + 1, Needle))
+        Result++;
+    return Result;
+}
+
+static void LogFromThread(int Index)
+{
+    SL_LOG_INFO("thread %d says hi", Index);
+}
+
+static void LogFromJob(void* Data)
+{
+    int Index = (int)(size_t)Data;
+    for (int i = 0; i < 20; i++)
+        SL_LOG_INFO("job %d line %d", Index, i);
+}
+
+int main(int argc, char** argv) {
+
+    FILE* Out = tmpfile();
+    assert(Out);
+
+    sl_log_init(Out);
+
+    char Stack[32];
+    strcpy(Stack, "copied");
+    vec3f Position = Vec3f(1, 2.5f, -3);
+    vec2f Size = Vec2f(640, 480);
+    quat Q = IdentityQuat();
+
+    SL_LOG_INFO("plain");
+    SL_LOG_INFO("ints %d %u %x %5d|%-3d|", -7, 7u, 255, 42, 1);
+    SL_LOG_WARN("reals %.2f %e %g", 3.14159, 1e-3f, 0.5);
+    SL_LOG_ERROR("string %s and %s", "literal", Stack);
+    strcpy(Stack, "overwritten");
+    SL_LOG_INFO("vec %v %.1v %.0v", Position, Size, Q);
+    SL_LOG_INFO("mismatch %f %d", 3, 2.9);
+    SL_LOG_INFO("percent 100%% done %c", 'x');
+    SL_LOG_INFO("missing %d %d", 1);
+
+    sl_log_set_level(SL_LOG_LEVEL_WARN);
+    SL_LOG_INFO("filtered out");
+    SL_LOG_DEBUG("filtered out");
+    sl_log_set_level(SL_LOG_LEVEL_DEBUG);
+    SL_LOG_DEBUG("debug shows");
+
+    sl_log_flush();
+    char* Text = ReadAll(Out);
+    assert(strstr(Text, "INFO  plain\n"));
+    assert(strstr(Text, "ints -7 7 ff    42|1  |\n"));
+    assert(strstr(Text, "WARN  reals 3.14 1.000000e-03 0.5\n"));
+    assert(strstr(Text, "ERROR string literal and copied\n"));
+    assert(strstr(Text, "vec { 1.000000, 2.500000, -3.000000 } { 640.0, 480.0 } { 0, 0, 0, 1 }\n"));
+    assert(strstr(Text, "mismatch 3.000000 2\n"));
+    assert(strstr(Text, "percent 100% done x\n"));
+    assert(strstr(Text, "missing 1 (missing)\n"));
+    assert(strstr(Text, "DEBUG debug shows\n"));
+    assert(!strstr(Text, "filtered out"));
+    assert(Text[0] == '[');
+    free(Text);
+
+    // lots of threads, everything arrives and stays in order per thread
+    fseek(Out, 0, SEEK_SET);
+    sl_job_init(4);
+    sl_job_counter Done = {0};
+    for (int i = 0; i < 8; i++)
+        sl_job_run(LogFromJob, (void*)(size_t)i, &Done);
+    sl_job_wait(&Done);
+    sl_job_shutdown();
+    sl_log_flush();
+
+    Text = ReadAll(Out);
+    assert(sl_log_dropped_count() == 0);
+    for (int i = 0; i < 8; i++)
+    {
+        char Needle[64];
+        snprintf(Needle, sizeof(Needle), "job %d line", i);
+        assert(CountOf(Text, Needle) == 20);
+
+        const char* Previous = Text;
+        for (int Line = 0; Line < 20; Line++)
+        {
+            snprintf(Needle, sizeof(Needle), "job %d line %d\n", i, Line);
+            const char* At = strstr(Text, Needle);
+            assert(At && At >= Previous);
+            Previous = At;
+        }
+    }
+    free(Text);
+
+    // more threads than the writer ever kept track of at once, every buffer
+    // gets drained and flush comes back
+    fseek(Out, 0, SEEK_SET);
+    const int ThreadCount = 300;
+    for (int Batch = 0; Batch < ThreadCount; Batch += 50)
+    {
+        std::thread Threads[50];
+        for (int i = 0; i < 50; i++)
+            Threads[i] = std::thread(LogFromThread, Batch + i);
+        for (int i = 0; i < 50; i++)
+            Threads[i].join();
+    }
+    // the main thread's buffer is one of the oldest, at the far end of the list
+    SL_LOG_INFO("main after threads");
+    sl_log_flush();
+    Text = ReadAll(Out);
+    assert(CountOf(Text, " says hi\n") == ThreadCount);
+    assert(strstr(Text, "main after threads\n"));
+    assert(strstr(Text, "thread 0 says hi\n") && strstr(Text, "thread 299 says hi\n"));
+    free(Text);
+
+    // the exited threads' buffers are gone, the job workers' included, and
+    // only the main thread's is left
+    assert(BufferCount() == 1);
+
+    // a full buffer drops instead of blocking and says so
+    fseek(Out, 0, SEEK_SET);
+    u64 DroppedBefore = sl_log_dropped_count();
+    char Long[SL_LOG_MAX_STRING + 1];
+    memset(Long, 'a', SL_LOG_MAX_STRING);
+    Long[SL_LOG_MAX_STRING] = 0;
+    for (int i = 0; i < 10000; i++)
+        SL_LOG_INFO("%s", Long);
+    sl_log_shutdown();
+    assert(sl_log_dropped_count() > DroppedBefore);
+    Text = ReadAll(Out);
+    assert(strstr(Text, "messages dropped"));
+    free(Text);
+
+    // after shutdown it writes straight to stderr
+    SL_LOG_INFO("direct %v", Size);
+
+    fclose(Out);
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <float.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_CPU_IMPL
+#define SL_PACK_IMPL
+#include "sl_pack.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+static u32 Bits(real32 F)
+{
+    u32 Result;
+    memcpy(&Result, &F, sizeof(Result));
+    return Result;
+}
+
+static void CheckBatchKernels()
+{
+    const int Count = 1003;
+    static real32 Floats[Count];
+    static u16 Halves[Count];
+    static i16 Snorms[Count];
+    static real32 Decoded[Count];
+    for (int i = 0; i < Count; i++)
+        Floats[i] = RandomReal32(-1.5f, 1.5f) * ((i % 5) ? 1.f : 70000.f);
+
+    EncodeHalfArray(Halves, Floats, Count);
+    DecodeHalfArray(Decoded, Halves, Count);
+    for (int i = 0; i < Count; i++)
+    {
+        assert(Halves[i] == Real32ToHalf(Floats[i]));
+        assert(Bits(Decoded[i]) == Bits(HalfToReal32(Halves[i])));
+    }
+
+    EncodeSnorm16Array(Snorms, Floats, Count);
+    DecodeSnorm16Array(Decoded, Snorms, Count);
+    for (int i = 0; i < Count; i++)
+    {
+        assert(Snorms[i] == Real32ToSnorm16(Floats[i]));
+        assert(Decoded[i] == Snorm16ToReal32(Snorms[i]));
+    }
+}
+
+int main(int argc, char** argv) {
+
+    srand(7);
+
+    // every half survives a round trip through float
+    for (u32 h = 0; h < 0x10000; h++)
+    {
+        real32 F = HalfToReal32((u16)h);
+        u16 Back = Real32ToHalf(F);
+        if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff))
+            assert((Back & 0x7e00) == 0x7e00);  // NaN stays NaN, quieted
+        else
+            assert(Back == h);
+    }
+
+    assert(Real32ToHalf(1.f) == 0x3c00);
+    assert(Real32ToHalf(-2.f) == 0xc000);
+    assert(Real32ToHalf(65504.f) == 0x7bff);
+    assert(Real32ToHalf(65520.f) == 0x7c00);        // rounds up to inf
+    assert(Real32ToHalf(1e-8f) == 0x0000);
+    assert(Real32ToHalf(5.9604645e-8f) == 0x0001);  // smallest subnormal
+    assert(Real32ToHalf(1.f + 1.f / 2048.f) == 0x3c00);     // tie, rounds to even
+    assert(Real32ToHalf(1.f + 3.f / 2048.f) == 0x3c02);     // tie, rounds to even
+
+    // batch paths match the scalar ones bit for bit, whichever kernels the
+    // dispatch picks, and with everything but the fallbacks masked off
+    CheckBatchKernels();
+    sl_cpu_override(0);
+    CheckBatchKernels();
+    sl_cpu_override(~0u);
+
+    assert(Real32ToSnorm16(1.f) == 32767 && Real32ToSnorm16(-1.f) == -32767);
+    assert(Snorm16ToReal32(-32768) == -1.f);
+
+    // 10:10:10:2
+    vec4f V = { 0.25f, 0.5f, 1.f, 1.f };
+    vec4f U = UnpackUnorm1010102(PackUnorm1010102(V));
+    assert(fabsf(U.X - V.X) < 1.f / 1023.f && fabsf(U.Y - V.Y) < 1.f / 1023.f);
+    assert(U.Z == 1.f && U.W == 1.f);
+
+    vec4f SV = { -0.75f, 0.1f, -1.f, -1.f };
+    vec4f SU = UnpackSnorm1010102(PackSnorm1010102(SV));
+    assert(fabsf(SU.X - SV.X) < 1.f / 511.f && fabsf(SU.Y - SV.Y) < 1.f / 511.f);
+    assert(SU.Z == -1.f && SU.W == -1.f);
+
+    // octahedral normals
+    const int Count = 1003;
+    vec3f* Normals = NULL;
+    for (int i = 0; i < Count; i++)
+    {
+        vec3f N = Vec3f(RandomReal32(-1, 1), RandomReal32(-1, 1), RandomReal32(-1, 1));
+        real32 Len = sqrtf(N.X*N.X + N.Y*N.Y + N.Z*N.Z);
+        N = Vec3f(N.X / Len, N.Y / Len, N.Z / Len);
+        da_append(Normals, N);
+    }
+    da_append(Normals, Vec3f(0, 0, -1));
+    da_append(Normals, Vec3f(0, 0, 1));
+
+    u32* Oct = sl_normals_to_oct_da(Normals);
+    vec3f* BackNormals = sl_oct_to_normals_da(Oct);
+    assert(da_len(BackNormals) == da_len(Normals));
+    for (int i = 0; i < da_len(Normals); i++)
+    {
+        vec3f A = Normals[i], B = BackNormals[i];
+        assert(A.X*B.X + A.Y*B.Y + A.Z*B.Z > 0.99999f);
+        assert(Oct[i] == EncodeOctNormal(A));
+    }
+
+    // the batch encoder matches on signed zeros and a zero vector too
+    vec3f Odd[8] = { Vec3f(-0.f, 0, -1), Vec3f(0, -0.f, -1), Vec3f(-0.f, -0.f, -1), Vec3f(0, 0, 0),
+                     Vec3f(1, 0, -0.f), Vec3f(-1, 0, 0), Vec3f(0.6f, -0.8f, -0.f), Vec3f(0, 0, -0.f) };
+    u32 OddOct[8];
+    EncodeOctNormalArray(OddOct, Odd, 8);
+    for (int i = 0; i < 8; i++)
+        assert(OddOct[i] == EncodeOctNormal(Odd[i]));
+
+    // half vec3f
+    vec3h* Packed = sl_vec3f_to_half_da(Normals);
+    vec3f* Unpacked = sl_half_to_vec3f_da(Packed);
+    assert(sizeof(vec3h) == 6);
+    for (int i = 0; i < da_len(Normals); i++)
+        assert(fabsf(Unpacked[i].Y - Normals[i].Y) < 1e-3f);
+
+    // quantized positions
+    vec3f* Positions = NULL;
+    for (int i = 0; i < Count; i++)
+    {
+        da_append(Positions, Vec3f(RandomReal32(-500, 500), RandomReal32(0, 10), RandomReal32(1000, 1001)));
+    }
+    vec3f Min, Max;
+    vec3q* Quantized = sl_quantize_positions_da(Positions, &Min, &Max);
+    vec3f* Dequantized = sl_dequantize_positions_da(Quantized, Min, Max);
+    // NOTE: half a step, plus a little for float error in (P - Min) * Scale, which
+    // can round up to 65535 ulps of a step the wrong way, and in Min + Q * Step
+    for (int i = 0; i < Count; i++)
+    {
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            real32 Step = (Max.E[Axis] - Min.E[Axis]) / 65535.f;
+            real32 Slop = 2.f * 65535.f * FLT_EPSILON * Step + 2.f * FLT_EPSILON * fabsf(Positions[i].E[Axis]);
+            assert(fabsf(Dequantized[i].E[Axis] - Positions[i].E[Axis]) <= 0.5f * Step + Slop);
+        }
+    }
+
+    da_delete(Normals); da_delete(Oct); da_delete(BackNormals);
+    da_delete(Packed); da_delete(Unpacked);
+    da_delete(Positions); da_delete(Quantized); da_delete(Dequantized);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_CPU_IMPL
+#define SL_PARSE_IMPL
+#include "sl_parse.h"
+
+typedef struct point { float X, Y, Z; } point;
+typedef struct point4 { float X, Y, Z, W; } point4;
+
+#define TEST_RANDOM_SEED 12345u
+#include "test_random.h"
+
+static void CheckSame(const char* Text)
+{
+    float* Values = NULL;
+    assert(sl_parse_floats(Text, strlen(Text), &Values, NULL) == 0);
+    assert(da_len(Values) == 1);
+    float Expected = (float)strtod(Text, NULL);
+    if (memcmp(&Values[0], &Expected, sizeof(float)) != 0)
+    {
+        printf("%s: got %.9g expected %.9g\n", Text, Values[0], Expected);
+        assert(0);
+    }
+    da_delete(Values);
+}
+
+static void CheckError(const char* Text, int Width, size_t Offset, int Line, int Column)
+{
+    point* Points = NULL;
+    sl_parse_error Error;
+    assert(sl_parse_tuples_da(Text, strlen(Text), Width, Points, &Error) == -1);
+    if (Error.Offset != Offset || Error.Line != Line || Error.Column != Column)
+    {
+        printf("\"%s\": %s at %d (%d:%d)\n", Text, Error.Message, (int)Error.Offset, Error.Line, Error.Column);
+        assert(0);
+    }
+    da_delete(Points);
+}
+
+int main(int argc, char** argv) {
+
+    // values match strtod exactly, short and long digit runs
+    const char* Fixed[] = { "0", "-0", "1", "+1", "-1.5", ".5", "5.", "3.14159265358979323846",
+                            "123456789012345678", "1234567890123456789012345", "0.000001",
+                            "1e10", "1.5E-7", "-2.5e+3", "1e30", "1e-30", "340282346638528859811704183484516925440",
+                            "0.1000000000000000055511151231257827", "00000000000000000000000000001" };
+    for (int i = 0; i < (int)(sizeof(Fixed) / sizeof(Fixed[0])); i++)
+        CheckSame(Fixed[i]);
+
+    // numbers longer than the stack copy handed to strtod
+    char Long[1200];
+    strcpy(Long, "0.");
+    for (int i = 0; i < 300; i++)
+        strcat(Long, "0");
+    strcat(Long, "12345678901234567890e300");
+    CheckSame(Long);
+    memset(Long, 0, sizeof(Long));
+    for (int i = 0; i < 1000; i++)
+        Long[i] = (char)('1' + i % 9);
+    strcat(Long, "e-980");
+    CheckSame(Long);
+    Long[0] = '-';
+    CheckSame(Long);
+
+    char Buffer[64];
+    for (int i = 0; i < 20000; i++)
+    {
+        switch (i % 4)
+        {
+            case 0: sprintf(Buffer, "%.6f", (double)(int)TestRandom() / 1000.0); break;
+            case 1: sprintf(Buffer, "%u.%u", TestRandom(), TestRandom()); break;
+            case 2: sprintf(Buffer, "%.9g", (double)TestRandom() * 1e-12); break;
+            case 3: sprintf(Buffer, "-%u%u", TestRandom() % 1000, TestRandom()); break;
+        }
+        CheckSame(Buffer);
+    }
+
+    // tuples, braced or not, mixed separators and comments
+    const char* Text =
+        "# header comment\n"
+        "{ 1, 2, 3 }\n"
+        "4,5,6\r\n"
+        "  7 8 9   \n"
+        "{10,11,12}{13, 14, 15}\n"
+        "; another comment\n"
+        "{\n  16,\n  17,\n  18\n}\n"
+        "\n";
+
+    point* Points = NULL;
+    sl_parse_error Error;
+    assert(sl_parse_tuples_da(Text, strlen(Text), 3, Points, &Error) == 0);
+    assert(da_len(Points) == 6);
+    for (int i = 0; i < 6; i++)
+        assert(Points[i].X == 3 * i + 1 && Points[i].Y == 3 * i + 2 && Points[i].Z == 3 * i + 3);
+
+    // appends to what's already there
+    assert(sl_parse_tuples_da("19 20 21", 8, 3, Points, NULL) == 0);
+    assert(da_len(Points) == 7 && Points[6].Z == 21);
+    da_delete(Points);
+
+    // wider elements get the rest zeroed
+    point4* Wide = NULL;
+    assert(sl_parse_tuples_da("{ 1, 2, 3 }\n", 12, 3, Wide, NULL) == 0);
+    assert(da_len(Wide) == 1 && Wide[0].Z == 3 && Wide[0].W == 0);
+    da_delete(Wide);
+
+    // SoA
+    float* Columns[3] = { NULL, NULL, NULL };
+    assert(sl_parse_tuples_soa(Text, strlen(Text), 3, Columns, NULL) == 0);
+    for (int c = 0; c < 3; c++)
+    {
+        assert(da_len(Columns[c]) == 6);
+        for (int i = 0; i < 6; i++)
+            assert(Columns[c][i] == 3 * i + c + 1);
+        da_delete(Columns[c]);
+    }
+
+    // floats ignore the grouping
+    float* Values = NULL;
+    assert(sl_parse_floats(Text, strlen(Text), &Values, NULL) == 0);
+    assert(da_len(Values) == 18 && Values[17] == 18);
+    da_delete(Values);
+
+    // only the length given is looked at
+    Values = NULL;
+    assert(sl_parse_floats("1 2 3", 3, &Values, NULL) == 0);
+    assert(da_len(Values) == 2);
+    da_delete(Values);
+
+    // errors point at the offending byte
+    CheckError("1 2 3\n4 5\n", 3, 9, 2, 4);
+    CheckError("1 2 3\n4 5 x\n", 3, 10, 2, 5);
+    CheckError("{ 1, 2 }", 3, 7, 1, 8);
+    CheckError("{ 1, 2, 3, 4 }", 3, 11, 1, 12);
+    CheckError("1 2 3 }", 3, 6, 1, 7);
+    CheckError("{ 1, 2, 3 \n", 3, 0, 1, 1);
+    CheckError("{ 1, { 2, 3 }", 3, 5, 1, 6);
+    CheckError("1.5.2 2 3", 3, 0, 1, 1);
+    CheckError("1 2 3e", 3, 4, 1, 5);
+    CheckError("1 2", 3, 0, 1, 1);
+
+    // what parsed before the error is kept
+    Points = NULL;
+    assert(sl_parse_tuples_da("1 2 3\n4 5 6\n7 8\n", 16, 3, Points, &Error) == -1);
+    assert(da_len(Points) == 2 && strcmp(Error.Message, "line ended in the middle of a tuple") == 0);
+    da_delete(Points);
+
+    // a big generated file agrees with strtod value by value
+    size_t Capacity = 1 << 20, Length = 0;
+    char* Big = (char*)malloc(Capacity);
+    float* Expected = NULL;
+    for (int i = 0; i < 10000; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            sprintf(Buffer, "%.6f", ((double)TestRandom() - 2147483648.0) / 4096.0);
+            float V = (float)strtod(Buffer, NULL);
+            da_append(Expected, V);
+            Length += sprintf(Big + Length, c == 0 ? "{ %s" : ", %s", Buffer);
+        }
+        Length += sprintf(Big + Length, " }\n");
+    }
+    Points = NULL;
+    assert(sl_parse_tuples_da(Big, Length, 3, Points, NULL) == 0);
+    assert(da_len(Points) == 10000);
+    assert(memcmp(Points, Expected, sizeof(float) * 30000) == 0);
+    da_delete(Points);
+
+    // and so does the scalar fallback
+    sl_cpu_override(0);
+    Points = NULL;
+    assert(sl_parse_tuples_da(Big, Length, 3, Points, NULL) == 0);
+    assert(memcmp(Points, Expected, sizeof(float) * 30000) == 0);
+    sl_cpu_override(~0u);
+    da_delete(Points);
+    da_delete(Expected);
+    free(Big);
+
+    printf("Passed\n");
+    return 0;
+}
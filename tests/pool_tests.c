@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define SL_POOL_DEBUG
+#define SL_POOL_IMPL
+#include "sl_pool.h"
+
+// everything dyn_array (and the job system) allocates comes from the pool
+#define da_alloc(Size) sl_pool_alloc(Size)
+#define da_realloc(Ptr, Size) sl_pool_realloc(Ptr, Size)
+#define da_free(Ptr) sl_pool_free(Ptr)
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#include "sl_job.h"
+
+typedef struct node
+{
+    struct node* Next;
+    int Value;
+    char Name[20];
+} node;
+
+static void Churn(void* Array, int Begin, int End, void* UserData)
+{
+    for (int Round = Begin; Round < End; Round++)
+    {
+        void* Live[256];
+        for (int i = 0; i < 256; i++)
+        {
+            size_t Size = (size_t)((i * 37 + Round * 11) % 300) + 1;
+            Live[i] = sl_pool_alloc(Size);
+            memset(Live[i], Round & 0x7f, Size);
+        }
+        for (int i = 0; i < 256; i += 2)
+            sl_pool_free(Live[i]);
+        for (int i = 1; i < 256; i += 2)
+        {
+            size_t Size = (size_t)((i * 37 + Round * 11) % 300) + 1;
+            for (size_t b = 0; b < Size; b++)
+                assert(((unsigned char*)Live[i])[b] == (Round & 0x7f));
+            sl_pool_free(Live[i]);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+
+    // every size lands in a class that fits it, and the classes are 16 aligned
+    for (size_t Size = 0; Size <= SL_POOL_MAX_SMALL; Size += (Size < 512 ? 1 : 7))
+    {
+        void* P = sl_pool_alloc(Size);
+        assert(P && ((size_t)P & 15) == 0);
+        size_t Usable = sl_pool_usable_size(P);
+        assert(Usable >= Size && (Size < 128 || Usable <= Size + Size / 4 + 16));
+        memset(P, 0x5a, Size);
+        sl_pool_free(P);
+    }
+
+    // freed objects are reused straight away
+    node* A = sl_pool_new(node);
+    sl_pool_free(A);
+    node* B = sl_pool_new(node);
+    assert(A == B);
+
+    // fresh memory is poisoned in debug builds
+    unsigned char* Fresh = (unsigned char*)sl_pool_alloc(40);
+    assert(Fresh[0] == 0xcd && Fresh[39] == 0xcd);
+    sl_pool_free(Fresh);
+    sl_pool_free(B);
+
+    // a linked list built and torn down through the pool
+    node* List = NULL;
+    for (int i = 0; i < 100000; i++)
+    {
+        node* Node = sl_pool_new(node);
+        Node->Value = i;
+        Node->Next = List;
+        List = Node;
+    }
+    size_t Reserved = sl_pool_reserved_bytes();
+    int Expected = 99999;
+    while (List)
+    {
+        node* Next = List->Next;
+        assert(List->Value == Expected--);
+        sl_pool_free(List);
+        List = Next;
+    }
+
+    // and again, with no new slabs needed
+    for (int i = 0; i < 100000; i++)
+    {
+        node* Node = sl_pool_new(node);
+        Node->Next = List;
+        List = Node;
+    }
+    assert(sl_pool_reserved_bytes() == Reserved);
+    while (List)
+    {
+        node* Next = List->Next;
+        sl_pool_free(List);
+        List = Next;
+    }
+
+    // big blocks go to the system and come back
+    char* Big = (char*)sl_pool_alloc(100000);
+    assert(sl_pool_usable_size(Big) == 100000);
+    Big[99999] = 1;
+    assert(sl_pool_reserved_bytes() >= Reserved + 100000);
+    sl_pool_free(Big);
+    assert(sl_pool_reserved_bytes() == Reserved);
+
+    // realloc keeps the contents through small and big sizes
+    char* Grow = (char*)sl_pool_realloc(NULL, 10);
+    for (int i = 0; i < 10; i++)
+        Grow[i] = (char)i;
+    for (size_t Size = 20; Size < 200000; Size *= 2)
+    {
+        Grow = (char*)sl_pool_realloc(Grow, Size);
+        for (int i = 0; i < 10; i++)
+            assert(Grow[i] == (char)i);
+    }
+    Grow = (char*)sl_pool_realloc(Grow, 12);
+    assert(sl_pool_usable_size(Grow) == 16 && Grow[9] == 9);
+    sl_pool_free(Grow);
+    sl_pool_free(NULL);
+
+    // dyn_arrays on the pool
+    int* Values = NULL;
+    for (int i = 0; i < 50000; i++)
+    {
+        da_append(Values, i);
+    }
+    for (int i = 0; i < 50000; i++)
+        assert(Values[i] == i);
+    da_delete(Values);
+
+    // several threads churning, objects freed by threads that didn't allocate them
+    sl_job_init(4);
+    sl_parallel_for_range(NULL, 400, 8, Churn, NULL);
+    sl_job_shutdown();
+    sl_pool_thread_flush();
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#ifndef SL_PROFILE
+#define SL_PROFILE
+#endif
+#ifndef SL_PROFILE_IMPL
+#define SL_PROFILE_IMPL
+#endif
+#define SL_PROFILE_MAX_EVENTS 4096
+#include "sl_profile.h"
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#include "sl_job.h"
+
+static void Inner()
+{
+    SL_PROFILE_ZONE("Inner");
+    for (volatile int i = 0; i < 10000; i++) {}
+}
+
+static void Outer()
+{
+    SL_PROFILE_ZONE("Outer \"quoted\"");
+    Inner();
+    for (volatile int i = 0; i < 10000; i++) {}
+}
+
+static void Work(void* Data)
+{
+    SL_PROFILE_ZONE("Work");
+    for (volatile int i = 0; i < 100000; i++) {}
+}
+
+// the main thread runs jobs too while it waits, keep its name
+static void NameThread(void* Data)
+{
+    if (sl_job_thread_index() > 0)
+        sl_profile_set_thread_name("worker");
+}
+
+static void IniHandler(char* Section, char* Param, char* Value, void* UserData)
+{
+}
+
+static char* ReadAll(const char* Path)
+{
+    FILE* File = fopen(Path, "rb");
+    assert(File);
+    fseek(File, 0, SEEK_END);
+    long Size = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    char* Result = (char*)malloc(Size + 1);
+    size_t Read = fread(Result, 1, Size, File);
+    Result[Read] = 0;
+    fclose(File);
+    return Result;
+}
+
+static int CountOf(const char* Haystack, const char* Needle)
+{
+    int Result = 0;
+    for (const char* At = strstr(Haystack, Needle); At; At = strstr(At + 1, Needle))
+        Result++;
+    return Result;
+}
+
+// ts and dur of the first event with this name
+static void FindEvent(const char* Json, const char* Name, double* Ts, double* Dur)
+{
+    const char* At = strstr(Json, Name);
+    assert(At);
+    At = strstr(At, "\"ts\":");
+    assert(At && sscanf(At, "\"ts\":%lf,\"dur\":%lf", Ts, Dur) == 2);
+}
+
+int main(int argc, char** argv) {
+
+    sl_profile_set_thread_name("main");
+    Outer();
+
+    // the library's own zones
+    FILE* File = fopen("sl_profile_test.ini", "wb");
+    fputs("[a]\nb = 1\n", File);
+    fclose(File);
+    ParseIniFile((char*)"sl_profile_test.ini", IniHandler, 0);
+    remove("sl_profile_test.ini");
+
+    int* List = NULL;
+    for (int i = 0; i < 100; i++)
+    {
+        da_append(List, i);
+    }
+    da_delete(List);
+
+    quat Qs[8];
+    for (int i = 0; i < 8; i++)
+        Qs[i] = IdentityQuat();
+    MulQuatArray(Qs, Qs, Qs, 8);
+
+    // zones from other threads land in their own buffers
+    sl_job_init(4);
+    sl_job_counter Done = {0};
+    for (int i = 1; i < 4; i++)
+        sl_job_run(NameThread, NULL, &Done);
+    for (int i = 0; i < 64; i++)
+        sl_job_run(Work, NULL, &Done);
+    sl_job_wait(&Done);
+    sl_job_shutdown();
+
+    int Events = sl_profile_event_count();
+    assert(sl_profile_dropped_count() == 0);
+    assert(sl_profile_write_chrome_json("sl_profile_test.json") == 0);
+
+    char* Json = ReadAll("sl_profile_test.json");
+    assert(strncmp(Json, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 39) == 0);
+    assert(strstr(Json, "]}\n") == Json + strlen(Json) - 3);
+    assert(CountOf(Json, "\"ph\":\"X\"") == Events);
+    assert(CountOf(Json, "\"name\":\"Work\"") == 64);
+    assert(CountOf(Json, "\"name\":\"main\"") == 1);
+    assert(strstr(Json, "\"name\":\"Outer \\\"quoted\\\"\""));
+    assert(strstr(Json, "\"name\":\"ParseIniFile\""));
+    assert(strstr(Json, "\"name\":\"ReadEntireFile\""));
+    assert(strstr(Json, "\"name\":\"_da_resize\""));
+    assert(strstr(Json, "\"name\":\"MulQuatArray\""));
+
+    // inner zone sits inside the outer one
+    double OuterTs, OuterDur, InnerTs, InnerDur;
+    FindEvent(Json, "\"name\":\"Outer", &OuterTs, &OuterDur);
+    FindEvent(Json, "\"name\":\"Inner\"", &InnerTs, &InnerDur);
+    assert(OuterDur > 0 && InnerDur > 0);
+    assert(InnerTs >= OuterTs && InnerTs + InnerDur <= OuterTs + OuterDur + 0.002);
+    free(Json);
+
+    // a full buffer drops new events and keeps the old ones
+    sl_profile_reset();
+    assert(sl_profile_event_count() == 0);
+    for (int i = 0; i < SL_PROFILE_MAX_EVENTS + 10; i++)
+    {
+        SL_PROFILE_ZONE("Spam");
+    }
+    assert(sl_profile_event_count() == SL_PROFILE_MAX_EVENTS);
+    assert(sl_profile_dropped_count() == 10);
+
+    remove("sl_profile_test.json");
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_RANDOM_IMPL
+#include "sl_random.h"
+
+// straight from the reference implementations, one state at a time
+static u64 Xoshiro256(u64* S)
+{
+    u64 Result = ((S[1] * 5) << 7 | (S[1] * 5) >> 57) * 9;
+    u64 T = S[1] << 17;
+    S[2] ^= S[0]; S[3] ^= S[1]; S[1] ^= S[2]; S[0] ^= S[3];
+    S[2] ^= T;
+    S[3] = (S[3] << 45) | (S[3] >> 19);
+    return Result;
+}
+
+static u32 Xoshiro128(u32* S)
+{
+    u32 Sum = S[0] + S[3];
+    u32 Result = ((Sum << 7) | (Sum >> 25)) + S[0];
+    u32 T = S[1] << 9;
+    S[2] ^= S[0]; S[3] ^= S[1]; S[1] ^= S[2]; S[0] ^= S[3];
+    S[2] ^= T;
+    S[3] = (S[3] << 11) | (S[3] >> 21);
+    return Result;
+}
+
+static void Moments(real32* Values, int Count, double* Mean, double* Variance)
+{
+    double Sum = 0, SumSq = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        Sum += Values[i];
+        SumSq += (double)Values[i] * Values[i];
+    }
+    *Mean = Sum / Count;
+    *Variance = SumSq / Count - *Mean * *Mean;
+}
+
+int main(int argc, char** argv) {
+
+    sl_random R;
+    sl_random_seed(&R, 42);
+
+    // the scalar generator and every batch lane follow the reference
+    u64 S[4];
+    memcpy(S, R.S, sizeof(S));
+    for (int i = 0; i < 1000; i++)
+        assert(sl_random_u64(&R) == Xoshiro256(S));
+
+    u32 Lanes[8][4];
+    for (int l = 0; l < 8; l++)
+        for (int w = 0; w < 4; w++)
+            Lanes[l][w] = R.Lanes[w][l];
+    static u32 Batch[1003];
+    sl_random_fill_u32(&R, Batch, 1003);
+    for (int i = 0; i < 1003; i++)
+        assert(Batch[i] == Xoshiro128(Lanes[i % 8]));
+    // the rest of the last group was used up
+    for (int i = 1003; i < 1008; i++)
+        Xoshiro128(Lanes[i % 8]);
+    for (int l = 0; l < 8; l++)
+        for (int w = 0; w < 4; w++)
+            assert(Lanes[l][w] == R.Lanes[w][l]);
+
+    // the lanes don't start in step with each other
+    for (int l = 1; l < 8; l++)
+        assert(memcmp(Lanes[0], Lanes[l], sizeof(Lanes[0])) != 0);
+
+    // uniforms are the top 24 bits of the same lanes
+    static real32 Floats[1000000];
+    for (int l = 0; l < 8; l++)
+        for (int w = 0; w < 4; w++)
+            Lanes[l][w] = R.Lanes[w][l];
+    sl_random_fill_real32(&R, Floats, 99, 0.f, 1.f);
+    for (int i = 0; i < 99; i++)
+        assert(Floats[i] == (real32)(Xoshiro128(Lanes[i % 8]) >> 8) / 16777216.f);
+
+    // same seed, same numbers; other seeds and streams, other numbers
+    sl_random A, B;
+    sl_random_seed(&A, 7);
+    sl_random_seed(&B, 7);
+    assert(memcmp(&A, &B, sizeof(A)) == 0);
+    B = sl_random_stream(7, 0);
+    assert(memcmp(&A, &B, sizeof(A)) == 0);
+    B = sl_random_stream(7, 1);
+    sl_random_jump(&A);
+    assert(memcmp(&A, &B, sizeof(A)) == 0);
+    sl_random Streams[4];
+    for (int s = 0; s < 4; s++)
+        Streams[s] = sl_random_stream(7, s);
+    for (int s = 0; s < 4; s++)
+    {
+        for (int t = s + 1; t < 4; t++)
+        {
+            assert(memcmp(Streams[s].S, Streams[t].S, sizeof(S)) != 0);
+            assert(memcmp(Streams[s].Lanes, Streams[t].Lanes, sizeof(Streams[s].Lanes)) != 0);
+        }
+    }
+    sl_random_seed(&B, 8);
+    assert(sl_random_u64(&A) != sl_random_u64(&B));
+
+    // single values
+    for (int i = 0; i < 100000; i++)
+    {
+        real32 F = sl_random_real32(&R);
+        assert(F >= 0.f && F < 1.f);
+        real64 D = sl_random_real64(&R);
+        assert(D >= 0.0 && D < 1.0);
+        real32 G = sl_random_range(&R, -3.f, 5.f);
+        assert(G >= -3.f && G <= 5.f);
+    }
+    int Buckets[7] = {};
+    for (int i = 0; i < 70000; i++)
+    {
+        u32 Pick = sl_random_below(&R, 7);
+        assert(Pick < 7);
+        Buckets[Pick]++;
+    }
+    for (int b = 0; b < 7; b++)
+        assert(Buckets[b] > 9500 && Buckets[b] < 10500);
+    assert(sl_random_below(&R, 1) == 0);
+    for (int i = 0; i < 1000; i++)
+        assert(sl_random_below(&R, 0x80000001u) < 0x80000001u);
+
+    // big batches have the right shape
+    double Mean, Variance;
+    sl_random_fill_real32(&R, Floats, 1000000, -2.f, 2.f);
+    for (int i = 0; i < 1000000; i++)
+        assert(Floats[i] >= -2.f && Floats[i] <= 2.f);
+    Moments(Floats, 1000000, &Mean, &Variance);
+    assert(fabs(Mean) < 0.01 && fabs(Variance - 16.0 / 12.0) < 0.01);
+
+    for (int Count = 999999; Count <= 1000000; Count++)
+    {
+        sl_random_fill_normal(&R, Floats, Count, 3.f, 2.f);
+        int WithinOne = 0;
+        for (int i = 0; i < Count; i++)
+        {
+            assert(isfinite(Floats[i]));
+            WithinOne += fabsf(Floats[i] - 3.f) < 2.f;
+        }
+        Moments(Floats, Count, &Mean, &Variance);
+        assert(fabs(Mean - 3.0) < 0.01 && fabs(Variance - 4.0) < 0.03);
+        assert(fabs(WithinOne / (double)Count - 0.682689) < 0.003);
+    }
+    for (int i = 0; i < 10000; i++)
+        Floats[i] = sl_random_normal(&R);
+    Moments(Floats, 10000, &Mean, &Variance);
+    assert(fabs(Mean) < 0.05 && fabs(Variance - 1.0) < 0.05);
+
+#ifdef SL_SSE2
+    // the SIMD log and sincos behind the normals, against libm
+    for (int i = 1; i <= 1 << 24; i += 37)
+    {
+        real32 X[4], Out[4];
+        for (int k = 0; k < 4; k++)
+            X[k] = (real32)(i + k) / 16777216.f;
+        _mm_storeu_ps(Out, sl_random_log4(_mm_loadu_ps(X)));
+        for (int k = 0; k < 4; k++)
+            assert(fabsf(Out[k] - logf(X[k])) <= 2e-7f * fmaxf(1.f, fabsf(logf(X[k]))));
+    }
+    for (int i = 0; i < 1 << 20; i += 4)
+    {
+        real32 X[4], Sin[4], Cos[4];
+        for (int k = 0; k < 4; k++)
+            X[k] = (real32)(2.0 * SL_PI) * (real32)(i + k) / (real32)(1 << 20) - (real32)SL_PI;
+        __m128 VS, VC;
+        sl_random_sincos4(_mm_loadu_ps(X), &VS, &VC);
+        _mm_storeu_ps(Sin, VS);
+        _mm_storeu_ps(Cos, VC);
+        for (int k = 0; k < 4; k++)
+            assert(fabsf(Sin[k] - sinf(X[k])) <= 2e-7f && fabsf(Cos[k] - cosf(X[k])) <= 2e-7f);
+    }
+#endif
+
+    // dyn_array helpers append, and land where they should
+    vec3f* Points = NULL;
+    da_append(Points, Vec3f(9, 9, 9));
+    sl_random_vec3f_box_da(&R, &Points, 10001, Vec3f(-1, 0, 10), Vec3f(1, 2, 20));
+    assert(da_len(Points) == 10002 && Points[0].X == 9.f);
+    for (int i = 1; i < da_len(Points); i++)
+    {
+        assert(Points[i].X >= -1 && Points[i].X <= 1);
+        assert(Points[i].Y >= 0 && Points[i].Y <= 2);
+        assert(Points[i].Z >= 10 && Points[i].Z <= 20);
+    }
+
+    vec2f* Flat = NULL;
+    sl_random_vec2f_box_da(&R, &Flat, 5, Vec2f(3, 3), Vec2f(4, 4));
+    sl_random_vec2f_box_da(&R, &Flat, 3, Vec2f(-4, -4), Vec2f(-3, -3));
+    assert(da_len(Flat) == 8);
+    for (int i = 0; i < 8; i++)
+        assert(i < 5 ? (Flat[i].X >= 3 && Flat[i].Y <= 4) : (Flat[i].X <= -3 && Flat[i].Y >= -4));
+
+    // unit vectors spread evenly: no lean, a third of the mass on each axis
+    vec3f* Directions = NULL;
+    const int DirectionCount = 200003;
+    sl_random_vec3f_sphere_da(&R, &Directions, DirectionCount);
+    assert(da_len(Directions) == DirectionCount);
+    double Sum[3] = {}, SumSq[3] = {};
+    for (int i = 0; i < DirectionCount; i++)
+    {
+        vec3f D = Directions[i];
+        assert(fabsf(D.X * D.X + D.Y * D.Y + D.Z * D.Z - 1.f) < 1e-5f);
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            Sum[Axis] += D.E[Axis];
+            SumSq[Axis] += D.E[Axis] * D.E[Axis];
+        }
+    }
+    for (int Axis = 0; Axis < 3; Axis++)
+        assert(fabs(Sum[Axis] / DirectionCount) < 0.01 && fabs(SumSq[Axis] / DirectionCount - 1.0 / 3.0) < 0.01);
+
+    // rotations: unit length, and they scatter a fixed vector evenly too
+    quat* Rotations = NULL;
+    sl_random_quat_da(&R, &Rotations, 100001);
+    assert(da_len(Rotations) == 100001);
+    double Spread[3] = {};
+    for (int i = 0; i < da_len(Rotations); i++)
+    {
+        assert(fabsf(NormQuat(Rotations[i]) - 1.f) < 1e-5f);
+        vec3f V = RotateVec3fByQuat(Rotations[i], Vec3f(0, 0, 1));
+        for (int Axis = 0; Axis < 3; Axis++)
+            Spread[Axis] += V.E[Axis];
+    }
+    for (int Axis = 0; Axis < 3; Axis++)
+        assert(fabs(Spread[Axis] / da_len(Rotations)) < 0.01);
+
+    // nothing asked for, nothing appended
+    sl_random_quat_da(&R, &Rotations, 0);
+    assert(da_len(Rotations) == 100001);
+
+    da_delete(Points);
+    da_delete(Flat);
+    da_delete(Directions);
+    da_delete(Rotations);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+
+#define DYN_ARRAY_IMPL
+#define SL_JOB_IMPL
+#define SL_SORT_IMPL
+#include "sl_sort.h"
+
+typedef struct point { float X, Y, Z; int Id; } point;
+
+#define IntLess(A, B) (*(A) < *(B))
+SL_SORT_DEFINE(SortInts, int, IntLess)
+
+#define PointLessZ(A, B) ((A)->Z < (B)->Z)
+SL_SORT_DEFINE(SortPointsByZ, point, PointLessZ)
+
+#define TEST_RANDOM_SEED 987654321u
+#include "test_random.h"
+
+static int CompareInts(const void* A, const void* B)
+{
+    int X = *(const int*)A, Y = *(const int*)B;
+    return (X > Y) - (X < Y);
+}
+
+// fills with one of the patterns that trip up naive quicksorts
+static void Fill(int* Values, int Count, int Pattern)
+{
+    for (int i = 0; i < Count; i++)
+    {
+        switch (Pattern)
+        {
+            case 0: Values[i] = (int)TestRandom(); break;
+            case 1: Values[i] = i; break;
+            case 2: Values[i] = Count - i; break;
+            case 3: Values[i] = 7; break;
+            case 4: Values[i] = (int)(TestRandom() % 4); break;
+            case 5: Values[i] = i < Count / 2 ? i : Count - i; break;   // organ pipe
+            case 6: Values[i] = (i % 2) ? i : -i; break;
+        }
+    }
+}
+
+static void CheckPointsSortedStable(const point* Points, int Count)
+{
+    for (int i = 1; i < Count; i++)
+    {
+        assert(Points[i - 1].Z <= Points[i].Z);
+        if (Points[i - 1].Z == Points[i].Z)
+            assert(Points[i - 1].Id < Points[i].Id);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    int Sizes[] = { 0, 1, 2, 3, 10, 24, 25, 100, 1000, 100000 };
+    int* Values = (int*)malloc(sizeof(int) * 100000);
+    int* Expected = (int*)malloc(sizeof(int) * 100000);
+    int* Source = (int*)malloc(sizeof(int) * 100000);
+
+    for (int s = 0; s < (int)(sizeof(Sizes) / sizeof(Sizes[0])); s++)
+    {
+        int Count = Sizes[s];
+        for (int Pattern = 0; Pattern < 7; Pattern++)
+        {
+            Fill(Source, Count, Pattern);
+            memcpy(Expected, Source, sizeof(int) * Count);
+            qsort(Expected, Count, sizeof(int), CompareInts);
+
+            memcpy(Values, Source, sizeof(int) * Count);
+            SortInts(Values, Count);
+            assert(memcmp(Values, Expected, sizeof(int) * Count) == 0);
+
+            memcpy(Values, Source, sizeof(int) * Count);
+            SortInts_parallel(Values, Count);
+            assert(memcmp(Values, Expected, sizeof(int) * Count) == 0);
+
+            memcpy(Values, Source, sizeof(int) * Count);
+            sl_radix_sort_i32(Values, Count, NULL);
+            assert(memcmp(Values, Expected, sizeof(int) * Count) == 0);
+        }
+    }
+
+    // searching
+    int Sorted[] = { 1, 3, 3, 3, 5, 8 };
+    int Key = 3;
+    assert(SortInts_lower_bound(Sorted, 6, &Key) == 1);
+    assert(SortInts_upper_bound(Sorted, 6, &Key) == 4);
+    assert(SortInts_find(Sorted, 6, &Key) == 1);
+    Key = 4;
+    assert(SortInts_lower_bound(Sorted, 6, &Key) == 4 && SortInts_find(Sorted, 6, &Key) == -1);
+    Key = 0;
+    assert(SortInts_lower_bound(Sorted, 6, &Key) == 0);
+    Key = 9;
+    assert(SortInts_lower_bound(Sorted, 6, &Key) == 6 && SortInts_find(Sorted, 6, &Key) == -1);
+    assert(SortInts_lower_bound(Sorted, 0, &Key) == 0);
+
+    // unsigned and float keys
+    unsigned int* Unsigned = (unsigned int*)Values;
+    for (int i = 0; i < 100000; i++)
+        Unsigned[i] = TestRandom() >> (i % 32);
+    sl_radix_sort_u32(Unsigned, 100000, (unsigned int*)Expected);
+    for (int i = 1; i < 100000; i++)
+        assert(Unsigned[i - 1] <= Unsigned[i]);
+
+    float Floats[] = { 3.5f, -1.f, 0.f, -0.f, 1e30f, -1e30f, 2.f, -2.5f, 1e-30f, -1e-30f };
+    float FloatsSorted[] = { -1e30f, -2.5f, -1.f, -1e-30f, -0.f, 0.f, 1e-30f, 2.f, 3.5f, 1e30f };
+    sl_radix_sort_f32(Floats, 10, NULL);
+    assert(memcmp(Floats, FloatsSorted, sizeof(Floats)) == 0);
+
+    // records by a float member, and both stable sorts keep equal keys in order
+    int PointCount = 100000;
+    point* Points = (point*)malloc(sizeof(point) * PointCount);
+    point* Copy = (point*)malloc(sizeof(point) * PointCount);
+    for (int i = 0; i < PointCount; i++)
+    {
+        Points[i].X = (float)i;
+        Points[i].Y = 0;
+        Points[i].Z = (float)((int)(TestRandom() % 2000) - 1000) * 0.25f;
+        Points[i].Id = i;
+    }
+    memcpy(Copy, Points, sizeof(point) * PointCount);
+
+    sl_radix_sort_by_f32_key(Points, PointCount, sizeof(point), offsetof(point, Z));
+    CheckPointsSortedStable(Points, PointCount);
+    for (int i = 0; i < PointCount; i++)
+        assert(Points[i].X == (float)Points[i].Id);
+
+    memcpy(Points, Copy, sizeof(point) * PointCount);
+    SortPointsByZ_parallel(Points, PointCount);
+    CheckPointsSortedStable(Points, PointCount);
+
+    memcpy(Points, Copy, sizeof(point) * PointCount);
+    SortPointsByZ(Points, PointCount);
+    for (int i = 1; i < PointCount; i++)
+        assert(Points[i - 1].Z <= Points[i].Z);
+
+    // and the parallel sort on a real pool
+    sl_job_init(4);
+    memcpy(Points, Copy, sizeof(point) * PointCount);
+    SortPointsByZ_parallel(Points, PointCount);
+    CheckPointsSortedStable(Points, PointCount);
+
+    Fill(Values, 100000, 0);
+    memcpy(Expected, Values, sizeof(int) * 100000);
+    qsort(Expected, 100000, sizeof(int), CompareInts);
+    SortInts_parallel(Values, 100000);
+    assert(memcmp(Values, Expected, sizeof(int) * 100000) == 0);
+    sl_job_shutdown();
+
+    free(Points);
+    free(Copy);
+    free(Values);
+    free(Expected);
+    free(Source);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -5,6 +5,25 @@
 #define _SL_H_IMPLEMENTATION
 #include "sl.h"
 
+static bool NearlyEqual(real32 A, real32 B)
+{
+   return fabsf(A - B) < 1e-4f;
+}
+
+static int IniCount;
+
+static void CheckIni(char* Section, char* Param, char* Value, void* UserData)
+{
+   char* Seen = CatStringsScratch(CatStringsScratch(Section, (char*)"."), Param);
+   if (IniCount == 0)
+      sl_assert(strcmp(Seen, "window.width") == 0 && strcmp(Value, "1280") == 0);
+   if (IniCount == 1)
+      sl_assert(strcmp(Seen, "window.title") == 0 && strcmp(Value, "sl test") == 0);
+   if (IniCount == 2)
+      sl_assert(strcmp(Seen, "audio.volume") == 0 && strcmp(Value, "0.5") == 0);
+   IniCount++;
+}
+
 int main(int argc, char** argv)
 {
 
@@ -51,6 +70,226 @@ int main(int argc, char** argv)
    sl_assert(W.X == -1.0f);
    sl_assert(W.Y == 1.0f);
 
+   //
+   // Geodesy
+   //
+
+   vec3d Ecef = GeodeticToEcef(Vec3d(0, 0, 0));
+   sl_assert(fabs(Ecef.X - SL_WGS84_A) < 1e-6);
+   sl_assert(fabs(Ecef.Y) < 1e-6 && fabs(Ecef.Z) < 1e-6);
+
+   Ecef = GeodeticToEcef(Vec3d(SL_PI_2, 0, 100.0));
+   sl_assert(fabs(Ecef.Z - (SL_WGS84_B + 100.0)) < 1e-6);
+
+   vec3d Tracks[6] = {
+      Vec3d(DegreesToRadians(38.8977), DegreesToRadians(-77.0365), FeetToMeters(35000.0)),
+      Vec3d(DegreesToRadians(-33.8688), DegreesToRadians(151.2093), 58.0),
+      Vec3d(DegreesToRadians(89.9999), DegreesToRadians(10.0), 0.0),
+      Vec3d(DegreesToRadians(-89.5), DegreesToRadians(-170.0), -50.0),
+      Vec3d(0.0, DegreesToRadians(179.9), 400000.0),
+      Vec3d(DegreesToRadians(45.0), DegreesToRadians(45.0), 12345.678),
+   };
+   vec3d RoundTrip[6];
+   GeodeticToEcefArray(RoundTrip, Tracks, 6);
+   EcefToGeodeticArray(RoundTrip, RoundTrip, 6);
+   for (int i = 0; i < 6; i++)
+   {
+      // ~1e-9 radians is under a centimeter on the ground
+      sl_assert(fabs(RoundTrip[i].Lat - Tracks[i].Lat) < 1e-9);
+      sl_assert(fabs(RoundTrip[i].Lon - Tracks[i].Lon) < 1e-9);
+      sl_assert(fabs(RoundTrip[i].Alt - Tracks[i].Alt) < 1e-3);
+   }
+
+   // the batch versions (2 at a time with their own trig under SL_SSE2) agree
+   // with the single ones to a few ulps, including the inputs they hand back
+   // to libm: huge angles and points near the center of the earth
+   const int GeoCount = 1001;
+   static vec3d Geo[GeoCount], Ecefs[GeoCount], Batch[GeoCount];
+   srand(27);
+   for (int i = 0; i < GeoCount; i++)
+   {
+      real64 U = rand() / (real64)RAND_MAX, W = rand() / (real64)RAND_MAX;
+      Geo[i] = Vec3d((U - 0.5) * SL_PI, (W - 0.5) * 4.0 * SL_PI, -1000.0 + 1e6 * (rand() / (real64)RAND_MAX));
+   }
+   Geo[7].Lon = 3e7;
+   Geo[500].Lat = -SL_PI_2;
+   Geo[501].Lat = SL_PI_2;
+   for (int i = 0; i < GeoCount; i++)
+      Ecefs[i] = GeodeticToEcef(Geo[i]);
+
+   GeodeticToEcefArray(Batch, Geo, GeoCount);
+   for (int i = 0; i < GeoCount; i++)
+   {
+      for (int k = 0; k < 3; k++)
+         sl_assert(fabs(Batch[i].E[k] - Ecefs[i].E[k]) <= 1e-8);
+   }
+   Ecefs[10] = Vec3d(36000.0, -42000.0, 18000.0);
+   Ecefs[600] = Vec3d(0.0, 0.0, 6356752.0);
+
+   EcefToGeodeticArray(Batch, Ecefs, GeoCount);
+   for (int i = 0; i < GeoCount; i++)
+   {
+      vec3d Expected = EcefToGeodetic(Ecefs[i]);
+      sl_assert(fabs(Batch[i].Lat - Expected.Lat) <= 1e-15);
+      sl_assert(fabs(Batch[i].Lon - Expected.Lon) <= 1e-15);
+      sl_assert(fabs(Batch[i].Alt - Expected.Alt) <= 1e-8);
+   }
+   EcefToGeodeticArray(Ecefs, Ecefs, GeoCount);
+   sl_assert(memcmp(Ecefs, Batch, sizeof(Batch)) == 0);
+
+   //
+   // Quat
+   //
+
+   quat Q = QuatFromAxisAngle(Vec3f(0, 0, 1), (real32)SL_PI_2);
+   sl_assert(NearlyEqual(NormQuat(Q), 1.0f));
+
+   vec3f R = RotateVec3fByQuat(Q, Vec3f(1, 0, 0));
+   sl_assert(NearlyEqual(R.X, 0.0f));
+   sl_assert(NearlyEqual(R.Y, 1.0f));
+   sl_assert(NearlyEqual(R.Z, 0.0f));
+
+   quat QQ = Q * Q;
+   R = RotateVec3fByQuat(QQ, Vec3f(1, 0, 0));
+   sl_assert(NearlyEqual(R.X, -1.0f));
+   sl_assert(NearlyEqual(R.Y, 0.0f));
+
+   quat I = MulQuat(Q, InvQuat(Q));
+   sl_assert(NearlyEqual(I.w, 1.0f));
+   sl_assert(NearlyEqual(I.z, 0.0f));
+   sl_assert(NearlyEqual(ConjQuat(Q).z, InvQuat(Q).z));
+
+   quat Z = NozQuat(Quat(0, 0, 0, 0));
+   sl_assert(Z.x == 0.0f && Z.w == 0.0f);
+
+   mat4f M = QuatToMat4f(Q);
+   vec4f P = { 1.f, 0.f, 0.f, 1.f };
+   P = Mul(M, P);
+   sl_assert(NearlyEqual(P.X, 0.0f));
+   sl_assert(NearlyEqual(P.Y, 1.0f));
+
+   // halfway to 90 degrees is 45, well clear of the antipodal case where the
+   // path flips on the sign of a dot product that rounds to zero
+   quat Half = SlerpQuat(IdentityQuat(), Q, 0.5f);
+   quat Eighth = QuatFromAxisAngle(Vec3f(0, 0, 1), (real32)SL_PI_4);
+   sl_assert(NearlyEqual(Half.z, Eighth.z));
+   sl_assert(NearlyEqual(Half.w, Eighth.w));
+
+   // batch kernels must match the scalar versions, including the leftovers
+   // that don't fill a SIMD group
+   quat As[7], Bs[7], Out[7];
+   real32 Ts[7];
+   for (int i = 0; i < 7; i++)
+   {
+      As[i] = QuatFromAxisAngle(Vec3f(1, (real32)i, 2), 0.3f * i);
+      Bs[i] = QuatFromAxisAngle(Vec3f((real32)i, 1, -1), -0.2f * i - 1.0f);
+      Ts[i] = i / 7.0f;
+   }
+
+   MulQuatArray(Out, As, Bs, 7);
+   for (int i = 0; i < 7; i++)
+   {
+      quat Expected = MulQuat(As[i], Bs[i]);
+      sl_assert(NearlyEqual(Out[i].x, Expected.x) && NearlyEqual(Out[i].w, Expected.w));
+   }
+
+   SlerpQuatArray(Out, As, Bs, Ts, 7);
+   for (int i = 0; i < 7; i++)
+   {
+      quat Expected = SlerpQuat(As[i], Bs[i], Ts[i]);
+      sl_assert(NearlyEqual(Out[i].y, Expected.y) && NearlyEqual(Out[i].w, Expected.w));
+   }
+
+   NlerpQuatArray(Out, As, Bs, Ts, 7);
+   for (int i = 0; i < 7; i++)
+   {
+      quat Expected = NlerpQuat(As[i], Bs[i], Ts[i]);
+      sl_assert(NearlyEqual(Out[i].z, Expected.z) && NearlyEqual(Out[i].w, Expected.w));
+   }
+
+   mat4f Matrices[7];
+   QuatToMat4fArray(Matrices, As, 7);
+   for (int i = 0; i < 7; i++)
+   {
+      mat4f Expected = QuatToMat4f(As[i]);
+      for (int e = 0; e < 16; e++)
+         sl_assert(NearlyEqual(Matrices[i].E[e], Expected.E[e]));
+   }
+
+   vec3f Points[7] = { Vec3f(1, 0, 0), Vec3f(0, 1, 0), Vec3f(0, 0, 1), Vec3f(1, 2, 3),
+                       Vec3f(-4, 5, 6), Vec3f(7, -8, 9), Vec3f(-1, -2, -3) };
+   vec3f Rotated[7];
+   RotateVec3fArrayByQuat(Rotated, Points, 7, As[3]);
+   for (int i = 0; i < 7; i++)
+   {
+      vec3f Expected = RotateVec3fByQuat(As[3], Points[i]);
+      sl_assert(NearlyEqual(Rotated[i].X, Expected.X) && NearlyEqual(Rotated[i].Y, Expected.Y) &&
+                NearlyEqual(Rotated[i].Z, Expected.Z));
+   }
+   // in place
+   RotateVec3fArrayByQuat(Points, Points, 7, As[3]);
+   sl_assert(memcmp(Points, Rotated, sizeof(Points)) == 0);
+
+   // scratch memory
+   sl_scratch_mark Outer = sl_scratch_push();
+   char* Joined = CatStringsScratch((char*)"foo", (char*)"bar");
+   sl_assert(strcmp(Joined, "foobar") == 0);
+
+   char* Heap = Vec3fToString(Vec3f(1, 2, 3));
+   sl_assert(strcmp(Heap, Vec3fToStringScratch(Vec3f(1, 2, 3))) == 0);
+   sl_assert(strcmp(Heap, "1.000000, 2.000000, 3.000000") == 0);
+   free(Heap);
+   vec4f V4 = { 1, 2, 3, 4 };
+   Heap = Vec4fToString(V4);
+   sl_assert(strcmp(Heap, Vec4fToStringScratch(V4)) == 0);
+   free(Heap);
+
+   sl_scratch_mark Inner = sl_scratch_push();
+   void* First = sl_scratch_alloc(3);
+   void* Second = sl_scratch_alloc(100);
+   sl_assert(((size_t)First & 15) == 0 && ((size_t)Second & 15) == 0);
+   sl_assert((char*)Second - (char*)First == 16);
+
+   // bigger than a block gets a block of its own
+   char* Big = (char*)sl_scratch_alloc(SL_SCRATCH_BLOCK_SIZE * 2);
+   memset(Big, 0xab, SL_SCRATCH_BLOCK_SIZE * 2);
+   sl_scratch_pop(Inner);
+
+   // popping hands the same memory back
+   sl_assert(sl_scratch_alloc(3) == First);
+   sl_assert(strcmp(Joined, "foobar") == 0);
+   sl_scratch_pop(Outer);
+   sl_assert(CatStringsScratch((char*)"a", (char*)"b") == Joined);
+   sl_scratch_pop(Outer);
+
+   {
+      sl_scratch_scope Scope;
+      sl_assert(strcmp(sl_scratch_printf("%d-%s", 42, "x"), "42-x") == 0);
+      sl_assert(strcmp(Vec2fToStringScratch(Vec2f(0.5f, -1)), "0.500000, -1.000000") == 0);
+   }
+   sl_assert(sl_scratch_alloc(1) == Joined);
+   sl_scratch_pop(Outer);
+
+   // INI, with a trailing newline and one without
+   const char* IniText[2] = {
+      "; settings\n[window]\nwidth = 1280\ntitle=sl test # comment\n\n[audio]\nvolume=0.5\n",
+      "[window]\nwidth = 1280\ntitle=sl test\n[audio]\nvolume = 0.5",
+   };
+   for (int i = 0; i < 2; i++)
+   {
+      FILE* File = fopen("sl_test.ini", "wb");
+      fputs(IniText[i], File);
+      fclose(File);
+
+      IniCount = 0;
+      sl_assert(ParseIniFile((char*)"sl_test.ini", CheckIni, 0) == 0);
+      sl_assert(IniCount == 3);
+   }
+   remove("sl_test.ini");
+   sl_assert(ParseIniFile((char*)"does_not_exist.ini", CheckIni, 0) == -1);
+
+   sl_scratch_release();
+
    printf("Success\n");
    return 0;
 }
\ No newline at end of file
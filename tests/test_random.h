@@ -0,0 +1,24 @@
+#ifndef TEST_RANDOM_H
+#define TEST_RANDOM_H
+
+//
+// Random numbers for the tests
+//
+// xorshift32, so every run sees the same numbers and a failure reproduces.
+// Define TEST_RANDOM_SEED before including this to give a test its own sequence.
+//
+
+#ifndef TEST_RANDOM_SEED
+#define TEST_RANDOM_SEED 1u
+#endif
+
+static unsigned int TestSeed = TEST_RANDOM_SEED;
+static unsigned int TestRandom(void)
+{
+    TestSeed ^= TestSeed << 13;
+    TestSeed ^= TestSeed >> 17;
+    TestSeed ^= TestSeed << 5;
+    return TestSeed;
+}
+
+#endif // TEST_RANDOM_H
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_TRANSFORM_IMPL
+#include "sl_transform.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+static mat4f RandomLocal()
+{
+    mat4f M = MakeRotationMat4f(Vec3f(RandomReal32(-3, 3), RandomReal32(-3, 3), RandomReal32(-3, 3)));
+    return TranslateMat4fByVec3f(M, Vec3f(RandomReal32(-5, 5), RandomReal32(-5, 5), RandomReal32(-5, 5)));
+}
+
+// the world matrix the slow way, straight up the parent handles
+static mat4f ReferenceWorld(sl_transforms* T, sl_transform Node)
+{
+    sl_transform Parent = sl_transform_parent(T, Node);
+    if (Parent == SL_TRANSFORM_NONE)
+        return sl_transform_local(T, Node);
+    return MulMat4f(ReferenceWorld(T, Parent), sl_transform_local(T, Node));
+}
+
+static i32 SubtreeSize(sl_transforms* T, i32 Index)
+{
+    i32 Size = 1;
+    for (i32 c = T->ChildStart[Index]; c < T->ChildStart[Index + 1]; c++)
+        Size += SubtreeSize(T, c);
+    return Size;
+}
+
+// breadth first, parents first, child ranges line up, every world matrix exact
+static void CheckAll(sl_transforms* T, sl_transform* Live)
+{
+    i32 Count = sl_transform_count(T);
+    assert(da_len(Live) == Count);
+    assert(da_len(T->ChildStart) == Count + 1 && T->ChildStart[Count] == Count);
+    i32 Roots = T->ChildStart[0];
+    for (i32 i = 0; i < Count; i++)
+    {
+        assert((T->Parent[i] < 0) == (i < Roots));
+        assert(T->Parent[i] < i);
+        assert(T->ChildStart[i] <= T->ChildStart[i + 1]);
+        for (i32 c = T->ChildStart[i]; c < T->ChildStart[i + 1]; c++)
+            assert(T->Parent[c] == i);
+        assert(T->Index[T->Handle[i]] == i);
+    }
+    for (i32 k = 0; k < Count; k++)
+    {
+        mat4f World = sl_transform_world(T, Live[k]);
+        mat4f Expected = ReferenceWorld(T, Live[k]);
+        // bit exact, with or without FMA
+        assert(memcmp(&World, &Expected, sizeof(mat4f)) == 0);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    srand(3);
+
+    // MulMat4f applies the right hand side first
+    mat4f Move = TranslateMat4fByVec3f(Mat4Identity(), Vec3f(1, 2, 3));
+    mat4f Turn = MakeRotationMat4f(Vec3f(0, 0, (real32)(SL_PI / 2)));
+    vec4f Origin = { 0, 0, 0, 1 };
+    vec4f P = Mul(MulMat4f(Turn, Move), Origin);
+    vec4f Q = Mul(Turn, Mul(Move, Origin));
+    assert(memcmp(&P, &Q, sizeof(vec4f)) == 0);
+    mat4f Same = MulMat4f(Mat4Identity(), Move);
+    assert(memcmp(&Same, &Move, sizeof(mat4f)) == 0);
+    Same = RotateMat4fByVec3f(Move, Vec3f(0, 0, (real32)(SL_PI / 2)));
+    mat4f Expected = MulMat4f(Turn, Move);
+    assert(memcmp(&Same, &Expected, sizeof(mat4f)) == 0);
+
+    // a random forest, added parents first but in no particular shape
+    sl_transforms T = {};
+    sl_transform* Live = NULL;
+    assert(sl_transform_update(&T) == 0);
+    for (i32 i = 0; i < 3000; i++)
+    {
+        sl_transform Parent = (i < 5 || rand() % 50 == 0) ? SL_TRANSFORM_NONE : Live[rand() % da_len(Live)];
+        sl_transform Node = sl_transform_add(&T, Parent, RandomLocal());
+        assert(Node == i);
+        da_append(Live, Node);
+    }
+    assert(sl_transform_update(&T) == 3000);
+    CheckAll(&T, Live);
+    assert(sl_transform_update(&T) == 0);
+
+    // moving a few nodes recomputes their subtrees and nothing else, a dirty
+    // node under another dirty node only counts once
+    for (i32 Round = 0; Round < 50; Round++)
+    {
+        i32 Moves = 1 + rand() % 8;
+        u8* Covered = (u8*)calloc(3000, 1);
+        for (i32 m = 0; m < Moves; m++)
+        {
+            sl_transform Node = Live[rand() % da_len(Live)];
+            sl_transform_set_local(&T, Node, RandomLocal());
+            Covered[T.Index[Node]] = 1;
+        }
+        if (Round % 5 == 0)
+        {
+            // a node and its own child both moving
+            sl_transform Node = Live[rand() % da_len(Live)];
+            i32 i = T.Index[Node];
+            if (T.ChildStart[i] < T.ChildStart[i + 1])
+            {
+                sl_transform_set_local(&T, Node, RandomLocal());
+                sl_transform_set_local(&T, T.Handle[T.ChildStart[i]], RandomLocal());
+                Covered[i] = 1;
+            }
+        }
+        // parents come first, so marking down the order covers every subtree
+        i32 Expected = 0;
+        for (i32 i = 0; i < sl_transform_count(&T); i++)
+        {
+            if (T.Parent[i] >= 0 && Covered[T.Parent[i]])
+                Covered[i] = 1;
+            Expected += Covered[i];
+        }
+        assert(sl_transform_update(&T) == Expected);
+        CheckAll(&T, Live);
+        free(Covered);
+    }
+
+    // a root moving takes its whole tree with it
+    sl_transform Root = T.Handle[0];
+    sl_transform_set_local(&T, Root, RandomLocal());
+    assert(sl_transform_update(&T) == SubtreeSize(&T, 0));
+    CheckAll(&T, Live);
+
+    // reparenting, with the loops refused
+    sl_transform Child = T.Handle[T.ChildStart[0]];
+    assert(!sl_transform_set_parent(&T, Root, Child));
+    assert(!sl_transform_set_parent(&T, Root, Root));
+    for (i32 i = 0; i < 200; i++)
+    {
+        sl_transform Node = Live[rand() % da_len(Live)];
+        sl_transform Parent = rand() % 10 ? Live[rand() % da_len(Live)] : SL_TRANSFORM_NONE;
+        sl_transform_set_parent(&T, Node, Parent);
+        if (i % 40 == 0)
+            sl_transform_set_local(&T, Live[rand() % da_len(Live)], RandomLocal());
+    }
+    sl_transform_update(&T);
+    CheckAll(&T, Live);
+    assert(sl_transform_set_parent(&T, Child, SL_TRANSFORM_NONE));
+    assert(sl_transform_parent(&T, Child) == SL_TRANSFORM_NONE);
+    sl_transform_update(&T);
+    CheckAll(&T, Live);
+
+    // removing takes the subtree, the handles come back for new nodes
+    sl_transform Doomed = T.Handle[T.ChildStart[0]];
+    i32 Gone = SubtreeSize(&T, T.ChildStart[0]);
+    i32 Before = sl_transform_count(&T);
+    sl_transform_remove(&T, Doomed);
+    // nothing moves under it, or under what's below it, on the way out
+    assert(T.ChildStart[1] - T.ChildStart[0] > 1 && Gone > 1);
+    sl_transform Sibling = T.Handle[T.ChildStart[0] + 1];
+    sl_transform Below = T.Handle[T.ChildStart[T.ChildStart[0]]];
+    assert(!sl_transform_set_parent(&T, Sibling, Doomed));
+    assert(!sl_transform_set_parent(&T, Sibling, Below));
+    assert(sl_transform_parent(&T, Sibling) == Root);
+    sl_transform_remove(&T, Doomed);
+    sl_transform_update(&T);
+    assert(sl_transform_count(&T) == Before - Gone);
+    assert(T.Index[Doomed] == -1);
+    assert(da_len(T.FreeHandles) == Gone);
+    for (i32 k = 0; k < da_len(Live); k++)
+    {
+        if (T.Index[Live[k]] < 0)
+        {
+            Live[k] = Live[da_len(Live) - 1];
+            _da_hdr(Live)--;
+            k--;
+        }
+    }
+    CheckAll(&T, Live);
+
+    sl_transform Reused = sl_transform_add(&T, Live[0], RandomLocal());
+    assert(Reused < 3000 && T.Index[Reused] >= 0);
+    da_append(Live, Reused);
+    assert(sl_transform_update(&T) == 1);
+    CheckAll(&T, Live);
+
+    // everything dirty at once is every node once
+    sl_transform_update_all(&T);
+    assert(sl_transform_update(&T) == sl_transform_count(&T));
+    CheckAll(&T, Live);
+
+    // removing everything leaves an empty hierarchy that still works
+    for (i32 k = 0; k < da_len(Live); k++)
+    {
+        if (sl_transform_parent(&T, Live[k]) == SL_TRANSFORM_NONE)
+            sl_transform_remove(&T, Live[k]);
+    }
+    assert(sl_transform_update(&T) == 0);
+    assert(sl_transform_count(&T) == 0);
+    sl_transform Alone = sl_transform_add(&T, SL_TRANSFORM_NONE, Move);
+    assert(sl_transform_update(&T) == 1);
+    mat4f World = sl_transform_world(&T, Alone);
+    assert(memcmp(&World, &Move, sizeof(mat4f)) == 0);
+
+    sl_transforms_free(&T);
+    assert(sl_transform_count(&T) == 0);
+    da_delete(Live);
+
+    printf("Passed\n");
+    return 0;
+}
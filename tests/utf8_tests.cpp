@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define SL_UTF8_CHECK
+#define SL_UTF8_IMPL
+#define SL_CPU_IMPL
+#define DYN_ARRAY_IMPL
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define TEST_RANDOM_SEED 777u
+#include "test_random.h"
+
+static int Encode(unsigned int CodePoint, unsigned char* Out)
+{
+    if (CodePoint < 0x80) { Out[0] = (unsigned char)CodePoint; return 1; }
+    if (CodePoint < 0x800)
+    {
+        Out[0] = (unsigned char)(0xc0 | (CodePoint >> 6));
+        Out[1] = (unsigned char)(0x80 | (CodePoint & 0x3f));
+        return 2;
+    }
+    if (CodePoint < 0x10000)
+    {
+        Out[0] = (unsigned char)(0xe0 | (CodePoint >> 12));
+        Out[1] = (unsigned char)(0x80 | ((CodePoint >> 6) & 0x3f));
+        Out[2] = (unsigned char)(0x80 | (CodePoint & 0x3f));
+        return 3;
+    }
+    Out[0] = (unsigned char)(0xf0 | (CodePoint >> 18));
+    Out[1] = (unsigned char)(0x80 | ((CodePoint >> 12) & 0x3f));
+    Out[2] = (unsigned char)(0x80 | ((CodePoint >> 6) & 0x3f));
+    Out[3] = (unsigned char)(0x80 | (CodePoint & 0x3f));
+    return 4;
+}
+
+static unsigned int RandomCodePoint()
+{
+    switch (TestRandom() % 4)
+    {
+        case 0: return TestRandom() % 0x80;
+        case 1: return 0x80 + TestRandom() % (0x800 - 0x80);
+        case 2:
+        {
+            unsigned int c = 0x800 + TestRandom() % (0x10000 - 0x800);
+            return (c >= 0xd800 && c < 0xe000) ? c - 0x800 : c;
+        }
+        default: return 0x10000 + TestRandom() % (0x110000 - 0x10000);
+    }
+}
+
+// the error offset with everything forced down the scalar path
+static int ValidateScalar(const char* Text, size_t Length, size_t* Offset)
+{
+    sl_cpu_override(0);
+    int Result = sl_utf8_validate(Text, Length, Offset);
+    sl_cpu_override(~0u);
+    return Result;
+}
+
+// every dispatch level agrees with the scalar pass
+static void CheckAllPaths(const char* Text, size_t Length, int Expected, size_t ExpectedOffset)
+{
+    unsigned int Levels[3] = { 0, SL_CPU_SSE2 | SL_CPU_SSSE3, ~0u };
+    for (int i = 0; i < 3; i++)
+    {
+        sl_cpu_override(Levels[i]);
+        size_t Offset = 12345;
+        int Valid = sl_utf8_validate(Text, Length, &Offset);
+        assert(Valid == Expected);
+        if (!Valid)
+            assert(Offset == ExpectedOffset);
+    }
+    sl_cpu_override(~0u);
+}
+
+typedef struct utf8_case
+{
+    const char* Bytes;
+    int Valid;
+    int Offset;     // of the first bad byte within Bytes
+} utf8_case;
+
+static void WriteFile(const char* Path, const char* Text, size_t Length)
+{
+    FILE* File = fopen(Path, "wb");
+    assert(File);
+    fwrite(Text, 1, Length, File);
+    fclose(File);
+}
+
+static int IniValues;
+static void CountIni(char* Section, char* Param, char* Value, void* UserData)
+{
+    IniValues++;
+}
+
+int main(int argc, char** argv) {
+
+    // known good and bad sequences, at every alignment across the block edges
+    utf8_case Cases[] = {
+        { "plain ascii", 1, 0 },
+        { "h\xc3\xa9llo", 1, 0 },
+        { "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", 1, 0 },
+        { "\xf0\x9f\x98\x80", 1, 0 },           // U+1F600
+        { "\xf4\x8f\xbf\xbf", 1, 0 },           // U+10FFFF
+        { "\xed\x9f\xbf\xee\x80\x80", 1, 0 },   // either side of the surrogates
+        { "\xc2\x80\xdf\xbf", 1, 0 },
+        { "ab\x80", 0, 2 },                     // stray continuation
+        { "a\xc0\x80", 0, 1 },                  // overlong NUL
+        { "\xc1\xbf", 0, 0 },
+        { "x\xe0\x80\x80", 0, 1 },              // overlong three byte
+        { "\xe0\x9f\xbf", 0, 0 },
+        { "xy\xed\xa0\x80", 0, 2 },             // surrogate
+        { "\xf0\x8f\xbf\xbf", 0, 0 },           // overlong four byte
+        { "\xf4\x90\x80\x80", 0, 0 },           // past U+10FFFF
+        { "\xf5\x80\x80\x80", 0, 0 },
+        { "ok\xff", 0, 2 },
+        { "\xe6\x97", 0, 0 },                   // cut short at the end
+        { "\xe6\x97z", 0, 0 },                  // cut short in the middle
+        { "\xf0\x9f\x98", 0, 0 },
+        { "\xc3", 0, 0 },
+        { "\xc3\xa9\xa9", 0, 2 },               // one continuation too many
+    };
+    char Buffer[256];
+    for (int c = 0; c < (int)(sizeof(Cases) / sizeof(Cases[0])); c++)
+    {
+        size_t Length = strlen(Cases[c].Bytes);
+        for (int Before = 0; Before < 70; Before++)
+        {
+            for (int After = 0; After < 40; After += 13)
+            {
+                memset(Buffer, 'a', Before);
+                memcpy(Buffer + Before, Cases[c].Bytes, Length);
+                memset(Buffer + Before + Length, 'b', After);
+                size_t Total = Before + Length + After;
+                CheckAllPaths(Buffer, Total, Cases[c].Valid, Before + Cases[c].Offset);
+            }
+        }
+    }
+    assert(sl_utf8_validate("", 0, NULL));
+    assert(sl_utf8_validate(NULL, 0, NULL));
+
+    // random text with random damage, the SIMD paths find the same first error
+    static unsigned char Text[4096];
+    for (int Round = 0; Round < 3000; Round++)
+    {
+        size_t Length = 0;
+        size_t Target = TestRandom() % 600;
+        while (Length < Target)
+            Length += Encode(RandomCodePoint(), Text + Length);
+
+        int Damage = TestRandom() % 4;
+        for (int d = 0; d < Damage && Length; d++)
+        {
+            size_t At = TestRandom() % Length;
+            switch (TestRandom() % 3)
+            {
+                case 0: Text[At] = (unsigned char)TestRandom(); break;
+                case 1: Text[At] ^= 0x40; break;
+                default: Length = At; break;       // truncate
+            }
+        }
+
+        size_t Expected = 0;
+        int Valid = ValidateScalar((const char*)Text, Length, &Expected);
+        if (!Damage)
+            assert(Valid);
+        CheckAllPaths((const char*)Text, Length, Valid, Expected);
+    }
+
+    // round trips through UTF-32 and UTF-16
+    static unsigned int CodePoints[2000], Decoded32[8000];
+    static unsigned short Expected16[4000], Decoded16[8000];
+    for (int Round = 0; Round < 200; Round++)
+    {
+        int Count = TestRandom() % 2000;
+        int Ascii = Round & 1;
+        size_t Length = 0, Units = 0;
+        for (int i = 0; i < Count; i++)
+        {
+            // long ASCII runs go down the widening path
+            CodePoints[i] = (Ascii && (i / 40) % 2) ? 32 + TestRandom() % 90 : RandomCodePoint();
+            Length += Encode(CodePoints[i], Text + Length);
+            if (CodePoints[i] < 0x10000)
+            {
+                Expected16[Units++] = (unsigned short)CodePoints[i];
+            }
+            else
+            {
+                Expected16[Units++] = (unsigned short)(0xd800 + ((CodePoints[i] - 0x10000) >> 10));
+                Expected16[Units++] = (unsigned short)(0xdc00 + ((CodePoints[i] - 0x10000) & 0x3ff));
+            }
+            if (Length > sizeof(Text) - 4)
+            {
+                Count = i + 1;
+                break;
+            }
+        }
+
+        for (int Level = 0; Level < 2; Level++)
+        {
+            sl_cpu_override(Level ? ~0u : 0);
+            assert(sl_utf8_count_utf32((const char*)Text, Length) == (size_t)Count);
+            assert(sl_utf8_count_utf16((const char*)Text, Length) == Units);
+            assert(sl_utf8_to_utf32((const char*)Text, Length, Decoded32, NULL) == (size_t)Count);
+            assert(memcmp(Decoded32, CodePoints, sizeof(unsigned int) * Count) == 0);
+            assert(sl_utf8_to_utf16((const char*)Text, Length, Decoded16, NULL) == Units);
+            assert(memcmp(Decoded16, Expected16, sizeof(unsigned short) * Units) == 0);
+        }
+        sl_cpu_override(~0u);
+    }
+
+    // appending to dyn_arrays, bad text leaves the list alone
+    unsigned int* List32 = NULL;
+    unsigned short* List16 = NULL;
+    assert(sl_utf8_to_utf32_da("abc", 3, List32, NULL) == 3);
+    assert(sl_utf8_to_utf32_da("\xf0\x9f\x98\x80!", 5, List32, NULL) == 2);
+    assert(da_len(List32) == 5 && List32[3] == 0x1f600 && List32[4] == '!');
+    size_t Offset = 0;
+    assert(sl_utf8_to_utf32_da("ab\xc3", 3, List32, &Offset) == SL_UTF8_ERROR);
+    assert(Offset == 2 && da_len(List32) == 5);
+    assert(sl_utf8_to_utf16_da("\xf0\x9f\x98\x80\xc3\xa9", 6, List16, NULL) == 3);
+    assert(da_len(List16) == 3 && List16[0] == 0xd83d && List16[1] == 0xde00 && List16[2] == 0xe9);
+    for (int i = 0; i < 1000; i++)
+    {
+        sl_utf8_to_utf16_da("0123456789", 10, List16, NULL);
+    }
+    assert(da_len(List16) == 10003 && List16[10002] == '9');
+    da_delete(List32);
+    da_delete(List16);
+
+    // the file and INI loaders check as they read
+    const char* GoodIni = "[caf\xc3\xa9]\nname = \xe6\x97\xa5\xe6\x9c\xac\nsize = 3\n";
+    WriteFile("sl_utf8_good.ini", GoodIni, strlen(GoodIni));
+    read_file_result Good = ReadEntireFile((char*)"sl_utf8_good.ini");
+    assert(Good.success && !Good.bad_utf8 && Good.size == strlen(GoodIni));
+    free(Good.contents);
+    IniValues = 0;
+    assert(ParseIniFile((char*)"sl_utf8_good.ini", CountIni, 0) == 0);
+    assert(IniValues == 2);
+
+    const char* BadIni = "[section]\nname = caf\xe9\nsize = 3\n";
+    WriteFile("sl_utf8_bad.ini", BadIni, strlen(BadIni));
+    read_file_result Bad = ReadEntireFile((char*)"sl_utf8_bad.ini");
+    assert(!Bad.success && Bad.bad_utf8 && Bad.utf8_error_offset == 20 && !Bad.contents);
+    IniValues = 0;
+    assert(ParseIniFile((char*)"sl_utf8_bad.ini", CountIni, 0) == -2);
+    assert(IniValues == 0);
+
+    // binary reads aren't text, they aren't checked
+    Bad = ReadEntireFile((char*)"sl_utf8_bad.ini", true);
+    assert(Bad.success && !Bad.bad_utf8);
+    free(Bad.contents);
+    assert(ParseIniFile((char*)"does_not_exist.ini", CountIni, 0) == -1);
+
+    remove("sl_utf8_good.ini");
+    remove("sl_utf8_bad.ini");
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+#include "sl_vec.h"
+
+using namespace sl;
+
+// everything here is evaluated by the compiler
+constexpr vec3 CA(1.f, 2.f, 3.f);
+constexpr vec3 CB(4.f, 5.f, 6.f);
+constexpr vec3 CSum = CA * 2.f + CB - CA;
+static_assert(CSum[0] == 5.f && CSum[1] == 7.f && CSum[2] == 9.f, "constexpr expression");
+static_assert(dot(CA, CB) == 32.f, "constexpr dot");
+static_assert(cross(vec3(1.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f)) == vec3(0.f, 0.f, 1.f), "constexpr cross");
+
+constexpr mat4 CT = translation(vec3(10.f, 20.f, 30.f)) * scaling(vec3(2.f));
+constexpr vec4 CP = CT * vec4(1.f, 1.f, 1.f, 1.f);
+static_assert(CP[0] == 12.f && CP[1] == 22.f && CP[2] == 32.f && CP[3] == 1.f, "constexpr transform");
+
+static_assert(ivec3(1, 2, 3) * 3 == ivec3(3, 6, 9), "int instantiation");
+static_assert(sizeof(vec3) == sizeof(vec3f), "vec3 matches vec3f");
+static_assert(sizeof(mat4) == sizeof(mat4f), "mat4 matches mat4f");
+
+int main(int argc, char** argv) {
+
+    vec3 A(1.f, 2.f, 3.f);
+    vec3 B(0.5f);
+    vec3 C(1.f, 1.f, 1.f);
+    float s = 4.f;
+
+    vec3 R = A*s + B - C;
+    assert(R[0] == 3.5f);
+    assert(R[1] == 7.5f);
+    assert(R[2] == 11.5f);
+
+    // aliasing the destination has to work
+    R = R - R * 0.5f;
+    assert(R[0] == 1.75f);
+
+    R += A;
+    assert(R[0] == 2.75f);
+
+    assert(hadamard(A, C * 2.f) == vec3(2.f, 4.f, 6.f));
+    assert(-A == vec3(-1.f, -2.f, -3.f));
+
+    vec3 N = normalize(vec3(3.f, 0.f, 4.f));
+    assert(N[0] == 0.6f && N[2] == 0.8f);
+    assert(length(vec3(3.f, 0.f, 4.f)) == 5.f);
+
+    // interop with the plain C types
+    vec3f F = Vec3f(1.f, 2.f, 3.f);
+    vec3 FromC = F;
+    vec3f BackToC = vec3(FromC * 2.f);
+    assert(BackToC.X == 2.f && BackToC.Y == 4.f && BackToC.Z == 6.f);
+
+    vec2 V2 = vec2(Vec2f(1.f, 1.f));
+    assert(perp(V2) == vec2(-1.f, 1.f));
+
+    dvec3 D = Vec3d(1.0, 2.0, 3.0);
+    D = D * 0.5 + D;
+    assert(D[2] == 4.5);
+
+    mat4f M = Mat4Identity();
+    M = TranslateMat4fByVec3f(M, Vec3f(1.f, 2.f, 3.f));
+    mat4 TM = M;
+    vec4 P = TM * vec4(0.f, 0.f, 0.f, 1.f);
+    vec4f Origin = { 0.f, 0.f, 0.f, 1.f };
+    vec4f PC = Mul(M, Origin);
+    assert(P[0] == PC.X && P[1] == PC.Y && P[2] == PC.Z);
+
+    mat4f Back = TM * transpose(transpose(mat4::identity()));
+    assert(Back.E[12] == 1.f && Back.E[13] == 2.f && Back.E[14] == 3.f);
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#define _SL_H_IMPLEMENTATION
+#include "sl.h"
+
+#define DYN_ARRAY_IMPL
+#define SL_CPU_IMPL
+#define SL_PACK_IMPL
+#define SL_VERTEX_IMPL
+#include "sl_vertex.h"
+
+static real32 RandomReal32(real32 Min, real32 Max)
+{
+    return Min + (Max - Min) * ((real32)rand() / (real32)RAND_MAX);
+}
+
+// the 8 and 16 bit formats clamp NaN to the bottom of the range like Real32ToSnorm16
+static real32 Saturate(real32 F, real32 Lo)
+{
+    return F != F ? Lo : Clamp(F, Lo, 1.f);
+}
+
+// what one value should come out as, straight from the scalar conversions
+static void Reference(sl_vertex_format Format, real32* In, int Components, unsigned char* Out)
+{
+    vec4f V = {};
+    memcpy(V.E, In, sizeof(real32) * Components);
+    u32 Packed;
+    for (int c = 0; c < Components; c++)
+    {
+        switch (Format)
+        {
+            case SL_VERTEX_FLOAT: memcpy(Out + 4 * c, In + c, 4); break;
+            case SL_VERTEX_HALF: { u16 H = Real32ToHalf(In[c]); memcpy(Out + 2 * c, &H, 2); } break;
+            case SL_VERTEX_SNORM16: { i16 S = Real32ToSnorm16(In[c]); memcpy(Out + 2 * c, &S, 2); } break;
+            case SL_VERTEX_UNORM16: { u16 U = (u16)lrintf(Saturate(In[c], 0.f) * 65535.f); memcpy(Out + 2 * c, &U, 2); } break;
+            case SL_VERTEX_SNORM8: Out[c] = (u8)(i8)lrintf(Saturate(In[c], -1.f) * 127.f); break;
+            case SL_VERTEX_UNORM8: Out[c] = (u8)lrintf(Saturate(In[c], 0.f) * 255.f); break;
+            default: break;
+        }
+    }
+    switch (Format)
+    {
+        case SL_VERTEX_SNORM1010102: Packed = PackSnorm1010102(V); memcpy(Out, &Packed, 4); break;
+        case SL_VERTEX_UNORM1010102: Packed = PackUnorm1010102(V); memcpy(Out, &Packed, 4); break;
+        case SL_VERTEX_OCT_NORMAL: Packed = EncodeOctNormal(Vec3f(V.X, V.Y, V.Z)); memcpy(Out, &Packed, 4); break;
+        default: break;
+    }
+}
+
+static real32 Tolerance(sl_vertex_format Format)
+{
+    switch (Format)
+    {
+        case SL_VERTEX_FLOAT: return 0.f;
+        case SL_VERTEX_HALF: return 1e-3f;
+        case SL_VERTEX_SNORM16:
+        case SL_VERTEX_UNORM16: return 1e-4f;
+        case SL_VERTEX_OCT_NORMAL: return 1e-3f;
+        case SL_VERTEX_SNORM1010102:
+        case SL_VERTEX_UNORM1010102: return 1.f / 511.f;
+        default: return 1.f / 127.f;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    srand(11);
+
+    // layouts: offsets stay 4 byte aligned, bad combinations are refused
+    sl_vertex_layout Layout = {};
+    assert(sl_vertex_layout_add(&Layout, 3, SL_VERTEX_FLOAT) == 0);
+    assert(sl_vertex_layout_add(&Layout, 3, SL_VERTEX_HALF) == 1);
+    assert(sl_vertex_layout_add(&Layout, 3, SL_VERTEX_UNORM8) == 2);
+    assert(sl_vertex_layout_add(&Layout, 2, SL_VERTEX_SNORM16) == 3);
+    assert(Layout.Attribs[1].Offset == 12 && Layout.Attribs[1].Size == 6);
+    assert(Layout.Attribs[2].Offset == 20 && Layout.Attribs[3].Offset == 24);
+    assert(Layout.Stride == 28);
+    sl_vertex_layout_pad(&Layout, 16);
+    assert(Layout.Stride == 32);
+    assert(sl_vertex_layout_add(&Layout, 2, SL_VERTEX_OCT_NORMAL) == -1);
+    assert(sl_vertex_layout_add(&Layout, 2, SL_VERTEX_UNORM1010102) == -1);
+    assert(sl_vertex_layout_add(&Layout, 5, SL_VERTEX_FLOAT) == -1);
+    assert(sl_vertex_layout_add(&Layout, 1, SL_VERTEX_UNORM8) == 4);
+    assert(Layout.Attribs[4].Offset == 28 && Layout.Stride == 32);
+
+    // every format, on its own and all together, against the scalar conversions,
+    // with counts that split the chunks and leave SIMD tails
+    const int Count = 2 * SL_VERTEX_CHUNK + 37;
+    struct { int Components; sl_vertex_format Format; } Attribs[] = {
+        { 3, SL_VERTEX_FLOAT }, { 3, SL_VERTEX_OCT_NORMAL }, { 2, SL_VERTEX_HALF },
+        { 4, SL_VERTEX_SNORM16 }, { 1, SL_VERTEX_UNORM16 }, { 3, SL_VERTEX_SNORM8 },
+        { 4, SL_VERTEX_UNORM8 }, { 3, SL_VERTEX_SNORM1010102 }, { 4, SL_VERTEX_UNORM1010102 },
+        { 2, SL_VERTEX_FLOAT }, { 3, SL_VERTEX_UNORM8 },
+    };
+    const int AttribCount = sizeof(Attribs) / sizeof(Attribs[0]);
+    real32* Sources[AttribCount];
+    real32* Decoded[AttribCount];
+    for (int a = 0; a < AttribCount; a++)
+    {
+        int Values = Count * Attribs[a].Components;
+        Sources[a] = (real32*)malloc(sizeof(real32) * Values);
+        Decoded[a] = (real32*)malloc(sizeof(real32) * Values);
+        for (int i = 0; i < Values; i++)
+            Sources[a][i] = RandomReal32(-1.2f, 1.2f);
+        if (Attribs[a].Format == SL_VERTEX_OCT_NORMAL)
+        {
+            vec3f* Normals = (vec3f*)Sources[a];
+            for (int i = 0; i < Count; i++)
+            {
+                vec3f N = Normals[i];
+                real32 Length = sqrtf(N.X * N.X + N.Y * N.Y + N.Z * N.Z);
+                Normals[i] = Vec3f(N.X / Length, N.Y / Length, N.Z / Length);
+            }
+        }
+        // the edges of the ranges, and a NaN for the formats that define one
+        if (Attribs[a].Format != SL_VERTEX_OCT_NORMAL)
+        {
+            Sources[a][0] = 1.f;
+            Sources[a][Values - 1] = -1.f;
+        }
+        if (Attribs[a].Format >= SL_VERTEX_SNORM16 && Attribs[a].Format <= SL_VERTEX_UNORM8)
+            Sources[a][Values / 2] = NAN;
+    }
+
+    u8* Buffer = NULL;
+    for (int Mode = 0; Mode <= AttribCount; Mode++)
+    {
+        // one attribute at a time, then all of them in one padded vertex
+        int First = Mode < AttribCount ? Mode : 0;
+        int Last = Mode < AttribCount ? Mode + 1 : AttribCount;
+        sl_vertex_layout L = {};
+        for (int a = First; a < Last; a++)
+            sl_vertex_layout_add(&L, Attribs[a].Components, Attribs[a].Format);
+        if (Mode == AttribCount)
+            sl_vertex_layout_pad(&L, 32);
+
+        for (int Level = 0; Level < 2; Level++)
+        {
+            sl_cpu_override(Level ? ~0u : 0);
+            if (Buffer)
+                memset(Buffer, 0xcd, da_len(Buffer));
+            sl_vertex_pack_da(&L, Sources + First, Count, &Buffer);
+            assert(da_len(Buffer) == Count * L.Stride);
+
+            for (int i = 0; i < Count; i++)
+            {
+                u8* Vertex = Buffer + i * L.Stride;
+                int End = 0;
+                for (int a = 0; a < L.Count; a++)
+                {
+                    sl_vertex_attrib* Attrib = L.Attribs + a;
+                    unsigned char Expected[16];
+                    Reference(Attrib->Format, Sources[First + a] + i * Attrib->Components, Attrib->Components, Expected);
+                    assert(memcmp(Vertex + Attrib->Offset, Expected, Attrib->Size) == 0);
+                    for (int b = End; b < Attrib->Offset; b++)
+                        assert(Vertex[b] == 0);
+                    End = Attrib->Offset + Attrib->Size;
+                }
+                for (int b = End; b < L.Stride; b++)
+                    assert(Vertex[b] == 0);
+            }
+
+            sl_vertex_unpack(&L, Buffer, Count, Decoded + First);
+            for (int a = First; a < Last; a++)
+            {
+                real32 Tol = Tolerance(Attribs[a].Format);
+                bool Unsigned = Attribs[a].Format == SL_VERTEX_UNORM16 || Attribs[a].Format == SL_VERTEX_UNORM8 ||
+                    Attribs[a].Format == SL_VERTEX_UNORM1010102;
+                for (int i = 0; i < Count * Attribs[a].Components; i++)
+                {
+                    real32 In = Sources[a][i];
+                    if (In != In)
+                        continue;
+                    In = Unsigned ? Clamp01(In) : Clamp(In, -1.f, 1.f);
+                    if (Attribs[a].Format == SL_VERTEX_FLOAT || Attribs[a].Format == SL_VERTEX_HALF)
+                        In = Sources[a][i];
+                    // W of 10:10:10:2 only has 2 bits
+                    if (Attribs[a].Components == 4 && i % 4 == 3 && Attribs[a].Format >= SL_VERTEX_SNORM1010102)
+                        Tol = 0.5f;
+                    assert(fabsf(Decoded[a][i] - In) <= Tol * (1.f + fabsf(In)));
+                    Tol = Tolerance(Attribs[a].Format);
+                }
+            }
+        }
+        sl_cpu_override(~0u);
+    }
+
+    // unpacking only some attributes leaves the rest alone
+    sl_vertex_layout Both = {};
+    sl_vertex_layout_add(&Both, 3, SL_VERTEX_FLOAT);
+    sl_vertex_layout_add(&Both, 2, SL_VERTEX_HALF);
+    real32* Pair[2] = { Sources[0], Sources[2] };
+    sl_vertex_pack_da(&Both, Pair, Count, &Buffer);
+    assert(da_len(Buffer) == Count * 16);
+    Decoded[2][5] = 42.f;
+    real32* Only[2] = { Decoded[0], NULL };
+    sl_vertex_unpack(&Both, Buffer, Count, Only);
+    assert(memcmp(Decoded[0], Sources[0], sizeof(real32) * 3 * Count) == 0);
+    assert(Decoded[2][5] == 42.f);
+
+    // reusing the buffer for fewer vertices shrinks the length, not the allocation
+    int Capacity = da_cap(Buffer);
+    sl_vertex_pack_da(&Both, Pair, 10, &Buffer);
+    assert(da_len(Buffer) == 160 && da_cap(Buffer) == Capacity);
+    sl_vertex_pack_da(&Both, Pair, 0, &Buffer);
+    assert(da_len(Buffer) == 0);
+
+    for (int a = 0; a < AttribCount; a++)
+    {
+        free(Sources[a]);
+        free(Decoded[a]);
+    }
+    da_delete(Buffer);
+
+    printf("Passed\n");
+    return 0;
+}